@@ -29,13 +29,28 @@
 /// \author James Hughes
 /// \date   September 2012
 
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <future>
 #include <sstream>
+#include <thread>
 #include "Interface.h"
 #include "src/Exceptions.h"
 #include "src/Hub.h"
+#include "src/GLStateMan.h"
+#include "src/BatchMan.h"
+#include "src/OcclusionMan.h"
+#include "src/UploadQueue.h"
+#include "src/StreamBuffer.h"
+#include "src/BufferArena.h"
 #include "src/Log.h"
 #include "src/InterfaceImplementation.h"
 #include "src/SpireObject.h"
+#include "src/MeshOptimizer.h"
+#include "src/MappedFile.h"
+#include "src/SR6Format.h"
+#include "src/ShaderAttributeMan.h"
 
 using namespace std::placeholders;
 
@@ -93,18 +108,20 @@ void Interface::clearGLResources()
 }
 
 //------------------------------------------------------------------------------
-void Interface::addVBO(const std::string& name,
-                       const uint8_t* vboData, size_t vboSize,
-                       const std::vector<std::string>& attribNames)
+VBOHandle Interface::addVBO(const std::string& name,
+                            const uint8_t* vboData, size_t vboSize,
+                            const std::vector<std::string>& attribNames,
+                            BUFFER_USAGE usage)
 {
-  mImpl->addConcurrentVBO(name, vboData, vboSize, attribNames);
+  return mImpl->addConcurrentVBO(name, vboData, vboSize, attribNames, usage);
 }
 
 //------------------------------------------------------------------------------
-void Interface::addIBO(const std::string& name,
-                       const uint8_t* iboData, size_t iboSize, IBO_TYPE type)
+IBOHandle Interface::addIBO(const std::string& name,
+                            const uint8_t* iboData, size_t iboSize, IBO_TYPE type,
+                            BUFFER_USAGE usage)
 {
-  mImpl->addConcurrentIBO(name, iboData, iboSize, type);
+  return mImpl->addConcurrentIBO(name, iboData, iboSize, type, usage);
 }
 
 //------------------------------------------------------------------------------
@@ -112,9 +129,227 @@ void Interface::renderObject(const std::string& objectName,
                              const std::string& pass)
 {
   std::shared_ptr<SpireObject> obj = getObjectWithName(objectName);
+  mHub->getStreamBuffer().flush();
   obj->renderPass(pass);
 }
 
+//------------------------------------------------------------------------------
+void Interface::renderObject(ObjectHandle object, PassHandle pass)
+{
+  if (pass.isValid() == false)
+    throw std::invalid_argument("Invalid pass handle.");
+  mImpl->getObject(object)->renderPass(static_cast<size_t>(pass.index));
+}
+
+//------------------------------------------------------------------------------
+void Interface::renderPass(const std::string& pass)
+{
+  mImpl->renderPass(pass);
+}
+
+//------------------------------------------------------------------------------
+void Interface::renderPass(PassHandle pass)
+{
+  mImpl->renderPass(pass);
+}
+
+//------------------------------------------------------------------------------
+void Interface::compileRenderList(PassHandle pass)
+{
+  mImpl->compileRenderList(pass);
+}
+
+//------------------------------------------------------------------------------
+ObjectHandle Interface::getObjectHandle(const std::string& object) const
+{
+  return mImpl->getObjectHandle(object);
+}
+
+//------------------------------------------------------------------------------
+VBOHandle Interface::getVBOHandle(const std::string& vboName) const
+{
+  return mImpl->getVBOHandle(vboName);
+}
+
+//------------------------------------------------------------------------------
+IBOHandle Interface::getIBOHandle(const std::string& iboName) const
+{
+  return mImpl->getIBOHandle(iboName);
+}
+
+//------------------------------------------------------------------------------
+PassHandle Interface::getPassHandle(const std::string& pass) const
+{
+  return mImpl->getPassHandle(pass);
+}
+
+//------------------------------------------------------------------------------
+PassHandle Interface::addPass(const std::string& pass)
+{
+  return mImpl->addPass(pass);
+}
+
+//------------------------------------------------------------------------------
+void Interface::setBatchingEnabled(bool enabled)
+{
+  mHub->getBatchManager().setEnabled(enabled);
+}
+
+//------------------------------------------------------------------------------
+size_t Interface::getNumDrawBatches() const
+{
+  return mHub->getBatchManager().getNumBatches();
+}
+
+//------------------------------------------------------------------------------
+void Interface::setCullingUniform(const std::string& uniformName)
+{
+  mImpl->setCullingUniform(uniformName);
+}
+
+//------------------------------------------------------------------------------
+size_t Interface::getNumCulledPasses() const
+{
+  return mImpl->getNumCulledPasses();
+}
+
+//------------------------------------------------------------------------------
+size_t Interface::getNumRenderedPasses() const
+{
+  return mImpl->getNumRenderedPasses();
+}
+
+//------------------------------------------------------------------------------
+size_t Interface::getNumRenderListBuilds() const
+{
+  return mImpl->getNumRenderListBuilds();
+}
+
+//------------------------------------------------------------------------------
+void Interface::setOcclusionCullingEnabled(bool enabled)
+{
+  mHub->getOcclusionManager().setEnabled(enabled);
+}
+
+//------------------------------------------------------------------------------
+size_t Interface::getNumOccludedPasses() const
+{
+  return mHub->getOcclusionManager().getNumOccludedPasses();
+}
+
+//------------------------------------------------------------------------------
+void Interface::setUploadBudget(double milliseconds)
+{
+  mHub->getUploadQueue().setBudget(milliseconds);
+}
+
+//------------------------------------------------------------------------------
+size_t Interface::processUploads()
+{
+  return mHub->getUploadQueue().process();
+}
+
+//------------------------------------------------------------------------------
+size_t Interface::getNumPendingUploads() const
+{
+  return mHub->getUploadQueue().getNumPendingBuffers();
+}
+
+//------------------------------------------------------------------------------
+size_t Interface::getNumPendingUploadBytes() const
+{
+  return mHub->getUploadQueue().getNumPendingBytes();
+}
+
+//------------------------------------------------------------------------------
+size_t Interface::getNumBytesUploaded() const
+{
+  return mHub->getUploadQueue().getNumBytesUploaded();
+}
+
+//------------------------------------------------------------------------------
+void Interface::setNumRecordingThreads(size_t numThreads)
+{
+  mImpl->setNumRecordingThreads(numThreads);
+}
+
+//------------------------------------------------------------------------------
+void Interface::generateIBOLODs(const std::string& iboName,
+                                std::shared_ptr<std::vector<uint8_t>> iboData,
+                                std::shared_ptr<std::vector<uint8_t>> vboData,
+                                const std::vector<std::string>& attribNames)
+{
+  mImpl->generateIBOLODs(iboName, iboData, vboData, attribNames);
+}
+
+//------------------------------------------------------------------------------
+size_t Interface::getNumIBOLODs(const std::string& iboName) const
+{
+  return mImpl->getNumIBOLODs(iboName);
+}
+
+//------------------------------------------------------------------------------
+Interface::MeshOptimization Interface::optimizeMesh(
+    std::vector<uint8_t>& vboData, const std::vector<std::string>& attribNames,
+    std::vector<uint8_t>& iboData, IBO_TYPE type) const
+{
+  size_t stride;
+  size_t positionOffset;
+  mImpl->getPositionLayout(attribNames, stride, positionOffset);
+  return optimizeMesh(vboData, stride, positionOffset, iboData, type);
+}
+
+//------------------------------------------------------------------------------
+Interface::MeshOptimization Interface::optimizeMesh(
+    std::vector<uint8_t>& vboData, size_t stride, size_t positionOffset,
+    std::vector<uint8_t>& iboData, IBO_TYPE type)
+{
+  if (stride == 0 || positionOffset + 3 * sizeof(float) > stride)
+    throw std::invalid_argument("Invalid vertex layout for mesh optimization.");
+
+  size_t indexSize;
+  switch (type)
+  {
+    case IBO_8BIT:  indexSize = sizeof(uint8_t);  break;
+    case IBO_16BIT: indexSize = sizeof(uint16_t); break;
+    default:        indexSize = sizeof(uint32_t); break;
+  }
+
+  std::vector<uint32_t> indices;
+  widenIndices(iboData.data(), iboData.size() / indexSize, indexSize, indices);
+
+  MeshOptimizerStats stats =
+      CPM_SPIRE_NS::optimizeMesh(vboData.data(), vboData.size() / stride,
+                                 stride, positionOffset, indices);
+
+  MeshOptimization result;
+  result.acmrBefore = stats.acmrBefore;
+  result.acmrAfter  = stats.acmrAfter;
+
+  indexSize = getMinIndexSize(indices);
+  switch (indexSize)
+  {
+    case sizeof(uint8_t):   result.type = IBO_8BIT;   break;
+    case sizeof(uint16_t):  result.type = IBO_16BIT;  break;
+    default:                result.type = IBO_32BIT;  break;
+  }
+  narrowIndices(indices, indexSize, iboData);
+
+  return result;
+}
+
+//------------------------------------------------------------------------------
+void Interface::setLODPixelError(float pixels)
+{
+  mImpl->setLODPixelError(pixels);
+}
+
+//------------------------------------------------------------------------------
+void Interface::setSmallFeatureCulling(float pixels)
+{
+  mImpl->setSmallFeatureCulling(pixels);
+}
+
 //------------------------------------------------------------------------------
 void Interface::makeCurrent()
 {
@@ -122,9 +357,33 @@ void Interface::makeCurrent()
 }
 
 //------------------------------------------------------------------------------
-void Interface::addObject(const std::string& objectName)
+void Interface::invalidateGLState()
+{
+  mHub->getGLStateManager().invalidate();
+}
+
+//------------------------------------------------------------------------------
+size_t Interface::getNumGLStateCallsIssued() const
 {
-  mImpl->addObject(objectName);
+  return mHub->getGLStateManager().getNumIssuedCalls();
+}
+
+//------------------------------------------------------------------------------
+size_t Interface::getNumGLStateCallsSkipped() const
+{
+  return mHub->getGLStateManager().getNumSkippedCalls();
+}
+
+//------------------------------------------------------------------------------
+void Interface::resetGLStateCounters()
+{
+  mHub->getGLStateManager().resetCounters();
+}
+
+//------------------------------------------------------------------------------
+ObjectHandle Interface::addObject(const std::string& objectName)
+{
+  return mImpl->addObject(objectName);
 }
 
 //------------------------------------------------------------------------------
@@ -133,6 +392,12 @@ void Interface::removeObject(const std::string& objectName)
   mImpl->removeObject(objectName);
 }
 
+//------------------------------------------------------------------------------
+void Interface::removeObject(ObjectHandle object)
+{
+  mImpl->removeObject(object);
+}
+
 //------------------------------------------------------------------------------
 void Interface::removeAllObjects()
 {
@@ -140,11 +405,12 @@ void Interface::removeAllObjects()
 }
 
 //------------------------------------------------------------------------------
-void Interface::addVBO(const std::string& name,
-                       std::shared_ptr<std::vector<uint8_t>> vboData,
-                       const std::vector<std::string>& attribNames)
+VBOHandle Interface::addVBO(const std::string& name,
+                            std::shared_ptr<std::vector<uint8_t>> vboData,
+                            const std::vector<std::string>& attribNames,
+                            BUFFER_USAGE usage)
 {
-  mImpl->addVBO(name, vboData, attribNames);
+  return mImpl->addVBO(name, vboData, attribNames, usage);
 }
 
 //------------------------------------------------------------------------------
@@ -154,11 +420,30 @@ void Interface::removeVBO(const std::string& vboName)
 }
 
 //------------------------------------------------------------------------------
-void Interface::addIBO(const std::string& name,
-                       std::shared_ptr<std::vector<uint8_t>> iboData,
-                       IBO_TYPE type)
+void Interface::removeVBO(VBOHandle vbo)
 {
-  mImpl->addIBO(name, iboData, type);
+  mImpl->removeVBO(vbo);
+}
+
+//------------------------------------------------------------------------------
+void Interface::updateVBO(const std::string& vboName, size_t offset,
+                          const uint8_t* data, size_t size)
+{
+  mImpl->updateVBO(mImpl->getVBOHandle(vboName), offset, data, size);
+}
+
+//------------------------------------------------------------------------------
+void Interface::updateVBO(VBOHandle vbo, size_t offset, const uint8_t* data, size_t size)
+{
+  mImpl->updateVBO(vbo, offset, data, size);
+}
+
+//------------------------------------------------------------------------------
+IBOHandle Interface::addIBO(const std::string& name,
+                            std::shared_ptr<std::vector<uint8_t>> iboData,
+                            IBO_TYPE type, BUFFER_USAGE usage)
+{
+  return mImpl->addIBO(name, iboData, type, usage);
 }
 
 //------------------------------------------------------------------------------
@@ -168,15 +453,121 @@ void Interface::removeIBO(const std::string& iboName)
 }
 
 //------------------------------------------------------------------------------
-void Interface::addPassToObject(const std::string& object,
-                                const std::string& program,
-                                const std::string& vboName,
-                                const std::string& iboName,
-                                PRIMITIVE_TYPES type,
-                                const std::string& pass,
-                                const std::string& parentPass)
+void Interface::removeIBO(IBOHandle ibo)
+{
+  mImpl->removeIBO(ibo);
+}
+
+//------------------------------------------------------------------------------
+void Interface::updateIBO(const std::string& iboName, size_t offset,
+                          const uint8_t* data, size_t size)
+{
+  mImpl->updateIBO(mImpl->getIBOHandle(iboName), offset, data, size);
+}
+
+//------------------------------------------------------------------------------
+void Interface::updateIBO(IBOHandle ibo, size_t offset, const uint8_t* data, size_t size)
 {
-  mImpl->addPassToObject(object, program, vboName, iboName, type, pass, parentPass);
+  mImpl->updateIBO(ibo, offset, data, size);
+}
+
+//------------------------------------------------------------------------------
+void Interface::setStreamBufferSize(size_t bytes)
+{
+  mHub->getStreamBuffer().setCapacity(bytes);
+}
+
+//------------------------------------------------------------------------------
+VBOHandle Interface::addStreamVBO(const std::string& name,
+                                  const std::vector<std::string>& attribNames)
+{
+  return mImpl->addStreamVBO(name, attribNames);
+}
+
+//------------------------------------------------------------------------------
+IBOHandle Interface::addStreamIBO(const std::string& name, IBO_TYPE type)
+{
+  return mImpl->addStreamIBO(name, type);
+}
+
+//------------------------------------------------------------------------------
+uint8_t* Interface::writeStreamVBO(const std::string& vboName, size_t size)
+{
+  return mImpl->writeStreamVBO(mImpl->getVBOHandle(vboName), size);
+}
+
+//------------------------------------------------------------------------------
+uint8_t* Interface::writeStreamVBO(VBOHandle vbo, size_t size)
+{
+  return mImpl->writeStreamVBO(vbo, size);
+}
+
+//------------------------------------------------------------------------------
+uint8_t* Interface::writeStreamIBO(const std::string& iboName, size_t size)
+{
+  return mImpl->writeStreamIBO(mImpl->getIBOHandle(iboName), size);
+}
+
+//------------------------------------------------------------------------------
+uint8_t* Interface::writeStreamIBO(IBOHandle ibo, size_t size)
+{
+  return mImpl->writeStreamIBO(ibo, size);
+}
+
+//------------------------------------------------------------------------------
+void Interface::endStreamFrame()
+{
+  mHub->getStreamBuffer().endFrame();
+}
+
+//------------------------------------------------------------------------------
+size_t Interface::getNumStreamStalls() const
+{
+  return mHub->getStreamBuffer().getNumStalls();
+}
+
+//------------------------------------------------------------------------------
+void Interface::setBufferArenaEnabled(bool enabled)
+{
+  mHub->getVertexArena().setEnabled(enabled);
+  mHub->getIndexArena().setEnabled(enabled);
+}
+
+//------------------------------------------------------------------------------
+size_t Interface::compactBufferArenas()
+{
+  return mImpl->compactBufferArenas();
+}
+
+//------------------------------------------------------------------------------
+size_t Interface::getNumArenaBuffers() const
+{
+  return mHub->getVertexArena().getNumBlocks()
+       + mHub->getIndexArena().getNumBlocks();
+}
+
+//------------------------------------------------------------------------------
+PassHandle Interface::addPassToObject(const std::string& object,
+                                      const std::string& program,
+                                      const std::string& vboName,
+                                      const std::string& iboName,
+                                      PRIMITIVE_TYPES type,
+                                      const std::string& pass,
+                                      const std::string& parentPass)
+{
+  return mImpl->addPassToObject(object, program, vboName, iboName, type, pass, parentPass);
+}
+
+//------------------------------------------------------------------------------
+PassHandle Interface::addPassToObject(ObjectHandle object,
+                                      const std::string& program,
+                                      VBOHandle vbo,
+                                      IBOHandle ibo,
+                                      PRIMITIVE_TYPES type,
+                                      PassHandle pass,
+                                      PassHandle parentPass)
+{
+  return mImpl->addPassToObject(object, program, vbo, ibo, type, pass, parentPass);
 }
 
 //------------------------------------------------------------------------------
@@ -185,6 +576,27 @@ void Interface::removePassFromObject(const std::string& object, const std::strin
   mImpl->removePassFromObject(object, pass);
 }
 
+//------------------------------------------------------------------------------
+void Interface::removePassFromObject(ObjectHandle object, PassHandle pass)
+{
+  mImpl->removePassFromObject(object, pass);
+}
+
+//------------------------------------------------------------------------------
+void Interface::setObjectPassInstanceVBO(const std::string& object,
+                                         const std::string& instanceVBOName,
+                                         const std::string& pass)
+{
+  mImpl->setObjectPassInstanceVBO(object, instanceVBOName, pass);
+}
+
+//------------------------------------------------------------------------------
+void Interface::setObjectPassInstanceVBO(ObjectHandle object, VBOHandle instanceVBO,
+                                         PassHandle pass)
+{
+  mImpl->setObjectPassInstanceVBO(object, instanceVBO, pass);
+}
+
 //------------------------------------------------------------------------------
 std::vector<Interface::UnsatisfiedUniform> Interface::getUnsatisfiedUniforms(
     const std::string& object, const std::string& pass)
@@ -193,6 +605,15 @@ std::vector<Interface::UnsatisfiedUniform> Interface::getUnsatisfiedUniforms(
   return obj->getUnsatisfiedUniforms(pass);
 }
 
+//------------------------------------------------------------------------------
+std::vector<Interface::UnsatisfiedUniform> Interface::getUnsatisfiedUniforms(
+    ObjectHandle object, PassHandle pass)
+{
+  if (pass.isValid() == false)
+    throw std::invalid_argument("Invalid pass handle.");
+  return mImpl->getObject(object)->getUnsatisfiedUniforms(static_cast<size_t>(pass.index));
+}
+
 //------------------------------------------------------------------------------
 void Interface::addObjectPassUniformConcrete(const std::string& object,
                                              const std::string& uniformName,
@@ -202,6 +623,15 @@ void Interface::addObjectPassUniformConcrete(const std::string& object,
   mImpl->addObjectPassUniformConcrete(object, uniformName, item, pass);
 }
 
+//------------------------------------------------------------------------------
+void Interface::addObjectPassUniformConcrete(ObjectHandle object,
+                                             const std::string& uniformName,
+                                             std::shared_ptr<AbstractUniformStateItem> item,
+                                             PassHandle pass)
+{
+  mImpl->addObjectPassUniformConcrete(object, uniformName, item, pass);
+}
+
 
 //------------------------------------------------------------------------------
 void Interface::addObjectGlobalUniformConcrete(const std::string& object,
@@ -211,6 +641,14 @@ void Interface::addObjectGlobalUniformConcrete(const std::string& object,
   mImpl->addObjectGlobalUniformConcrete(object, uniformName, item);
 }
 
+//------------------------------------------------------------------------------
+void Interface::addObjectGlobalUniformConcrete(ObjectHandle object,
+                                               const std::string& uniformName,
+                                               std::shared_ptr<AbstractUniformStateItem> item)
+{
+  mImpl->addObjectGlobalUniformConcrete(object, uniformName, item);
+}
+
 //------------------------------------------------------------------------------
 void Interface::addGlobalUniformConcrete(const std::string& uniformName,
                                          std::shared_ptr<AbstractUniformStateItem> item)
@@ -247,9 +685,10 @@ Interface::getObjectGlobalUniformConcrete(const std::string& object,
 
 //------------------------------------------------------------------------------
 void Interface::addShaderAttribute(const std::string& codeName, size_t numComponents,
-                                   bool normalize, size_t size, Interface::DATA_TYPES type)
+                                   bool normalize, size_t size, Interface::DATA_TYPES type,
+                                   size_t divisor)
 {
-  mImpl->addShaderAttribute(codeName, numComponents, normalize, size, type);
+  mImpl->addShaderAttribute(codeName, numComponents, normalize, size, type, divisor);
 }
 
 //------------------------------------------------------------------------------
@@ -271,10 +710,22 @@ void Interface::addPersistentShader(const std::string& programName,
 }
 
 
-//------------------------------------------------------------------------------
-size_t Interface::loadProprietarySR5AssetFile(std::istream& stream,
-                                              std::vector<uint8_t>& vbo,
-                                              std::vector<uint8_t>& ibo)
+namespace {
+
+// Asset files store 16 bit triangles, and 3 floats of position followed by 3
+// floats of normal per vertex, exactly as they are laid out in the vbo.
+const size_t SR5TriangleSize = 3 * sizeof(uint16_t);
+const size_t SR5VertexSize   = 6 * sizeof(float);
+
+// Each face is a count byte followed by one triangle (count 3) or two
+// triangles (count 4). Other counts have no indices.
+size_t getSR5FaceTriangles(uint8_t count)
+{
+  return (count == 3 ? 1 : (count == 4 ? 2 : 0));
+}
+
+// Reads the header and returns the number of meshes in the file.
+uint32_t readSR5Header(std::istream& stream)
 {
   // Read default SCIRun asset header.
   std::string header = "SCR5";
@@ -290,124 +741,295 @@ size_t Interface::loadProprietarySR5AssetFile(std::istream& stream,
     throw std::invalid_argument("Header does not match asset file.");
   }
 
-  // Read in the number of meshes (this is ignored for now and the first mesh is
-  // used).
   uint32_t numMeshes = 0;
   stream.read(reinterpret_cast<char*>(&numMeshes), sizeof(uint32_t));
   if (numMeshes == 0)
   {
     throw std::invalid_argument("Need at least one mesh in asset file.");
   }
+  return numMeshes;
+}
 
-  // Read in the first mesh (this is the only mesh we will read in)
-  uint32_t numVertices = 0;
-  stream.read(reinterpret_cast<char*>(&numVertices), sizeof(uint32_t));
+// Finds up to 'facesLeft' complete faces at the start of [begin, end) and
+// returns the end of the last one. Found faces are subtracted from
+// 'facesLeft', their triangles added to 'numTriangles'.
+const uint8_t* scanSR5Faces(const uint8_t* begin, const uint8_t* end,
+                            size_t& facesLeft, size_t& numTriangles)
+{
+  const uint8_t* face = begin;
+  while (facesLeft > 0 && face < end)
+  {
+    size_t faceTriangles = getSR5FaceTriangles(face[0]);
+    if (static_cast<size_t>(end - face) < 1 + faceTriangles * SR5TriangleSize)
+      break;
 
-  V3 position;
-  V3 normal;
+    face += 1 + faceTriangles * SR5TriangleSize;
+    numTriangles += faceTriangles;
+    --facesLeft;
+  }
+  return face;
+}
+
+// Copies the indices of the complete faces in [begin, end) to 'out'.
+void copySR5Faces(const uint8_t* begin, const uint8_t* end, uint8_t* out)
+{
+  for (const uint8_t* face = begin; face < end; )
+  {
+    size_t size = getSR5FaceTriangles(face[0]) * SR5TriangleSize;
+    std::memcpy(out, face + 1, size);
+    out  += size;
+    face += 1 + size;
+  }
+}
 
-  // Reserve appropriate space in the vbo.
-  size_t vboSize = sizeof(float) * 6 * numVertices;
-  vbo.resize(vboSize); // linear complexity.
-  float* vboPtr = reinterpret_cast<float*>(&vbo[0]); // Remember, standard guarantees that vectors are contiguous in memory.
+// Reads everything left in 'stream'.
+void readRemaining(std::istream& stream, std::vector<uint8_t>& data)
+{
+  // Read in one go if the stream can tell how much is left.
+  std::streampos start = stream.tellg();
+  if (start != std::streampos(-1))
+  {
+    stream.seekg(0, std::ios::end);
+    std::streampos stop = stream.tellg();
+    stream.seekg(start);
+    if (stop != std::streampos(-1) && stop >= start)
+    {
+      data.resize(static_cast<size_t>(stop - start));
+      if (data.empty() == false)
+      {
+        stream.read(reinterpret_cast<char*>(&data[0]), static_cast<std::streamsize>(data.size()));
+        data.resize(static_cast<size_t>(stream.gcount()));
+      }
+      return;
+    }
+  }
 
-  for (size_t i = 0; i < numVertices; i++)
+  const size_t chunkSize = 1024 * 1024;
+  size_t size = 0;
+  while (stream.good())
   {
-    // Read position data
-    stream.read(reinterpret_cast<char*>(&position.x), sizeof(float));
-    stream.read(reinterpret_cast<char*>(&position.y), sizeof(float));
-    stream.read(reinterpret_cast<char*>(&position.z), sizeof(float));
-    vboPtr[0] = position.x;
-    vboPtr[1] = position.y;
-    vboPtr[2] = position.z;
-    vboPtr += 3;
-
-    // Read normal data
-    stream.read(reinterpret_cast<char*>(&normal.x), sizeof(float));
-    stream.read(reinterpret_cast<char*>(&normal.y), sizeof(float));
-    stream.read(reinterpret_cast<char*>(&normal.z), sizeof(float));
-    vboPtr[0] = normal.x;
-    vboPtr[1] = normal.y;
-    vboPtr[2] = normal.z;
-    vboPtr += 3;
+    data.resize(size + chunkSize);
+    stream.read(reinterpret_cast<char*>(&data[size]), static_cast<std::streamsize>(chunkSize));
+    size += static_cast<size_t>(stream.gcount());
   }
+  data.resize(size);
+}
+
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
+size_t Interface::loadProprietarySR5AssetFile(std::istream& stream,
+                                              std::vector<uint8_t>& vbo,
+                                              std::vector<uint8_t>& ibo)
+{
+  // The number of meshes is ignored and the first mesh is used. See
+  // loadProprietarySR5AssetFileMeshes.
+  readSR5Header(stream);
+
+  // Read in the first mesh (this is the only mesh we will read in)
+  uint32_t numVertices = 0;
+  stream.read(reinterpret_cast<char*>(&numVertices), sizeof(uint32_t));
+
+  // Vertices are read in one go.
+  size_t vboSize = SR5VertexSize * numVertices;
+  vbo.resize(vboSize);
+  if (vboSize > 0)
+    stream.read(reinterpret_cast<char*>(&vbo[0]), static_cast<std::streamsize>(vboSize));
+  if (stream.fail())
+    throw std::invalid_argument("Unexpected end of asset file.");
 
   // Read in the IBO data.
-  uint32_t numTriangles = 0;  // Will be counted when loading.
   uint32_t numFaces = 0;
   stream.read(reinterpret_cast<char*>(&numFaces), sizeof(uint32_t));
 
-  // Worst case number of triangles: 2 * numFaces (all quads).
-  // The following has pretty harsh algorithmic time -- 3*N. Can easily be sped
-  // up by using the preprocessing program to determine how many triangles there
-  // are in the object. This would reduce the complexity to 2*N.
-  uint32_t numTrianglesWorstCase = numFaces * 2;
-  size_t iboWorstCaseSize = numTrianglesWorstCase * sizeof(uint16_t) * 3;
-  ibo.resize(iboWorstCaseSize); // linear in complexity
-  uint16_t* iboPtr = reinterpret_cast<uint16_t*>(&ibo[0]); // Remember, standard guarantees that vectors are contiguous in memory.
+  // Faces are read through a buffer, but never past the last face so the
+  // stream is left where the mesh ends. Most meshes are mostly triangles,
+  // the ibo grows if there are quads.
+  const size_t bufferSize = 256 * 1024;
+  std::vector<uint8_t> buffer(bufferSize);
+  size_t buffered = 0;
 
-  for (size_t i = 0; i < numFaces; i++)
+  ibo.clear();
+  ibo.reserve(static_cast<size_t>(numFaces) * SR5TriangleSize);
+
+  size_t numTriangles = 0;
+  size_t facesLeft = numFaces;
+  while (facesLeft > 0)
   {
-    uint8_t numIndices;
-    stream.read(reinterpret_cast<char*>(&numIndices), sizeof(uint8_t));
-    if (numIndices == 3)
+    // Every face left takes at least its count byte. If the count of the
+    // first one is buffered, its exact size is known.
+    size_t bytesLeft = facesLeft;
+    if (buffered > 0)
+      bytesLeft += getSR5FaceTriangles(buffer[0]) * SR5TriangleSize;
+    size_t toRead = std::min(bufferSize, bytesLeft) - buffered;
+    stream.read(reinterpret_cast<char*>(&buffer[buffered]), static_cast<std::streamsize>(toRead));
+    if (stream.fail())
+      throw std::invalid_argument("Unexpected end of asset file.");
+    buffered += toRead;
+
+    // Find the complete faces in the buffer, then copy their indices.
+    const uint8_t* begin = buffer.data();
+    size_t numBufferedTriangles = 0;
+    const uint8_t* facesEnd = scanSR5Faces(begin, begin + buffered, facesLeft,
+                                           numBufferedTriangles);
+
+    size_t iboSize = ibo.size();
+    ibo.resize(iboSize + numBufferedTriangles * SR5TriangleSize);
+    copySR5Faces(begin, facesEnd, ibo.data() + iboSize);
+    numTriangles += numBufferedTriangles;
+
+    // Keep the partial face for the next read.
+    buffered -= static_cast<size_t>(facesEnd - begin);
+    std::memmove(buffer.data(), facesEnd, buffered);
+  }
+
+  return numTriangles;
+}
+
+//------------------------------------------------------------------------------
+std::vector<Interface::AssetMesh> Interface::loadProprietarySR5AssetFileMeshes(
+    std::istream& stream, size_t numThreads)
+{
+  uint32_t numMeshes = readSR5Header(stream);
+
+  std::vector<uint8_t> data;
+  readRemaining(stream, data);
+
+  // Scan for where the vertices and faces of each mesh are. Vertices are
+  // skipped, faces only have their count bytes looked at.
+  struct MeshRange
+  {
+    const uint8_t*  vertices;
+    size_t          numVertices;
+    const uint8_t*  faces;
+    const uint8_t*  facesEnd;
+    size_t          numTriangles;
+  };
+
+  const uint8_t* pos = data.data();
+  const uint8_t* end = pos + data.size();
+  auto readCount = [&pos, end]() -> uint32_t
+  {
+    if (static_cast<size_t>(end - pos) < sizeof(uint32_t))
+      throw std::invalid_argument("Unexpected end of asset file.");
+    uint32_t count;
+    std::memcpy(&count, pos, sizeof(uint32_t));
+    pos += sizeof(uint32_t);
+    return count;
+  };
+
+  std::vector<MeshRange> ranges(numMeshes);
+  for (auto it = ranges.begin(); it != ranges.end(); ++it)
+  {
+    it->numVertices = readCount();
+    it->vertices    = pos;
+    if (static_cast<size_t>(end - pos) < it->numVertices * SR5VertexSize)
+      throw std::invalid_argument("Unexpected end of asset file.");
+    pos += it->numVertices * SR5VertexSize;
+
+    size_t facesLeft = readCount();
+    it->faces        = pos;
+    it->numTriangles = 0;
+    pos = scanSR5Faces(pos, end, facesLeft, it->numTriangles);
+    if (facesLeft > 0)
+      throw std::invalid_argument("Unexpected end of asset file.");
+    it->facesEnd = pos;
+  }
+
+  // Decode the meshes concurrently. Threads grab the next mesh until none
+  // are left, which balances meshes of very different sizes.
+  std::vector<AssetMesh> meshes(numMeshes);
+  std::atomic<size_t> nextMesh(0);
+  auto decode = [&ranges, &meshes, &nextMesh]()
+  {
+    for (size_t m = nextMesh++; m < ranges.size(); m = nextMesh++)
     {
-      uint16_t index0;
-      uint16_t index1;
-      uint16_t index2;
-      stream.read(reinterpret_cast<char*>(&index0), sizeof(uint16_t));
-      stream.read(reinterpret_cast<char*>(&index1), sizeof(uint16_t));
-      stream.read(reinterpret_cast<char*>(&index2), sizeof(uint16_t));
-      iboPtr[0] = index0;
-      iboPtr[1] = index1;
-      iboPtr[2] = index2;
-
-      iboPtr += 3;
-      ++numTriangles;
+      const MeshRange& range = ranges[m];
+      AssetMesh& mesh = meshes[m];
+      mesh.vbo.assign(range.vertices, range.vertices + range.numVertices * SR5VertexSize);
+      mesh.ibo.resize(range.numTriangles * SR5TriangleSize);
+      copySR5Faces(range.faces, range.facesEnd, mesh.ibo.data());
+      mesh.numTriangles = range.numTriangles;
     }
-    else if (numIndices == 4)
+  };
+
+  if (numThreads == 0)
+    numThreads = std::max(1u, std::thread::hardware_concurrency());
+  numThreads = std::min(numThreads, ranges.size());
+
+  // The calling thread decodes as well.
+  std::vector<std::future<void>> workers;
+  for (size_t i = 1; i < numThreads; ++i)
+    workers.push_back(std::async(std::launch::async, decode));
+  decode();
+  for (auto it = workers.begin(); it != workers.end(); ++it)
+    it->get();
+
+  return meshes;
+}
+
+//------------------------------------------------------------------------------
+std::vector<Interface::AssetBuffers> Interface::loadSR6AssetFile(
+    const std::string& filename, const std::string& name, BUFFER_USAGE usage)
+{
+  MappedFile file(filename);
+  std::vector<uint8_t> decoded;
+  std::vector<SR6Mesh> meshes = readSR6(file.getData(), file.getSize(), decoded);
+
+  ShaderAttributeMan& attributeMan = mHub->getShaderAttributeManager();
+  std::vector<AssetBuffers> buffers;
+  for (size_t m = 0; m < meshes.size(); ++m)
+  {
+    const SR6Mesh& mesh = meshes[m];
+
+    std::vector<std::string> attribNames;
+    for (auto it = mesh.attributes.begin(); it != mesh.attributes.end(); ++it)
     {
-      // Two triangles
+      if (it->type > TYPE_DOUBLE)
+        throw std::invalid_argument("Invalid SR6 attribute type.");
+      DATA_TYPES type = static_cast<DATA_TYPES>(it->type);
+
+      if (std::get<0>(attributeMan.findAttributeWithName(it->name)))
       {
-        uint16_t index0;
-        uint16_t index1;
-        uint16_t index2;
-        stream.read(reinterpret_cast<char*>(&index0), sizeof(uint16_t));
-        stream.read(reinterpret_cast<char*>(&index1), sizeof(uint16_t));
-        stream.read(reinterpret_cast<char*>(&index2), sizeof(uint16_t));
-
-        iboPtr[0] = index0;
-        iboPtr[1] = index1;
-        iboPtr[2] = index2;
-
-        iboPtr += 3;
+        AttribState known = attributeMan.getAttributeWithName(it->name);
+        if (   known.numComponents != it->numComponents || known.type != type
+            || known.size != it->size || known.normalize != it->normalize)
+          throw std::invalid_argument("SR6 attribute " + it->name
+                                      + " does not match the known attribute.");
       }
-
+      else
       {
-        uint16_t index0;
-        uint16_t index1;
-        uint16_t index2;
-        stream.read(reinterpret_cast<char*>(&index0), sizeof(uint16_t));
-        stream.read(reinterpret_cast<char*>(&index1), sizeof(uint16_t));
-        stream.read(reinterpret_cast<char*>(&index2), sizeof(uint16_t));
-
-        iboPtr[0] = index0;
-        iboPtr[1] = index1;
-        iboPtr[2] = index2;
-
-        iboPtr += 3;
+        addShaderAttribute(it->name, it->numComponents, it->normalize, it->size, type);
       }
-
-      numTriangles += 2;
+      attribNames.push_back(it->name);
     }
 
+    IBO_TYPE iboType = IBO_32BIT;
+    if (mesh.indexSize == sizeof(uint8_t))
+      iboType = IBO_8BIT;
+    else if (mesh.indexSize == sizeof(uint16_t))
+      iboType = IBO_16BIT;
+
+    std::string meshName = name + std::to_string(m);
+    AssetBuffers meshBuffers;
+    meshBuffers.vbo = addVBO(meshName, mesh.vbo, mesh.vboSize, attribNames, usage);
+    meshBuffers.ibo = addIBO(meshName, mesh.ibo, mesh.iboSize, iboType, usage);
+    buffers.push_back(meshBuffers);
   }
 
-  // Resize the IBO appropriately (this is the operation that can be eliminated
-  // if we know how many triangles there will be beforehand).
-  size_t realIBOSize = numTriangles * sizeof(uint16_t) * 3;
-  ibo.resize(realIBOSize); // linear in complexity
+  return buffers;
+}
+
+//------------------------------------------------------------------------------
+size_t Interface::loadProprietarySR5AssetFile(std::istream& stream,
+                                              std::vector<uint8_t>& vbo,
+                                              std::vector<uint8_t>& ibo,
+                                              MeshOptimization& optimization)
+{
+  size_t numTriangles = loadProprietarySR5AssetFile(stream, vbo, ibo);
 
+  // Positions followed by normals, see above.
+  optimization = optimizeMesh(vbo, sizeof(float) * 6, 0, ibo, IBO_16BIT);
   return numTriangles;
 }
 
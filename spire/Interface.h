@@ -45,6 +45,7 @@
 #include "Context.h"
 
 #include "src/Math.h"
+#include "src/Handle.h"
 #include "src/ShaderUniformStateManTemplates.h"
 
 /// \todo The following *really* wants to be a constexpr inside of StuInterface,
@@ -101,6 +102,16 @@ public:
     IBO_32BIT,
   };
 
+  /// Usage hints given to GL when VBOs and IBOs are created. Buffers modified
+  /// with updateVBO / updateIBO should be USAGE_DYNAMIC, or USAGE_STREAM if
+  /// most of their contents change every frame.
+  enum BUFFER_USAGE
+  {
+    USAGE_STATIC,
+    USAGE_DYNAMIC,
+    USAGE_STREAM,
+  };
+
   /// Generally not needed at this stage.
   /// \todo Add supported OpenGL version to spire. This will allow us to 
   ///       determine what shaders we should us.
@@ -170,6 +181,13 @@ public:
   // it is unlikely that they ever will be. In most scenarios, you should use
   // this concurrent interface instead of the threaded interface.
 
+  // Handles: Objects, VBOs, and IBOs can be addressed by name or by the
+  // handle returned when they were added. Handle based functions avoid
+  // hashing and copying names, which is preferable when updating many
+  // objects every frame. Handles to removed resources are detected and
+  // cause std::out_of_range to be thrown. Pass handles are obtained from
+  // addPass, addPassToObject, or getPassHandle and never become stale.
+
   /// Renders an object given a specific pass.
   /// \todo Should we allow extra uniforms to be passed in, or should we stick
   ///       with the callback function for finding uniforms? Possibly add
@@ -181,6 +199,167 @@ public:
   /// \todo Implement
   void renderObject(const std::string& objectName,
                     const std::string& pass = SPIRE_DEFAULT_PASS);
+  void renderObject(ObjectHandle object, PassHandle pass);
+
+  /// Renders 'pass' for every object that contains the pass. Subpasses
+  /// are rendered as well. The passes are sorted by shader program, VBO, and
+  /// IBO before rendering so that redundant GL state changes are skipped.
+  /// The order in which objects are rendered is not defined.
+  /// The sorted list of passes is compiled once and replayed every frame
+  /// until objects, passes, or buffers are added or removed. Rendering a
+  /// pass that has never been added does nothing.
+  void renderPass(const std::string& pass = SPIRE_DEFAULT_PASS);
+  void renderPass(PassHandle pass);
+
+  /// Compiles the render list replayed by renderPass ahead of time, so that
+  /// the first frame after a scene change does not pay for it.
+  void compileRenderList(PassHandle pass);
+
+  /// Retrieves handles by name. Throws std::out_of_range if there is no
+  /// object, VBO, or IBO with the given name.
+  ObjectHandle getObjectHandle(const std::string& object) const;
+  VBOHandle getVBOHandle(const std::string& vboName) const;
+  IBOHandle getIBOHandle(const std::string& iboName) const;
+
+  /// Retrieves the handle for 'pass'. Throws std::out_of_range if the pass
+  /// has not been added, either through addPass or addPassToObject.
+  PassHandle getPassHandle(const std::string& pass = SPIRE_DEFAULT_PASS) const;
+
+  /// Adds 'pass' if it does not exist yet and returns its handle. Passes
+  /// only need to be added explicitly to obtain a handle before any object
+  /// pass is added with addPassToObject.
+  PassHandle addPass(const std::string& pass);
+
+  /// Enables merging of small object passes into shared draw batches. Passes
+  /// sharing a shader program, pass, primitive type, IBO type, and attribute
+  /// layout have their geometry copied into a shared VBO / IBO and are drawn
+  /// with one glMultiDrawElementsBaseVertex call per run of passes with
+  /// identical local uniforms. Batches are updated as objects are added and
+  /// removed. Disabled by default.
+  /// Throws UnsupportedException if batching is requested but the OpenGL
+  /// core profile is not being used.
+  void setBatchingEnabled(bool enabled);
+
+  /// Number of draw batches built while batching is enabled.
+  size_t getNumDrawBatches() const;
+
+  /// Enables frustum culling in renderPass. Object passes whose bounds lie
+  /// entirely outside of the view frustum are not rendered. The frustum is
+  /// extracted from the 4x4 matrix uniform 'uniformName' (for example
+  /// "uProjIVObject") as seen by each pass, so the matrix must transform the
+  /// pass' vertices into clip space. Bounds are computed from the "aPos"
+  /// attribute when VBOs are added; passes without bounds, and passes that
+  /// do not use the uniform, are never culled. Pass an empty string to
+  /// disable culling (the default).
+  void setCullingUniform(const std::string& uniformName);
+
+  /// Number of object passes culled during the last call to renderPass.
+  size_t getNumCulledPasses() const;
+
+  /// Number of object passes drawn during the last call to renderPass.
+  /// Passes whose geometry is still queued for upload are not drawn.
+  size_t getNumRenderedPasses() const;
+
+  /// Number of times renderPass or compileRenderList had to rebuild a
+  /// render list because the scene changed.
+  size_t getNumRenderListBuilds() const;
+
+  /// Enables occlusion culling of heavy object passes in renderPass. The
+  /// bounding boxes of passes that survive frustum culling are drawn as
+  /// proxies inside occlusion queries after the visible passes are rendered,
+  /// and passes whose proxies were hidden are skipped in later frames.
+  /// Results lag by at least a frame, so an object that becomes visible may
+  /// pop in. Requires a culling uniform (see setCullingUniform), which
+  /// transforms the proxies, and a depth buffer. Throws UnsupportedException
+  /// under OpenGL ES 2.0, and under OpenGL 3.2 without
+  /// GL_ARB_occlusion_query2. Disabled by default.
+  void setOcclusionCullingEnabled(bool enabled);
+
+  /// Streams the contents of VBOs and IBOs added from now on to GL over
+  /// several frames instead of uploading them in addVBO / addIBO. At most
+  /// 'milliseconds' are spent uploading in each call to processUploads.
+  /// Passes whose buffers are not fully uploaded are skipped when rendering.
+  /// 0 disables the queue (the default). Buffers added through the raw
+  /// pointer overloads are copied while queued.
+  void setUploadBudget(double milliseconds);
+
+  /// Uploads queued VBO / IBO data for at most the upload budget. Call once
+  /// per frame, before rendering. Returns the number of bytes uploaded.
+  size_t processUploads();
+
+  /// Upload queue statistics: buffers and bytes waiting to be uploaded, and
+  /// bytes uploaded by the last call to processUploads.
+  /// @{
+  size_t getNumPendingUploads() const;
+  size_t getNumPendingUploadBytes() const;
+  size_t getNumBytesUploaded() const;
+  /// @}
+
+  /// Splits the CPU side of renderPass (culling, LOD selection, and sort key
+  /// generation) across 'numThreads' threads, including the calling thread.
+  /// Each thread records a command buffer for a slice of the pass' sorted
+  /// render list, and the buffers are executed in order on the calling
+  /// thread, which makes all GL calls. Worker threads are only used for
+  /// passes with many objects. 0 or 1 disables worker threads (the default).
+  void setNumRecordingThreads(size_t numThreads);
+
+  /// Starts generating a chain of simplified versions of the triangle list
+  /// 'iboName' on a worker thread, using quadric error edge collapses. The
+  /// levels reference the vertices of the original VBO. 'iboData' must hold
+  /// the contents given to addIBO and 'vboData' / 'attribNames' those given
+  /// to addVBO for the VBO the IBO indexes. Positions are read from the
+  /// "aPos" attribute. The buffers are only read, but must not be modified
+  /// until the chain is ready. Once ready, passes using the IBO select a level
+  /// every frame based on their projected size (see setLODPixelError). LOD
+  /// selection requires a culling uniform (see setCullingUniform).
+  void generateIBOLODs(const std::string& iboName,
+                       std::shared_ptr<std::vector<uint8_t>> iboData,
+                       std::shared_ptr<std::vector<uint8_t>> vboData,
+                       const std::vector<std::string>& attribNames);
+
+  /// Number of levels of detail of 'iboName', including the IBO itself. 1
+  /// until the chain started by generateIBOLODs is picked up by renderPass.
+  size_t getNumIBOLODs(const std::string& iboName) const;
+
+  /// Result of optimizeMesh.
+  struct MeshOptimization
+  {
+    IBO_TYPE  type;       ///< Index type the IBO data was rewritten with.
+    float     acmrBefore; ///< Vertex shader invocations per triangle before.
+    float     acmrAfter;  ///< Vertex shader invocations per triangle after.
+  };
+
+  /// Optimizes a triangle list and the VBO it indexes before they are given
+  /// to addVBO / addIBO. Reorders the triangles for post-transform vertex
+  /// cache hits and less overdraw, then reorders the vertices in the order
+  /// the triangles first use them. 'iboData' is rewritten with the smallest
+  /// index type that holds its indices, which is returned along with the
+  /// ACMR (average cache miss ratio) before and after, for a 16 entry cache.
+  /// Positions are read from the "aPos" attribute. Throws
+  /// std::invalid_argument if 'iboData' is not a triangle list or indexes
+  /// past the end of 'vboData'.
+  MeshOptimization optimizeMesh(std::vector<uint8_t>& vboData,
+                                const std::vector<std::string>& attribNames,
+                                std::vector<uint8_t>& iboData, IBO_TYPE type) const;
+
+  /// Same as above, for vertices 'stride' bytes apart whose positions are 3
+  /// floats 'positionOffset' bytes into each vertex.
+  static MeshOptimization optimizeMesh(std::vector<uint8_t>& vboData,
+                                       size_t stride, size_t positionOffset,
+                                       std::vector<uint8_t>& iboData, IBO_TYPE type);
+
+  /// Passes use the coarsest level of detail whose simplification error
+  /// projects to at most 'pixels' pixels on screen. Defaults to 1.
+  void setLODPixelError(float pixels);
+
+  /// Small feature culling: passes whose bounding sphere projects to fewer
+  /// than 'pixels' pixels across are culled. Requires a culling uniform (see
+  /// setCullingUniform). Pass 0 to disable (the default).
+  void setSmallFeatureCulling(float pixels);
+
+  /// Number of object passes skipped by occlusion culling during the last
+  /// call to renderPass.
+  size_t getNumOccludedPasses() const;
 
   /// Adds a VBO. This VBO can be re-used by any objects in the system.
   /// \param  name          Name of the VBO. See addIBOToObject for a full
@@ -193,9 +372,12 @@ public:
   ///                       attributes match up with what you have provided in
   ///                       in the VBO. This only checked when a call to
   ///                       addPassToObject is made.
-  void addVBO(const std::string& name,
-              const uint8_t* vboData, size_t vboSize,
-              const std::vector<std::string>& attribNames);
+  /// \param  usage         Usage hint, see updateVBO.
+  /// \return Handle to the VBO.
+  VBOHandle addVBO(const std::string& name,
+                   const uint8_t* vboData, size_t vboSize,
+                   const std::vector<std::string>& attribNames,
+                   BUFFER_USAGE usage = USAGE_STATIC);
 
   /// Adds an IBO.
   /// \param  name          Name of the IBO.
@@ -205,8 +387,10 @@ public:
   ///                       OpenGL buffer.
   /// \prama  iboSize       Size of iboData in bytes.
   /// \param  type          Specifies what kind of IBO iboData represents.
-  void addIBO(const std::string& name, const uint8_t* iboData, size_t iboSize,
-              IBO_TYPE type);
+  /// \param  usage         Usage hint, see updateIBO.
+  /// \return Handle to the IBO.
+  IBOHandle addIBO(const std::string& name, const uint8_t* iboData, size_t iboSize,
+                   IBO_TYPE type, BUFFER_USAGE usage = USAGE_STATIC);
 
   /// Obtain the current number of objects.
   /// \todo This function nedes to go to the implementation.
@@ -226,6 +410,22 @@ public:
   /// the thread.
   void makeCurrent();
 
+  /// Spire shadows the currently bound program, array / element buffers, and
+  /// enabled vertex attribute arrays to avoid issuing redundant GL calls.
+  /// Call this function if you modify any of these bindings outside of spire.
+  void invalidateGLState();
+
+  /// Number of program, buffer, and vertex attribute array GL calls that
+  /// spire has issued since the last call to resetGLStateCounters.
+  size_t getNumGLStateCallsIssued() const;
+
+  /// Number of program, buffer, and vertex attribute array GL calls that
+  /// spire skipped because the state was already bound.
+  size_t getNumGLStateCallsSkipped() const;
+
+  /// Resets the issued and skipped GL state call counters.
+  void resetGLStateCounters();
+
   // Terminates spire. This should be called before the OpenGL context is
   // destroyed.
   void terminate();
@@ -235,13 +435,15 @@ public:
   //---------
 
   /// Adds a renderable 'object' to the scene.
-  void addObject(const std::string& object);
+  /// \return Handle to the object.
+  ObjectHandle addObject(const std::string& object);
 
   /// Completely removes 'object' from the pipe. This includes removing all of
   /// the object's passes as well.
   /// Throws an std::out_of_range exception if the object is not found in the 
   /// system.
   void removeObject(const std::string& object);
+  void removeObject(ObjectHandle object);
 
   /// Removes all objects from the system.
   void removeAllObjects();
@@ -261,14 +463,29 @@ public:
   ///                       attributes match up with what you have provided in
   ///                       in the VBO. This only checked when a call to
   ///                       addPassToObject is made.
-  void addVBO(const std::string& name,
-              std::shared_ptr<std::vector<uint8_t>> vboData,
-              const std::vector<std::string>& attribNames);
+  /// \param  usage         Usage hint, see updateVBO.
+  VBOHandle addVBO(const std::string& name,
+                   std::shared_ptr<std::vector<uint8_t>> vboData,
+                   const std::vector<std::string>& attribNames,
+                   BUFFER_USAGE usage = USAGE_STATIC);
 
   // Removes the specified vbo. It is safe to issue this call even though some
   // of your passes may still be referencing the VBOs/IBOs. When the passes are
   // destroyed, their associated VBOs/IBOs will be destroyed.
   void removeVBO(const std::string& vboName);
+  void removeVBO(VBOHandle vbo);
+
+  /// Replaces 'size' bytes of the VBO, starting 'offset' bytes into it, with
+  /// 'data', which is copied. Passes using the VBO keep working without being
+  /// re-added. Updates are coalesced and uploaded right before a pass using
+  /// the VBO is drawn, updates covering the whole VBO orphan the old storage.
+  /// VBOs that are updated regularly should be added with USAGE_DYNAMIC or
+  /// USAGE_STREAM; updated VBOs are never batched. Culling bounds grow to
+  /// include updated positions but never shrink. Throws std::out_of_range if
+  /// the VBO does not exist or the range exceeds it.
+  void updateVBO(const std::string& vboName, size_t offset,
+                 const uint8_t* data, size_t size);
+  void updateVBO(VBOHandle vbo, size_t offset, const uint8_t* data, size_t size);
 
   /// Adds an IBO. Throws an std::out_of_range exception if the object is not
   /// found in the system.
@@ -283,14 +500,84 @@ public:
   ///                       spire. Unless there is a reference to it out side
   ///                       of spire, it will be destroyed.
   /// \param  type          Specifies what kind of IBO iboData represents.
-  void addIBO(const std::string& name,
-              std::shared_ptr<std::vector<uint8_t>> iboData,
-              IBO_TYPE type);
+  /// \param  usage         Usage hint, see updateIBO.
+  IBOHandle addIBO(const std::string& name,
+                   std::shared_ptr<std::vector<uint8_t>> iboData,
+                   IBO_TYPE type, BUFFER_USAGE usage = USAGE_STATIC);
 
   /// Removes specified ibo from the object. It is safe to issue this call even
   /// though some of your passes may still be referencing the VBOs/IBOs. When
   /// the passes are destroyed, their associated VBOs/IBOs will be destroyed.
   void removeIBO(const std::string& iboName);
+  void removeIBO(IBOHandle ibo);
+
+  /// Same as updateVBO, for IBOs. The number of indices does not change.
+  /// Updating an IBO discards its LOD chain (see generateIBOLODs).
+  void updateIBO(const std::string& iboName, size_t offset,
+                 const uint8_t* data, size_t size);
+  void updateIBO(IBOHandle ibo, size_t offset, const uint8_t* data, size_t size);
+
+  //-------------------
+  // Streamed geometry
+  //-------------------
+
+  // Geometry that only lives for one frame (widgets, selection boxes, ...)
+  // is written directly into a ring buffer instead of being added and
+  // removed as VBOs / IBOs every frame. Streamed VBOs / IBOs are added once
+  // and used in passes like any other VBO / IBO, but their contents are
+  // written anew every frame with writeStreamVBO / writeStreamIBO. Passes
+  // are only rendered in frames in which their streamed buffers were
+  // written. Streamed geometry has no bounds and is never culled.
+
+  /// Sets the size of the ring buffer holding streamed geometry in bytes.
+  /// It must hold all streamed geometry of a frame. 0 releases the buffer
+  /// (the default).
+  void setStreamBufferSize(size_t bytes);
+
+  /// Adds a streamed VBO / IBO. See addVBO / addIBO.
+  /// @{
+  VBOHandle addStreamVBO(const std::string& name,
+                         const std::vector<std::string>& attribNames);
+  IBOHandle addStreamIBO(const std::string& name, IBO_TYPE type);
+  /// @}
+
+  /// Returns a pointer to 'size' bytes of the ring buffer that the VBO's
+  /// vertices (IBO's indices) for the current frame must be written to.
+  /// Unless the ring buffer is persistently mapped (4.x core profile with
+  /// OpenGL 4.4 or GL_ARB_buffer_storage), the pointer is only valid until
+  /// the next call to any of these functions or to renderPass. Throws
+  /// std::out_of_range if the frame's streamed geometry exceeds the ring
+  /// buffer, std::invalid_argument if the VBO (IBO) is not streamed.
+  /// @{
+  uint8_t* writeStreamVBO(const std::string& vboName, size_t size);
+  uint8_t* writeStreamVBO(VBOHandle vbo, size_t size);
+  uint8_t* writeStreamIBO(const std::string& iboName, size_t size);
+  uint8_t* writeStreamIBO(IBOHandle ibo, size_t size);
+  /// @}
+
+  /// Ends the frame for streamed geometry. Call once per frame after the
+  /// last pass using streamed geometry was rendered. Ring buffer space is
+  /// reused once GL is done drawing from it.
+  void endStreamFrame();
+
+  /// Number of times writing streamed geometry had to wait for GL to finish
+  /// drawing from ring buffer space. Increase the ring buffer size if this
+  /// keeps growing.
+  size_t getNumStreamStalls() const;
+
+  /// Enables sub-allocating small static VBOs and IBOs (up to 256KB) out of
+  /// a few shared GL buffers, instead of creating a buffer for each. Only
+  /// affects VBOs and IBOs added afterwards. Disabled by default.
+  void setBufferArenaEnabled(bool enabled);
+
+  /// Moves the sub-allocated VBOs and IBOs into as few shared buffers as
+  /// possible and deletes the rest. Worthwhile after removing many of them.
+  /// Does nothing without a 3.x+ core profile, or while uploads are pending.
+  /// Returns the number of bytes released.
+  size_t compactBufferArenas();
+
+  /// Number of shared GL buffers backing sub-allocated VBOs and IBOs.
+  size_t getNumArenaBuffers() const;
 
   /// Loads an asset file and populates the given vectors with vbo and ibo
   /// data. In the future, we should expand this to include other asset types.
@@ -303,6 +590,52 @@ public:
                                             std::vector<uint8_t>& vbo,
                                             std::vector<uint8_t>& ibo);
 
+  /// Same as above, but also optimizes the mesh (see optimizeMesh). The IBO
+  /// may be narrowed, its index type is returned in 'optimization'.
+  static size_t loadProprietarySR5AssetFile(std::istream& stream,
+                                            std::vector<uint8_t>& vbo,
+                                            std::vector<uint8_t>& ibo,
+                                            MeshOptimization& optimization);
+
+  /// Geometry of one mesh in an asset file.
+  struct AssetMesh
+  {
+    std::vector<uint8_t>  vbo;
+    std::vector<uint8_t>  ibo;
+    size_t                numTriangles;
+  };
+
+  /// Loads every mesh of an asset file, in file order. VBOs and IBOs have the
+  /// same layout as those of loadProprietarySR5AssetFile. The rest of the
+  /// stream is read in one go and scanned for where each mesh starts, then
+  /// the meshes are decoded concurrently on up to 'numThreads' threads,
+  /// including the calling thread. 0 uses one thread per core. Throws
+  /// std::invalid_argument if the header does not match or the file is
+  /// truncated.
+  static std::vector<AssetMesh> loadProprietarySR5AssetFileMeshes(
+      std::istream& stream, size_t numThreads = 0);
+
+  /// VBO and IBO added for one mesh of an asset file.
+  struct AssetBuffers
+  {
+    VBOHandle vbo;
+    IBOHandle ibo;
+  };
+
+  /// Loads an SR6 asset file (see src/SR6Format.h), whose vertex and index
+  /// data is stored ready to be uploaded. The file is memory mapped and the
+  /// data is handed to addVBO / addIBO without being copied. Compressed
+  /// meshes are decoded into a temporary buffer first. Adds a VBO and
+  /// an IBO named 'name' followed by the mesh's index ("name0", "name1",
+  /// ...) for every mesh, in file order. Vertex attributes stored in the
+  /// file that are not known yet are added (see addShaderAttribute). Throws
+  /// NotFound if the file cannot be opened, std::invalid_argument if it is
+  /// malformed or one of its attributes is already known with a different
+  /// layout.
+  std::vector<AssetBuffers> loadSR6AssetFile(const std::string& filename,
+                                             const std::string& name,
+                                             BUFFER_USAGE usage = USAGE_STATIC);
+
   /// Adds a geometry pass to an object given by the identifier 'object'.
   /// Throws an std::out_of_range exception if the object is not found in the 
   /// system. If there already exists a geometry pass, it throws a 'Duplicate' 
@@ -314,14 +647,24 @@ public:
   /// \param  iboName       IBO to use.
   /// \param  type          Primitive type.
   /// \param  pass          Pass name.
-  /// \return Pass ID. Use this ID to assign uniforms to the pass.
-  void addPassToObject(const std::string& object,
-                       const std::string& program,
-                       const std::string& vboName,
-                       const std::string& iboName,
-                       PRIMITIVE_TYPES type,
-                       const std::string& pass = SPIRE_DEFAULT_PASS,
-                       const std::string& parentPass = "");
+  /// \return Pass handle. Use this handle to assign uniforms to the pass.
+  PassHandle addPassToObject(const std::string& object,
+                             const std::string& program,
+                             const std::string& vboName,
+                             const std::string& iboName,
+                             PRIMITIVE_TYPES type,
+                             const std::string& pass = SPIRE_DEFAULT_PASS,
+                             const std::string& parentPass = "");
+
+  /// Handle version of the above. A default constructed 'parentPass'
+  /// indicates that the pass has no parent.
+  PassHandle addPassToObject(ObjectHandle object,
+                             const std::string& program,
+                             VBOHandle vbo,
+                             IBOHandle ibo,
+                             PRIMITIVE_TYPES type,
+                             PassHandle pass,
+                             PassHandle parentPass = PassHandle());
 
   /// Removes a pass from the object.
   /// Throws an std::out_of_range exception if the object or pass is not found 
@@ -330,6 +673,24 @@ public:
   /// \param  pass          Pass name.
   void removePassFromObject(const std::string& object,
                             const std::string& pass);
+  void removePassFromObject(ObjectHandle object, PassHandle pass);
+
+  /// Instances the given object pass. The pass is rendered once for every
+  /// instance in the VBO 'instanceVBOName'. The instance VBO may only contain
+  /// attributes that were registered with a divisor > 0
+  /// (see addShaderAttribute). When hardware instancing is not available
+  /// (OpenGL ES 2.0), each instance is drawn with a separate draw call.
+  /// Calling this function again replaces the instance VBO.
+  /// Throws std::out_of_range if the object or VBO are not found and
+  /// std::invalid_argument if the VBO contains per-vertex attributes.
+  /// \param  object          Unique object name.
+  /// \param  instanceVBOName VBO containing per-instance attributes.
+  /// \param  pass            Pass name.
+  void setObjectPassInstanceVBO(const std::string& object,
+                                const std::string& instanceVBOName,
+                                const std::string& pass = SPIRE_DEFAULT_PASS);
+  void setObjectPassInstanceVBO(ObjectHandle object, VBOHandle instanceVBO,
+                                PassHandle pass);
 
 
   //----------
@@ -341,6 +702,8 @@ public:
   /// per-frame basis.
   std::vector<UnsatisfiedUniform> getUnsatisfiedUniforms(
       const std::string& object, const std::string& pass = SPIRE_DEFAULT_PASS);
+  std::vector<UnsatisfiedUniform> getUnsatisfiedUniforms(ObjectHandle object,
+                                                         PassHandle pass);
 
   /// Associates a uniform value to the specified object's pass. If the uniform
   /// already exists, then its value will be updated if it passes a type check.
@@ -359,11 +722,26 @@ public:
                                      new UniformStateItem<T>(uniformData)), pass);
   }
 
-  /// Concrete implementation of the above templated function.
+  template <typename T>
+  void addObjectPassUniform(ObjectHandle object,
+                            const std::string& uniformName,
+                            T uniformData,
+                            PassHandle pass)
+  {
+    addObjectPassUniformConcrete(object, uniformName, 
+                                 std::shared_ptr<AbstractUniformStateItem>(
+                                     new UniformStateItem<T>(uniformData)), pass);
+  }
+
+  /// Concrete implementation of the above templated functions.
   void addObjectPassUniformConcrete(const std::string& object,
                                     const std::string& uniformName,
                                     std::shared_ptr<AbstractUniformStateItem> item,
                                     const std::string& pass = SPIRE_DEFAULT_PASS);
+  void addObjectPassUniformConcrete(ObjectHandle object,
+                                    const std::string& uniformName,
+                                    std::shared_ptr<AbstractUniformStateItem> item,
+                                    PassHandle pass);
 
   /// Adds a uniform that will be consumed regardless of the pass. Pass uniforms
   /// take precedence over pass global uniforms.
@@ -377,10 +755,23 @@ public:
                                        new UniformStateItem<T>(uniformData)));
   }
 
-  /// Concrete implementation of the above templated function.
+  template <typename T>
+  void addObjectGlobalUniform(ObjectHandle object,
+                              const std::string& uniformName,
+                              T uniformData)
+  {
+    addObjectGlobalUniformConcrete(object, uniformName,
+                                   std::shared_ptr<AbstractUniformStateItem>(
+                                       new UniformStateItem<T>(uniformData)));
+  }
+
+  /// Concrete implementation of the above templated functions.
   void addObjectGlobalUniformConcrete(const std::string& object,
                                       const std::string& uniformName,
                                       std::shared_ptr<AbstractUniformStateItem> item);
+  void addObjectGlobalUniformConcrete(ObjectHandle object,
+                                      const std::string& uniformName,
+                                      std::shared_ptr<AbstractUniformStateItem> item);
 
   /// Will add *or* update the global uniform if it already exsits.
   /// A shader of a given name is only allowed to be one type. If you attempt
@@ -445,8 +836,11 @@ public:
   //-------------------
 
   // Attributes just as they are in the OpenGL rendering pipeline.
+  // Attributes with a 'divisor' greater than 0 are per-instance attributes,
+  // advancing once every 'divisor' instances. See setObjectPassInstanceVBO.
   void addShaderAttribute(const std::string& codeName, size_t numComponents,
-                          bool normalize, size_t size, Interface::DATA_TYPES t);
+                          bool normalize, size_t size, Interface::DATA_TYPES t,
+                          size_t divisor = 0);
 
   //-----------------
   // Shader Programs
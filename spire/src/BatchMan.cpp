@@ -0,0 +1,485 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2013 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+/// \author agent
+/// \date   October 2026
+
+#include <algorithm>
+
+#include "Common.h"
+#include "Exceptions.h"
+#include "BatchMan.h"
+#include "Hub.h"
+#include "GLStateMan.h"
+#include "SpireObject.h"
+
+namespace CPM_SPIRE_NS {
+
+#ifdef SPIRE_USE_BATCHING
+
+//------------------------------------------------------------------------------
+// DrawBatch
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+DrawBatch::DrawBatch(Hub& hub, const ObjectPass& firstPass) :
+    mHub(hub),
+    mShader(firstPass.getShader()),
+    mAttribBinding(firstPass.getAttribBinding()),
+    mPrimitiveType(firstPass.getPrimitiveType()),
+    mIndexType(firstPass.getIBO()->getType()),
+    mStride(static_cast<size_t>(firstPass.getAttribBinding()->getStride())),
+    mNumPasses(0),
+    mLastFrame(0),
+    mVAO(0),
+    mVBO(0),
+    mIBO(0),
+    mVBOCapacity(0),
+    mIBOCapacity(0),
+    mVBOUsed(0),
+    mIBOUsed(0),
+    mVBOWasted(0),
+    mIBOWasted(0),
+    mVAODirty(true)
+{
+}
+
+//------------------------------------------------------------------------------
+DrawBatch::~DrawBatch()
+{
+  for (auto it = mMembers.begin(); it != mMembers.end(); ++it)
+  {
+    if (it->pass != nullptr)
+      it->pass->setBatch(nullptr, 0);
+  }
+
+  GLStateMan& state = mHub.getGLStateManager();
+  if (mVAO != 0)
+  {
+    state.onVertexArrayDeleted(mVAO);
+    GL(glDeleteVertexArrays(1, &mVAO));
+  }
+  if (mVBO != 0)
+  {
+    state.onBufferDeleted(mVBO);
+    GL(glDeleteBuffers(1, &mVBO));
+  }
+  if (mIBO != 0)
+  {
+    state.onBufferDeleted(mIBO);
+    GL(glDeleteBuffers(1, &mIBO));
+  }
+}
+
+//------------------------------------------------------------------------------
+void DrawBatch::addPass(ObjectPass* pass)
+{
+  Member member(pass);
+  member.vertexOffset = mVBOUsed;
+  member.vertexSize   = pass->getVBO()->getSize();
+  member.indexOffset  = mIBOUsed;
+  member.indexSize    = pass->getIBO()->getSize();
+  member.numElements  = static_cast<GLsizei>(pass->getIBO()->getNumElements());
+
+  reserve(mVBOUsed + member.vertexSize, mIBOUsed + member.indexSize);
+
+  // The copy targets are not part of the shadowed GL state (GLStateMan). They
+  // are only ever used here.
+  // The pass' buffers may be sub-allocated (see BufferArena).
+  GL(glBindBuffer(GL_COPY_READ_BUFFER, pass->getVBO()->getGLIndex()));
+  GL(glBindBuffer(GL_COPY_WRITE_BUFFER, mVBO));
+  GL(glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER,
+                         static_cast<GLintptr>(pass->getVBO()->getOffset()),
+                         static_cast<GLintptr>(member.vertexOffset),
+                         static_cast<GLsizeiptr>(member.vertexSize)));
+
+  GL(glBindBuffer(GL_COPY_READ_BUFFER, pass->getIBO()->getGLIndex()));
+  GL(glBindBuffer(GL_COPY_WRITE_BUFFER, mIBO));
+  GL(glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER,
+                         static_cast<GLintptr>(pass->getIBO()->getOffset()),
+                         static_cast<GLintptr>(member.indexOffset),
+                         static_cast<GLsizeiptr>(member.indexSize)));
+
+  mVBOUsed += member.vertexSize;
+  mIBOUsed += member.indexSize;
+
+  pass->setBatch(this, mMembers.size());
+  mMembers.push_back(member);
+  ++mNumPasses;
+}
+
+//------------------------------------------------------------------------------
+void DrawBatch::removePass(ObjectPass* pass)
+{
+  Member& member = mMembers.at(pass->getBatchSlot());
+  if (member.pass != pass)
+    throw std::invalid_argument("Pass does not belong to this batch.");
+
+  mVBOWasted += member.vertexSize;
+  mIBOWasted += member.indexSize;
+  member.pass = nullptr;
+  pass->setBatch(nullptr, 0);
+  --mNumPasses;
+}
+
+//------------------------------------------------------------------------------
+void DrawBatch::markVisible(const ObjectPass* pass, uint64_t frame)
+{
+  mMembers[pass->getBatchSlot()].frame = frame;
+  mLastFrame = frame;
+}
+
+//------------------------------------------------------------------------------
+void DrawBatch::reserve(size_t vertexBytes, size_t indexBytes)
+{
+  if (vertexBytes > mVBOCapacity)
+  {
+    size_t capacity = std::max(vertexBytes, mVBOCapacity * 2);
+    reallocate(mVBO, capacity, mVBOUsed);
+    mVBOCapacity = capacity;
+  }
+
+  if (indexBytes > mIBOCapacity)
+  {
+    size_t capacity = std::max(indexBytes, mIBOCapacity * 2);
+    reallocate(mIBO, capacity, mIBOUsed);
+    mIBOCapacity = capacity;
+  }
+}
+
+//------------------------------------------------------------------------------
+void DrawBatch::reallocate(GLuint& buffer, size_t capacity, size_t used)
+{
+  GLStateMan& state = mHub.getGLStateManager();
+
+  // Both the VBO and the IBO are allocated through GL_ARRAY_BUFFER so that
+  // the element array binding of the currently bound VAO is not clobbered.
+  GLuint newBuffer;
+  GL(glGenBuffers(1, &newBuffer));
+  state.bindArrayBuffer(newBuffer);
+  GL(glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(capacity),
+                  nullptr, GL_STATIC_DRAW));
+
+  if (buffer != 0)
+  {
+    if (used > 0)
+    {
+      GL(glBindBuffer(GL_COPY_READ_BUFFER, buffer));
+      GL(glBindBuffer(GL_COPY_WRITE_BUFFER, newBuffer));
+      GL(glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0,
+                             static_cast<GLsizeiptr>(used)));
+    }
+    state.onBufferDeleted(buffer);
+    GL(glDeleteBuffers(1, &buffer));
+  }
+
+  buffer = newBuffer;
+  mVAODirty = true;
+}
+
+//------------------------------------------------------------------------------
+void DrawBatch::compact()
+{
+  if (mVBOWasted == 0 || mVBOWasted < mVBOUsed / 2)
+    return;
+
+  GLStateMan& state = mHub.getGLStateManager();
+
+  // Copy the live members into freshly allocated buffers.
+  GLuint oldVBO = mVBO;
+  GLuint oldIBO = mIBO;
+  mVBO          = 0;
+  mIBO          = 0;
+  mVBOCapacity  = 0;
+  mIBOCapacity  = 0;
+  reserve(mVBOUsed - mVBOWasted, mIBOUsed - mIBOWasted);
+
+  std::vector<Member> members;
+  members.reserve(mNumPasses);
+  size_t vertexOffset = 0;
+  size_t indexOffset  = 0;
+  for (auto it = mMembers.begin(); it != mMembers.end(); ++it)
+  {
+    if (it->pass == nullptr)
+      continue;
+
+    GL(glBindBuffer(GL_COPY_READ_BUFFER, oldVBO));
+    GL(glBindBuffer(GL_COPY_WRITE_BUFFER, mVBO));
+    GL(glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER,
+                           static_cast<GLintptr>(it->vertexOffset),
+                           static_cast<GLintptr>(vertexOffset),
+                           static_cast<GLsizeiptr>(it->vertexSize)));
+
+    GL(glBindBuffer(GL_COPY_READ_BUFFER, oldIBO));
+    GL(glBindBuffer(GL_COPY_WRITE_BUFFER, mIBO));
+    GL(glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER,
+                           static_cast<GLintptr>(it->indexOffset),
+                           static_cast<GLintptr>(indexOffset),
+                           static_cast<GLsizeiptr>(it->indexSize)));
+
+    Member member = *it;
+    member.vertexOffset = vertexOffset;
+    member.indexOffset  = indexOffset;
+    vertexOffset += member.vertexSize;
+    indexOffset  += member.indexSize;
+
+    member.pass->setBatch(this, members.size());
+    members.push_back(member);
+  }
+
+  state.onBufferDeleted(oldVBO);
+  GL(glDeleteBuffers(1, &oldVBO));
+  state.onBufferDeleted(oldIBO);
+  GL(glDeleteBuffers(1, &oldIBO));
+
+  mMembers.swap(members);
+  mVBOUsed    = vertexOffset;
+  mIBOUsed    = indexOffset;
+  mVBOWasted  = 0;
+  mIBOWasted  = 0;
+}
+
+//------------------------------------------------------------------------------
+void DrawBatch::buildVertexArray()
+{
+  GLStateMan& state = mHub.getGLStateManager();
+
+  if (mVAO != 0)
+  {
+    state.onVertexArrayDeleted(mVAO);
+    GL(glDeleteVertexArrays(1, &mVAO));
+    mVAO = 0;
+  }
+
+  GL(glGenVertexArrays(1, &mVAO));
+  state.bindVertexArray(mVAO);
+  state.bindArrayBuffer(mVBO);
+  mAttribBinding->bind(state);
+  state.bindElementArrayBuffer(mIBO);
+
+  mVAODirty = false;
+}
+
+//------------------------------------------------------------------------------
+void DrawBatch::render(uint64_t frame)
+{
+  if (mNumPasses == 0)
+    return;
+
+  GLStateMan& state = mHub.getGLStateManager();
+  if (mVAODirty)
+    buildVertexArray();
+
+  state.useProgram(mShader->getProgramID());
+  state.bindVertexArray(mVAO);
+
+  // Accumulate runs of visible members that share local uniforms. Each run
+  // is drawn with a single call.
+  ObjectPass* runPass = nullptr;
+  for (auto it = mMembers.begin(); it != mMembers.end(); ++it)
+  {
+    if (it->pass == nullptr || it->frame != frame)
+      continue;
+
+    if (runPass != nullptr && it->pass->hasSameLocalUniforms(*runPass) == false)
+      drawRun(runPass);
+
+    if (mDrawCounts.empty())
+      runPass = it->pass;
+
+    mDrawCounts.push_back(it->numElements);
+    mDrawOffsets.push_back(reinterpret_cast<const GLvoid*>(it->indexOffset));
+    mDrawBaseVertices.push_back(static_cast<GLint>(it->vertexOffset / mStride));
+  }
+
+  if (runPass != nullptr)
+    drawRun(runPass);
+}
+
+//------------------------------------------------------------------------------
+void DrawBatch::drawRun(ObjectPass* pass)
+{
+  pass->applyUniforms();
+
+  if (mDrawCounts.size() == 1)
+  {
+    GL(glDrawElementsBaseVertex(mPrimitiveType, mDrawCounts[0], mIndexType,
+                                const_cast<GLvoid*>(mDrawOffsets[0]),
+                                mDrawBaseVertices[0]));
+  }
+  else
+  {
+    GL(glMultiDrawElementsBaseVertex(mPrimitiveType, &mDrawCounts[0], mIndexType,
+                                     &mDrawOffsets[0],
+                                     static_cast<GLsizei>(mDrawCounts.size()),
+                                     &mDrawBaseVertices[0]));
+  }
+
+  mDrawCounts.clear();
+  mDrawOffsets.clear();
+  mDrawBaseVertices.clear();
+}
+
+//------------------------------------------------------------------------------
+bool BatchMan::BatchKey::operator<(const BatchKey& other) const
+{
+  if (program != other.program)             return program < other.program;
+  if (passIndex != other.passIndex)         return passIndex < other.passIndex;
+  if (primitiveType != other.primitiveType) return primitiveType < other.primitiveType;
+  if (indexType != other.indexType)         return indexType < other.indexType;
+  return attributes < other.attributes;
+}
+
+#endif
+
+//------------------------------------------------------------------------------
+// BatchMan
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+BatchMan::BatchMan(Hub& hub) :
+    mHub(hub),
+    mEnabled(false),
+    mFrame(0)
+{
+}
+
+//------------------------------------------------------------------------------
+BatchMan::~BatchMan()
+{
+}
+
+//------------------------------------------------------------------------------
+void BatchMan::setEnabled(bool enabled)
+{
+#ifdef SPIRE_USE_BATCHING
+  if (enabled == false)
+  {
+    mActiveBatches.clear();
+    mBatches.clear();
+  }
+  mEnabled = enabled;
+#else
+  if (enabled)
+    throw UnsupportedException("Batching requires an OpenGL core profile.");
+#endif
+}
+
+//------------------------------------------------------------------------------
+void BatchMan::beginFrame()
+{
+  ++mFrame;
+
+#ifdef SPIRE_USE_BATCHING
+  mActiveBatches.clear();
+
+  for (auto it = mBatches.begin(); it != mBatches.end();)
+  {
+    if (it->second->getNumPasses() == 0)
+    {
+      it = mBatches.erase(it);
+    }
+    else
+    {
+      it->second->compact();
+      ++it;
+    }
+  }
+#endif
+}
+
+//------------------------------------------------------------------------------
+bool BatchMan::addPass(ObjectPass* pass)
+{
+#ifdef SPIRE_USE_BATCHING
+  if (mEnabled == false)
+    return false;
+
+  DrawBatch* batch = pass->getBatch();
+  if (pass->isBatchable() == false)
+  {
+    // The pass was updated or gained LODs since it was batched. The batch's
+    // copy of its geometry is stale.
+    if (batch != nullptr)
+      batch->removePass(pass);
+    return false;
+  }
+
+  if (batch == nullptr)
+  {
+    // Members are addressed with a base vertex, so the VBO must hold a
+    // whole number of vertices.
+    size_t vboSize = pass->getVBO()->getSize();
+    if (vboSize > MaxBatchedVBOSize || vboSize % static_cast<size_t>(pass->getAttribBinding()->getStride()) != 0)
+      return false;
+
+    BatchKey key;
+    key.program       = pass->getProgramID();
+    key.passIndex     = pass->getPassIndex();
+    key.primitiveType = pass->getPrimitiveType();
+    key.indexType     = pass->getIBO()->getType();
+    key.attributes    = pass->getVBO()->getAttributeCollection().getAttributeIndices();
+
+    std::unique_ptr<DrawBatch>& entry = mBatches[key];
+    if (entry == nullptr)
+      entry.reset(new DrawBatch(mHub, *pass));
+
+    batch = entry.get();
+    batch->addPass(pass);
+  }
+
+  if (batch->getLastFrame() != mFrame)
+    mActiveBatches.push_back(batch);
+  batch->markVisible(pass, mFrame);
+  return true;
+#else
+  (void)pass;
+  return false;
+#endif
+}
+
+//------------------------------------------------------------------------------
+void BatchMan::render()
+{
+#ifdef SPIRE_USE_BATCHING
+  for (auto it = mActiveBatches.begin(); it != mActiveBatches.end(); ++it)
+    (*it)->render(mFrame);
+#endif
+}
+
+//------------------------------------------------------------------------------
+size_t BatchMan::getNumBatches() const
+{
+#ifdef SPIRE_USE_BATCHING
+  return mBatches.size();
+#else
+  return 0;
+#endif
+}
+
+} // namespace CPM_SPIRE_NS
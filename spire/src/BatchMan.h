@@ -0,0 +1,213 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2013 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+/// \author agent
+/// \date   October 2026
+
+#ifndef SPIRE_HIGH_BATCHMAN_H
+#define SPIRE_HIGH_BATCHMAN_H
+
+#include <map>
+#include <memory>
+#include <vector>
+#include <cstdint>
+
+#include "Common.h"
+
+namespace CPM_SPIRE_NS {
+
+class Hub;
+class ObjectPass;
+class ShaderProgramAsset;
+class AttribBindingPlan;
+
+#ifdef SPIRE_USE_BATCHING
+/// Set of object passes sharing a program, pass, primitive type, index type,
+/// and attribute layout. The geometry of every member is copied into one
+/// shared VBO / IBO so that all members can be drawn with a single
+/// glMultiDrawElementsBaseVertex call.
+///
+/// Members are appended to the end of the shared buffers as they are added.
+/// Removing a member leaves a hole in the buffers which is reclaimed by
+/// compact.
+class DrawBatch
+{
+public:
+  DrawBatch(Hub& hub, const ObjectPass& firstPass);
+  virtual ~DrawBatch();
+
+  /// Copies the pass' geometry into the shared buffers and associates the
+  /// pass with this batch (see ObjectPass::setBatch).
+  void addPass(ObjectPass* pass);
+
+  /// Removes the pass from the batch. The pass' geometry is left in the
+  /// shared buffers until the next call to compact.
+  void removePass(ObjectPass* pass);
+
+  /// Marks the pass as visible for 'frame'. Only visible passes are drawn.
+  void markVisible(const ObjectPass* pass, uint64_t frame);
+
+  /// Draws every pass marked visible for 'frame'. Consecutive passes with
+  /// identical local uniforms are drawn with a single multi-draw call.
+  void render(uint64_t frame);
+
+  /// Reclaims the space left by removed passes if it accounts for more than
+  /// half of the shared buffers.
+  void compact();
+
+  /// Last frame in which a pass of this batch was marked visible.
+  uint64_t getLastFrame() const   {return mLastFrame;}
+
+  /// Number of passes in the batch.
+  size_t getNumPasses() const     {return mNumPasses;}
+
+private:
+
+  struct Member
+  {
+    Member(ObjectPass* objectPass) :
+        pass(objectPass),
+        vertexOffset(0),
+        vertexSize(0),
+        indexOffset(0),
+        indexSize(0),
+        numElements(0),
+        frame(0)
+    {}
+
+    ObjectPass* pass;         ///< nullptr if the pass was removed.
+    size_t      vertexOffset; ///< Byte offset into mVBO.
+    size_t      vertexSize;   ///< Size of the pass' VBO in bytes.
+    size_t      indexOffset;  ///< Byte offset into mIBO.
+    size_t      indexSize;    ///< Size of the pass' IBO in bytes.
+    GLsizei     numElements;  ///< Number of indices.
+    uint64_t    frame;        ///< Last frame the pass was marked visible.
+  };
+
+  /// Grows the shared buffers such that they can hold at least the given
+  /// number of bytes. Existing contents are preserved.
+  void reserve(size_t vertexBytes, size_t indexBytes);
+
+  /// Reallocates 'buffer' with 'capacity' bytes, copying the first 'used'
+  /// bytes of the old buffer to the new one.
+  void reallocate(GLuint& buffer, size_t capacity, size_t used);
+
+  /// (Re)builds mVAO from the shared buffers.
+  void buildVertexArray();
+
+  /// Issues the draws accumulated in mDrawCounts using the uniforms of 'pass'.
+  void drawRun(ObjectPass* pass);
+
+  Hub&                                      mHub;
+  std::shared_ptr<ShaderProgramAsset>       mShader;        ///< Shared by all members.
+  std::shared_ptr<const AttribBindingPlan>  mAttribBinding; ///< Shared by all members.
+  GLenum                                    mPrimitiveType;
+  GLenum                                    mIndexType;
+  size_t                                    mStride;        ///< Vertex stride in bytes.
+
+  std::vector<Member>   mMembers;       ///< Indexed by ObjectPass::getBatchSlot.
+  size_t                mNumPasses;     ///< Members that have not been removed.
+  uint64_t              mLastFrame;
+
+  GLuint                mVAO;
+  GLuint                mVBO;
+  GLuint                mIBO;
+  size_t                mVBOCapacity;   ///< Bytes allocated for mVBO.
+  size_t                mIBOCapacity;   ///< Bytes allocated for mIBO.
+  size_t                mVBOUsed;       ///< Bytes used in mVBO, including holes.
+  size_t                mIBOUsed;       ///< Bytes used in mIBO, including holes.
+  size_t                mVBOWasted;     ///< Bytes in mVBO left by removed passes.
+  size_t                mIBOWasted;     ///< Bytes in mIBO left by removed passes.
+  bool                  mVAODirty;      ///< True if the buffers were reallocated.
+
+  // Per frame draw parameters. Retained to avoid reallocation.
+  std::vector<GLsizei>        mDrawCounts;
+  std::vector<const GLvoid*>  mDrawOffsets;
+  std::vector<GLint>          mDrawBaseVertices;
+};
+#endif
+
+/// Groups small object passes into DrawBatches. Batching is opt-in (see
+/// setEnabled) and is only available under the core profiles, where
+/// glMultiDrawElementsBaseVertex and glCopyBufferSubData are present.
+class BatchMan
+{
+public:
+  BatchMan(Hub& hub);
+  virtual ~BatchMan();
+
+  /// Enables or disables batching. Disabling batching releases all batches.
+  /// Throws UnsupportedException when enabling batching under OpenGL ES 2.0.
+  void setEnabled(bool enabled);
+  bool isEnabled() const          {return mEnabled;}
+
+  /// Starts a new frame. Passes must be re-added every frame to be rendered.
+  void beginFrame();
+
+  /// Adds the pass to its batch, creating the batch if necessary, and marks
+  /// it visible for the current frame. Returns false if the pass cannot be
+  /// batched, in which case it must be rendered individually.
+  bool addPass(ObjectPass* pass);
+
+  /// Renders every batch with passes added in the current frame.
+  void render();
+
+  /// Number of batches.
+  size_t getNumBatches() const;
+
+  /// Passes whose VBO is larger than this are never batched. Batching only
+  /// pays off when draw call overhead dominates.
+  static const size_t MaxBatchedVBOSize = 64 * 1024;
+
+private:
+
+  Hub&      mHub;
+  bool      mEnabled;
+  uint64_t  mFrame;
+
+#ifdef SPIRE_USE_BATCHING
+  /// Passes are only batched together if their keys are identical.
+  struct BatchKey
+  {
+    GLuint              program;
+    size_t              passIndex;
+    GLenum              primitiveType;
+    GLenum              indexType;
+    std::vector<size_t> attributes;
+
+    bool operator<(const BatchKey& other) const;
+  };
+
+  std::map<BatchKey, std::unique_ptr<DrawBatch>>  mBatches;
+  std::vector<DrawBatch*>                         mActiveBatches; ///< Batches with visible passes.
+#endif
+};
+
+} // namespace CPM_SPIRE_NS
+
+#endif
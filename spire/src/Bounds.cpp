@@ -0,0 +1,204 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2013 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+/// \author agent
+/// \date   October 2026
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "Bounds.h"
+
+#ifdef SPIRE_USE_SSE2
+  #include <emmintrin.h>
+#endif
+
+namespace CPM_SPIRE_NS {
+
+#ifdef SPIRE_USE_SSE2
+//------------------------------------------------------------------------------
+// Loads the 3 floats at 'p' into (x, y, z, 0) without reading past them.
+static inline __m128 loadPosition(const uint8_t* p)
+{
+  __m128 xy = _mm_castpd_ps(_mm_load_sd(reinterpret_cast<const double*>(p)));
+  __m128 z  = _mm_load_ss(reinterpret_cast<const float*>(p + 2 * sizeof(float)));
+  return _mm_movelh_ps(xy, z);
+}
+#endif
+
+//------------------------------------------------------------------------------
+bool computeBounds(const uint8_t* vertices, size_t numVertices,
+                   size_t stride, size_t offset,
+                   AABB& aabbOut, BoundingSphere& sphereOut)
+{
+  if (numVertices == 0)
+    return false;
+
+  const uint8_t* first = vertices + offset;
+
+#ifdef SPIRE_USE_SSE2
+  __m128 vmin = loadPosition(first);
+  __m128 vmax = vmin;
+  const uint8_t* p = first + stride;
+  for (size_t i = 1; i < numVertices; ++i, p += stride)
+  {
+    __m128 pos = loadPosition(p);
+    vmin = _mm_min_ps(vmin, pos);
+    vmax = _mm_max_ps(vmax, pos);
+  }
+
+  float minOut[4];
+  float maxOut[4];
+  _mm_storeu_ps(minOut, vmin);
+  _mm_storeu_ps(maxOut, vmax);
+  aabbOut.min = V3(minOut[0], minOut[1], minOut[2]);
+  aabbOut.max = V3(maxOut[0], maxOut[1], maxOut[2]);
+
+  // Sphere centered on the box, radius is the largest distance to a vertex.
+  __m128 center = _mm_mul_ps(_mm_add_ps(vmin, vmax), _mm_set1_ps(0.5f));
+  __m128 maxDist2 = _mm_setzero_ps();
+  p = first;
+  for (size_t i = 0; i < numVertices; ++i, p += stride)
+  {
+    __m128 d  = _mm_sub_ps(loadPosition(p), center);
+    __m128 d2 = _mm_mul_ps(d, d);
+    // Horizontal add of x, y, and z (w is 0).
+    d2 = _mm_add_ps(d2, _mm_shuffle_ps(d2, d2, _MM_SHUFFLE(2, 3, 0, 1)));
+    d2 = _mm_add_ps(d2, _mm_shuffle_ps(d2, d2, _MM_SHUFFLE(1, 0, 3, 2)));
+    maxDist2 = _mm_max_ps(maxDist2, d2);
+  }
+
+  sphereOut.center = (aabbOut.min + aabbOut.max) * 0.5f;
+  sphereOut.radius = std::sqrt(_mm_cvtss_f32(maxDist2));
+#else
+  float pos[3];
+  std::memcpy(pos, first, sizeof(pos));
+  V3 vmin(pos[0], pos[1], pos[2]);
+  V3 vmax = vmin;
+  const uint8_t* p = first + stride;
+  for (size_t i = 1; i < numVertices; ++i, p += stride)
+  {
+    std::memcpy(pos, p, sizeof(pos));
+    V3 v(pos[0], pos[1], pos[2]);
+    vmin = glm::min(vmin, v);
+    vmax = glm::max(vmax, v);
+  }
+  aabbOut.min = vmin;
+  aabbOut.max = vmax;
+
+  V3 center = (vmin + vmax) * 0.5f;
+  float maxDist2 = 0.0f;
+  p = first;
+  for (size_t i = 0; i < numVertices; ++i, p += stride)
+  {
+    std::memcpy(pos, p, sizeof(pos));
+    V3 d = V3(pos[0], pos[1], pos[2]) - center;
+    float dist2 = glm::dot(d, d);
+    if (dist2 > maxDist2)
+      maxDist2 = dist2;
+  }
+
+  sphereOut.center = center;
+  sphereOut.radius = std::sqrt(maxDist2);
+#endif
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+void mergeBounds(const AABB& aabb, const BoundingSphere& sphere,
+                 AABB& aabbInOut, BoundingSphere& sphereInOut)
+{
+  aabbInOut.min = glm::min(aabbInOut.min, aabb.min);
+  aabbInOut.max = glm::max(aabbInOut.max, aabb.max);
+
+  V3 center = (aabbInOut.min + aabbInOut.max) * 0.5f;
+  sphereInOut.radius = std::max(glm::length(sphereInOut.center - center) + sphereInOut.radius,
+                                glm::length(sphere.center - center) + sphere.radius);
+  sphereInOut.center = center;
+}
+
+//------------------------------------------------------------------------------
+// Frustum
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+Frustum::Frustum(const M44& m)
+{
+  // Gribb / Hartmann plane extraction. GLM matrices are column major, so
+  // row i is (m[0][i], m[1][i], m[2][i], m[3][i]).
+  V4 row0(m[0][0], m[1][0], m[2][0], m[3][0]);
+  V4 row1(m[0][1], m[1][1], m[2][1], m[3][1]);
+  V4 row2(m[0][2], m[1][2], m[2][2], m[3][2]);
+  V4 row3(m[0][3], m[1][3], m[2][3], m[3][3]);
+
+  mPlanes[0] = row3 + row0;   // Left
+  mPlanes[1] = row3 - row0;   // Right
+  mPlanes[2] = row3 + row1;   // Bottom
+  mPlanes[3] = row3 - row1;   // Top
+  mPlanes[4] = row3 + row2;   // Near
+  mPlanes[5] = row3 - row2;   // Far
+
+  for (int i = 0; i < 6; ++i)
+  {
+    float len = glm::length(V3(mPlanes[i]));
+    if (len > 0.0f)
+      mPlanes[i] /= len;
+  }
+}
+
+//------------------------------------------------------------------------------
+bool Frustum::intersects(const BoundingSphere& sphere) const
+{
+  for (int i = 0; i < 6; ++i)
+  {
+    const V4& plane = mPlanes[i];
+    if (glm::dot(V3(plane), sphere.center) + plane.w < -sphere.radius)
+      return false;
+  }
+  return true;
+}
+
+//------------------------------------------------------------------------------
+bool Frustum::intersects(const AABB& box) const
+{
+  for (int i = 0; i < 6; ++i)
+  {
+    // Test the corner of the box furthest along the plane's normal.
+    const V4& plane = mPlanes[i];
+    V3 corner(plane.x >= 0.0f ? box.max.x : box.min.x,
+              plane.y >= 0.0f ? box.max.y : box.min.y,
+              plane.z >= 0.0f ? box.max.z : box.min.z);
+    if (glm::dot(V3(plane), corner) + plane.w < 0.0f)
+      return false;
+  }
+  return true;
+}
+
+} // namespace CPM_SPIRE_NS
@@ -0,0 +1,98 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2013 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+/// \author agent
+/// \date   October 2026
+
+#ifndef SPIRE_HIGH_BOUNDS_H
+#define SPIRE_HIGH_BOUNDS_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "Common.h"
+
+namespace CPM_SPIRE_NS {
+
+/// Axis aligned bounding box.
+struct AABB
+{
+  AABB() : min(0.0f), max(0.0f) {}
+
+  V3 min;
+  V3 max;
+};
+
+/// Bounding sphere.
+struct BoundingSphere
+{
+  BoundingSphere() : center(0.0f), radius(0.0f) {}
+
+  V3    center;
+  float radius;
+};
+
+/// Computes the bounding box and bounding sphere of 'numVertices' positions.
+/// Each position consists of 3 floats starting 'offset' bytes into a vertex,
+/// vertices are 'stride' bytes apart. The sphere is centered on the box.
+/// Uses SSE when available (SPIRE_USE_SSE2).
+/// Returns false if there are no vertices.
+bool computeBounds(const uint8_t* vertices, size_t numVertices,
+                   size_t stride, size_t offset,
+                   AABB& aabbOut, BoundingSphere& sphereOut);
+
+/// Grows 'aabbInOut' and 'sphereInOut' to enclose 'aabb' and 'sphere' as
+/// well. The sphere stays centered on the box.
+void mergeBounds(const AABB& aabb, const BoundingSphere& sphere,
+                 AABB& aabbInOut, BoundingSphere& sphereInOut);
+
+/// View frustum. The planes are extracted from a projection * view * world
+/// matrix, so bounds are tested in the coordinate system of the geometry
+/// that is transformed by the matrix.
+class Frustum
+{
+public:
+  Frustum(const M44& projIVObject);
+
+  /// Returns false if the volume is entirely outside of the frustum. Volumes
+  /// that straddle a frustum plane are considered inside.
+  /// @{
+  bool intersects(const BoundingSphere& sphere) const;
+  bool intersects(const AABB& box) const;
+  /// @}
+
+private:
+
+  /// Left, right, bottom, top, near, and far planes. The normals
+  /// (xyz) point into the frustum and are normalized.
+  V4  mPlanes[6];
+};
+
+} // namespace CPM_SPIRE_NS
+
+#endif
@@ -0,0 +1,236 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2013 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+/// \author agent
+/// \date   October 2026
+
+#include <algorithm>
+
+#include "BufferArena.h"
+#include "Hub.h"
+#include "GLStateMan.h"
+#include "UploadQueue.h"
+
+namespace CPM_SPIRE_NS {
+
+struct BufferArena::Allocation
+{
+  Slot      slot;
+  size_t    sizeClass;
+  size_t    size;       ///< Requested size in bytes.
+  size_t    index;      ///< Index into mAllocations.
+  GLuint*   bufferOut;
+  size_t*   offsetOut;
+};
+
+//------------------------------------------------------------------------------
+BufferArena::BufferArena(Hub& hub, GLenum target) :
+    mHub(hub),
+    mTarget(target),
+    mEnabled(false),
+    mFreeLists(getSizeClass(MaxAllocationSize) + 1)
+{
+}
+
+//------------------------------------------------------------------------------
+BufferArena::~BufferArena()
+{
+  for (auto it = mBlocks.begin(); it != mBlocks.end(); ++it)
+  {
+    mHub.getGLStateManager().onBufferDeleted(it->buffer);
+    GL(glDeleteBuffers(1, &it->buffer));
+  }
+}
+
+//------------------------------------------------------------------------------
+size_t BufferArena::getSizeClass(size_t size)
+{
+  size_t sizeClass = 0;
+  while (getClassSize(sizeClass) < size)
+    ++sizeClass;
+  return sizeClass;
+}
+
+//------------------------------------------------------------------------------
+GLuint BufferArena::createBuffer()
+{
+  GLuint buffer;
+  GL(glGenBuffers(1, &buffer));
+#ifndef SPIRE_USE_VAO
+  if (mTarget == GL_ELEMENT_ARRAY_BUFFER)
+  {
+    mHub.getGLStateManager().bindElementArrayBuffer(buffer);
+    GL(glBufferData(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLsizeiptr>(BlockSize),
+                    NULL, GL_STATIC_DRAW));
+    return buffer;
+  }
+#endif
+  // Index blocks are allocated through GL_ARRAY_BUFFER as well with VAOs so
+  // that the element array binding of the bound VAO is left alone.
+  mHub.getGLStateManager().bindArrayBuffer(buffer);
+  GL(glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(BlockSize),
+                  NULL, GL_STATIC_DRAW));
+  return buffer;
+}
+
+//------------------------------------------------------------------------------
+BufferArena::Slot BufferArena::carve(std::vector<Block>& blocks, size_t slotSize)
+{
+  if (blocks.empty() || blocks.back().used + slotSize > BlockSize)
+  {
+    Block block;
+    block.buffer  = createBuffer();
+    block.used    = 0;
+    block.live    = 0;
+    blocks.push_back(block);
+  }
+
+  Slot slot;
+  slot.block  = blocks.size() - 1;
+  slot.offset = blocks.back().used;
+  blocks.back().used += slotSize;
+  return slot;
+}
+
+//------------------------------------------------------------------------------
+BufferArena::Allocation* BufferArena::allocate(size_t size, GLuint* bufferOut,
+                                               size_t* offsetOut)
+{
+  if (mEnabled == false || size == 0 || size > MaxAllocationSize)
+    return nullptr;
+
+  std::unique_ptr<Allocation> allocation(new Allocation);
+  allocation->sizeClass = getSizeClass(size);
+  allocation->size      = size;
+  allocation->index     = mAllocations.size();
+  allocation->bufferOut = bufferOut;
+  allocation->offsetOut = offsetOut;
+
+  std::vector<Slot>& freeList = mFreeLists[allocation->sizeClass];
+  if (freeList.empty() == false)
+  {
+    allocation->slot = freeList.back();
+    freeList.pop_back();
+  }
+  else
+  {
+    allocation->slot = carve(mBlocks, getClassSize(allocation->sizeClass));
+  }
+
+  Block& block = mBlocks[allocation->slot.block];
+  block.live += getClassSize(allocation->sizeClass);
+  *bufferOut = block.buffer;
+  *offsetOut = allocation->slot.offset;
+
+  mAllocations.push_back(std::move(allocation));
+  return mAllocations.back().get();
+}
+
+//------------------------------------------------------------------------------
+void BufferArena::deallocate(Allocation* allocation)
+{
+  mBlocks[allocation->slot.block].live -= getClassSize(allocation->sizeClass);
+  mFreeLists[allocation->sizeClass].push_back(allocation->slot);
+
+  // Swap with the last allocation and pop.
+  size_t index = allocation->index;
+  std::swap(mAllocations[index], mAllocations.back());
+  mAllocations[index]->index = index;
+  mAllocations.pop_back();
+}
+
+//------------------------------------------------------------------------------
+size_t BufferArena::getNumLiveBytes() const
+{
+  size_t live = 0;
+  for (auto it = mBlocks.begin(); it != mBlocks.end(); ++it)
+    live += it->live;
+  return live;
+}
+
+//------------------------------------------------------------------------------
+size_t BufferArena::compact()
+{
+#ifdef SPIRE_USE_BUFFER_COPIES
+  if (mHub.getUploadQueue().getNumPendingBuffers() > 0)
+    return 0;
+
+  // Power of two slots packed largest first fill blocks without gaps, so
+  // compacting is worthwhile if the live bytes fit into fewer blocks.
+  size_t numBlocks = (getNumLiveBytes() + BlockSize - 1) / BlockSize;
+  if (numBlocks >= mBlocks.size())
+    return 0;
+
+  std::vector<Allocation*> order;
+  order.reserve(mAllocations.size());
+  for (auto it = mAllocations.begin(); it != mAllocations.end(); ++it)
+    order.push_back(it->get());
+  std::stable_sort(order.begin(), order.end(),
+                   [](const Allocation* a, const Allocation* b)
+                   {
+                     return a->sizeClass > b->sizeClass;
+                   });
+
+  // The copy targets are not part of the shadowed GL state (GLStateMan).
+  std::vector<Block> blocks;
+  for (auto it = order.begin(); it != order.end(); ++it)
+  {
+    Allocation* allocation = *it;
+    size_t slotSize = getClassSize(allocation->sizeClass);
+    Slot slot = carve(blocks, slotSize);
+    blocks[slot.block].live += slotSize;
+
+    GL(glBindBuffer(GL_COPY_READ_BUFFER, mBlocks[allocation->slot.block].buffer));
+    GL(glBindBuffer(GL_COPY_WRITE_BUFFER, blocks[slot.block].buffer));
+    GL(glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER,
+                           static_cast<GLintptr>(allocation->slot.offset),
+                           static_cast<GLintptr>(slot.offset),
+                           static_cast<GLsizeiptr>(allocation->size)));
+
+    allocation->slot = slot;
+    *allocation->bufferOut = blocks[slot.block].buffer;
+    *allocation->offsetOut = slot.offset;
+  }
+
+  size_t released = (mBlocks.size() - blocks.size()) * BlockSize;
+  for (auto it = mBlocks.begin(); it != mBlocks.end(); ++it)
+  {
+    mHub.getGLStateManager().onBufferDeleted(it->buffer);
+    GL(glDeleteBuffers(1, &it->buffer));
+  }
+  mBlocks.swap(blocks);
+  for (auto it = mFreeLists.begin(); it != mFreeLists.end(); ++it)
+    it->clear();
+
+  return released;
+#else
+  return 0;
+#endif
+}
+
+} // namespace CPM_SPIRE_NS
@@ -0,0 +1,138 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2013 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+/// \author agent
+/// \date   October 2026
+
+#ifndef SPIRE_HIGH_BUFFERARENA_H
+#define SPIRE_HIGH_BUFFERARENA_H
+
+#include <memory>
+#include <vector>
+#include <cstdint>
+
+#include "Common.h"
+
+namespace CPM_SPIRE_NS {
+
+class Hub;
+
+/// Sub-allocates small VBOs or IBOs out of a few large GL buffers (blocks),
+/// so that scenes with thousands of small meshes do not need thousands of
+/// buffer objects. Allocations are rounded up to power of two size classes.
+/// Freed slots go on a free list per size class and are handed out again
+/// before new space is carved out of a block.
+///
+/// Owners see an allocation as a (buffer, offset) pair. The arena writes it
+/// through the pointers given to allocate, and rewrites it when compact
+/// moves the allocation.
+class BufferArena
+{
+public:
+  /// 'target' is GL_ARRAY_BUFFER for vertex data, GL_ELEMENT_ARRAY_BUFFER
+  /// for index data.
+  BufferArena(Hub& hub, GLenum target);
+  virtual ~BufferArena();
+
+  /// Opaque allocation handle.
+  struct Allocation;
+
+  /// New allocations are only made while the arena is enabled. Disabled by
+  /// default.
+  void setEnabled(bool enabled)       {mEnabled = enabled;}
+  bool isEnabled() const              {return mEnabled;}
+
+  /// Allocates 'size' bytes and writes their location to '*bufferOut' and
+  /// '*offsetOut', which must stay valid until the allocation is freed.
+  /// Returns nullptr if the arena is disabled or 'size' is 0 or larger than
+  /// MaxAllocationSize; such buffers need a GL buffer of their own.
+  Allocation* allocate(size_t size, GLuint* bufferOut, size_t* offsetOut);
+
+  /// Returns the allocation's slot to its free list.
+  void deallocate(Allocation* allocation);
+
+  /// Moves all allocations into as few blocks as possible and deletes the
+  /// rest, reclaiming the slots on the free lists. Only available with
+  /// SPIRE_USE_BUFFER_COPIES. Skipped while uploads are queued (see
+  /// UploadQueue) since they target the current locations. Returns the
+  /// number of bytes released.
+  size_t compact();
+
+  /// Number of GL buffers backing the arena.
+  size_t getNumBlocks() const         {return mBlocks.size();}
+
+  /// Bytes in allocated slots, and bytes held by the blocks.
+  /// @{
+  size_t getNumLiveBytes() const;
+  size_t getNumReservedBytes() const  {return mBlocks.size() * BlockSize;}
+  /// @}
+
+  /// Size of each GL buffer.
+  static const size_t BlockSize         = 8 * 1024 * 1024;
+
+  /// Smallest and largest size classes.
+  static const size_t MinAllocationSize = 256;
+  static const size_t MaxAllocationSize = 256 * 1024;
+
+private:
+
+  struct Block
+  {
+    GLuint  buffer;
+    size_t  used;     ///< Bytes carved out of the block so far.
+    size_t  live;     ///< Bytes in slots that are currently allocated.
+  };
+
+  struct Slot
+  {
+    size_t  block;    ///< Index into mBlocks.
+    size_t  offset;   ///< Byte offset within the block.
+  };
+
+  /// Size class of an allocation of 'size' bytes.
+  static size_t getSizeClass(size_t size);
+  static size_t getClassSize(size_t sizeClass)  {return MinAllocationSize << sizeClass;}
+
+  /// Carves a slot of 'slotSize' bytes out of the last block, creating a new
+  /// block if it is full.
+  Slot carve(std::vector<Block>& blocks, size_t slotSize);
+
+  /// Creates a GL buffer of BlockSize bytes.
+  GLuint createBuffer();
+
+  Hub&                                      mHub;
+  GLenum                                    mTarget;
+  bool                                      mEnabled;
+  std::vector<Block>                        mBlocks;
+  std::vector<std::vector<Slot>>            mFreeLists;   ///< Indexed by size class.
+  std::vector<std::unique_ptr<Allocation>>  mAllocations; ///< Live allocations.
+};
+
+} // namespace CPM_SPIRE_NS
+
+#endif
@@ -0,0 +1,103 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2013 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+/// \author agent
+/// \date   October 2026
+
+#include <algorithm>
+#include <iterator>
+#include <cstring>
+
+#include "BufferUpdates.h"
+
+namespace CPM_SPIRE_NS {
+
+//------------------------------------------------------------------------------
+void BufferUpdates::add(size_t offset, const uint8_t* data, size_t size)
+{
+  if (size == 0)
+    return;
+
+  size_t begin = offset;
+  size_t end   = offset + size;
+
+  // The first range to merge with is the last one starting at or before
+  // 'offset', provided it reaches 'offset'.
+  auto first = mRanges.upper_bound(offset);
+  if (first != mRanges.begin())
+  {
+    auto prev = std::prev(first);
+    if (prev->first + prev->second.size() >= offset)
+      first = prev;
+  }
+
+  // Every range starting at or before 'end' overlaps or touches the update.
+  auto last = first;
+  for (; last != mRanges.end() && last->first <= end; ++last)
+  {
+    begin = std::min(begin, last->first);
+    end   = std::max(end, last->first + last->second.size());
+  }
+
+  std::vector<uint8_t> merged(end - begin);
+  for (auto it = first; it != last; ++it)
+  {
+    std::memcpy(&merged[it->first - begin], it->second.data(), it->second.size());
+    mNumBytes -= it->second.size();
+  }
+  std::memcpy(&merged[offset - begin], data, size);
+
+  mRanges.erase(first, last);
+  mNumBytes += merged.size();
+  mRanges.insert(std::make_pair(begin, std::move(merged)));
+}
+
+//------------------------------------------------------------------------------
+void BufferUpdates::upload(GLenum target, size_t baseOffset, size_t size,
+                           GLenum usage, bool ownsBuffer)
+{
+  if (ownsBuffer && mRanges.size() == 1 && mRanges.begin()->first == 0
+      && mRanges.begin()->second.size() == size)
+  {
+    GL(glBufferData(target, static_cast<GLsizeiptr>(size),
+                    mRanges.begin()->second.data(), usage));
+  }
+  else
+  {
+    for (auto it = mRanges.begin(); it != mRanges.end(); ++it)
+    {
+      GL(glBufferSubData(target, static_cast<GLintptr>(baseOffset + it->first),
+                         static_cast<GLsizeiptr>(it->second.size()),
+                         it->second.data()));
+    }
+  }
+
+  clear();
+}
+
+} // namespace CPM_SPIRE_NS
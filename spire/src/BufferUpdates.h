@@ -0,0 +1,85 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2013 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+/// \author agent
+/// \date   October 2026
+
+#ifndef SPIRE_HIGH_BUFFERUPDATES_H
+#define SPIRE_HIGH_BUFFERUPDATES_H
+
+#include <map>
+#include <vector>
+#include <cstdint>
+
+#include "Common.h"
+
+namespace CPM_SPIRE_NS {
+
+/// Changes to the contents of a GL buffer that have not been uploaded yet
+/// (see Interface::updateVBO). Overlapping and adjacent ranges are coalesced
+/// as they are added, later updates overwrite earlier ones, so each
+/// contiguous dirty region is uploaded with a single call.
+class BufferUpdates
+{
+public:
+  BufferUpdates() : mNumBytes(0) {}
+
+  /// Records that 'size' bytes starting at byte 'offset' of the buffer
+  /// change to 'data'. The data is copied.
+  void add(size_t offset, const uint8_t* data, size_t size);
+
+  /// Uploads all pending ranges to the buffer bound to 'target' and clears
+  /// them. Range offsets are relative to 'baseOffset' bytes into the buffer,
+  /// and 'size' is the size of the updated VBO / IBO. If a single range
+  /// covers all of it and 'ownsBuffer' is true, the buffer is orphaned and
+  /// respecified with glBufferData so the driver does not have to wait for
+  /// draws still reading the old contents. Otherwise ranges are uploaded
+  /// with glBufferSubData.
+  void upload(GLenum target, size_t baseOffset, size_t size, GLenum usage,
+              bool ownsBuffer);
+
+  /// Drops all pending ranges.
+  void clear()                      {mRanges.clear(); mNumBytes = 0;}
+
+  bool empty() const                {return mRanges.empty();}
+  size_t getNumRanges() const       {return mRanges.size();}
+  size_t getNumBytes() const        {return mNumBytes;}
+
+  /// Pending ranges keyed by byte offset.
+  const std::map<size_t, std::vector<uint8_t>>& getRanges() const {return mRanges;}
+
+private:
+
+  /// Dirty ranges keyed by byte offset. Ranges neither overlap nor touch.
+  std::map<size_t, std::vector<uint8_t>>  mRanges;
+  size_t                                  mNumBytes;  ///< Sum of all range sizes.
+};
+
+} // namespace CPM_SPIRE_NS
+
+#endif
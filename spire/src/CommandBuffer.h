@@ -0,0 +1,92 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2013 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+/// \author agent
+/// \date   October 2026
+
+#ifndef SPIRE_HIGH_COMMANDBUFFER_H
+#define SPIRE_HIGH_COMMANDBUFFER_H
+
+#include <vector>
+#include <cstdint>
+
+#include "Common.h"
+
+namespace CPM_SPIRE_NS {
+
+class ObjectPass;
+class AbstractUniformStateItem;
+
+/// A draw recorded while culling. Recording is free of GL calls, so command
+/// buffers may be filled on worker threads and executed on the GL thread.
+struct DrawCommand
+{
+  DrawCommand(uint64_t key, ObjectPass* objectPass,
+              const AbstractUniformStateItem* matrix) :
+      sortKey(key),
+      pass(objectPass),
+      projIVObject(matrix)
+  {}
+
+  uint64_t    sortKey;      ///< See ObjectPass::getSortKey.
+  ObjectPass* pass;         ///< LOD already selected (see ObjectPass::setLOD).
+  const AbstractUniformStateItem* projIVObject; ///< Culling matrix of the pass, if any.
+};
+
+/// Draws recorded for a contiguous range of a RenderList. Memory is retained
+/// between frames.
+class CommandBuffer
+{
+public:
+  CommandBuffer() : mNumCulled(0) {}
+
+  void clear()
+  {
+    mDraws.clear();
+    mNumCulled = 0;
+  }
+
+  void addDraw(ObjectPass* pass, uint64_t sortKey,
+               const AbstractUniformStateItem* projIVObject)
+  {
+    mDraws.emplace_back(DrawCommand(sortKey, pass, projIVObject));
+  }
+
+  void addCulled()                              {++mNumCulled;}
+
+  const std::vector<DrawCommand>& getDraws() const  {return mDraws;}
+  size_t getNumCulled() const                   {return mNumCulled;}
+
+private:
+  std::vector<DrawCommand>  mDraws;
+  size_t                    mNumCulled;
+};
+
+} // namespace CPM_SPIRE_NS
+
+#endif
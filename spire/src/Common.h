@@ -41,6 +41,66 @@
 #include "Math.h"
 #include "Log.h"
 
+// Vertex array objects are part of the OpenGL 3.0 core profile. OpenGL ES 2.0
+// only exposes them through an extension, so we fall back to binding vertex
+// attributes on every draw there.
+#if defined(USE_CORE_PROFILE_3) || defined(USE_CORE_PROFILE_4)
+  #define SPIRE_USE_VAO
+#endif
+
+// Hardware instancing (glDrawElementsInstanced / glVertexAttribDivisor) in the
+// core profiles. glVertexAttribDivisor is OpenGL 3.3, so it is also checked at
+// run time (see GLCaps). Instanced passes are drawn one instance at a time
+// otherwise.
+#if defined(USE_CORE_PROFILE_3) || defined(USE_CORE_PROFILE_4)
+  #define SPIRE_USE_INSTANCING
+#endif
+
+// Uniform buffer objects (OpenGL 3.1) back global uniforms in the core
+// profiles. See GlobalUniformBlock.
+#if defined(USE_CORE_PROFILE_3) || defined(USE_CORE_PROFILE_4)
+  #define SPIRE_USE_UBO
+#endif
+
+// Merged draw batches (see BatchMan) rely on glCopyBufferSubData and
+// glMultiDrawElementsBaseVertex (OpenGL 3.2), neither of which are available
+// in OpenGL ES 2.0.
+#if defined(USE_CORE_PROFILE_3) || defined(USE_CORE_PROFILE_4)
+  #define SPIRE_USE_BATCHING
+#endif
+
+// Occlusion culling (see OcclusionMan) relies on GL_ANY_SAMPLES_PASSED
+// queries (OpenGL 3.3). 3.2 contexts need GL_ARB_occlusion_query2, which is
+// checked at run time when occlusion culling is enabled (see GLCaps).
+#if defined(USE_CORE_PROFILE_3) || defined(USE_CORE_PROFILE_4)
+  #define SPIRE_USE_OCCLUSION_QUERIES
+#endif
+
+// Buffer arenas (see BufferArena) move live allocations when compacting
+// with glCopyBufferSubData (OpenGL 3.1). Arenas are never compacted in
+// OpenGL ES 2.0.
+#if defined(USE_CORE_PROFILE_3) || defined(USE_CORE_PROFILE_4)
+  #define SPIRE_USE_BUFFER_COPIES
+#endif
+
+// Streamed geometry (see StreamBuffer) is written to a persistently mapped
+// buffer (glBufferStorage, OpenGL 4.4) in the 4.x core profile when the
+// context supports it (see GLCaps), and through unsynchronized
+// glMapBufferRange calls guarded by fences (OpenGL 3.2) otherwise. OpenGL ES
+// 2.0 orphans the buffer every frame instead.
+#if defined(USE_CORE_PROFILE_4)
+  #define SPIRE_USE_PERSISTENT_MAPPING
+#endif
+#if defined(USE_CORE_PROFILE_3) || defined(USE_CORE_PROFILE_4)
+  #define SPIRE_USE_SYNC_OBJECTS
+#endif
+
+// SSE2 is used by a few CPU side kernels (see Bounds) when the target
+// supports it. Every x86-64 processor does.
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+  #define SPIRE_USE_SSE2
+#endif
+
 namespace CPM_SPIRE_NS {
 
 } // namespace CPM_SPIRE_NS
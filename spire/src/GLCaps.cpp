@@ -0,0 +1,141 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2013 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+/// \author agent
+/// \date   October 2026
+
+#include <sstream>
+
+#include "Common.h"
+#include "GLCaps.h"
+
+namespace CPM_SPIRE_NS {
+
+//------------------------------------------------------------------------------
+GLCaps::GLCaps() :
+    mQueried(false),
+    mMajor(0),
+    mMinor(0)
+{
+}
+
+//------------------------------------------------------------------------------
+void GLCaps::query()
+{
+  if (mQueried)
+    return;
+  mQueried = true;
+
+#if defined(USE_CORE_PROFILE_3) || defined(USE_CORE_PROFILE_4)
+  GLint major = 0;
+  GLint minor = 0;
+  GL(glGetIntegerv(GL_MAJOR_VERSION, &major));
+  GL(glGetIntegerv(GL_MINOR_VERSION, &minor));
+  mMajor = static_cast<int>(major);
+  mMinor = static_cast<int>(minor);
+
+  // The extension string was removed from the core profile.
+  GLint numExtensions = 0;
+  GL(glGetIntegerv(GL_NUM_EXTENSIONS, &numExtensions));
+  for (GLint i = 0; i < numExtensions; ++i)
+  {
+    const GLubyte* name = glGetStringi(GL_EXTENSIONS, static_cast<GLuint>(i));
+    if (name != nullptr)
+      mExtensions.insert(reinterpret_cast<const char*>(name));
+  }
+#else
+  mMajor = 2;
+  mMinor = 0;
+
+  const GLubyte* extensions = glGetString(GL_EXTENSIONS);
+  if (extensions != nullptr)
+  {
+    std::istringstream stream(reinterpret_cast<const char*>(extensions));
+    std::string name;
+    while (stream >> name)
+      mExtensions.insert(name);
+  }
+#endif
+}
+
+//------------------------------------------------------------------------------
+bool GLCaps::hasVersion(int major, int minor)
+{
+  query();
+  return (mMajor > major || (mMajor == major && mMinor >= minor));
+}
+
+//------------------------------------------------------------------------------
+void GLCaps::limitVersion(int major, int minor)
+{
+  query();
+  if (hasVersion(major, minor) == false)
+    return;
+
+  mMajor = major;
+  mMinor = minor;
+}
+
+//------------------------------------------------------------------------------
+bool GLCaps::hasExtension(const std::string& name)
+{
+  query();
+  return (mExtensions.find(name) != mExtensions.end());
+}
+
+//------------------------------------------------------------------------------
+bool GLCaps::hasInstancedArrays()
+{
+#ifdef SPIRE_USE_INSTANCING
+  return hasVersion(3, 3);
+#else
+  return false;
+#endif
+}
+
+//------------------------------------------------------------------------------
+bool GLCaps::hasOcclusionQuery2()
+{
+#ifdef SPIRE_USE_OCCLUSION_QUERIES
+  return hasVersion(3, 3) || hasExtension("GL_ARB_occlusion_query2");
+#else
+  return false;
+#endif
+}
+
+//------------------------------------------------------------------------------
+bool GLCaps::hasBufferStorage()
+{
+#ifdef SPIRE_USE_PERSISTENT_MAPPING
+  return hasVersion(4, 4) || hasExtension("GL_ARB_buffer_storage");
+#else
+  return false;
+#endif
+}
+
+} // namespace CPM_SPIRE_NS
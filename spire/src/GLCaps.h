@@ -0,0 +1,90 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2013 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+/// \author agent
+/// \date   October 2026
+
+#ifndef SPIRE_HIGH_GLCAPS_H
+#define SPIRE_HIGH_GLCAPS_H
+
+#include <set>
+#include <string>
+
+#include "Common.h"
+
+namespace CPM_SPIRE_NS {
+
+/// Version and extensions of the current GL context. The build profile
+/// (USE_CORE_PROFILE_3 / USE_CORE_PROFILE_4) only guarantees the minor version
+/// the profile starts at, features introduced in later minor versions are
+/// checked here before they are used.
+///
+/// The context is queried on first use. All functions must be called from the
+/// thread owning the context.
+class GLCaps
+{
+public:
+  GLCaps();
+  virtual ~GLCaps()   {}
+
+  /// Returns true if the context's version is at least 'major'.'minor'.
+  bool hasVersion(int major, int minor);
+
+  /// Treats the context as if its version were at most 'major'.'minor', so
+  /// that the fallbacks for features of later versions are used. Extensions
+  /// are not affected. Must be called before any GL object is created.
+  void limitVersion(int major, int minor);
+
+  /// Returns true if the context exposes the extension 'name'
+  /// (e.g. "GL_ARB_buffer_storage").
+  bool hasExtension(const std::string& name);
+
+  /// glVertexAttribDivisor (OpenGL 3.3). GL_ARB_instanced_arrays is not
+  /// accepted, it only exposes the ARB suffixed entry point.
+  bool hasInstancedArrays();
+
+  /// GL_ANY_SAMPLES_PASSED queries (OpenGL 3.3 or GL_ARB_occlusion_query2).
+  bool hasOcclusionQuery2();
+
+  /// glBufferStorage (OpenGL 4.4 or GL_ARB_buffer_storage).
+  bool hasBufferStorage();
+
+private:
+
+  /// Queries the version and extensions, if not done already.
+  void query();
+
+  bool                  mQueried;     ///< True once query has run.
+  int                   mMajor;       ///< Major version of the context.
+  int                   mMinor;       ///< Minor version of the context.
+  std::set<std::string> mExtensions;  ///< Extensions exposed by the context.
+};
+
+} // namespace CPM_SPIRE_NS
+
+#endif
@@ -0,0 +1,240 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2013 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+/// \author agent
+/// \date   October 2026
+
+#include <stdexcept>
+
+#include "Common.h"
+#include "GLStateMan.h"
+
+namespace CPM_SPIRE_NS {
+
+//------------------------------------------------------------------------------
+GLStateMan::GLStateMan() :
+    mNumIssued(0),
+    mNumSkipped(0)
+{
+  invalidateBindings();
+}
+
+//------------------------------------------------------------------------------
+void GLStateMan::invalidateBindings()
+{
+  mProgram                  = 0;
+  mVertexArray              = 0;
+  mArrayBuffer              = 0;
+
+  mProgramValid             = false;
+  mVertexArrayValid         = false;
+  mArrayBufferValid         = false;
+
+  invalidateVertexArrayBindings();
+}
+
+//------------------------------------------------------------------------------
+void GLStateMan::invalidateVertexArrayBindings()
+{
+  mElementArrayBuffer       = 0;
+  mEnabledAttribs           = 0;
+
+  mElementArrayBufferValid  = false;
+  mKnownAttribs             = 0;
+}
+
+//------------------------------------------------------------------------------
+void GLStateMan::invalidate()
+{
+  invalidateBindings();
+}
+
+//------------------------------------------------------------------------------
+void GLStateMan::resetCounters()
+{
+  mNumIssued  = 0;
+  mNumSkipped = 0;
+}
+
+//------------------------------------------------------------------------------
+void GLStateMan::useProgram(GLuint program)
+{
+  if (mProgramValid && mProgram == program)
+  {
+    ++mNumSkipped;
+    return;
+  }
+
+  GL(glUseProgram(program));
+  mProgram      = program;
+  mProgramValid = true;
+  ++mNumIssued;
+}
+
+//------------------------------------------------------------------------------
+void GLStateMan::bindArrayBuffer(GLuint buffer)
+{
+  if (mArrayBufferValid && mArrayBuffer == buffer)
+  {
+    ++mNumSkipped;
+    return;
+  }
+
+  GL(glBindBuffer(GL_ARRAY_BUFFER, buffer));
+  mArrayBuffer      = buffer;
+  mArrayBufferValid = true;
+  ++mNumIssued;
+}
+
+//------------------------------------------------------------------------------
+void GLStateMan::bindElementArrayBuffer(GLuint buffer)
+{
+  if (mElementArrayBufferValid && mElementArrayBuffer == buffer)
+  {
+    ++mNumSkipped;
+    return;
+  }
+
+  GL(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffer));
+  mElementArrayBuffer       = buffer;
+  mElementArrayBufferValid  = true;
+  ++mNumIssued;
+}
+
+#ifdef SPIRE_USE_VAO
+//------------------------------------------------------------------------------
+void GLStateMan::bindVertexArray(GLuint vao)
+{
+  if (mVertexArrayValid && mVertexArray == vao)
+  {
+    ++mNumSkipped;
+    return;
+  }
+
+  GL(glBindVertexArray(vao));
+  mVertexArray      = vao;
+  mVertexArrayValid = true;
+  ++mNumIssued;
+
+  invalidateVertexArrayBindings();
+}
+
+//------------------------------------------------------------------------------
+void GLStateMan::onVertexArrayDeleted(GLuint vao)
+{
+  // GL reverts the binding to 0 when the bound vertex array is deleted.
+  if (mVertexArrayValid && mVertexArray == vao)
+  {
+    mVertexArray = 0;
+    invalidateVertexArrayBindings();
+  }
+}
+#endif
+
+//------------------------------------------------------------------------------
+void GLStateMan::enableAttribArrays(uint32_t mask)
+{
+  for (GLuint i = 0; mask != 0; ++i, mask >>= 1)
+  {
+    if ((mask & 1) == 0)
+      continue;
+
+    uint32_t bit = static_cast<uint32_t>(1) << i;
+    if ((mKnownAttribs & bit) && (mEnabledAttribs & bit))
+    {
+      ++mNumSkipped;
+      continue;
+    }
+
+    GL(glEnableVertexAttribArray(i));
+    mKnownAttribs   |= bit;
+    mEnabledAttribs |= bit;
+    ++mNumIssued;
+  }
+}
+
+//------------------------------------------------------------------------------
+void GLStateMan::disableAttribArrays(uint32_t mask)
+{
+  for (GLuint i = 0; mask != 0; ++i, mask >>= 1)
+  {
+    if ((mask & 1) == 0)
+      continue;
+
+    uint32_t bit = static_cast<uint32_t>(1) << i;
+    if ((mKnownAttribs & bit) && !(mEnabledAttribs & bit))
+    {
+      ++mNumSkipped;
+      continue;
+    }
+
+    GL(glDisableVertexAttribArray(i));
+    mKnownAttribs   |= bit;
+    mEnabledAttribs &= ~bit;
+    ++mNumIssued;
+  }
+}
+
+//------------------------------------------------------------------------------
+void GLStateMan::setEnabledAttribArrays(uint32_t mask)
+{
+  disableAttribArrays(mEnabledAttribs & mKnownAttribs & ~mask);
+  enableAttribArrays(mask);
+}
+
+//------------------------------------------------------------------------------
+void GLStateMan::onProgramDeleted(GLuint program)
+{
+  // A deleted program remains in use until another program is made current.
+  // The name may be reused by GL after that point, so we can no longer trust
+  // the shadowed value.
+  if (mProgramValid && mProgram == program)
+    mProgramValid = false;
+}
+
+//------------------------------------------------------------------------------
+void GLStateMan::onBufferDeleted(GLuint buffer)
+{
+  if (mArrayBufferValid && mArrayBuffer == buffer)
+    mArrayBuffer = 0;
+
+  if (mElementArrayBufferValid && mElementArrayBuffer == buffer)
+    mElementArrayBuffer = 0;
+}
+
+//------------------------------------------------------------------------------
+uint32_t GLStateMan::getAttribBit(GLint location)
+{
+  if (location < 0 || location >= 32)
+    throw std::out_of_range("Attribute location does not fit in the attribute mask.");
+
+  return static_cast<uint32_t>(1) << location;
+}
+
+} // namespace CPM_SPIRE_NS
+
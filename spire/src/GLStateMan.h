@@ -0,0 +1,142 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2013 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+/// \author agent
+/// \date   October 2026
+
+#ifndef SPIRE_HIGH_GLSTATEMAN_H
+#define SPIRE_HIGH_GLSTATEMAN_H
+
+#include <cstdint>
+
+#include "Common.h"
+
+namespace CPM_SPIRE_NS {
+
+/// Shadows the GL binding state that spire touches while rendering: the
+/// current program, the vertex array object (core profiles only), the array
+/// and element array buffers, and the set of enabled vertex attribute arrays.
+/// GL calls are only issued when the requested binding differs from the
+/// shadowed state.
+///
+/// Every class in spire that binds programs or buffers, or enables vertex
+/// attribute arrays, must go through this manager. Otherwise the shadowed
+/// state will drift from the actual GL state. If the application modifies
+/// any of these bindings outside of spire, it must call invalidate.
+class GLStateMan
+{
+public:
+  GLStateMan();
+  virtual ~GLStateMan()   {}
+
+  /// Equivalent to glUseProgram.
+  void useProgram(GLuint program);
+
+  /// Equivalent to glBindBuffer(GL_ARRAY_BUFFER, buffer).
+  void bindArrayBuffer(GLuint buffer);
+
+  /// Equivalent to glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffer).
+  /// Under the core profiles this binding is part of the bound vertex array
+  /// object's state.
+  void bindElementArrayBuffer(GLuint buffer);
+
+#ifdef SPIRE_USE_VAO
+  /// Equivalent to glBindVertexArray. The element array buffer binding and
+  /// attribute array enables belong to the vertex array object, so they are
+  /// forgotten whenever the vertex array object changes.
+  void bindVertexArray(GLuint vao);
+
+  /// Should be called whenever a vertex array object is deleted.
+  void onVertexArrayDeleted(GLuint vao);
+#endif
+
+  /// Enables every vertex attribute array whose bit is set in 'mask'.
+  /// Bit N corresponds to attribute location N.
+  void enableAttribArrays(uint32_t mask);
+
+  /// Disables every vertex attribute array whose bit is set in 'mask'.
+  void disableAttribArrays(uint32_t mask);
+
+  /// Enables the vertex attribute arrays in 'mask' and disables any other
+  /// attribute array that is known to be enabled. Used when switching
+  /// between vertex layouts so that shared attributes are left untouched.
+  void setEnabledAttribArrays(uint32_t mask);
+
+  /// Should be called whenever a program is deleted. If the program is
+  /// currently in use, the shadowed program is invalidated.
+  void onProgramDeleted(GLuint program);
+
+  /// Should be called whenever a buffer is deleted. GL reverts any binding
+  /// of a deleted buffer to 0, the shadowed state follows suit.
+  void onBufferDeleted(GLuint buffer);
+
+  /// Forgets all shadowed state. The next request for every binding will be
+  /// issued to GL.
+  void invalidate();
+
+  /// Number of GL calls issued through this manager.
+  size_t getNumIssuedCalls() const    {return mNumIssued;}
+
+  /// Number of GL calls that were skipped because the requested state
+  /// was already bound.
+  size_t getNumSkippedCalls() const   {return mNumSkipped;}
+
+  /// Resets the issued and skipped call counters.
+  void resetCounters();
+
+  /// Bit mask for the given attribute location. Attribute locations beyond
+  /// the width of the mask are not supported.
+  static uint32_t getAttribBit(GLint location);
+
+private:
+
+  /// Marks every binding as unknown.
+  void invalidateBindings();
+
+  /// Marks the bindings that are stored in vertex array objects as unknown.
+  void invalidateVertexArrayBindings();
+
+  GLuint    mProgram;             ///< Program in use.
+  GLuint    mVertexArray;         ///< Bound vertex array object.
+  GLuint    mArrayBuffer;         ///< Buffer bound to GL_ARRAY_BUFFER.
+  GLuint    mElementArrayBuffer;  ///< Buffer bound to GL_ELEMENT_ARRAY_BUFFER.
+  uint32_t  mEnabledAttribs;      ///< Enabled vertex attribute arrays.
+
+  bool      mProgramValid;        ///< False if mProgram is unknown.
+  bool      mVertexArrayValid;    ///< False if mVertexArray is unknown.
+  bool      mArrayBufferValid;    ///< False if mArrayBuffer is unknown.
+  bool      mElementArrayBufferValid; ///< False if mElementArrayBuffer is unknown.
+  uint32_t  mKnownAttribs;        ///< Attribute arrays whose state is known.
+
+  size_t    mNumIssued;           ///< Number of GL calls issued.
+  size_t    mNumSkipped;          ///< Number of GL calls skipped.
+};
+
+} // namespace CPM_SPIRE_NS
+
+#endif
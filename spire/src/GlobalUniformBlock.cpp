@@ -0,0 +1,283 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2013 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+/// \author agent
+/// \date   October 2026
+
+#include <cstring>
+
+#include "Common.h"
+#include "Exceptions.h"
+#include "GlobalUniformBlock.h"
+#include "Hub.h"
+#include "ShaderUniformMan.h"
+#include "ShaderUniformStateMan.h"
+
+#ifdef SPIRE_USE_UBO
+
+namespace CPM_SPIRE_NS {
+
+namespace {
+
+// Retrieves the number of columns and rows (column length) of the given GL
+// type. Non-matrix types have 1 column. Returns false if the type is not
+// supported in the global block.
+bool getTypeDimensions(GLenum type, GLint& columns, GLint& rows)
+{
+  switch (type)
+  {
+    case GL_FLOAT:        columns = 1; rows = 1; return true;
+    case GL_FLOAT_VEC2:   columns = 1; rows = 2; return true;
+    case GL_FLOAT_VEC3:   columns = 1; rows = 3; return true;
+    case GL_FLOAT_VEC4:   columns = 1; rows = 4; return true;
+    case GL_FLOAT_MAT2:   columns = 2; rows = 2; return true;
+    case GL_FLOAT_MAT3:   columns = 3; rows = 3; return true;
+    case GL_FLOAT_MAT4:   columns = 4; rows = 4; return true;
+    default:                                     return false;
+  }
+}
+
+// Retrieves the offset one past the last byte of a member of the given type.
+GLint getMemberEnd(GLenum type, GLint offset, GLint matrixStride)
+{
+  GLint columns, rows;
+  getTypeDimensions(type, columns, rows);
+  return offset + (columns - 1) * matrixStride + rows * static_cast<GLint>(sizeof(float));
+}
+
+} // namespace
+
+//------------------------------------------------------------------------------
+GlobalUniformBlock::GlobalUniformBlock(Hub& hub) :
+    mHub(hub),
+    mBuffer(0),
+    mDirty(false)
+{
+}
+
+//------------------------------------------------------------------------------
+GlobalUniformBlock::~GlobalUniformBlock()
+{
+  if (mBuffer != 0)
+    GL(glDeleteBuffers(1, &mBuffer));
+}
+
+//------------------------------------------------------------------------------
+bool GlobalUniformBlock::isBlockMember(GLuint program, GLuint activeUniformIndex)
+{
+  GLint blockIndex = -1;
+  GL(glGetActiveUniformsiv(program, 1, &activeUniformIndex,
+                           GL_UNIFORM_BLOCK_INDEX, &blockIndex));
+  return (blockIndex != -1);
+}
+
+//------------------------------------------------------------------------------
+bool GlobalUniformBlock::registerProgram(GLuint program)
+{
+  GLuint blockIndex = glGetUniformBlockIndex(program, getBlockName());
+  if (blockIndex == GL_INVALID_INDEX)
+    return false;
+
+  GL(glUniformBlockBinding(program, blockIndex, getBindingPoint()));
+
+  GLint blockSize = 0;
+  GL(glGetActiveUniformBlockiv(program, blockIndex, GL_UNIFORM_BLOCK_DATA_SIZE, &blockSize));
+
+  GLint numMembers = 0;
+  GL(glGetActiveUniformBlockiv(program, blockIndex, GL_UNIFORM_BLOCK_ACTIVE_UNIFORMS, &numMembers));
+  if (numMembers <= 0)
+    return true;
+
+  std::vector<GLint> signedIndices(static_cast<size_t>(numMembers));
+  GL(glGetActiveUniformBlockiv(program, blockIndex, GL_UNIFORM_BLOCK_ACTIVE_UNIFORM_INDICES,
+                               &signedIndices[0]));
+  std::vector<GLuint> indices(signedIndices.begin(), signedIndices.end());
+
+  std::vector<GLint> offsets(indices.size());
+  std::vector<GLint> types(indices.size());
+  std::vector<GLint> sizes(indices.size());
+  std::vector<GLint> matrixStrides(indices.size());
+  GLsizei count = static_cast<GLsizei>(indices.size());
+  GL(glGetActiveUniformsiv(program, count, &indices[0], GL_UNIFORM_OFFSET, &offsets[0]));
+  GL(glGetActiveUniformsiv(program, count, &indices[0], GL_UNIFORM_TYPE, &types[0]));
+  GL(glGetActiveUniformsiv(program, count, &indices[0], GL_UNIFORM_SIZE, &sizes[0]));
+  GL(glGetActiveUniformsiv(program, count, &indices[0], GL_UNIFORM_MATRIX_STRIDE, &matrixStrides[0]));
+
+  // Members are only added once the whole block has been checked against the
+  // layout of previously registered programs.
+  std::vector<Member> newMembers;
+  ShaderUniformMan& uniformMan = mHub.getShaderUniformManager();
+  for (size_t i = 0; i < indices.size(); ++i)
+  {
+    const GLsizei maxNameSize = 1024;
+    char name[maxNameSize];
+    GLsizei nameLength = 0;
+    GL(glGetActiveUniformName(program, indices[i], maxNameSize, &nameLength, name));
+    std::string memberName(name, static_cast<size_t>(nameLength));
+
+    GLint columns, rows;
+    GLenum type = static_cast<GLenum>(types[i]);
+    if (sizes[i] != 1 || getTypeDimensions(type, columns, rows) == false)
+    {
+      Log::error() << "Unsupported member '" << memberName << "' in uniform block "
+                   << getBlockName() << ". Only non-array float, vector and "
+                   << "matrix types are supported." << std::endl;
+      throw UnsupportedException("Unsupported global uniform block member type.");
+    }
+
+    // Register the member with the uniform manager so that global uniforms
+    // with the same name are type checked against it.
+    std::shared_ptr<const UniformState> state = uniformMan.findUniformWithName(memberName);
+    if (state == nullptr)
+    {
+      uniformMan.addUniform(memberName, type);
+      state = uniformMan.getUniformWithName(memberName);
+    }
+    if (state->type != type)
+      throw ShaderUniformTypeError("Uniform block member type does not match uniform type.");
+
+    // Merge with the layout of previously registered programs. Differently
+    // named members sharing bytes of the buffer would overwrite each other.
+    GLint end = getMemberEnd(type, offsets[i], matrixStrides[i]);
+    bool found = false;
+    for (auto it = mMembers.begin(); it != mMembers.end(); ++it)
+    {
+      if (it->name == memberName)
+      {
+        if (it->offset != offsets[i] || it->type != type)
+        {
+          Log::error() << "Member '" << memberName << "' of uniform block "
+                       << getBlockName() << " differs between programs." << std::endl;
+          throw GLError("Inconsistent global uniform block layout.");
+        }
+        found = true;
+      }
+      else if (   offsets[i] < getMemberEnd(it->type, it->offset, it->matrixStride)
+               && it->offset < end)
+      {
+        Log::error() << "Member '" << memberName << "' of uniform block "
+                     << getBlockName() << " overlaps member '" << it->name
+                     << "' of another program." << std::endl;
+        throw GLError("Inconsistent global uniform block layout.");
+      }
+    }
+
+    if (found == false)
+    {
+      Member member;
+      member.name         = memberName;
+      member.uniformIndex = state->index;
+      member.type         = type;
+      member.offset       = offsets[i];
+      member.matrixStride = matrixStrides[i];
+      newMembers.push_back(member);
+    }
+  }
+
+  if (newMembers.empty() == false)
+  {
+    mMembers.insert(mMembers.end(), newMembers.begin(), newMembers.end());
+    mDirty = true;
+  }
+
+  if (static_cast<size_t>(blockSize) > mData.size())
+  {
+    mData.resize(static_cast<size_t>(blockSize), 0);
+    mDirty = true;
+  }
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+void GlobalUniformBlock::onGlobalUniformChanged(size_t uniformIndex)
+{
+  if (mDirty)
+    return;
+
+  for (auto it = mMembers.begin(); it != mMembers.end(); ++it)
+  {
+    if (it->uniformIndex == uniformIndex)
+    {
+      mDirty = true;
+      return;
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+void GlobalUniformBlock::packMember(const Member& member)
+{
+  const AbstractUniformStateItem* item =
+      mHub.getGlobalUniformStateMan().findGlobalUniform(member.uniformIndex);
+  if (item == nullptr)
+    throw ShaderUniformNotFound("Could not initialize uniform: " + member.name);
+
+  const float* data = reinterpret_cast<const float*>(item->getRawData());
+  if (data == nullptr)
+    throw UnsupportedException("Uniform '" + member.name + "' cannot be stored in a uniform block.");
+
+  // Uniform state items store tightly packed, column major data. std140
+  // pads every matrix column to matrixStride.
+  GLint columns, rows;
+  getTypeDimensions(member.type, columns, rows);
+  size_t columnSize = static_cast<size_t>(rows) * sizeof(float);
+  for (GLint c = 0; c < columns; ++c)
+  {
+    size_t dst = static_cast<size_t>(member.offset + c * member.matrixStride);
+    std::memcpy(&mData[dst], data + c * rows, columnSize);
+  }
+}
+
+//------------------------------------------------------------------------------
+void GlobalUniformBlock::flush()
+{
+  if (mDirty == false || mData.empty())
+    return;
+
+  for (auto it = mMembers.begin(); it != mMembers.end(); ++it)
+    packMember(*it);
+
+  if (mBuffer == 0)
+  {
+    GL(glGenBuffers(1, &mBuffer));
+    GL(glBindBufferBase(GL_UNIFORM_BUFFER, getBindingPoint(), mBuffer));
+  }
+
+  // Orphan the previous contents so we do not stall on draws that are still
+  // reading from the buffer.
+  GL(glBindBuffer(GL_UNIFORM_BUFFER, mBuffer));
+  GL(glBufferData(GL_UNIFORM_BUFFER, static_cast<GLsizeiptr>(mData.size()),
+                  &mData[0], GL_DYNAMIC_DRAW));
+
+  mDirty = false;
+}
+
+} // namespace CPM_SPIRE_NS
+
+#endif // SPIRE_USE_UBO
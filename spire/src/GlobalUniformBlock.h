@@ -0,0 +1,120 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2013 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+/// \author agent
+/// \date   October 2026
+
+#ifndef SPIRE_HIGH_GLOBALUNIFORMBLOCK_H
+#define SPIRE_HIGH_GLOBALUNIFORMBLOCK_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include "Common.h"
+
+#ifdef SPIRE_USE_UBO
+
+namespace CPM_SPIRE_NS {
+
+class Hub;
+
+/// std140 uniform buffer backing global uniforms in core profile builds.
+///
+/// Shaders opt in by declaring a uniform block named 'SpireGlobals' with the
+/// std140 layout (and no instance name), e.g.:
+///
+///   layout(std140) uniform SpireGlobals { mat4 uProjIVObject; };
+///
+/// Members of the block are set using the regular global uniform interface
+/// (Interface::addGlobalUniform). The block is bound to a fixed binding point
+/// shared by all programs and is uploaded at most once per change of any of
+/// its members, instead of once per program per draw. Block members cannot be
+/// overriden by pass or object uniforms.
+class GlobalUniformBlock
+{
+public:
+  GlobalUniformBlock(Hub& hub);
+  virtual ~GlobalUniformBlock();
+
+  /// Name of the uniform block in shader code.
+  static const char* getBlockName()   {return "SpireGlobals";}
+
+  /// Uniform buffer binding point the block is bound to in every program.
+  static GLuint getBindingPoint()     {return 0;}
+
+  /// Reflects the block (if present) in 'program', binds it to the global
+  /// binding point, and merges its layout with previously registered
+  /// programs. Returns true if the program uses the block.
+  /// Throws GLError if the block's layout differs between programs, or if
+  /// differently named members of different programs overlap.
+  bool registerProgram(GLuint program);
+
+  /// Returns true if the active uniform at 'activeUniformIndex' in 'program'
+  /// belongs to any uniform block. Block members have no uniform location
+  /// and cannot be set with glUniform*.
+  static bool isBlockMember(GLuint program, GLuint activeUniformIndex);
+
+  /// Should be called whenever a global uniform changes. Marks the block as
+  /// dirty if the uniform is a member of the block.
+  void onGlobalUniformChanged(size_t uniformIndex);
+
+  /// Packs global uniform state into the block and uploads it, if dirty.
+  /// Throws ShaderUniformNotFound if a block member has no global value.
+  void flush();
+
+  /// Size, in bytes, of the block.
+  size_t getBlockSize() const         {return mData.size();}
+
+private:
+
+  /// Single member of the block.
+  struct Member
+  {
+    std::string name;         ///< Code name of the member.
+    size_t      uniformIndex; ///< See UniformState::index.
+    GLenum      type;         ///< GL type of the member.
+    GLint       offset;       ///< std140 offset of the member.
+    GLint       matrixStride; ///< Stride between matrix columns.
+  };
+
+  /// Copies the value of 'member' from global uniform state into mData.
+  void packMember(const Member& member);
+
+  Hub&                  mHub;
+  std::vector<Member>   mMembers;   ///< All known members of the block.
+  std::vector<uint8_t>  mData;      ///< CPU copy of the block contents.
+  GLuint                mBuffer;    ///< GL uniform buffer (0 until first flush).
+  bool                  mDirty;     ///< True if mBuffer needs to be updated.
+};
+
+} // namespace CPM_SPIRE_NS
+
+#endif // SPIRE_USE_UBO
+
+#endif
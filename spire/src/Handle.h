@@ -0,0 +1,76 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2013 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+/// \author agent
+/// \date   October 2026
+
+#ifndef SPIRE_HIGH_HANDLE_H
+#define SPIRE_HIGH_HANDLE_H
+
+#include <cstdint>
+
+namespace CPM_SPIRE_NS {
+
+/// Lightweight reference to a resource stored in spire (see SlotMap). A
+/// handle becomes stale once its resource is removed; stale handles are
+/// detected and never alias a newer resource. Default constructed handles
+/// are invalid.
+/// 'Tag' only serves to make handles of different resource types distinct.
+template <typename Tag>
+struct Handle
+{
+  Handle() : index(0), generation(0)  {}
+  Handle(uint32_t slotIndex, uint32_t slotGeneration) :
+      index(slotIndex),
+      generation(slotGeneration)
+  {}
+
+  /// False for default constructed handles. Does not check for staleness.
+  bool isValid() const    {return generation != 0;}
+
+  bool operator==(const Handle& other) const
+  {return index == other.index && generation == other.generation;}
+  bool operator!=(const Handle& other) const  {return !(*this == other);}
+
+  uint32_t index;       ///< Slot index.
+  uint32_t generation;  ///< Generation of the slot when the handle was issued.
+};
+
+struct ObjectHandleTag  {};
+struct PassHandleTag    {};
+struct VBOHandleTag     {};
+struct IBOHandleTag     {};
+
+typedef Handle<ObjectHandleTag> ObjectHandle;
+typedef Handle<PassHandleTag>   PassHandle;
+typedef Handle<VBOHandleTag>    VBOHandle;
+typedef Handle<IBOHandleTag>    IBOHandle;
+
+} // namespace CPM_SPIRE_NS
+
+#endif
@@ -39,6 +39,13 @@
 #include "FileUtil.h"
 #include "InterfaceImplementation.h"
 #include "ShaderMan.h"
+#include "GLStateMan.h"
+#include "GLCaps.h"
+#include "BatchMan.h"
+#include "OcclusionMan.h"
+#include "UploadQueue.h"
+#include "StreamBuffer.h"
+#include "BufferArena.h"
 #include "ShaderAttributeMan.h"
 #include "ShaderProgramMan.h"
 #include "ShaderUniformStateMan.h"
@@ -56,12 +63,20 @@ Hub::Hub(std::shared_ptr<Context> context,
          Interface::LogFunction logFn) :
     mLogFun(logFn),
     mContext(context),
+    mGLStateMan(new GLStateMan()),
+    mGLCaps(new GLCaps()),
     mShaderMan(new ShaderMan(*this)),
     mShaderAttributes(new ShaderAttributeMan()),
     mShaderProgramMan(new ShaderProgramMan(*this)),
     mShaderUniforms(new ShaderUniformMan()),
     mShaderUniformStateMan(new ShaderUniformStateMan(*this)),
     mPassUniformStateMan(new PassUniformStateMan(*this)),
+    mBatchMan(new BatchMan(*this)),
+    mOcclusionMan(new OcclusionMan(*this)),
+    mUploadQueue(new UploadQueue(*this)),
+    mStreamBuffer(new StreamBuffer(*this)),
+    mVertexArena(new BufferArena(*this, GL_ARRAY_BUFFER)),
+    mIndexArena(new BufferArena(*this, GL_ELEMENT_ARRAY_BUFFER)),
     mShaderDirs(shaderDirs),
     mInterfaceImpl(new InterfaceImplementation(*this)),
     mPixScreenWidth(640),
@@ -50,6 +50,13 @@ class ShaderMan;
 class ShaderAttributeMan;
 class ShaderUniformMan;
 class ShaderProgramMan;
+class GLStateMan;
+class GLCaps;
+class BatchMan;
+class OcclusionMan;
+class UploadQueue;
+class StreamBuffer;
+class BufferArena;
 
 /// Central hub for the renderer.
 /// Most managers will reference this class in some way.
@@ -87,6 +94,30 @@ public:
   /// Retrieves the shader program manager.
   ShaderProgramMan& getShaderProgramManager()     {return *mShaderProgramMan;}
 
+  /// Retrieves the GL binding state manager.
+  GLStateMan& getGLStateManager()                 {return *mGLStateMan;}
+
+  /// Retrieves the version and extensions of the GL context.
+  GLCaps& getGLCaps()                             {return *mGLCaps;}
+
+  /// Retrieves the draw batch manager.
+  BatchMan& getBatchManager()                     {return *mBatchMan;}
+
+  /// Retrieves the occlusion culling manager.
+  OcclusionMan& getOcclusionManager()             {return *mOcclusionMan;}
+
+  /// Retrieves the geometry upload queue.
+  UploadQueue& getUploadQueue()                   {return *mUploadQueue;}
+
+  /// Retrieves the ring buffer holding streamed geometry.
+  StreamBuffer& getStreamBuffer()                 {return *mStreamBuffer;}
+
+  /// Retrieves the arenas small static VBOs / IBOs are sub-allocated from.
+  /// @{
+  BufferArena& getVertexArena()                   {return *mVertexArena;}
+  BufferArena& getIndexArena()                    {return *mIndexArena;}
+  /// @}
+
   /// Retrieves the actual screen width in pixels.
   size_t getActualScreenWidth() const             {return mPixScreenWidth;}
 
@@ -107,12 +138,20 @@ private:
   Interface::LogFunction              mLogFun;          ///< Log function.
   std::unique_ptr<Log>                mLog;             ///< Spire logging class.
   std::shared_ptr<Context>            mContext;         ///< Rendering context.
+  std::unique_ptr<GLStateMan>         mGLStateMan;      ///< GL binding state (must outlive all GL objects).
+  std::unique_ptr<GLCaps>             mGLCaps;          ///< GL version and extensions.
   std::unique_ptr<ShaderMan>          mShaderMan;       ///< Shader manager.
   std::unique_ptr<ShaderAttributeMan> mShaderAttributes;///< Shader attribute manager.
   std::unique_ptr<ShaderProgramMan>   mShaderProgramMan;///< Shader program manager.
   std::unique_ptr<ShaderUniformMan>   mShaderUniforms;  ///< Shader attribute manager.
   std::unique_ptr<ShaderUniformStateMan> mShaderUniformStateMan; ///< Uniform state manager.
   std::unique_ptr<PassUniformStateMan>mPassUniformStateMan;///< Shader manager for pass'.
+  std::unique_ptr<BatchMan>           mBatchMan;        ///< Merged draw batches.
+  std::unique_ptr<OcclusionMan>       mOcclusionMan;    ///< Occlusion queries.
+  std::unique_ptr<UploadQueue>        mUploadQueue;     ///< Must outlive all VBOs / IBOs.
+  std::unique_ptr<StreamBuffer>       mStreamBuffer;    ///< Must outlive all VBOs / IBOs.
+  std::unique_ptr<BufferArena>        mVertexArena;     ///< Must outlive all VBOs.
+  std::unique_ptr<BufferArena>        mIndexArena;      ///< Must outlive all IBOs.
   std::vector<std::string>            mShaderDirs;      ///< Shader directories to search.
 
   std::shared_ptr<InterfaceImplementation>  mInterfaceImpl; ///< Interface implementation.
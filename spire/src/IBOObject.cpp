@@ -29,35 +29,295 @@
 /// \author James Hughes
 /// \date   February 2013
 
+#include <stdexcept>
+
 #include "IBOObject.h"
+#include "Hub.h"
+#include "GLStateMan.h"
+#include "Log.h"
+#include "UploadQueue.h"
+#include "MeshOptimizer.h"
 
 namespace CPM_SPIRE_NS {
 
 IBOObject::IBOObject(std::shared_ptr<std::vector<uint8_t>> iboData,
-                     Interface::IBO_TYPE type)
+                     Interface::IBO_TYPE type, Hub& hub, GLenum usage) :
+    mHub(hub),
+    mOffset(0),
+    mStream(nullptr),
+    mStreamFrame(0),
+    mArenaAllocation(nullptr),
+    mUsage(usage),
+    mUpdated(false)
 {
-  buildIBOObject(&(*iboData)[0], iboData->size(), type);
+  buildIBOObject(&(*iboData)[0], iboData->size(), type, iboData);
 }
 
 IBOObject::IBOObject(const uint8_t* iboData, size_t iboDataSize,
-                     Interface::IBO_TYPE type)
+                     Interface::IBO_TYPE type, Hub& hub, GLenum usage) :
+    mHub(hub),
+    mOffset(0),
+    mStream(nullptr),
+    mStreamFrame(0),
+    mArenaAllocation(nullptr),
+    mUsage(usage),
+    mUpdated(false)
 {
-  buildIBOObject(iboData, iboDataSize, type);
+  std::shared_ptr<const std::vector<uint8_t>> queuedData;
+  if (hub.getUploadQueue().isEnabled())
+    queuedData = std::make_shared<std::vector<uint8_t>>(iboData, iboData + iboDataSize);
+  buildIBOObject(iboData, iboDataSize, type, queuedData);
+}
+
+IBOObject::IBOObject(Interface::IBO_TYPE type, Hub& hub) :
+    mHub(hub),
+    mGLIndex(0),
+    mNumElements(0),
+    mSize(0),
+    mResident(true),
+    mOffset(0),
+    mStream(&hub.getStreamBuffer()),
+    mStreamFrame(0),
+    mArenaAllocation(nullptr),
+    mUsage(GL_STREAM_DRAW),
+    mUpdated(false)
+{
+  switch (type)
+  {
+    case Interface::IBO_8BIT:   mType = GL_UNSIGNED_BYTE;   break;
+    case Interface::IBO_16BIT:  mType = GL_UNSIGNED_SHORT;  break;
+    case Interface::IBO_32BIT:  mType = GL_UNSIGNED_INT;    break;
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wunreachable-code"
+    default:
+      throw std::invalid_argument("IBO type expected to be of type Interface::IBO_TYPE.");
+#pragma clang diagnostic pop
+  }
 }
 
 IBOObject::~IBOObject()
 {
-  GL(glDeleteBuffers(1, &mGLIndex));
+  // Streamed IBOs do not own their buffer.
+  if (mStream != nullptr)
+    return;
+
+  if (mResident == false)
+    mHub.getUploadQueue().cancel(&mResident);
+
+  if (mArenaAllocation != nullptr)
+  {
+    mHub.getIndexArena().deallocate(mArenaAllocation);
+  }
+  else
+  {
+    mHub.getGLStateManager().onBufferDeleted(mGLIndex);
+    GL(glDeleteBuffers(1, &mGLIndex));
+  }
+  deleteLODs();
+}
+
+void IBOObject::deleteLODs()
+{
+  for (auto it = mLODs.begin(); it != mLODs.end(); ++it)
+  {
+    mHub.getGLStateManager().onBufferDeleted(it->glIndex);
+    GL(glDeleteBuffers(1, &it->glIndex));
+  }
+  mLODs.clear();
+}
+
+// Size in bytes of an index of GL type 'type'.
+static size_t getIndexSize(GLenum type)
+{
+  switch (type)
+  {
+    case GL_UNSIGNED_BYTE:  return sizeof(uint8_t);
+    case GL_UNSIGNED_SHORT: return sizeof(uint16_t);
+    default:                return sizeof(uint32_t);
+  }
+}
+
+void IBOObject::generateLODs(std::shared_ptr<const std::vector<uint8_t>> iboData,
+                             std::shared_ptr<const std::vector<uint8_t>> vboData,
+                             size_t stride, size_t positionOffset)
+{
+  if (mStream != nullptr)
+    throw std::invalid_argument("LODs cannot be generated for streamed IBOs.");
+  if (mNumElements % 3 != 0)
+    throw std::invalid_argument("LODs can only be generated for triangle lists.");
+  if (stride == 0 || positionOffset + 3 * sizeof(float) > stride)
+    throw std::invalid_argument("Invalid vertex layout for LOD generation.");
+
+  // Wait for any previous generation before starting over.
+  if (mPendingLODs.valid())
+    mPendingLODs.wait();
+
+  size_t indexSize = getIndexSize(mType);
+  GLuint numElements = mNumElements;
+  mPendingLODs = std::async(std::launch::async,
+      [iboData, vboData, stride, positionOffset, indexSize, numElements]()
+      {
+        std::vector<uint32_t> indices;
+        widenIndices(iboData->data(), numElements, indexSize, indices);
+        return buildLODChain(vboData->data(), vboData->size() / stride, stride,
+                             positionOffset, indices, MaxLODs, MinLODTriangles);
+      });
+}
+
+bool IBOObject::updateLODs()
+{
+  if (mPendingLODs.valid() == false)
+    return false;
+  if (mPendingLODs.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+    return true;
+
+  std::vector<LODLevel> levels;
+  try
+  {
+    levels = mPendingLODs.get();
+  }
+  catch (const std::exception& e)
+  {
+    Log::error() << "Failed to generate LODs: " << e.what() << std::endl;
+    return false;
+  }
+
+  deleteLODs();
+
+  // Levels keep the index type of the full IBO.
+  std::vector<uint8_t> narrowed;
+  for (auto it = levels.begin(); it != levels.end(); ++it)
+  {
+    const std::vector<uint32_t>& indices = it->indices;
+    const uint8_t* data = reinterpret_cast<const uint8_t*>(indices.data());
+    size_t size = indices.size() * sizeof(uint32_t);
+    if (mType != GL_UNSIGNED_INT)
+    {
+      narrowIndices(indices, getIndexSize(mType), narrowed);
+      data = narrowed.data();
+      size = narrowed.size();
+    }
+
+    LOD lod;
+    lod.numElements = static_cast<GLuint>(indices.size());
+    lod.error = it->error;
+    GL(glGenBuffers(1, &lod.glIndex));
+#ifdef SPIRE_USE_VAO
+    mHub.getGLStateManager().bindArrayBuffer(lod.glIndex);
+    GL(glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(size), data,
+                    GL_STATIC_DRAW));
+#else
+    mHub.getGLStateManager().bindElementArrayBuffer(lod.glIndex);
+    GL(glBufferData(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLsizeiptr>(size), data,
+                    GL_STATIC_DRAW));
+#endif
+    mLODs.push_back(lod);
+  }
+
+  return false;
+}
+
+void IBOObject::update(size_t offset, const uint8_t* data, size_t size)
+{
+  if (mStream != nullptr)
+    throw std::invalid_argument("Streamed IBOs are written with writeStream.");
+  if (offset > mSize || size > mSize - offset)
+    throw std::out_of_range("IBO update exceeds the size of the IBO.");
+
+  mUpdates.add(offset, data, size);
+  mUpdated = true;
+
+  // A chain being generated from the old indices is discarded as well.
+  if (mPendingLODs.valid())
+  {
+    mPendingLODs.wait();
+    mPendingLODs = std::future<std::vector<LODLevel>>();
+  }
+  deleteLODs();
+}
+
+void IBOObject::uploadUpdates()
+{
+  if (mResident == false)
+    return;
+
+#ifdef SPIRE_USE_VAO
+  // See buildIBOObject.
+  mHub.getGLStateManager().bindArrayBuffer(mGLIndex);
+  mUpdates.upload(GL_ARRAY_BUFFER, mOffset, mSize, mUsage, mArenaAllocation == nullptr);
+#else
+  mHub.getGLStateManager().bindElementArrayBuffer(mGLIndex);
+  mUpdates.upload(GL_ELEMENT_ARRAY_BUFFER, mOffset, mSize, mUsage, mArenaAllocation == nullptr);
+#endif
+}
+
+uint8_t* IBOObject::writeStream(size_t size)
+{
+  if (mStream == nullptr)
+    throw std::invalid_argument("Only streamed IBOs can be written with writeStream.");
+
+  size_t indexSize = 4;
+  if (mType == GL_UNSIGNED_BYTE)
+    indexSize = 1;
+  else if (mType == GL_UNSIGNED_SHORT)
+    indexSize = 2;
+
+  uint8_t* data = mStream->allocate(size, mOffset);
+  mGLIndex      = mStream->getGLIndex();
+  mSize         = size;
+  mNumElements  = static_cast<GLuint>(size / indexSize);
+  mStreamFrame  = mStream->getFrame();
+  return data;
+}
+
+size_t IBOObject::selectLOD(float pixelsPerUnit, float maxPixelError) const
+{
+  // Errors grow with each level.
+  size_t lod = 0;
+  while (lod < mLODs.size() && mLODs[lod].error * pixelsPerUnit <= maxPixelError)
+    ++lod;
+  return lod;
 }
 
 
 void IBOObject::buildIBOObject(const uint8_t* iboData, size_t iboDataSize,
-                               Interface::IBO_TYPE type)
+                               Interface::IBO_TYPE type,
+                               std::shared_ptr<const std::vector<uint8_t>> queuedData)
 {
-  GL(glGenBuffers(1, &mGLIndex));
-  GL(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mGLIndex));
-  GL(glBufferData(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLsizeiptr>(iboDataSize),
-                  iboData, GL_STATIC_DRAW));
+  UploadQueue& uploads = mHub.getUploadQueue();
+  mResident = (queuedData == nullptr || uploads.isEnabled() == false);
+
+  // Dynamic IBOs keep their own buffer so that updates may orphan it.
+  if (mUsage == GL_STATIC_DRAW)
+    mArenaAllocation = mHub.getIndexArena().allocate(iboDataSize, &mGLIndex, &mOffset);
+  if (mArenaAllocation == nullptr)
+    GL(glGenBuffers(1, &mGLIndex));
+
+#ifdef SPIRE_USE_VAO
+  // The element array binding is part of the bound VAO's state. Upload
+  // through GL_ARRAY_BUFFER so we don't clobber the IBO of some pass' VAO.
+  const GLenum target = GL_ARRAY_BUFFER;
+  mHub.getGLStateManager().bindArrayBuffer(mGLIndex);
+#else
+  const GLenum target = GL_ELEMENT_ARRAY_BUFFER;
+  mHub.getGLStateManager().bindElementArrayBuffer(mGLIndex);
+#endif
+  if (mArenaAllocation != nullptr)
+  {
+    if (mResident)
+    {
+      GL(glBufferSubData(target, static_cast<GLintptr>(mOffset),
+                         static_cast<GLsizeiptr>(iboDataSize), iboData));
+    }
+  }
+  else
+  {
+    GL(glBufferData(target, static_cast<GLsizeiptr>(iboDataSize),
+                    mResident ? iboData : NULL, mUsage));
+  }
+  if (mResident == false)
+    uploads.enqueue(mGLIndex, target, mOffset, queuedData, &mResident);
+  mSize = iboDataSize;
 
   // Calculate number of elements based on the IBO type.
   switch (type)
@@ -34,12 +34,19 @@
 
 #include <vector>
 #include <memory>
+#include <future>
 
 #include "Common.h"
 #include "../Interface.h"
+#include "MeshSimplifier.h"
+#include "BufferUpdates.h"
+#include "StreamBuffer.h"
+#include "BufferArena.h"
 
 namespace CPM_SPIRE_NS {
 
+class Hub;
+
 /// Object that encapsulates an OpenGL index buffer. The buffer will be
 /// automatically deleted by IBOObject's destructor.
 class IBOObject
@@ -47,23 +54,124 @@ class IBOObject
 public:
   // This constructor delegates to the raw version below.
   IBOObject(std::shared_ptr<std::vector<uint8_t>> iboData,
-            Interface::IBO_TYPE type);
-
-  IBOObject(const uint8_t* iboData, size_t iboDataSize, Interface::IBO_TYPE type);
+            Interface::IBO_TYPE type, Hub& hub, GLenum usage = GL_STATIC_DRAW);
+
+  /// If the upload queue is enabled (see UploadQueue), the data is copied and
+  /// uploaded over the following frames. 'usage' is the GL usage hint. Small
+  /// static IBOs are sub-allocated from the index arena if it is enabled
+  /// (see BufferArena).
+  IBOObject(const uint8_t* iboData, size_t iboDataSize, Interface::IBO_TYPE type,
+            Hub& hub, GLenum usage = GL_STATIC_DRAW);
+
+  /// Creates a streamed IBO, whose indices are written to the stream buffer
+  /// (see StreamBuffer) every frame with writeStream.
+  IBOObject(Interface::IBO_TYPE type, Hub& hub);
   ~IBOObject();
 
   GLuint getGLIndex() const               {return mGLIndex;}
   GLuint getNumElements() const           {return mNumElements;}
   GLenum getType() const                  {return mType;}
+  size_t getSize() const                  {return mSize;}
+
+  /// False while the IBO's contents are waiting in the upload queue, or if
+  /// the IBO is streamed and was not written during the current frame.
+  bool isResident() const
+  {
+    return mResident && (mStream == nullptr || mStreamFrame == mStream->getFrame());
+  }
+
+  /// Byte offset of the indices within the GL buffer. Only streamed and
+  /// sub-allocated IBOs have a non-zero offset. See getOffset(lod) for LODs.
+  size_t getOffset() const                {return mOffset;}
+
+  /// Allocates 'size' bytes in the stream buffer for the current frame and
+  /// returns a pointer to write the indices to (see StreamBuffer::allocate).
+  /// Throws std::invalid_argument if the IBO is not streamed.
+  uint8_t* writeStream(size_t size);
+  bool isStreamed() const                 {return mStream != nullptr;}
+
+  /// Replaces 'size' bytes starting at byte 'offset' with 'data'. The change
+  /// is uploaded by the next call to flushUpdates. Discards the LOD chain,
+  /// which no longer matches the indices. Throws std::out_of_range if the
+  /// range exceeds the IBO.
+  void update(size_t offset, const uint8_t* data, size_t size);
+
+  /// Uploads the changes made by update. Must be called on the GL thread.
+  void flushUpdates()                     {if (mUpdates.empty() == false) uploadUpdates();}
+
+  /// True if the IBO was created with GL_STATIC_DRAW and never updated.
+  bool isStatic() const                   {return mUsage == GL_STATIC_DRAW && mUpdated == false;}
+
+  /// Starts building a chain of simplified versions of the IBO on a worker
+  /// thread (see buildLODChain). 'iboData' holds the contents of this IBO,
+  /// which must be a triangle list, and 'vboData' the vertices it indexes.
+  /// Positions are 3 floats, 'positionOffset' bytes into each 'stride' byte
+  /// vertex. The buffers must not be modified while the worker runs.
+  /// Destroying the IBO waits for the worker to finish.
+  void generateLODs(std::shared_ptr<const std::vector<uint8_t>> iboData,
+                    std::shared_ptr<const std::vector<uint8_t>> vboData,
+                    size_t stride, size_t positionOffset);
+
+  /// Uploads the LOD chain once the worker has finished. Returns true while
+  /// the chain is still being generated. Must be called on the GL thread.
+  bool updateLODs();
+
+  /// Number of levels of detail, including the full IBO (level 0).
+  size_t getNumLODs() const               {return 1 + mLODs.size();}
+
+  /// GL buffer, byte offset within it and number of indices of level 'lod'.
+  /// Levels 1 and up have buffers of their own, starting at 0.
+  /// @{
+  GLuint getGLIndex(size_t lod) const     {return lod == 0 ? mGLIndex : mLODs[lod - 1].glIndex;}
+  size_t getOffset(size_t lod) const      {return lod == 0 ? mOffset : 0;}
+  GLuint getNumElements(size_t lod) const {return lod == 0 ? mNumElements : mLODs[lod - 1].numElements;}
+  /// @}
+
+  /// Returns the coarsest level whose error is at most 'maxPixelError' pixels
+  /// when one unit of object space covers 'pixelsPerUnit' pixels.
+  size_t selectLOD(float pixelsPerUnit, float maxPixelError) const;
+
+  /// Limits of the generated LOD chains.
+  static const size_t MaxLODs         = 8;
+  static const size_t MinLODTriangles = 256;
 
 private:
 
+  struct LOD
+  {
+    GLuint  glIndex;
+    GLuint  numElements;
+    float   error;        ///< Object space error, see MeshSimplifier::getError.
+  };
+
+  /// Uploads 'iboData', or queues 'queuedData' (which holds the same
+  /// contents) for upload if it is given and the upload queue is enabled.
   void buildIBOObject(const uint8_t* iboData, size_t iboDataSize,
-                      Interface::IBO_TYPE type);
+                      Interface::IBO_TYPE type,
+                      std::shared_ptr<const std::vector<uint8_t>> queuedData);
+
+  /// Uploads mUpdates once the IBO is resident.
+  void uploadUpdates();
+
+  /// Deletes the LOD buffers.
+  void deleteLODs();
 
+  Hub&                      mHub;        ///< Hub, used for binding the buffer.
   GLuint                    mGLIndex;    ///< Corresponds to the map index but obtained from OpenGL.
   GLuint                    mNumElements;///< Number of elements in the IBO.
   GLenum                    mType;       ///< Type of index buffer.
+  size_t                    mSize;       ///< Size of the IBO in bytes.
+  bool                      mResident;   ///< See isResident.
+  size_t                    mOffset;     ///< See getOffset.
+  StreamBuffer*             mStream;     ///< Non-null for streamed IBOs.
+  uint64_t                  mStreamFrame;///< Frame in which the IBO was last written.
+  BufferArena::Allocation*  mArenaAllocation; ///< Non-null if sub-allocated.
+  GLenum                    mUsage;      ///< GL usage hint.
+  bool                      mUpdated;    ///< True once update has been called.
+  BufferUpdates             mUpdates;    ///< Changes not uploaded yet.
+
+  std::vector<LOD>                        mLODs;        ///< Levels 1 and up.
+  std::future<std::vector<LODLevel>>      mPendingLODs; ///< Valid while generating.
 };
 
 } // namespace CPM_SPIRE_NS
@@ -29,10 +29,19 @@
 /// \author James Hughes
 /// \date   February 2013
 
+#include <limits>
+
 #include "Hub.h"
 #include "InterfaceImplementation.h"
 #include "SpireObject.h"
 #include "Exceptions.h"
+#include "BatchMan.h"
+#include "OcclusionMan.h"
+#include "Bounds.h"
+#include "ShaderUniformMan.h"
+#include "ShaderAttributeMan.h"
+#include "WorkerPool.h"
+#include "StreamBuffer.h"
 
 /// Remove types as we move away from making spire a one-stop-shop for OpenGL.
 /// Spire will only solve one uinque problem in terms of gathering shaders
@@ -52,167 +61,687 @@ GLenum getGLPrimitive(Interface::PRIMITIVE_TYPES type);
 
 //------------------------------------------------------------------------------
 InterfaceImplementation::InterfaceImplementation(Hub& hub) :
+    mSceneGeneration(1),
+    mNumRecordedBuffers(0),
+    mNumCulledPasses(0),
+    mNumRenderedPasses(0),
+    mNumRenderListBuilds(0),
+    mLODPixelError(1.0f),
+    mSmallFeaturePixels(0.0f),
     mHub(hub)
 {}
 
+//------------------------------------------------------------------------------
+InterfaceImplementation::~InterfaceImplementation()
+{
+}
+
 //------------------------------------------------------------------------------
 void InterfaceImplementation::clearGLResources()
 {
+  mObjects.clear();
   mNameToObject.clear();
   mPersistentShaders.clear();
-  mVBOMap.clear();
-  mIBOMap.clear();
+  mVBOs.clear();
+  mNameToVBO.clear();
+  mIBOs.clear();
+  mNameToIBO.clear();
+  invalidateRenderLists();
 }
 
 //------------------------------------------------------------------------------
 std::shared_ptr<SpireObject>
 InterfaceImplementation::getObjectWithName(const std::string& name) const
 {
-  return mNameToObject.at(name);
+  return mObjects.at(mNameToObject.at(name));
+}
+
+//------------------------------------------------------------------------------
+std::shared_ptr<SpireObject>
+InterfaceImplementation::getObject(ObjectHandle object) const
+{
+  return mObjects.at(object);
+}
+
+//------------------------------------------------------------------------------
+ObjectHandle InterfaceImplementation::getObjectHandle(const std::string& object) const
+{
+  return mNameToObject.at(object);
+}
+
+//------------------------------------------------------------------------------
+VBOHandle InterfaceImplementation::getVBOHandle(const std::string& vboName) const
+{
+  return mNameToVBO.at(vboName);
+}
+
+//------------------------------------------------------------------------------
+IBOHandle InterfaceImplementation::getIBOHandle(const std::string& iboName) const
+{
+  return mNameToIBO.at(iboName);
+}
+
+//------------------------------------------------------------------------------
+PassHandle InterfaceImplementation::getPassHandle(const std::string& pass) const
+{
+  size_t passIndex;
+  if (mHub.getPassUniformStateMan().findPassIndex(pass, passIndex) == false)
+    throw std::out_of_range("Pass has not been added: " + pass);
+
+  // Pass indices are never recycled, a single generation suffices.
+  return PassHandle(static_cast<uint32_t>(passIndex), 1);
+}
+
+//------------------------------------------------------------------------------
+PassHandle InterfaceImplementation::addPass(const std::string& pass)
+{
+  size_t passIndex = mHub.getPassUniformStateMan().addPass(pass);
+  return PassHandle(static_cast<uint32_t>(passIndex), 1);
+}
+
+//------------------------------------------------------------------------------
+size_t InterfaceImplementation::getPassIndex(PassHandle pass)
+{
+  if (pass.isValid() == false)
+    throw std::invalid_argument("Invalid pass handle.");
+  return pass.index;
 }
 
 //------------------------------------------------------------------------------
-void InterfaceImplementation::addObject(std::string objectName)
+ObjectHandle InterfaceImplementation::addObject(const std::string& objectName)
 {
   if (mNameToObject.find(objectName) != mNameToObject.end())
     throw Duplicate("There already exists an object by that name!");
 
   std::shared_ptr<SpireObject> obj = std::shared_ptr<SpireObject>(
       new SpireObject(mHub, objectName));
-  mNameToObject[objectName] = obj;
+  ObjectHandle handle = mObjects.insert(obj);
+  mNameToObject[objectName] = handle;
+  invalidateRenderLists();
+  return handle;
 }
 
 //------------------------------------------------------------------------------
-void InterfaceImplementation::removeObject(std::string objectName)
+void InterfaceImplementation::removeObject(const std::string& objectName)
 {
-  if (mNameToObject.find(objectName) == mNameToObject.end())
+  auto it = mNameToObject.find(objectName);
+  if (it == mNameToObject.end())
     throw std::range_error("Object to remove does not exist!");
 
-  std::shared_ptr<SpireObject> obj = mNameToObject.at(objectName);
-  mNameToObject.erase(objectName);
+  removeObject(it->second);
+}
+
+//------------------------------------------------------------------------------
+void InterfaceImplementation::removeObject(ObjectHandle object)
+{
+  // Keep the object alive until it is no longer referenced by either map.
+  std::shared_ptr<SpireObject> obj = mObjects.at(object);
+  mObjects.erase(object);
+  mNameToObject.erase(obj->getName());
+  invalidateRenderLists();
 }
 
 //------------------------------------------------------------------------------
 void InterfaceImplementation::removeAllObjects()
 {
+  mObjects.clear();
   mNameToObject.clear();
+  invalidateRenderLists();
+}
+
+//------------------------------------------------------------------------------
+VBOHandle InterfaceImplementation::addVBO(const std::string& vboName,
+                                          std::shared_ptr<std::vector<uint8_t>> vboData,
+                                          const std::vector<std::string>& attribNames,
+                                          Interface::BUFFER_USAGE usage)
+{
+  return addConcurrentVBO(vboName, &(*vboData)[0], vboData->size(), attribNames, usage);
 }
 
 //------------------------------------------------------------------------------
-void InterfaceImplementation::addVBO(std::string vboName,
-                                     std::shared_ptr<std::vector<uint8_t>> vboData,
-                                     std::vector<std::string> attribNames)
+VBOHandle InterfaceImplementation::addConcurrentVBO(
+    const std::string& vboName, const uint8_t* vboData, size_t vboSize,
+    const std::vector<std::string>& attribNames, Interface::BUFFER_USAGE usage)
 {
-  if (mVBOMap.find(vboName) != mVBOMap.end())
+  if (mNameToVBO.find(vboName) != mNameToVBO.end())
     throw Duplicate("Attempting to add duplicate VBO to object.");
 
-  mVBOMap.insert(std::make_pair(
-          vboName, std::shared_ptr<VBOObject>(
-              new VBOObject(vboData, attribNames, mHub.getShaderAttributeManager()))));
+  std::shared_ptr<VBOObject> vbo(new VBOObject(vboData, vboSize, attribNames, mHub,
+                                               getGLUsage(usage)));
+  VBOHandle handle = mVBOs.insert(NamedBuffer<VBOObject>(vboName, vbo));
+  mNameToVBO[vboName] = handle;
+  return handle;
 }
 
 //------------------------------------------------------------------------------
-void InterfaceImplementation::addConcurrentVBO(
-    const std::string& vboName, const uint8_t* vboData, size_t vboSize,
-    const std::vector<std::string>& attribNames)
+VBOHandle InterfaceImplementation::addStreamVBO(const std::string& vboName,
+                                                const std::vector<std::string>& attribNames)
 {
-  if (mVBOMap.find(vboName) != mVBOMap.end())
+  if (mNameToVBO.find(vboName) != mNameToVBO.end())
     throw Duplicate("Attempting to add duplicate VBO to object.");
 
-  mVBOMap.insert(std::make_pair(
-          vboName, std::shared_ptr<VBOObject>(
-              new VBOObject(vboData, vboSize, attribNames, 
-                            mHub.getShaderAttributeManager()))));
+  std::shared_ptr<VBOObject> vbo(new VBOObject(attribNames, mHub));
+  VBOHandle handle = mVBOs.insert(NamedBuffer<VBOObject>(vboName, vbo));
+  mNameToVBO[vboName] = handle;
+  return handle;
+}
+
+//------------------------------------------------------------------------------
+uint8_t* InterfaceImplementation::writeStreamVBO(VBOHandle vbo, size_t size)
+{
+  return mVBOs.at(vbo).buffer->writeStream(size);
 }
 
 //------------------------------------------------------------------------------
-void InterfaceImplementation::removeVBO(std::string vboName)
+void InterfaceImplementation::removeVBO(const std::string& vboName)
 {
-  size_t numElementsRemoved = mVBOMap.erase(vboName);
-  if (numElementsRemoved == 0)
+  auto it = mNameToVBO.find(vboName);
+  if (it == mNameToVBO.end())
     throw std::out_of_range("Could not find VBO to remove.");
+
+  removeVBO(it->second);
 }
 
 //------------------------------------------------------------------------------
-void InterfaceImplementation::addIBO(std::string iboName,
-                                     std::shared_ptr<std::vector<uint8_t>> iboData,
-                                     Interface::IBO_TYPE type)
+void InterfaceImplementation::removeVBO(VBOHandle vbo)
 {
-  if (mIBOMap.find(iboName) != mIBOMap.end())
-    throw Duplicate("Attempting to add duplicate IBO to object.");
+  std::string name = mVBOs.at(vbo).name;
+  mVBOs.erase(vbo);
+  mNameToVBO.erase(name);
+  invalidateRenderLists();
+}
 
-  mIBOMap.insert(std::make_pair(
-          iboName, std::shared_ptr<IBOObject>(new IBOObject(iboData, type))));
+//------------------------------------------------------------------------------
+void InterfaceImplementation::updateVBO(VBOHandle vboHandle, size_t offset,
+                                        const uint8_t* data, size_t size)
+{
+  mVBOs.at(vboHandle).buffer->update(offset, data, size);
 }
 
 //------------------------------------------------------------------------------
-void InterfaceImplementation::addConcurrentIBO(
+IBOHandle InterfaceImplementation::addIBO(const std::string& iboName,
+                                          std::shared_ptr<std::vector<uint8_t>> iboData,
+                                          Interface::IBO_TYPE type,
+                                          Interface::BUFFER_USAGE usage)
+{
+  return addConcurrentIBO(iboName, &(*iboData)[0], iboData->size(), type, usage);
+}
+
+//------------------------------------------------------------------------------
+IBOHandle InterfaceImplementation::addConcurrentIBO(
     const std::string& iboName, const uint8_t* iboData, size_t iboSize,
-    Interface::IBO_TYPE type)
+    Interface::IBO_TYPE type, Interface::BUFFER_USAGE usage)
+{
+  if (mNameToIBO.find(iboName) != mNameToIBO.end())
+    throw Duplicate("Attempting to add duplicate IBO to object.");
+
+  std::shared_ptr<IBOObject> ibo(new IBOObject(iboData, iboSize, type, mHub,
+                                               getGLUsage(usage)));
+  IBOHandle handle = mIBOs.insert(NamedBuffer<IBOObject>(iboName, ibo));
+  mNameToIBO[iboName] = handle;
+  return handle;
+}
+
+//------------------------------------------------------------------------------
+IBOHandle InterfaceImplementation::addStreamIBO(const std::string& iboName,
+                                                Interface::IBO_TYPE type)
 {
-  if (mIBOMap.find(iboName) != mIBOMap.end())
+  if (mNameToIBO.find(iboName) != mNameToIBO.end())
     throw Duplicate("Attempting to add duplicate IBO to object.");
 
-  mIBOMap.insert(std::make_pair(
-          iboName, std::shared_ptr<IBOObject>(new IBOObject(iboData, iboSize, type))));
+  std::shared_ptr<IBOObject> ibo(new IBOObject(type, mHub));
+  IBOHandle handle = mIBOs.insert(NamedBuffer<IBOObject>(iboName, ibo));
+  mNameToIBO[iboName] = handle;
+  return handle;
+}
+
+//------------------------------------------------------------------------------
+uint8_t* InterfaceImplementation::writeStreamIBO(IBOHandle ibo, size_t size)
+{
+  return mIBOs.at(ibo).buffer->writeStream(size);
+}
+
+//------------------------------------------------------------------------------
+size_t InterfaceImplementation::compactBufferArenas()
+{
+  size_t released = mHub.getVertexArena().compact()
+                  + mHub.getIndexArena().compact();
+
+  // Render lists are sorted by GL buffer, which moved.
+  if (released > 0)
+    invalidateRenderLists();
+  return released;
+}
+
+//------------------------------------------------------------------------------
+void InterfaceImplementation::generateIBOLODs(
+    const std::string& iboName, std::shared_ptr<std::vector<uint8_t>> iboData,
+    std::shared_ptr<std::vector<uint8_t>> vboData,
+    const std::vector<std::string>& attribNames)
+{
+  std::shared_ptr<IBOObject> ibo = mIBOs.at(getIBOHandle(iboName)).buffer;
+  if (iboData->size() != ibo->getSize())
+    throw std::invalid_argument("IBO data does not match the IBO's size.");
+
+  size_t stride;
+  size_t positionOffset;
+  getPositionLayout(attribNames, stride, positionOffset);
+
+  ibo->generateLODs(iboData, vboData, stride, positionOffset);
+  mPendingLODs.push_back(ibo);
 }
 
 //------------------------------------------------------------------------------
-void InterfaceImplementation::removeIBO(std::string iboName)
+size_t InterfaceImplementation::getNumIBOLODs(const std::string& iboName) const
 {
-  size_t numElementsRemoved = mIBOMap.erase(iboName);
-  if (numElementsRemoved == 0)
+  return mIBOs.at(getIBOHandle(iboName)).buffer->getNumLODs();
+}
+
+//------------------------------------------------------------------------------
+void InterfaceImplementation::getPositionLayout(
+    const std::vector<std::string>& attribNames, size_t& stride,
+    size_t& positionOffset) const
+{
+  ShaderAttributeCollection attributes(mHub.getShaderAttributeManager());
+  for (auto it = attribNames.begin(); it != attribNames.end(); ++it)
+    attributes.addAttribute(*it);
+
+  AttribState position;
+  if (   attributes.findAttribute(VBOObject::getPositionAttributeName(), position, positionOffset) == false
+      || position.type != Interface::TYPE_FLOAT
+      || position.numComponents < 3)
+    throw std::invalid_argument("Vertices require a float 'aPos' attribute.");
+
+  stride = attributes.calculateStride();
+}
+
+//------------------------------------------------------------------------------
+void InterfaceImplementation::removeIBO(const std::string& iboName)
+{
+  auto it = mNameToIBO.find(iboName);
+  if (it == mNameToIBO.end())
     throw std::out_of_range("Could not find IBO to remove.");
+
+  removeIBO(it->second);
 }
 
 //------------------------------------------------------------------------------
-void InterfaceImplementation::addPassToObject(
-    std::string object, std::string program, std::string vboName,
-    std::string iboName, Interface::PRIMITIVE_TYPES type, std::string pass,
-    std::string parentPass)
+void InterfaceImplementation::removeIBO(IBOHandle ibo)
 {
-  std::shared_ptr<SpireObject> obj = mNameToObject.at(object);
-  std::shared_ptr<VBOObject> vbo = mVBOMap.at(vboName);
-  std::shared_ptr<IBOObject> ibo = mIBOMap.at(iboName);
+  std::string name = mIBOs.at(ibo).name;
+  mIBOs.erase(ibo);
+  mNameToIBO.erase(name);
+  invalidateRenderLists();
+}
 
-  // The 'responsiblePass' must exist. It is under this pass in which objects
-  // will be rendered.
-  std::string responsiblePass = pass;
+//------------------------------------------------------------------------------
+void InterfaceImplementation::updateIBO(IBOHandle ibo, size_t offset,
+                                        const uint8_t* data, size_t size)
+{
+  mIBOs.at(ibo).buffer->update(offset, data, size);
+}
+
+//------------------------------------------------------------------------------
+PassHandle InterfaceImplementation::addPassToObject(
+    const std::string& object, const std::string& program, const std::string& vboName,
+    const std::string& iboName, Interface::PRIMITIVE_TYPES type, const std::string& pass,
+    const std::string& parentPass)
+{
+  PassHandle parentPassHandle;
   if (parentPass.size() > 0)
-    responsiblePass = parentPass;
+    parentPassHandle = addPass(parentPass);
 
-  obj->addPass(pass, program, vbo, ibo, getGLPrimitive(type), parentPass);
+  return addPassToObject(getObjectHandle(object), program, getVBOHandle(vboName),
+                         getIBOHandle(iboName), type, addPass(pass),
+                         parentPassHandle);
 }
 
+//------------------------------------------------------------------------------
+PassHandle InterfaceImplementation::addPassToObject(
+    ObjectHandle object, const std::string& program, VBOHandle vboHandle,
+    IBOHandle iboHandle, Interface::PRIMITIVE_TYPES type, PassHandle pass,
+    PassHandle parentPass)
+{
+  std::shared_ptr<SpireObject> obj = mObjects.at(object);
+  std::shared_ptr<VBOObject> vbo = mVBOs.at(vboHandle).buffer;
+  std::shared_ptr<IBOObject> ibo = mIBOs.at(iboHandle).buffer;
+
+  // An invalid parent pass handle indicates there is no parent pass.
+  const PassUniformStateMan& passMan = mHub.getPassUniformStateMan();
+  std::string parentPassName;
+  if (parentPass.isValid())
+    parentPassName = passMan.getPassName(getPassIndex(parentPass));
+
+  obj->addPass(passMan.getPassName(getPassIndex(pass)), program, vbo, ibo,
+               getGLPrimitive(type), parentPassName);
+  invalidateRenderLists();
+  return pass;
+}
 
 //------------------------------------------------------------------------------
-void InterfaceImplementation::removePassFromObject(std::string object, std::string pass)
+void InterfaceImplementation::renderPass(const std::string& pass)
 {
-  std::shared_ptr<SpireObject> obj = mNameToObject.at(object);
+  // No object can contain a pass that was never added.
+  size_t passIndex;
+  if (mHub.getPassUniformStateMan().findPassIndex(pass, passIndex))
+    renderPass(PassHandle(static_cast<uint32_t>(passIndex), 1));
+}
+
+//------------------------------------------------------------------------------
+void InterfaceImplementation::renderPass(PassHandle pass)
+{
+  // Replay the pass' render list. Culling below works on a copy.
+  getRenderList(getPassIndex(pass)).copyPasses(mGatheredPasses);
+
+  // Streamed geometry written since the last pass must reach GL first.
+  mHub.getStreamBuffer().flush();
+
+  // Pick up LOD chains finished by worker threads.
+  for (auto it = mPendingLODs.begin(); it != mPendingLODs.end();)
+  {
+    std::shared_ptr<IBOObject> ibo = it->lock();
+    if (ibo == nullptr || ibo->updateLODs() == false)
+      it = mPendingLODs.erase(it);
+    else
+      ++it;
+  }
+
+  // Culling, LOD selection, and sort keys. Possibly on worker threads.
+  recordGatheredPasses();
+
+  // Execute the command buffers in order. Occlusion queries, batching, and
+  // rendering involve GL and stay on this thread. Passes that can be merged
+  // into draw batches are rendered by the batch manager, the rest go through
+  // the render queue.
+  OcclusionMan& occlusion = mHub.getOcclusionManager();
+  occlusion.beginFrame();
+  BatchMan& batches = mHub.getBatchManager();
+  batches.beginFrame();
+
+  mRenderQueue.clear();
+  mNumCulledPasses = 0;
+  mNumRenderedPasses = 0;
+  for (size_t i = 0; i < mNumRecordedBuffers; ++i)
+  {
+    const CommandBuffer& buffer = mCommandBuffers[i];
+    mNumCulledPasses += buffer.getNumCulled();
+
+    const std::vector<DrawCommand>& draws = buffer.getDraws();
+    for (auto it = draws.begin(); it != draws.end(); ++it)
+    {
+      if (   it->projIVObject != nullptr && occlusion.isEnabled()
+          && occlusion.testPass(it->pass, it->projIVObject->getData<M44>()) == false)
+      {
+        ++mNumCulledPasses;
+        continue;
+      }
+
+      ++mNumRenderedPasses;
+      if (batches.addPass(it->pass) == false)
+        mRenderQueue.addPass(it->pass, it->sortKey);
+    }
+  }
+
+  mRenderQueue.render();
+  batches.render();
+
+  // Query the occluded and candidate passes against what was just drawn.
+  occlusion.renderProxies();
+}
+
+//------------------------------------------------------------------------------
+void InterfaceImplementation::compileRenderList(PassHandle pass)
+{
+  getRenderList(getPassIndex(pass));
+}
+
+//------------------------------------------------------------------------------
+const RenderList& InterfaceImplementation::getRenderList(size_t passIndex)
+{
+  if (passIndex >= mRenderLists.size())
+    mRenderLists.resize(passIndex + 1);
+
+  RenderList& list = mRenderLists[passIndex];
+  if (list.isCurrent(mSceneGeneration))
+    return list;
+
+  mGatheredPasses.clear();
+  for (auto it = mObjects.begin(); it != mObjects.end(); ++it)
+    (*it)->gatherPasses(passIndex, mGatheredPasses);
+
+  list.clear();
+  for (auto it = mGatheredPasses.begin(); it != mGatheredPasses.end(); ++it)
+    list.addPass(*it);
+  list.finalize(mSceneGeneration);
+  ++mNumRenderListBuilds;
+  return list;
+}
+
+//------------------------------------------------------------------------------
+float InterfaceImplementation::projectedPixelsPerUnit(const M44& projIVObject,
+                                                      const BoundingSphere& sphere,
+                                                      float halfScreenHeight)
+{
+  // Row 1 of the matrix maps object space to clip space y and row 3 to clip
+  // space w. The length of row 1 is the clip space size of one unit, which
+  // is divided by w at the point of the sphere closest to the camera.
+  V3 rowY(projIVObject[0][1], projIVObject[1][1], projIVObject[2][1]);
+  V3 rowW(projIVObject[0][3], projIVObject[1][3], projIVObject[2][3]);
+  float w =   glm::dot(rowW, sphere.center) + projIVObject[3][3]
+            - sphere.radius * glm::length(rowW);
+
+  // The camera is inside, or very close to, the sphere.
+  if (w <= std::numeric_limits<float>::epsilon())
+    return std::numeric_limits<float>::max();
+
+  return glm::length(rowY) / w * halfScreenHeight;
+}
+
+//------------------------------------------------------------------------------
+void InterfaceImplementation::setNumRecordingThreads(size_t numThreads)
+{
+  mRecordJobs.clear();
+  mWorkers.reset();
+  if (numThreads > 1)
+    mWorkers.reset(new WorkerPool(numThreads - 1));
+}
+
+//------------------------------------------------------------------------------
+void InterfaceImplementation::recordGatheredPasses()
+{
+  std::shared_ptr<const UniformState> uniform;
+  if (mCullingUniform.empty() == false)
+    uniform = mHub.getShaderUniformManager().findUniformWithName(mCullingUniform);
+
+  mCullState.enabled = (uniform != nullptr && uniform->type == GL_FLOAT_MAT4);
+  mCullState.uniformIndex = mCullState.enabled ? uniform->index : 0;
+  // Converts normalized device coordinates to pixels along y.
+  mCullState.halfScreenHeight = 0.5f * static_cast<float>(mHub.getActualScreenHeight());
+
+  size_t numJobs = 1;
+  if (mWorkers != nullptr)
+  {
+    numJobs = std::min(mWorkers->getNumThreads() + 1,
+                       mGatheredPasses.size() / MinPassesPerRecordingJob);
+    numJobs = std::max(numJobs, static_cast<size_t>(1));
+  }
+
+  if (mCommandBuffers.size() < numJobs)
+    mCommandBuffers.resize(numJobs);
+  mNumRecordedBuffers = numJobs;
+
+  if (numJobs == 1)
+  {
+    recordCommands(0, mGatheredPasses.size(), mCommandBuffers[0]);
+    return;
+  }
+
+  // Job i records the i-th slice of the sorted render list. Executing the
+  // buffers in order therefore preserves the sort.
+  if (mRecordJobs.size() != numJobs)
+  {
+    mRecordJobs.resize(numJobs);
+    for (size_t i = 0; i < numJobs; ++i)
+    {
+      mRecordJobs[i] = [this, i, numJobs]()
+      {
+        size_t numPasses = mGatheredPasses.size();
+        recordCommands(numPasses * i / numJobs, numPasses * (i + 1) / numJobs,
+                       mCommandBuffers[i]);
+      };
+    }
+  }
+
+  mWorkers->run(mRecordJobs);
+}
+
+//------------------------------------------------------------------------------
+void InterfaceImplementation::recordCommands(size_t begin, size_t end,
+                                             CommandBuffer& buffer) const
+{
+  buffer.clear();
+
+  if (mCullState.enabled == false)
+  {
+    // LODs are selected while culling. Draw full detail without culling.
+    for (size_t i = begin; i < end; ++i)
+    {
+      ObjectPass* pass = mGatheredPasses[i];
+      if (pass->isResident() == false)
+        continue;
+      pass->setLOD(0);
+      buffer.addDraw(pass, pass->getSortKey(), nullptr);
+    }
+    return;
+  }
+
+  // Passes belonging to the same object, or objects sharing a global
+  // transform, use the same matrix item. Only rebuild the frustum when the
+  // item changes.
+  uint64_t frustumVersion = 0;
+  Frustum frustum((M44()));
+
+  for (size_t i = begin; i < end; ++i)
+  {
+    ObjectPass* pass = mGatheredPasses[i];
+    if (pass->isResident() == false)
+      continue;
+
+    bool visible = true;
+    pass->setLOD(0);
+
+    // Passes without bounds or without a culling matrix are always drawn.
+    const AbstractUniformStateItem* item = nullptr;
+    if (pass->hasBounds())
+      item = pass->findUniform(mCullState.uniformIndex);
+    if (item != nullptr && item->getGLType() != UNIFORM_FLOAT_MAT4)
+      item = nullptr;
+
+    if (item != nullptr)
+    {
+      M44 projIVObject = item->getData<M44>();
+      if (item->getVersion() != frustumVersion)
+      {
+        frustum = Frustum(projIVObject);
+        frustumVersion = item->getVersion();
+      }
+      visible =    frustum.intersects(pass->getBoundingSphere())
+                && frustum.intersects(pass->getAABB());
+
+      if (visible && (mSmallFeaturePixels > 0.0f || pass->getIBO()->getNumLODs() > 1))
+      {
+        float pixelsPerUnit = projectedPixelsPerUnit(projIVObject,
+                                                     pass->getBoundingSphere(),
+                                                     mCullState.halfScreenHeight);
+        float pixelDiameter = 2.0f * pass->getBoundingSphere().radius * pixelsPerUnit;
+        if (pixelDiameter < mSmallFeaturePixels)
+          visible = false;
+        else
+          pass->setLOD(pass->getIBO()->selectLOD(pixelsPerUnit, mLODPixelError));
+      }
+    }
+
+    if (visible)
+      buffer.addDraw(pass, pass->getSortKey(), item);
+    else
+      buffer.addCulled();
+  }
+}
+
+//------------------------------------------------------------------------------
+void InterfaceImplementation::removePassFromObject(const std::string& object,
+                                                   const std::string& pass)
+{
+  std::shared_ptr<SpireObject> obj = getObjectWithName(object);
   obj->removePass(pass);
+  invalidateRenderLists();
+}
+
+//------------------------------------------------------------------------------
+void InterfaceImplementation::removePassFromObject(ObjectHandle object, PassHandle pass)
+{
+  mObjects.at(object)->removePass(getPassIndex(pass));
+  invalidateRenderLists();
 }
 
 //------------------------------------------------------------------------------
-void InterfaceImplementation::addObjectPassUniformConcrete(std::string object, std::string uniformName,
+void InterfaceImplementation::setObjectPassInstanceVBO(const std::string& object,
+                                                       const std::string& instanceVBOName,
+                                                       const std::string& pass)
+{
+  setObjectPassInstanceVBO(getObjectHandle(object), getVBOHandle(instanceVBOName),
+                           getPassHandle(pass));
+}
+
+//------------------------------------------------------------------------------
+void InterfaceImplementation::setObjectPassInstanceVBO(ObjectHandle object,
+                                                       VBOHandle instanceVBO,
+                                                       PassHandle pass)
+{
+  std::shared_ptr<SpireObject> obj = mObjects.at(object);
+  std::shared_ptr<VBOObject> vbo = mVBOs.at(instanceVBO).buffer;
+  obj->setPassInstanceVBO(getPassIndex(pass), vbo);
+  invalidateRenderLists();
+}
+
+//------------------------------------------------------------------------------
+void InterfaceImplementation::addObjectPassUniformConcrete(const std::string& object,
+                                                           const std::string& uniformName,
                                                            std::shared_ptr<AbstractUniformStateItem> item,
-                                                           std::string pass)
+                                                           const std::string& pass)
 {
-  std::shared_ptr<SpireObject> obj = mNameToObject.at(object);
+  std::shared_ptr<SpireObject> obj = getObjectWithName(object);
   obj->addPassUniform(pass, uniformName, item);
 }
 
 //------------------------------------------------------------------------------
-void InterfaceImplementation::addObjectGlobalUniformConcrete(std::string objectName,
-                                                             std::string uniformName,
+void InterfaceImplementation::addObjectPassUniformConcrete(ObjectHandle object,
+                                                           const std::string& uniformName,
+                                                           std::shared_ptr<AbstractUniformStateItem> item,
+                                                           PassHandle pass)
+{
+  mObjects.at(object)->addPassUniform(getPassIndex(pass), uniformName, item);
+}
+
+//------------------------------------------------------------------------------
+void InterfaceImplementation::addObjectGlobalUniformConcrete(const std::string& objectName,
+                                                             const std::string& uniformName,
                                                              std::shared_ptr<AbstractUniformStateItem> item)
 {
-  std::shared_ptr<SpireObject> obj = mNameToObject.at(objectName);
+  std::shared_ptr<SpireObject> obj = getObjectWithName(objectName);
   obj->addGlobalUniform(uniformName, item);
 }
 
+//------------------------------------------------------------------------------
+void InterfaceImplementation::addObjectGlobalUniformConcrete(ObjectHandle object,
+                                                             const std::string& uniformName,
+                                                             std::shared_ptr<AbstractUniformStateItem> item)
+{
+  mObjects.at(object)->addGlobalUniform(uniformName, item);
+}
 
 //------------------------------------------------------------------------------
-void InterfaceImplementation::addGlobalUniformConcrete(std::string uniformName,
+void InterfaceImplementation::addGlobalUniformConcrete(const std::string& uniformName,
                                                        std::shared_ptr<AbstractUniformStateItem> item)
 {
   // Access uniform state manager and apply/update uniform value.
@@ -220,16 +749,17 @@ void InterfaceImplementation::addGlobalUniformConcrete(std::string uniformName,
 }
 
 //------------------------------------------------------------------------------
-void InterfaceImplementation::addShaderAttribute(std::string codeName,
+void InterfaceImplementation::addShaderAttribute(const std::string& codeName,
                                                  size_t numComponents, bool normalize, size_t size,
-                                                 Interface::DATA_TYPES t)
+                                                 Interface::DATA_TYPES t, size_t divisor)
 {
-  mHub.getShaderAttributeManager().addAttribute(codeName, numComponents, normalize, size, t);
+  mHub.getShaderAttributeManager().addAttribute(codeName, numComponents, normalize, size, t,
+                                                divisor);
 }
 
 //------------------------------------------------------------------------------
-void InterfaceImplementation::addPersistentShader(std::string programName,
-                                                  std::vector<std::tuple<std::string, Interface::SHADER_TYPES>> tempShaders)
+void InterfaceImplementation::addPersistentShader(const std::string& programName,
+                                                  const std::vector<std::tuple<std::string, Interface::SHADER_TYPES>>& tempShaders)
 {
   std::list<std::tuple<std::string, GLenum>> shaders;
   for (auto it = tempShaders.begin(); it != tempShaders.end(); ++it)
@@ -350,5 +880,28 @@ GLenum InterfaceImplementation::getGLType(Interface::DATA_TYPES type)
   return GL_FLOAT;
 }
 
+//------------------------------------------------------------------------------
+GLenum InterfaceImplementation::getGLUsage(Interface::BUFFER_USAGE usage)
+{
+  switch (usage)
+  {
+    case Interface::USAGE_STATIC:     return GL_STATIC_DRAW;
+    case Interface::USAGE_DYNAMIC:    return GL_DYNAMIC_DRAW;
+    case Interface::USAGE_STREAM:     return GL_STREAM_DRAW;
+
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wunreachable-code"
+    default:
+    {
+      std::stringstream stream;
+      stream << "Expected usage to be one of Interface::BUFFER_USAGE, received " << usage;
+      throw std::invalid_argument(stream.str());
+    }
+#pragma clang diagnostic pop
+  }
+
+  return GL_STATIC_DRAW;
+}
+
 } // namespace CPM_SPIRE_NS
 
@@ -41,9 +41,14 @@
 #include <map>
 #include <tuple>
 #include <cstdint>
+#include <functional>
 #include "Common.h"
 
 #include "ThreadMessage.h"
+#include "RenderQueue.h"
+#include "RenderList.h"
+#include "CommandBuffer.h"
+#include "SlotMap.h"
 
 namespace CPM_SPIRE_NS {
 
@@ -52,6 +57,9 @@ class SpireObject;
 class ShaderProgramAsset;
 class VBOObject;
 class IBOObject;
+class ObjectPass;
+class WorkerPool;
+struct BoundingSphere;
 
 /// Implementation of the functions exposed in Interface.h
 /// All functions in this class are not thread safe.
@@ -59,7 +67,7 @@ class InterfaceImplementation
 {
 public:
   InterfaceImplementation(Hub& hub);
-  virtual ~InterfaceImplementation()  {}
+  virtual ~InterfaceImplementation();
   
   //============================================================================
   // IMPLEMENTATION
@@ -68,24 +76,94 @@ public:
   void clearGLResources();
 
   /// Retrieves number of objects.
-  size_t getNumObjects()      {return mNameToObject.size();}
+  size_t getNumObjects()      {return mObjects.size();}
 
   /// Retrieves the object with the specified name.
   std::shared_ptr<SpireObject> getObjectWithName(const std::string& name) const;
 
+  /// Retrieves the object referenced by 'object'.
+  /// Throws std::out_of_range if the handle is stale.
+  std::shared_ptr<SpireObject> getObject(ObjectHandle object) const;
+
+  /// Name to handle lookups. Throw std::out_of_range if the name is unknown.
+  /// @{
+  ObjectHandle getObjectHandle(const std::string& object) const;
+  VBOHandle getVBOHandle(const std::string& vboName) const;
+  IBOHandle getIBOHandle(const std::string& iboName) const;
+  /// @}
+
+  /// Retrieves the handle of 'pass'. Pass handles never become stale.
+  /// Throws std::out_of_range if the pass has not been added.
+  PassHandle getPassHandle(const std::string& pass) const;
+
+  /// Adds 'pass' if it does not exist yet and returns its handle.
+  PassHandle addPass(const std::string& pass);
+
   /// Retrieves appropriate primitive type GLenum from Interface primitives.
   static GLenum getGLPrimitive(Interface::PRIMITIVE_TYPES type);
 
   /// Retrieve gl type from Interface::DATA_TYPES.
   static GLenum getGLType(Interface::DATA_TYPES type);
 
-  void addConcurrentVBO(const std::string& vboName,
-                        const uint8_t* vboData, size_t vboSize,
-                        const std::vector<std::string>& attribNames);
-
-  void addConcurrentIBO(const std::string& iboName,
-                        const uint8_t* iboData, size_t iboSize,
-                        Interface::IBO_TYPE type);
+  /// Retrieves the GL buffer usage hint from Interface::BUFFER_USAGE.
+  static GLenum getGLUsage(Interface::BUFFER_USAGE usage);
+
+  VBOHandle addConcurrentVBO(const std::string& vboName,
+                             const uint8_t* vboData, size_t vboSize,
+                             const std::vector<std::string>& attribNames,
+                             Interface::BUFFER_USAGE usage);
+
+  IBOHandle addConcurrentIBO(const std::string& iboName,
+                             const uint8_t* iboData, size_t iboSize,
+                             Interface::IBO_TYPE type,
+                             Interface::BUFFER_USAGE usage);
+
+  /// Renders 'pass' (and its subpasses) for every object that has the pass.
+  /// Passes are sorted by GL state before rendering.
+  void renderPass(const std::string& pass);
+  void renderPass(PassHandle pass);
+
+  /// Builds the render list of 'pass' if the scene changed since it was last
+  /// built. renderPass does this automatically.
+  void compileRenderList(PassHandle pass);
+
+  /// Passes are culled against the view frustum given by the 4x4 matrix
+  /// uniform 'uniformName' before rendering. An empty name disables culling.
+  void setCullingUniform(const std::string& uniformName) {mCullingUniform = uniformName;}
+
+  /// LOD selection and small feature culling. See Interface.
+  /// @{
+  void setLODPixelError(float pixels)           {mLODPixelError = pixels;}
+  void setSmallFeatureCulling(float pixels)     {mSmallFeaturePixels = pixels;}
+  void generateIBOLODs(const std::string& iboName,
+                       std::shared_ptr<std::vector<uint8_t>> iboData,
+                       std::shared_ptr<std::vector<uint8_t>> vboData,
+                       const std::vector<std::string>& attribNames);
+  size_t getNumIBOLODs(const std::string& iboName) const;
+  /// @}
+
+  /// Retrieves the stride of vertices with attributes 'attribNames' and the
+  /// offset of their "aPos" attribute. Throws std::invalid_argument if there
+  /// is no position attribute of at least 3 floats.
+  void getPositionLayout(const std::vector<std::string>& attribNames,
+                         size_t& stride, size_t& positionOffset) const;
+
+  /// Culling and LOD selection in renderPass are split across 'numThreads'
+  /// threads, including the calling thread. 0 or 1 disables worker threads.
+  void setNumRecordingThreads(size_t numThreads);
+
+  /// Worker threads are only used if each receives at least this many passes.
+  static const size_t MinPassesPerRecordingJob = 512;
+
+  /// Number of passes culled by the last call to renderPass, including
+  /// passes rejected by occlusion culling.
+  size_t getNumCulledPasses() const   {return mNumCulledPasses;}
+
+  /// Number of passes drawn by the last call to renderPass.
+  size_t getNumRenderedPasses() const {return mNumRenderedPasses;}
+
+  /// Number of times a render list was (re)built.
+  size_t getNumRenderListBuilds() const {return mNumRenderListBuilds;}
 
   //============================================================================
   // CALLBACK IMPLEMENTATION -- Called from interface or a derived class.
@@ -95,34 +173,68 @@ public:
   // Objects
   //---------
 
-  void addObject(std::string objectName);
-  void removeObject(std::string objectName);
+  ObjectHandle addObject(const std::string& objectName);
+  void removeObject(const std::string& objectName);
+  void removeObject(ObjectHandle object);
   void removeAllObjects();
-  void addVBO(std::string vboName,
-              std::shared_ptr<std::vector<uint8_t>> vboData,
-              std::vector<std::string> attribNames);
-  void removeVBO(std::string vboName);
-  void addIBO(std::string iboName,
-                     std::shared_ptr<std::vector<uint8_t>> iboData,
-                     Interface::IBO_TYPE type);
-  void removeIBO(std::string iboName);
-  void addPassToObject(std::string object,
-                              std::string program, std::string vboName, 
-                              std::string iboName, Interface::PRIMITIVE_TYPES type,
-                              std::string pass, std::string parentPass);
-  void removePassFromObject(std::string object,
-                                   std::string pass);
+  VBOHandle addVBO(const std::string& vboName,
+                   std::shared_ptr<std::vector<uint8_t>> vboData,
+                   const std::vector<std::string>& attribNames,
+                   Interface::BUFFER_USAGE usage);
+  void removeVBO(const std::string& vboName);
+  void removeVBO(VBOHandle vbo);
+  void updateVBO(VBOHandle vbo, size_t offset, const uint8_t* data, size_t size);
+  VBOHandle addStreamVBO(const std::string& vboName,
+                         const std::vector<std::string>& attribNames);
+  uint8_t* writeStreamVBO(VBOHandle vbo, size_t size);
+  IBOHandle addIBO(const std::string& iboName,
+                   std::shared_ptr<std::vector<uint8_t>> iboData,
+                   Interface::IBO_TYPE type,
+                   Interface::BUFFER_USAGE usage);
+  void removeIBO(const std::string& iboName);
+  void removeIBO(IBOHandle ibo);
+  void updateIBO(IBOHandle ibo, size_t offset, const uint8_t* data, size_t size);
+  IBOHandle addStreamIBO(const std::string& iboName, Interface::IBO_TYPE type);
+  uint8_t* writeStreamIBO(IBOHandle ibo, size_t size);
+
+  /// Compacts the vertex and index arenas. Returns the number of bytes
+  /// released.
+  size_t compactBufferArenas();
+  PassHandle addPassToObject(const std::string& object,
+                             const std::string& program, const std::string& vboName,
+                             const std::string& iboName, Interface::PRIMITIVE_TYPES type,
+                             const std::string& pass, const std::string& parentPass);
+  PassHandle addPassToObject(ObjectHandle object,
+                             const std::string& program, VBOHandle vbo,
+                             IBOHandle ibo, Interface::PRIMITIVE_TYPES type,
+                             PassHandle pass, PassHandle parentPass);
+  void removePassFromObject(const std::string& object,
+                            const std::string& pass);
+  void removePassFromObject(ObjectHandle object, PassHandle pass);
+  void setObjectPassInstanceVBO(const std::string& object,
+                                const std::string& instanceVBOName,
+                                const std::string& pass);
+  void setObjectPassInstanceVBO(ObjectHandle object, VBOHandle instanceVBO,
+                                PassHandle pass);
 
   //----------
   // Uniforms
   //----------
-  void addObjectPassUniformConcrete(std::string object, std::string uniformName,
+  void addObjectPassUniformConcrete(const std::string& object,
+                                    const std::string& uniformName,
+                                    std::shared_ptr<AbstractUniformStateItem> item,
+                                    const std::string& pass);
+  void addObjectPassUniformConcrete(ObjectHandle object,
+                                    const std::string& uniformName,
                                     std::shared_ptr<AbstractUniformStateItem> item,
-                                    std::string pass);
-  void addObjectGlobalUniformConcrete(std::string object,
-                                      std::string uniformName,
+                                    PassHandle pass);
+  void addObjectGlobalUniformConcrete(const std::string& object,
+                                      const std::string& uniformName,
                                       std::shared_ptr<AbstractUniformStateItem> item);
-  void addGlobalUniformConcrete( std::string uniformName,
+  void addObjectGlobalUniformConcrete(ObjectHandle object,
+                                      const std::string& uniformName,
+                                      std::shared_ptr<AbstractUniformStateItem> item);
+  void addGlobalUniformConcrete(const std::string& uniformName,
                                 std::shared_ptr<AbstractUniformStateItem> item);
 
   //-------------------
@@ -130,30 +242,118 @@ public:
   //-------------------
 
   // Attributes just as they are in the OpenGL rendering pipeline.
-  void addShaderAttribute(std::string codeName, size_t numComponents,
-                          bool normalize, size_t size, Interface::DATA_TYPES t);
+  void addShaderAttribute(const std::string& codeName, size_t numComponents,
+                          bool normalize, size_t size, Interface::DATA_TYPES t,
+                          size_t divisor);
 
   //-----------------
   // Shader Programs
   //-----------------
 
-  void addPersistentShader(std::string programName,
-                           std::vector<std::tuple<std::string, Interface::SHADER_TYPES>> tempShaders);
+  void addPersistentShader(const std::string& programName,
+                           const std::vector<std::tuple<std::string, Interface::SHADER_TYPES>>& tempShaders);
 
 private:
 
-  /// This unordered map is a 1-1 mapping of object names onto objects.
-  std::unordered_map<std::string, std::shared_ptr<SpireObject>>   mNameToObject;
+  /// Pass index (see PassUniformStateMan::addPass) of 'pass'. Throws
+  /// std::invalid_argument if the handle is invalid.
+  static size_t getPassIndex(PassHandle pass);
+
+  /// Culls mGatheredPasses and records the remaining draws into
+  /// mCommandBuffers, on worker threads if there are enough passes.
+  void recordGatheredPasses();
+
+  /// Culls mGatheredPasses[begin, end), selects LODs, and records the draws
+  /// that remain into 'buffer'. Makes no GL calls and only reads shared
+  /// state, so it may run on a worker thread.
+  void recordCommands(size_t begin, size_t end, CommandBuffer& buffer) const;
+
+  /// Invalidates all render lists. Called whenever objects, passes, or
+  /// buffers are added or removed.
+  void invalidateRenderLists()  {++mSceneGeneration;}
+
+  /// Returns the up to date render list of 'passIndex'.
+  const RenderList& getRenderList(size_t passIndex);
+
+  /// Number of pixels covered by one unit of object space at the point of
+  /// 'sphere' closest to the camera. Returns the largest float if the camera
+  /// is inside the sphere.
+  static float projectedPixelsPerUnit(const M44& projIVObject,
+                                      const BoundingSphere& sphere,
+                                      float halfScreenHeight);
+
+  /// Buffers are removed by handle as well as by name, so their names are
+  /// stored alongside them.
+  template <typename T>
+  struct NamedBuffer
+  {
+    NamedBuffer(const std::string& bufferName, std::shared_ptr<T> bufferObject) :
+        name(bufferName),
+        buffer(bufferObject)
+    {}
+
+    std::string         name;
+    std::shared_ptr<T>  buffer;
+  };
+
+  /// All objects. Objects are iterated every frame so they are kept in the
+  /// contiguous storage of a slot map.
+  SlotMap<std::shared_ptr<SpireObject>, ObjectHandleTag>          mObjects;
+
+  /// Object names onto object handles.
+  std::unordered_map<std::string, ObjectHandle>                   mNameToObject;
 
   /// List of shaders that are stored persistently by this pipe (will never
   /// be GC'ed unless this pipe is destroyed).
   std::list<std::shared_ptr<ShaderProgramAsset>>                  mPersistentShaders;
 
-  /// VBO names to our representation of a vertex buffer object.
-  std::unordered_map<std::string, std::shared_ptr<VBOObject>>     mVBOMap;
-
-  /// IBO names to our representation of an index buffer object.
-  std::unordered_map<std::string, std::shared_ptr<IBOObject>>     mIBOMap;
+  /// Our representation of vertex buffer objects, and their names.
+  SlotMap<NamedBuffer<VBOObject>, VBOHandleTag>                   mVBOs;
+  std::unordered_map<std::string, VBOHandle>                      mNameToVBO;
+
+  /// Our representation of index buffer objects, and their names.
+  SlotMap<NamedBuffer<IBOObject>, IBOHandleTag>                   mIBOs;
+  std::unordered_map<std::string, IBOHandle>                      mNameToIBO;
+
+  /// Queue used by renderPass. Kept around to avoid per-frame allocation.
+  RenderQueue                                                     mRenderQueue;
+
+  /// Render lists indexed by pass index. Lists are current if they were built
+  /// for mSceneGeneration.
+  std::vector<RenderList>                                         mRenderLists;
+  uint64_t                                                        mSceneGeneration;
+
+  /// Culling parameters for the current frame, shared by recording jobs.
+  struct CullState
+  {
+    CullState() : enabled(false), uniformIndex(0), halfScreenHeight(0.0f) {}
+
+    bool    enabled;          ///< False if there is no valid culling uniform.
+    size_t  uniformIndex;     ///< Culling uniform, see UniformState::index.
+    float   halfScreenHeight; ///< Converts NDC to pixels along y.
+  };
+  CullState                                                       mCullState;
+
+  std::vector<CommandBuffer>                                      mCommandBuffers;
+  size_t                                                          mNumRecordedBuffers;
+  std::vector<std::function<void ()>>                             mRecordJobs;
+
+  /// Scratch vector used when gathering passes from objects.
+  std::vector<ObjectPass*>                                        mGatheredPasses;
+
+  std::string                                                     mCullingUniform;
+  size_t                                                          mNumCulledPasses;
+  size_t                                                          mNumRenderedPasses;
+  size_t                                                          mNumRenderListBuilds;
+  float                                                           mLODPixelError;
+  float                                                           mSmallFeaturePixels;
+
+  /// IBOs with LOD chains being generated on worker threads.
+  std::vector<std::weak_ptr<IBOObject>>                           mPendingLODs;
+
+  /// Threads used by recordGatheredPasses. Declared after the state the
+  /// workers read so that the threads are joined first.
+  std::unique_ptr<WorkerPool>                                     mWorkers;
 
 private:
 
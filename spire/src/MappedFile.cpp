@@ -0,0 +1,139 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2013 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+/// \author agent
+/// \date   October 2026
+
+#include <stdexcept>
+
+#include "MappedFile.h"
+#include "Exceptions.h"
+
+#ifndef _WIN32
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#else
+  #include <windows.h>
+#endif
+
+namespace CPM_SPIRE_NS {
+
+#ifndef _WIN32
+
+//------------------------------------------------------------------------------
+MappedFile::MappedFile(const std::string& filename) :
+    mData(nullptr),
+    mSize(0)
+{
+  int fd = open(filename.c_str(), O_RDONLY);
+  if (fd == -1)
+    throw NotFound("Unable to open " + filename);
+
+  struct stat info;
+  if (fstat(fd, &info) != 0)
+  {
+    close(fd);
+    throw std::runtime_error("Unable to stat " + filename);
+  }
+
+  mSize = static_cast<size_t>(info.st_size);
+  if (mSize > 0)
+  {
+    void* data = mmap(nullptr, mSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED)
+    {
+      close(fd);
+      throw std::runtime_error("Unable to map " + filename);
+    }
+    mData = static_cast<const uint8_t*>(data);
+  }
+
+  // The mapping keeps its own reference to the file.
+  close(fd);
+}
+
+//------------------------------------------------------------------------------
+MappedFile::~MappedFile()
+{
+  if (mData != nullptr)
+    munmap(const_cast<uint8_t*>(mData), mSize);
+}
+
+#else
+
+//------------------------------------------------------------------------------
+MappedFile::MappedFile(const std::string& filename) :
+    mData(nullptr),
+    mSize(0),
+    mFile(INVALID_HANDLE_VALUE),
+    mMapping(nullptr)
+{
+  mFile = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                      OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (mFile == INVALID_HANDLE_VALUE)
+    throw NotFound("Unable to open " + filename);
+
+  LARGE_INTEGER size;
+  if (GetFileSizeEx(mFile, &size) == FALSE)
+  {
+    CloseHandle(mFile);
+    throw std::runtime_error("Unable to stat " + filename);
+  }
+
+  mSize = static_cast<size_t>(size.QuadPart);
+  if (mSize > 0)
+  {
+    mMapping = CreateFileMappingA(mFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mMapping != nullptr)
+      mData = static_cast<const uint8_t*>(MapViewOfFile(mMapping, FILE_MAP_READ, 0, 0, 0));
+
+    if (mData == nullptr)
+    {
+      if (mMapping != nullptr)
+        CloseHandle(mMapping);
+      CloseHandle(mFile);
+      throw std::runtime_error("Unable to map " + filename);
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+MappedFile::~MappedFile()
+{
+  if (mData != nullptr)
+    UnmapViewOfFile(mData);
+  if (mMapping != nullptr)
+    CloseHandle(mMapping);
+  CloseHandle(mFile);
+}
+
+#endif
+
+} // namespace CPM_SPIRE_NS
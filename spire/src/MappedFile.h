@@ -0,0 +1,73 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2013 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+/// \author agent
+/// \date   October 2026
+
+#ifndef SPIRE_HIGH_MAPPEDFILE_H
+#define SPIRE_HIGH_MAPPEDFILE_H
+
+#include <string>
+#include <cstddef>
+#include <cstdint>
+
+namespace CPM_SPIRE_NS {
+
+/// Read-only memory mapping of a whole file. Pages are read in by the OS as
+/// they are touched, so nothing is copied up front.
+class MappedFile
+{
+public:
+  /// Maps 'filename'. Throws NotFound if the file cannot be opened, and
+  /// std::runtime_error if it cannot be mapped.
+  MappedFile(const std::string& filename);
+  virtual ~MappedFile();
+
+  /// Start of the file's contents. nullptr for an empty file.
+  const uint8_t* getData() const  {return mData;}
+
+  /// Size of the file in bytes.
+  size_t getSize() const          {return mSize;}
+
+private:
+  // Not copyable.
+  MappedFile(const MappedFile&);
+  MappedFile& operator=(const MappedFile&);
+
+  const uint8_t*  mData;
+  size_t          mSize;
+
+#ifdef _WIN32
+  void*           mFile;      ///< File handle.
+  void*           mMapping;   ///< File mapping handle.
+#endif
+};
+
+} // namespace CPM_SPIRE_NS
+
+#endif
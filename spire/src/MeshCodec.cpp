@@ -0,0 +1,781 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2013 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+/// \author agent
+/// \date   October 2026
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#include "MeshCodec.h"
+
+// Same test as SPIRE_USE_SSE2 in Common.h, which pulls in GL. This file is
+// also compiled into assetConv, which does not use GL.
+#if !defined(SPIRE_USE_SSE2) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+  #define SPIRE_USE_SSE2
+#endif
+
+#ifdef SPIRE_USE_SSE2
+  #include <emmintrin.h>
+#endif
+
+namespace CPM_SPIRE_NS {
+
+namespace {
+
+/// Vertices per block. Every plane holds one byte of each of them.
+const size_t BlockSize = 16;
+
+/// Bits per delta for each of the 2 bit plane modes.
+const size_t PlaneBits[4] = {0, 2, 4, 8};
+
+size_t getPlaneSize(unsigned mode)
+{
+  return BlockSize * PlaneBits[mode] / 8;
+}
+
+size_t getHeaderSize(size_t stride)
+{
+  return (stride + 3) / 4;
+}
+
+uint32_t loadWord(const uint8_t* in)
+{
+  uint32_t word;
+  std::memcpy(&word, in, sizeof(word));
+  return word;
+}
+
+void storeWord(uint8_t* out, uint32_t word)
+{
+  std::memcpy(out, &word, sizeof(word));
+}
+
+// Planes packed with n deltas per byte keep delta i in the low bits of byte
+// i, delta i + 16 / n in the next bits, and so on. SSE2 unpacks them with
+// shifts and masks.
+void packPlane(const uint8_t* deltas, std::vector<uint8_t>& header, size_t plane,
+               std::vector<uint8_t>& out)
+{
+  uint8_t largest = *std::max_element(deltas, deltas + BlockSize);
+  unsigned mode = 3;
+  if (largest == 0)       mode = 0;
+  else if (largest < 4)   mode = 1;
+  else if (largest < 16)  mode = 2;
+  header[plane / 4] |= static_cast<uint8_t>(mode << (2 * (plane % 4)));
+
+  switch (mode)
+  {
+    case 1:
+      for (size_t i = 0; i < 4; ++i)
+        out.push_back(static_cast<uint8_t>(  deltas[i]           | (deltas[i + 4] << 2)
+                                           | (deltas[i + 8] << 4) | (deltas[i + 12] << 6)));
+      break;
+
+    case 2:
+      for (size_t i = 0; i < 8; ++i)
+        out.push_back(static_cast<uint8_t>(deltas[i] | (deltas[i + 8] << 4)));
+      break;
+
+    case 3:
+      out.insert(out.end(), deltas, deltas + BlockSize);
+      break;
+  }
+}
+
+#ifdef SPIRE_USE_SSE2
+
+//------------------------------------------------------------------------------
+__m128i unpackPlane(const uint8_t* in, unsigned mode)
+{
+  switch (mode)
+  {
+    case 1:
+    {
+      int32_t packed;
+      std::memcpy(&packed, in, sizeof(packed));
+      __m128i v    = _mm_cvtsi32_si128(packed);
+      __m128i mask = _mm_set1_epi8(0x03);
+      __m128i d0   = _mm_and_si128(v, mask);
+      __m128i d1   = _mm_and_si128(_mm_srli_epi16(v, 2), mask);
+      __m128i d2   = _mm_and_si128(_mm_srli_epi16(v, 4), mask);
+      __m128i d3   = _mm_and_si128(_mm_srli_epi16(v, 6), mask);
+      return _mm_unpacklo_epi64(_mm_unpacklo_epi32(d0, d1), _mm_unpacklo_epi32(d2, d3));
+    }
+
+    case 2:
+    {
+      __m128i v    = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(in));
+      __m128i mask = _mm_set1_epi8(0x0F);
+      return _mm_unpacklo_epi64(_mm_and_si128(v, mask),
+                                _mm_and_si128(_mm_srli_epi16(v, 4), mask));
+    }
+
+    case 3:
+      return _mm_loadu_si128(reinterpret_cast<const __m128i*>(in));
+
+    default:
+      return _mm_setzero_si128();
+  }
+}
+
+//------------------------------------------------------------------------------
+// Decodes 4 planes, the bytes of zigzag coded word deltas, into the words
+// of 16 consecutive vertices.
+void decodeWords(const uint8_t* const planes[4], const unsigned modes[4],
+                 uint32_t previous, uint32_t* words)
+{
+  __m128i p0 = unpackPlane(planes[0], modes[0]);
+  __m128i p1 = unpackPlane(planes[1], modes[1]);
+  __m128i p2 = unpackPlane(planes[2], modes[2]);
+  __m128i p3 = unpackPlane(planes[3], modes[3]);
+
+  __m128i lo01 = _mm_unpacklo_epi8(p0, p1);
+  __m128i hi01 = _mm_unpackhi_epi8(p0, p1);
+  __m128i lo23 = _mm_unpacklo_epi8(p2, p3);
+  __m128i hi23 = _mm_unpackhi_epi8(p2, p3);
+
+  __m128i w[4];
+  w[0] = _mm_unpacklo_epi16(lo01, lo23);
+  w[1] = _mm_unpackhi_epi16(lo01, lo23);
+  w[2] = _mm_unpacklo_epi16(hi01, hi23);
+  w[3] = _mm_unpackhi_epi16(hi01, hi23);
+
+  __m128i sum = _mm_set1_epi32(static_cast<int32_t>(previous));
+  for (size_t i = 0; i < 4; ++i)
+  {
+    // Undo the zigzag coding, then sum the deltas.
+    __m128i sign = _mm_sub_epi32(_mm_setzero_si128(), _mm_and_si128(w[i], _mm_set1_epi32(1)));
+    __m128i d = _mm_xor_si128(_mm_srli_epi32(w[i], 1), sign);
+    d = _mm_add_epi32(d, _mm_slli_si128(d, 4));
+    d = _mm_add_epi32(d, _mm_slli_si128(d, 8));
+    sum = _mm_add_epi32(d, sum);
+
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(words + 4 * i), sum);
+    sum = _mm_shuffle_epi32(sum, _MM_SHUFFLE(3, 3, 3, 3));
+  }
+}
+
+//------------------------------------------------------------------------------
+// Decodes a plane of zigzag coded byte deltas into the bytes of 16
+// consecutive vertices.
+void decodeBytes(const uint8_t* plane, unsigned mode, uint8_t previous, uint8_t* bytes)
+{
+  __m128i z = unpackPlane(plane, mode);
+  __m128i sign = _mm_sub_epi8(_mm_setzero_si128(), _mm_and_si128(z, _mm_set1_epi8(1)));
+  __m128i d = _mm_xor_si128(_mm_and_si128(_mm_srli_epi16(z, 1), _mm_set1_epi8(0x7F)), sign);
+
+  d = _mm_add_epi8(d, _mm_slli_si128(d, 1));
+  d = _mm_add_epi8(d, _mm_slli_si128(d, 2));
+  d = _mm_add_epi8(d, _mm_slli_si128(d, 4));
+  d = _mm_add_epi8(d, _mm_slli_si128(d, 8));
+  d = _mm_add_epi8(d, _mm_set1_epi8(static_cast<char>(previous)));
+
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(bytes), d);
+}
+
+#else
+
+//------------------------------------------------------------------------------
+void unpackPlane(const uint8_t* in, unsigned mode, uint8_t* deltas)
+{
+  std::memset(deltas, 0, BlockSize);
+  switch (mode)
+  {
+    case 1:
+      for (size_t i = 0; i < 4; ++i)
+        for (size_t k = 0; k < 4; ++k)
+          deltas[i + 4 * k] = (in[i] >> (2 * k)) & 0x03;
+      break;
+
+    case 2:
+      for (size_t i = 0; i < 8; ++i)
+      {
+        deltas[i]     = in[i] & 0x0F;
+        deltas[i + 8] = in[i] >> 4;
+      }
+      break;
+
+    case 3:
+      std::memcpy(deltas, in, BlockSize);
+      break;
+  }
+}
+
+//------------------------------------------------------------------------------
+void decodeWords(const uint8_t* const planes[4], const unsigned modes[4],
+                 uint32_t previous, uint32_t* words)
+{
+  uint8_t deltas[4][BlockSize];
+  for (size_t b = 0; b < 4; ++b)
+    unpackPlane(planes[b], modes[b], deltas[b]);
+
+  for (size_t i = 0; i < BlockSize; ++i)
+  {
+    uint32_t value =   deltas[0][i]         | (deltas[1][i] << 8)
+                     | (deltas[2][i] << 16) | (static_cast<uint32_t>(deltas[3][i]) << 24);
+    previous += (value >> 1) ^ (0u - (value & 1));
+    words[i] = previous;
+  }
+}
+
+//------------------------------------------------------------------------------
+void decodeBytes(const uint8_t* plane, unsigned mode, uint8_t previous, uint8_t* bytes)
+{
+  uint8_t deltas[BlockSize];
+  unpackPlane(plane, mode, deltas);
+
+  for (size_t i = 0; i < BlockSize; ++i)
+  {
+    previous = static_cast<uint8_t>(previous + ((deltas[i] >> 1) ^ (0 - (deltas[i] & 1))));
+    bytes[i] = previous;
+  }
+}
+
+#endif
+
+uint32_t getIndex(const uint8_t* indices, size_t i, size_t indexSize)
+{
+  switch (indexSize)
+  {
+    case 1:
+      return indices[i];
+
+    case 2:
+    {
+      uint16_t index;
+      std::memcpy(&index, indices + 2 * i, sizeof(index));
+      return index;
+    }
+
+    default:
+    {
+      uint32_t index;
+      std::memcpy(&index, indices + 4 * i, sizeof(index));
+      return index;
+    }
+  }
+}
+
+void setIndex(uint8_t* indices, size_t i, size_t indexSize, uint32_t index)
+{
+  switch (indexSize)
+  {
+    case 1:
+      indices[i] = static_cast<uint8_t>(index);
+      break;
+
+    case 2:
+    {
+      uint16_t narrow = static_cast<uint16_t>(index);
+      std::memcpy(indices + 2 * i, &narrow, sizeof(narrow));
+      break;
+    }
+
+    default:
+      std::memcpy(indices + 4 * i, &index, sizeof(index));
+      break;
+  }
+}
+
+void checkIndexSize(size_t indexSize)
+{
+  if (indexSize != 1 && indexSize != 2 && indexSize != 4)
+    throw std::invalid_argument("Index size must be 1, 2, or 4 bytes.");
+}
+
+uint32_t zigzag(uint32_t delta)
+{
+  return (delta << 1) ^ ((delta & 0x80000000u) ? 0xFFFFFFFFu : 0u);
+}
+
+uint32_t unzigzag(uint32_t value)
+{
+  return (value >> 1) ^ (0u - (value & 1));
+}
+
+void putVarint(uint32_t value, std::vector<uint8_t>& out)
+{
+  while (value >= 0x80)
+  {
+    out.push_back(static_cast<uint8_t>(value | 0x80));
+    value >>= 7;
+  }
+  out.push_back(static_cast<uint8_t>(value));
+}
+
+uint8_t getByte(const uint8_t* data, size_t size, size_t& offset)
+{
+  if (offset == size)
+    throw std::invalid_argument("Truncated index data.");
+  return data[offset++];
+}
+
+uint32_t getVarint(const uint8_t* data, size_t size, size_t& offset)
+{
+  uint32_t value = 0;
+  for (unsigned shift = 0; ; shift += 7)
+  {
+    if (shift > 28)
+      throw std::invalid_argument("Malformed index data.");
+
+    uint8_t byte = getByte(data, size, offset);
+    if (shift == 28 && (byte & 0x70) != 0)
+      throw std::invalid_argument("Malformed index data.");
+    value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+    if ((byte & 0x80) == 0)
+      return value;
+  }
+}
+
+// Triangles are coded with one code byte, followed by the vertex FIFO
+// indices and deltas of the vertices that need them.
+//
+// Most triangles share an edge with one of the last few triangles, with the
+// opposite winding. Such triangles store the index of the edge in the edge
+// FIFO in the high nibble of the code, the rotation that puts the shared
+// edge first in bits 2 - 3, and how the third vertex is coded in bits 0 - 1.
+// Other triangles set bits 2 - 3 and store how each of their vertices is
+// coded in bits 6 - 7, 4 - 5, and 0 - 1.
+//
+// Vertices are coded as the next vertex (one past the largest index so far,
+// which is what meshes ordered by optimizeMesh use for new vertices), as an
+// index into the vertex FIFO stored in the next byte, or as a zigzag varint
+// delta. The delta is against the previous index, except for the third
+// vertex of a triangle sharing an edge, which is coded against either vertex
+// of the edge.
+const size_t   FIFOSize            = 16;
+const unsigned VertexNext          = 0;
+const unsigned VertexFIFO          = 1;
+const unsigned VertexExplicit      = 2; ///< Against the base.
+const unsigned VertexExplicitOther = 3; ///< Against the other base.
+const unsigned RotationNoEdge      = 3;
+
+/// State shared by encoder and decoder.
+struct TriangleCoder
+{
+  TriangleCoder() :
+      edgeHead(0),
+      vertexHead(0),
+      next(0),
+      previous(0)
+  {
+    std::fill(edges, edges + 2 * FIFOSize, 0);
+    std::fill(vertices, vertices + FIFOSize, 0);
+  }
+
+  /// Returns the FIFO index of edge (a, b), FIFOSize if there is none.
+  size_t findEdge(uint32_t a, uint32_t b) const
+  {
+    for (size_t i = 0; i < FIFOSize; ++i)
+    {
+      const uint32_t* edge = getEdge(i);
+      if (edge[0] == a && edge[1] == b)
+        return i;
+    }
+    return FIFOSize;
+  }
+
+  /// Edge 'i' of the edge FIFO, 0 being the most recent.
+  const uint32_t* getEdge(size_t i) const
+  {
+    return &edges[2 * ((edgeHead + FIFOSize - 1 - i) % FIFOSize)];
+  }
+
+  /// Adds the edges a neighbor of triangle (a, b, c) shares with it.
+  void pushTriangle(uint32_t a, uint32_t b, uint32_t c)
+  {
+    pushEdge(b, a);
+    pushEdge(c, b);
+    pushEdge(a, c);
+    previous = c;
+  }
+
+  void pushEdge(uint32_t a, uint32_t b)
+  {
+    edges[2 * edgeHead + 0] = a;
+    edges[2 * edgeHead + 1] = b;
+    edgeHead = (edgeHead + 1) % FIFOSize;
+  }
+
+  /// Returns the FIFO index of vertex 'v', FIFOSize if there is none.
+  size_t findVertex(uint32_t v) const
+  {
+    for (size_t i = 0; i < FIFOSize; ++i)
+      if (getVertex(i) == v)
+        return i;
+    return FIFOSize;
+  }
+
+  uint32_t getVertex(size_t i) const
+  {
+    return vertices[(vertexHead + FIFOSize - 1 - i) % FIFOSize];
+  }
+
+  /// Records a vertex that was not coded from the vertex FIFO.
+  void pushVertex(uint32_t v)
+  {
+    vertices[vertexHead] = v;
+    vertexHead = (vertexHead + 1) % FIFOSize;
+    if (v >= next)
+      next = v + 1;
+  }
+
+  /// Appends vertex 'v', coded against 'base' or 'other', and returns its
+  /// mode.
+  unsigned encodeVertex(uint32_t v, uint32_t base, uint32_t other,
+                        std::vector<uint8_t>& extra)
+  {
+    if (v == next)
+    {
+      pushVertex(v);
+      return VertexNext;
+    }
+
+    size_t i = findVertex(v);
+    if (i < FIFOSize)
+    {
+      extra.push_back(static_cast<uint8_t>(i));
+      return VertexFIFO;
+    }
+
+    pushVertex(v);
+    if (zigzag(v - other) < zigzag(v - base))
+    {
+      putVarint(zigzag(v - other), extra);
+      return VertexExplicitOther;
+    }
+    putVarint(zigzag(v - base), extra);
+    return VertexExplicit;
+  }
+
+  /// Decodes a vertex coded with 'mode' against 'base' or 'other'.
+  uint32_t decodeVertex(unsigned mode, uint32_t base, uint32_t other, uint64_t limit,
+                        const uint8_t* data, size_t size, size_t& offset)
+  {
+    uint32_t v;
+    switch (mode)
+    {
+      case VertexNext:
+        v = next;
+        break;
+
+      case VertexFIFO:
+      {
+        uint8_t i = getByte(data, size, offset);
+        if (i >= FIFOSize)
+          throw std::invalid_argument("Malformed index data.");
+        return getVertex(i);
+      }
+
+      case VertexExplicit:
+        v = base + unzigzag(getVarint(data, size, offset));
+        break;
+
+      default:
+        v = other + unzigzag(getVarint(data, size, offset));
+        break;
+    }
+
+    if (v >= limit)
+      throw std::invalid_argument("Malformed index data.");
+    pushVertex(v);
+    return v;
+  }
+
+  uint32_t  edges[2 * FIFOSize];    ///< Pairs of vertices.
+  size_t    edgeHead;               ///< Where the next edge goes.
+  uint32_t  vertices[FIFOSize];
+  size_t    vertexHead;             ///< Where the next vertex goes.
+  uint32_t  next;                   ///< One past the largest vertex so far.
+  uint32_t  previous;               ///< Last index coded.
+};
+
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
+void encodeVertices(const uint8_t* vertices, size_t count, size_t stride,
+                    std::vector<uint8_t>& out)
+{
+  const size_t numWords = stride / 4;
+  std::vector<uint8_t> previous(stride, 0);
+  std::vector<uint8_t> header(getHeaderSize(stride));
+  uint32_t words[BlockSize];
+  uint8_t deltas[BlockSize];
+  for (size_t first = 0; first < count; first += BlockSize)
+  {
+    // Vertices past the end repeat the last one, giving zero deltas.
+    size_t numVertices = std::min(BlockSize, count - first);
+    size_t headerOffset = out.size();
+    std::fill(header.begin(), header.end(), 0);
+    out.resize(out.size() + header.size());
+
+    for (size_t w = 0; w < numWords; ++w)
+    {
+      uint32_t last = loadWord(&previous[4 * w]);
+      for (size_t i = 0; i < BlockSize; ++i)
+      {
+        uint32_t value = (i < numVertices) ? loadWord(vertices + (first + i) * stride + 4 * w) : last;
+        uint32_t delta = value - last;
+        words[i] = zigzag(delta);
+        last = value;
+      }
+      storeWord(&previous[4 * w], last);
+
+      for (size_t b = 0; b < 4; ++b)
+      {
+        for (size_t i = 0; i < BlockSize; ++i)
+          deltas[i] = static_cast<uint8_t>(words[i] >> (8 * b));
+        packPlane(deltas, header, 4 * w + b, out);
+      }
+    }
+
+    for (size_t k = 4 * numWords; k < stride; ++k)
+    {
+      uint8_t last = previous[k];
+      for (size_t i = 0; i < BlockSize; ++i)
+      {
+        uint8_t value = (i < numVertices) ? vertices[(first + i) * stride + k] : last;
+        uint8_t delta = static_cast<uint8_t>(value - last);
+        deltas[i] = static_cast<uint8_t>((delta << 1) ^ ((delta & 0x80) ? 0xFF : 0x00));
+        last = value;
+      }
+      previous[k] = last;
+      packPlane(deltas, header, k, out);
+    }
+
+    std::copy(header.begin(), header.end(), out.begin() + headerOffset);
+  }
+}
+
+//------------------------------------------------------------------------------
+void decodeVertices(const uint8_t* data, size_t size, size_t count,
+                    size_t stride, uint8_t* vertices)
+{
+  const size_t numWords = stride / 4;
+  std::vector<uint8_t> previous(stride, 0);
+  uint32_t words[BlockSize];
+  uint8_t bytes[BlockSize];
+  size_t offset = 0;
+
+  // Returns the next plane and its mode.
+  auto nextPlane = [&](const uint8_t* header, size_t plane, unsigned& mode)
+  {
+    mode = (header[plane / 4] >> (2 * (plane % 4))) & 0x03;
+    if (size - offset < getPlaneSize(mode))
+      throw std::invalid_argument("Truncated vertex data.");
+    const uint8_t* in = data + offset;
+    offset += getPlaneSize(mode);
+    return in;
+  };
+
+  for (size_t first = 0; first < count; first += BlockSize)
+  {
+    size_t numVertices = std::min(BlockSize, count - first);
+    if (size - offset < getHeaderSize(stride))
+      throw std::invalid_argument("Truncated vertex data.");
+    const uint8_t* header = data + offset;
+    offset += getHeaderSize(stride);
+
+    uint8_t* out = vertices + first * stride;
+    for (size_t w = 0; w < numWords; ++w)
+    {
+      const uint8_t* planes[4];
+      unsigned modes[4];
+      for (size_t b = 0; b < 4; ++b)
+        planes[b] = nextPlane(header, 4 * w + b, modes[b]);
+
+      decodeWords(planes, modes, loadWord(&previous[4 * w]), words);
+      storeWord(&previous[4 * w], words[BlockSize - 1]);
+
+      for (size_t i = 0; i < numVertices; ++i)
+        storeWord(out + i * stride + 4 * w, words[i]);
+    }
+
+    for (size_t k = 4 * numWords; k < stride; ++k)
+    {
+      unsigned mode;
+      const uint8_t* plane = nextPlane(header, k, mode);
+      decodeBytes(plane, mode, previous[k], bytes);
+      previous[k] = bytes[BlockSize - 1];
+
+      for (size_t i = 0; i < numVertices; ++i)
+        out[i * stride + k] = bytes[i];
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+void encodeIndices(const uint8_t* indices, size_t count, size_t indexSize,
+                   std::vector<uint8_t>& out)
+{
+  checkIndexSize(indexSize);
+
+  TriangleCoder coder;
+  std::vector<uint8_t> extra;
+  size_t numTriangles = count / 3;
+  for (size_t t = 0; t < numTriangles; ++t)
+  {
+    uint32_t tri[3];
+    for (size_t k = 0; k < 3; ++k)
+      tri[k] = getIndex(indices, 3 * t + k, indexSize);
+
+    // Look for a shared edge in each rotation of the triangle.
+    size_t edge = FIFOSize;
+    unsigned rotation = 0;
+    for (; rotation < 3; ++rotation)
+    {
+      edge = coder.findEdge(tri[rotation], tri[(rotation + 1) % 3]);
+      if (edge < FIFOSize)
+        break;
+    }
+
+    extra.clear();
+    uint8_t code;
+    if (edge < FIFOSize)
+    {
+      unsigned third = coder.encodeVertex(tri[(rotation + 2) % 3], tri[(rotation + 1) % 3],
+                                          tri[rotation], extra);
+      code = static_cast<uint8_t>((edge << 4) | (rotation << 2) | third);
+    }
+    else
+    {
+      uint32_t base = coder.previous;
+      unsigned modes[3];
+      for (size_t k = 0; k < 3; ++k)
+      {
+        modes[k] = coder.encodeVertex(tri[k], base, base, extra);
+        base = tri[k];
+      }
+      code = static_cast<uint8_t>((modes[0] << 6) | (modes[1] << 4)
+                                  | (RotationNoEdge << 2) | modes[2]);
+    }
+
+    out.push_back(code);
+    out.insert(out.end(), extra.begin(), extra.end());
+    coder.pushTriangle(tri[0], tri[1], tri[2]);
+  }
+
+  // Indices that do not make up a whole triangle.
+  for (size_t i = 3 * numTriangles; i < count; ++i)
+  {
+    uint32_t index = getIndex(indices, i, indexSize);
+    putVarint(zigzag(index - coder.previous), out);
+    coder.previous = index;
+  }
+}
+
+//------------------------------------------------------------------------------
+void decodeIndices(const uint8_t* data, size_t size, size_t count,
+                   size_t indexSize, uint8_t* indices)
+{
+  checkIndexSize(indexSize);
+
+  uint64_t limit = uint64_t(1) << (8 * indexSize);
+  TriangleCoder coder;
+  size_t offset = 0;
+  size_t numTriangles = count / 3;
+  for (size_t t = 0; t < numTriangles; ++t)
+  {
+    uint8_t code = getByte(data, size, offset);
+    unsigned rotation = (code >> 2) & 0x03;
+
+    uint32_t tri[3];
+    if (rotation != RotationNoEdge)
+    {
+      // Edge FIFO entries and the vertices decoded from them were checked
+      // against the limit when they were decoded.
+      const uint32_t* edge = coder.getEdge(code >> 4);
+      tri[rotation]           = edge[0];
+      tri[(rotation + 1) % 3] = edge[1];
+      tri[(rotation + 2) % 3] = coder.decodeVertex(code & 0x03, edge[1], edge[0], limit,
+                                                   data, size, offset);
+    }
+    else
+    {
+      const unsigned modes[3] = {
+        static_cast<unsigned>(code >> 6),
+        static_cast<unsigned>((code >> 4) & 0x03),
+        static_cast<unsigned>(code & 0x03)
+      };
+      uint32_t base = coder.previous;
+      for (size_t k = 0; k < 3; ++k)
+      {
+        // There is no other base.
+        if (modes[k] == VertexExplicitOther)
+          throw std::invalid_argument("Malformed index data.");
+        tri[k] = coder.decodeVertex(modes[k], base, base, limit, data, size, offset);
+        base = tri[k];
+      }
+    }
+
+    for (size_t k = 0; k < 3; ++k)
+      setIndex(indices, 3 * t + k, indexSize, tri[k]);
+    coder.pushTriangle(tri[0], tri[1], tri[2]);
+  }
+
+  for (size_t i = 3 * numTriangles; i < count; ++i)
+  {
+    uint32_t index = coder.previous + unzigzag(getVarint(data, size, offset));
+    if (index >= limit)
+      throw std::invalid_argument("Malformed index data.");
+
+    setIndex(indices, i, indexSize, index);
+    coder.previous = index;
+  }
+}
+
+//------------------------------------------------------------------------------
+void quantizeFloats(float* values, size_t count, unsigned mantissaBits)
+{
+  if (mantissaBits >= 23)
+    return;
+
+  const uint32_t exponent = 0x7F800000u;
+  uint32_t shift = 23 - mantissaBits;
+  uint32_t mask  = (uint32_t(1) << shift) - 1;
+  uint32_t half  = uint32_t(1) << (shift - 1);
+  for (size_t i = 0; i < count; ++i)
+  {
+    uint32_t bits;
+    std::memcpy(&bits, &values[i], sizeof(bits));
+    if ((bits & exponent) == exponent)
+      continue;
+
+    // Round to nearest. Values that would round up to infinity are
+    // truncated instead.
+    uint32_t rounded = (bits + half) & ~mask;
+    if ((rounded & exponent) == exponent)
+      rounded = bits & ~mask;
+
+    std::memcpy(&values[i], &rounded, sizeof(rounded));
+  }
+}
+
+} // namespace CPM_SPIRE_NS
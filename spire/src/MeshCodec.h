@@ -0,0 +1,89 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2013 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+/// \author agent
+/// \date   October 2026
+
+#ifndef SPIRE_HIGH_MESHCODEC_H
+#define SPIRE_HIGH_MESHCODEC_H
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace CPM_SPIRE_NS {
+
+// Lossless compression of vertex and index buffers, used by SR6 asset files.
+//
+// Vertices are coded in blocks of 16. Every 4 bytes of the vertex are delta
+// coded as a 32 bit word against the same word of the previous vertex, and
+// the zigzag coded deltas are split into 4 planes: the low bytes of the 16
+// deltas, then the next bytes, and so on. Trailing bytes of vertices whose
+// size is not a multiple of 4 are delta coded byte by byte, one plane each.
+// Each plane is stored with the fewest bits (0, 2, 4, or 8) that hold its
+// bytes. Smooth attributes leave the high planes small. The decoder uses
+// SSE2 when it is available.
+//
+// Indices are coded a triangle at a time. Triangles sharing an edge with one
+// of the last few triangles take a byte, plus one or two for their third
+// vertex unless it is new. Indices past the last whole triangle are delta
+// coded against the previous index and stored as zigzag varints.
+//
+// None of these depend on GL and they may be used from any thread.
+
+/// Appends the encoding of 'count' vertices of 'stride' bytes to 'out'.
+void encodeVertices(const uint8_t* vertices, size_t count, size_t stride,
+                    std::vector<uint8_t>& out);
+
+/// Decodes 'count' vertices of 'stride' bytes from the 'size' bytes at
+/// 'data' into 'vertices'. Throws std::invalid_argument if 'data' is
+/// truncated.
+void decodeVertices(const uint8_t* data, size_t size, size_t count,
+                    size_t stride, uint8_t* vertices);
+
+/// Appends the encoding of 'count' indices of 'indexSize' (1, 2, or 4)
+/// bytes to 'out'. Any indices are accepted, but only triangle lists code
+/// well.
+void encodeIndices(const uint8_t* indices, size_t count, size_t indexSize,
+                   std::vector<uint8_t>& out);
+
+/// Decodes 'count' indices of 'indexSize' bytes from the 'size' bytes at
+/// 'data' into 'indices'. Throws std::invalid_argument if 'data' is
+/// truncated or malformed.
+void decodeIndices(const uint8_t* data, size_t size, size_t count,
+                   size_t indexSize, uint8_t* indices);
+
+/// Rounds 'values' to 'mantissaBits' (0 to 23) bits of mantissa. This is
+/// lossy, but zeroes the low bytes of every value, which encodeVertices
+/// stores for free. 10 to 14 bits are plenty for most positions and
+/// normals. Infinities and NaNs are left alone.
+void quantizeFloats(float* values, size_t count, unsigned mantissaBits);
+
+} // namespace CPM_SPIRE_NS
+
+#endif
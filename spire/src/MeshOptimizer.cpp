@@ -0,0 +1,453 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2013 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+/// \author agent
+/// \date   October 2026
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+#include "MeshOptimizer.h"
+
+namespace CPM_SPIRE_NS {
+
+namespace {
+
+void validateTriangleList(const std::vector<uint32_t>& indices, size_t numVertices)
+{
+  if (indices.size() % 3 != 0)
+    throw std::invalid_argument("Mesh optimization requires a triangle list.");
+
+  for (auto it = indices.begin(); it != indices.end(); ++it)
+  {
+    if (*it >= numVertices)
+      throw std::invalid_argument("Index out of range during mesh optimization.");
+  }
+}
+
+void readPosition(const uint8_t* vertices, size_t stride, size_t positionOffset,
+                  uint32_t vertex, float* out)
+{
+  std::memcpy(out, vertices + vertex * stride + positionOffset, 3 * sizeof(float));
+}
+
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
+float computeACMR(const std::vector<uint32_t>& indices, size_t numVertices,
+                  size_t cacheSize)
+{
+  validateTriangleList(indices, numVertices);
+  if (indices.empty())
+    return 0.0f;
+
+  // A vertex is in the FIFO cache if it entered within the last 'cacheSize'
+  // misses. Timestamps start past the cache size so every vertex misses once.
+  std::vector<size_t> cacheTime(numVertices, 0);
+  size_t time = cacheSize + 1;
+  size_t misses = 0;
+  for (auto it = indices.begin(); it != indices.end(); ++it)
+  {
+    if (time - cacheTime[*it] > cacheSize)
+    {
+      cacheTime[*it] = time++;
+      ++misses;
+    }
+  }
+
+  return static_cast<float>(misses) / static_cast<float>(indices.size() / 3);
+}
+
+//------------------------------------------------------------------------------
+void optimizeVertexCache(std::vector<uint32_t>& indices, size_t numVertices,
+                         std::vector<size_t>* clustersOut, size_t cacheSize)
+{
+  validateTriangleList(indices, numVertices);
+  if (clustersOut != nullptr)
+    clustersOut->clear();
+
+  size_t numTriangles = indices.size() / 3;
+  if (numTriangles == 0)
+    return;
+
+  // Triangles around each vertex, packed.
+  std::vector<uint32_t> firstTriangle(numVertices + 1, 0);
+  for (auto it = indices.begin(); it != indices.end(); ++it)
+    ++firstTriangle[*it + 1];
+  for (size_t v = 0; v < numVertices; ++v)
+    firstTriangle[v + 1] += firstTriangle[v];
+
+  std::vector<uint32_t> vertexTriangles(indices.size());
+  std::vector<uint32_t> fill(firstTriangle.begin(), firstTriangle.end() - 1);
+  for (size_t i = 0; i < indices.size(); ++i)
+    vertexTriangles[fill[indices[i]]++] = static_cast<uint32_t>(i / 3);
+
+  // Number of triangles around each vertex that have not been emitted yet.
+  std::vector<uint32_t> live(numVertices);
+  for (size_t v = 0; v < numVertices; ++v)
+    live[v] = firstTriangle[v + 1] - firstTriangle[v];
+
+  std::vector<size_t>   cacheTime(numVertices, 0);
+  std::vector<bool>     emitted(numTriangles, false);
+  std::vector<uint32_t> deadEnd;      // Recently referenced vertices.
+  std::vector<uint32_t> candidates;   // Vertices of the last fan.
+  std::vector<size_t>   hardClusters; // Cache is cold at these triangles.
+  std::vector<uint32_t> output;
+  output.reserve(indices.size());
+
+  size_t time   = cacheSize + 1;
+  size_t cursor = 0;
+
+  // Continues with a recently referenced vertex or, failing that, the next
+  // vertex in input order that still has triangles left.
+  auto skipDeadEnd = [&](uint32_t& vertex) -> bool
+  {
+    while (deadEnd.empty() == false)
+    {
+      vertex = deadEnd.back();
+      deadEnd.pop_back();
+      if (live[vertex] > 0)
+        return true;
+    }
+    for (; cursor < numVertices; ++cursor)
+    {
+      if (live[cursor] > 0)
+      {
+        vertex = static_cast<uint32_t>(cursor);
+        return true;
+      }
+    }
+    return false;
+  };
+
+  uint32_t fanning;
+  bool more     = skipDeadEnd(fanning);
+  bool boundary = true;
+  while (more)
+  {
+    // Emit all remaining triangles around the fanning vertex.
+    candidates.clear();
+    for (uint32_t i = firstTriangle[fanning]; i < firstTriangle[fanning + 1]; ++i)
+    {
+      uint32_t t = vertexTriangles[i];
+      if (emitted[t])
+        continue;
+
+      if (boundary)
+      {
+        hardClusters.push_back(output.size() / 3);
+        boundary = false;
+      }
+
+      for (size_t k = 0; k < 3; ++k)
+      {
+        uint32_t v = indices[3 * t + k];
+        output.push_back(v);
+        deadEnd.push_back(v);
+        candidates.push_back(v);
+        --live[v];
+        if (time - cacheTime[v] > cacheSize)
+          cacheTime[v] = time++;
+      }
+      emitted[t] = true;
+    }
+
+    // Fan around the candidate that has been in the cache the longest, as
+    // long as its remaining triangles will find it still cached.
+    bool found = false;
+    size_t bestPriority = 0;
+    for (auto it = candidates.begin(); it != candidates.end(); ++it)
+    {
+      uint32_t v = *it;
+      if (live[v] == 0)
+        continue;
+
+      size_t priority = 0;
+      if (time - cacheTime[v] + 2 * live[v] <= cacheSize)
+        priority = time - cacheTime[v];
+      if (found == false || priority > bestPriority)
+      {
+        found        = true;
+        bestPriority = priority;
+        fanning      = v;
+      }
+    }
+
+    if (found == false)
+    {
+      more     = skipDeadEnd(fanning);
+      boundary = true;
+    }
+  }
+
+  indices.swap(output);
+  if (clustersOut == nullptr)
+    return;
+
+  // Split the hard clusters further wherever the triangles so far would reach
+  // the overall ACMR even when starting with a cold cache. Reordering the
+  // resulting clusters then costs little vertex cache efficiency.
+  float threshold = computeACMR(indices, numVertices, cacheSize);
+  hardClusters.push_back(numTriangles);
+  std::fill(cacheTime.begin(), cacheTime.end(), 0);
+  time = cacheSize + 1;
+  for (size_t c = 0; c + 1 < hardClusters.size(); ++c)
+  {
+    size_t end = hardClusters[c + 1];
+    size_t misses = 0;
+    size_t triangles = 0;
+    time += cacheSize + 1;
+    clustersOut->push_back(hardClusters[c]);
+    for (size_t t = hardClusters[c]; t < end; ++t)
+    {
+      for (size_t k = 0; k < 3; ++k)
+      {
+        uint32_t v = indices[3 * t + k];
+        if (time - cacheTime[v] > cacheSize)
+        {
+          cacheTime[v] = time++;
+          ++misses;
+        }
+      }
+      ++triangles;
+
+      if (t + 1 < end && static_cast<float>(misses) <= threshold * static_cast<float>(triangles))
+      {
+        clustersOut->push_back(t + 1);
+        time += cacheSize + 1;
+        misses = 0;
+        triangles = 0;
+      }
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+void optimizeOverdraw(std::vector<uint32_t>& indices,
+                      const std::vector<size_t>& clusters,
+                      const uint8_t* vertices, size_t numVertices,
+                      size_t stride, size_t positionOffset)
+{
+  validateTriangleList(indices, numVertices);
+  if (clusters.size() < 2)
+    return;
+
+  size_t numTriangles = indices.size() / 3;
+  size_t numClusters  = clusters.size();
+
+  // Area weighted centroid and normal of each cluster, and of the mesh.
+  std::vector<double> centroids(3 * numClusters, 0.0);
+  std::vector<double> normals(3 * numClusters, 0.0);
+  std::vector<double> areas(numClusters, 0.0);
+  double meshCentroid[3] = {0.0, 0.0, 0.0};
+  double meshArea = 0.0;
+
+  for (size_t c = 0; c < numClusters; ++c)
+  {
+    size_t end = (c + 1 < numClusters) ? clusters[c + 1] : numTriangles;
+    for (size_t t = clusters[c]; t < end; ++t)
+    {
+      float p0[3], p1[3], p2[3];
+      readPosition(vertices, stride, positionOffset, indices[3 * t + 0], p0);
+      readPosition(vertices, stride, positionOffset, indices[3 * t + 1], p1);
+      readPosition(vertices, stride, positionOffset, indices[3 * t + 2], p2);
+
+      double e1[3] = {p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2]};
+      double e2[3] = {p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2]};
+      double n[3]  = {e1[1] * e2[2] - e1[2] * e2[1],
+                      e1[2] * e2[0] - e1[0] * e2[2],
+                      e1[0] * e2[1] - e1[1] * e2[0]};
+      double area = 0.5 * std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+
+      for (size_t k = 0; k < 3; ++k)
+      {
+        double center = (p0[k] + p1[k] + p2[k]) / 3.0;
+        centroids[3 * c + k] += area * center;
+        normals[3 * c + k]   += n[k];
+        meshCentroid[k]      += area * center;
+      }
+      areas[c] += area;
+      meshArea += area;
+    }
+  }
+
+  if (meshArea <= 0.0)
+    return;
+  for (size_t k = 0; k < 3; ++k)
+    meshCentroid[k] /= meshArea;
+
+  // Clusters facing away from the mesh center first.
+  std::vector<double> keys(numClusters, 0.0);
+  for (size_t c = 0; c < numClusters; ++c)
+  {
+    const double* n = &normals[3 * c];
+    double length = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+    if (areas[c] <= 0.0 || length <= 0.0)
+      continue;
+
+    for (size_t k = 0; k < 3; ++k)
+      keys[c] += (centroids[3 * c + k] / areas[c] - meshCentroid[k]) * n[k] / length;
+  }
+
+  std::vector<size_t> order(numClusters);
+  for (size_t c = 0; c < numClusters; ++c)
+    order[c] = c;
+  std::stable_sort(order.begin(), order.end(),
+                   [&keys](size_t a, size_t b) {return keys[a] > keys[b];});
+
+  std::vector<uint32_t> output;
+  output.reserve(indices.size());
+  for (auto it = order.begin(); it != order.end(); ++it)
+  {
+    size_t begin = clusters[*it];
+    size_t end   = (*it + 1 < numClusters) ? clusters[*it + 1] : numTriangles;
+    output.insert(output.end(), indices.begin() + 3 * begin, indices.begin() + 3 * end);
+  }
+  indices.swap(output);
+}
+
+//------------------------------------------------------------------------------
+size_t optimizeVertexFetch(uint8_t* vertices, size_t numVertices, size_t stride,
+                           std::vector<uint32_t>& indices)
+{
+  validateTriangleList(indices, numVertices);
+
+  const uint32_t unassigned = std::numeric_limits<uint32_t>::max();
+  std::vector<uint32_t> remap(numVertices, unassigned);
+  uint32_t next = 0;
+  for (auto it = indices.begin(); it != indices.end(); ++it)
+  {
+    if (remap[*it] == unassigned)
+      remap[*it] = next++;
+    *it = remap[*it];
+  }
+
+  size_t numReferenced = next;
+  for (size_t v = 0; v < numVertices; ++v)
+  {
+    if (remap[v] == unassigned)
+      remap[v] = next++;
+  }
+
+  std::vector<uint8_t> original(vertices, vertices + numVertices * stride);
+  for (size_t v = 0; v < numVertices; ++v)
+    std::memcpy(vertices + remap[v] * stride, &original[v * stride], stride);
+
+  return numReferenced;
+}
+
+//------------------------------------------------------------------------------
+void widenIndices(const uint8_t* data, size_t count, size_t indexSize,
+                  std::vector<uint32_t>& out)
+{
+  out.resize(count);
+  for (size_t i = 0; i < count; ++i)
+  {
+    switch (indexSize)
+    {
+      case 1:
+        out[i] = data[i];
+        break;
+
+      case 2:
+        {
+          uint16_t index;
+          std::memcpy(&index, data + i * sizeof(uint16_t), sizeof(index));
+          out[i] = index;
+        }
+        break;
+
+      default:
+        std::memcpy(&out[i], data + i * sizeof(uint32_t), sizeof(uint32_t));
+        break;
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+void narrowIndices(const std::vector<uint32_t>& indices, size_t indexSize,
+                   std::vector<uint8_t>& out)
+{
+  out.resize(indices.size() * indexSize);
+  for (size_t i = 0; i < indices.size(); ++i)
+  {
+    switch (indexSize)
+    {
+      case 1:
+        out[i] = static_cast<uint8_t>(indices[i]);
+        break;
+
+      case 2:
+        {
+          uint16_t index = static_cast<uint16_t>(indices[i]);
+          std::memcpy(&out[i * sizeof(uint16_t)], &index, sizeof(index));
+        }
+        break;
+
+      default:
+        std::memcpy(&out[i * sizeof(uint32_t)], &indices[i], sizeof(uint32_t));
+        break;
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+size_t getMinIndexSize(const std::vector<uint32_t>& indices)
+{
+  uint32_t maxIndex = 0;
+  for (auto it = indices.begin(); it != indices.end(); ++it)
+    maxIndex = std::max(maxIndex, *it);
+
+  if (maxIndex <= std::numeric_limits<uint8_t>::max())
+    return sizeof(uint8_t);
+  if (maxIndex <= std::numeric_limits<uint16_t>::max())
+    return sizeof(uint16_t);
+  return sizeof(uint32_t);
+}
+
+//------------------------------------------------------------------------------
+MeshOptimizerStats optimizeMesh(uint8_t* vertices, size_t numVertices,
+                                size_t stride, size_t positionOffset,
+                                std::vector<uint32_t>& indices)
+{
+  MeshOptimizerStats stats;
+  stats.acmrBefore = computeACMR(indices, numVertices);
+
+  std::vector<size_t> clusters;
+  optimizeVertexCache(indices, numVertices, &clusters);
+  optimizeOverdraw(indices, clusters, vertices, numVertices, stride, positionOffset);
+  optimizeVertexFetch(vertices, numVertices, stride, indices);
+
+  stats.acmrAfter = computeACMR(indices, numVertices);
+  return stats;
+}
+
+} // namespace CPM_SPIRE_NS
@@ -0,0 +1,112 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2013 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+/// \author agent
+/// \date   October 2026
+
+#ifndef SPIRE_HIGH_MESHOPTIMIZER_H
+#define SPIRE_HIGH_MESHOPTIMIZER_H
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace CPM_SPIRE_NS {
+
+// Triangle list optimizations that reduce the number of vertex shader
+// invocations and the amount of overdraw, without changing what is drawn.
+// Based on "Fast Triangle Reordering for Vertex Locality and Reduced
+// Overdraw" (Sander, Nehab, and Barczak 2007).
+//
+// None of these depend on GL and they may be used from any thread.
+
+/// Post-transform vertex cache size the optimizations target. Smaller than
+/// the cache of most hardware, which keeps the ordering effective there.
+const size_t MeshOptimizerCacheSize = 16;
+
+/// Average cache miss ratio: the number of vertex shader invocations per
+/// triangle when 'indices' is drawn through a FIFO cache of 'cacheSize'
+/// vertices. Ranges from about 0.5 (ideal) to 3 (no reuse). Returns 0 for an
+/// empty triangle list.
+float computeACMR(const std::vector<uint32_t>& indices, size_t numVertices,
+                  size_t cacheSize = MeshOptimizerCacheSize);
+
+/// Reorders the triangles of 'indices' for vertex cache hits (Tipsify). If
+/// 'clustersOut' is given, it receives the index of the first triangle of
+/// each cluster of triangles that may be moved around as a whole without
+/// raising the ACMR much (see optimizeOverdraw). Throws
+/// std::invalid_argument if the number of indices is not a multiple of 3 or
+/// if an index is out of range.
+void optimizeVertexCache(std::vector<uint32_t>& indices, size_t numVertices,
+                         std::vector<size_t>* clustersOut = nullptr,
+                         size_t cacheSize = MeshOptimizerCacheSize);
+
+/// Reorders the clusters computed by optimizeVertexCache so that clusters
+/// facing away from the center of the mesh are drawn first. They are the
+/// most likely to occlude the rest of the mesh. Positions are 3 floats,
+/// 'positionOffset' bytes into each vertex, vertices are 'stride' bytes
+/// apart.
+void optimizeOverdraw(std::vector<uint32_t>& indices,
+                      const std::vector<size_t>& clusters,
+                      const uint8_t* vertices, size_t numVertices,
+                      size_t stride, size_t positionOffset);
+
+/// Reorders the vertices in the order the triangles first reference them,
+/// so vertices are fetched sequentially, and rewrites 'indices' to match.
+/// Vertices that are not referenced are moved to the end. Returns the number
+/// of referenced vertices.
+size_t optimizeVertexFetch(uint8_t* vertices, size_t numVertices, size_t stride,
+                           std::vector<uint32_t>& indices);
+
+/// Reads 'count' indices of 'indexSize' bytes (1, 2, or 4) from 'data'.
+void widenIndices(const uint8_t* data, size_t count, size_t indexSize,
+                  std::vector<uint32_t>& out);
+
+/// Writes 'indices' as indices of 'indexSize' bytes (1, 2, or 4). Indices
+/// that do not fit are truncated.
+void narrowIndices(const std::vector<uint32_t>& indices, size_t indexSize,
+                   std::vector<uint8_t>& out);
+
+/// Smallest index size (1, 2, or 4 bytes) that holds all of 'indices'.
+size_t getMinIndexSize(const std::vector<uint32_t>& indices);
+
+/// ACMR of a triangle list before and after optimizeMesh.
+struct MeshOptimizerStats
+{
+  float acmrBefore;
+  float acmrAfter;
+};
+
+/// Runs optimizeVertexCache, optimizeOverdraw, and optimizeVertexFetch.
+MeshOptimizerStats optimizeMesh(uint8_t* vertices, size_t numVertices,
+                                size_t stride, size_t positionOffset,
+                                std::vector<uint32_t>& indices);
+
+} // namespace CPM_SPIRE_NS
+
+#endif
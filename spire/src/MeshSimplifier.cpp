@@ -0,0 +1,377 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2013 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+/// \author agent
+/// \date   October 2026
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+#include "MeshSimplifier.h"
+
+namespace CPM_SPIRE_NS {
+
+//------------------------------------------------------------------------------
+// Quadric
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+MeshSimplifier::Quadric::Quadric()
+{
+  std::fill(q, q + 10, 0.0);
+}
+
+//------------------------------------------------------------------------------
+void MeshSimplifier::Quadric::addPlane(double a, double b, double c, double d)
+{
+  q[0] += a * a; q[1] += a * b; q[2] += a * c; q[3] += a * d;
+                 q[4] += b * b; q[5] += b * c; q[6] += b * d;
+                                q[7] += c * c; q[8] += c * d;
+                                               q[9] += d * d;
+}
+
+//------------------------------------------------------------------------------
+void MeshSimplifier::Quadric::add(const Quadric& other)
+{
+  for (int i = 0; i < 10; ++i)
+    q[i] += other.q[i];
+}
+
+//------------------------------------------------------------------------------
+double MeshSimplifier::Quadric::evaluate(const double* p) const
+{
+  const double x = p[0], y = p[1], z = p[2];
+  return        q[0] * x * x + 2.0 * q[1] * x * y + 2.0 * q[2] * x * z + 2.0 * q[3] * x
+              + q[4] * y * y + 2.0 * q[5] * y * z + 2.0 * q[6] * y
+              + q[7] * z * z + 2.0 * q[8] * z
+              + q[9];
+}
+
+//------------------------------------------------------------------------------
+// MeshSimplifier
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+static void triangleNormal(const double* p0, const double* p1, const double* p2,
+                           double* n)
+{
+  const double e1[3] = {p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2]};
+  const double e2[3] = {p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2]};
+  n[0] = e1[1] * e2[2] - e1[2] * e2[1];
+  n[1] = e1[2] * e2[0] - e1[0] * e2[2];
+  n[2] = e1[0] * e2[1] - e1[1] * e2[0];
+}
+
+//------------------------------------------------------------------------------
+MeshSimplifier::MeshSimplifier(const uint8_t* vertices, size_t numVertices,
+                               size_t stride, size_t positionOffset,
+                               const std::vector<uint32_t>& indices) :
+    mPositions(3 * numVertices),
+    mQuadrics(numVertices),
+    mStamps(numVertices, 0),
+    mLocked(numVertices, false),
+    mRemoved(numVertices, false),
+    mVertexTriangles(numVertices),
+    mTriangles(indices),
+    mTriangleRemoved(indices.size() / 3, false),
+    mNumTriangles(indices.size() / 3),
+    mVisited(numVertices, 0),
+    mVisitMark(0),
+    mMaxCost(0.0)
+{
+  if (indices.size() % 3 != 0)
+    throw std::invalid_argument("Mesh simplification requires a triangle list.");
+
+  for (size_t i = 0; i < numVertices; ++i)
+  {
+    float pos[3];
+    std::memcpy(pos, vertices + i * stride + positionOffset, sizeof(pos));
+    mPositions[3 * i + 0] = pos[0];
+    mPositions[3 * i + 1] = pos[1];
+    mPositions[3 * i + 2] = pos[2];
+  }
+
+  // Plane quadrics and vertex to triangle adjacency.
+  for (size_t t = 0; t < mNumTriangles; ++t)
+  {
+    const uint32_t* tri = &mTriangles[3 * t];
+    if (tri[0] >= numVertices || tri[1] >= numVertices || tri[2] >= numVertices)
+      throw std::invalid_argument("Index out of range during mesh simplification.");
+
+    double n[3];
+    triangleNormal(position(tri[0]), position(tri[1]), position(tri[2]), n);
+    double len = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+    if (len > 0.0)
+    {
+      n[0] /= len; n[1] /= len; n[2] /= len;
+      const double* p = position(tri[0]);
+      double d = -(n[0] * p[0] + n[1] * p[1] + n[2] * p[2]);
+      for (int k = 0; k < 3; ++k)
+        mQuadrics[tri[k]].addPlane(n[0], n[1], n[2], d);
+    }
+
+    for (int k = 0; k < 3; ++k)
+      mVertexTriangles[tri[k]].push_back(static_cast<uint32_t>(t));
+  }
+
+  // An edge is on the boundary if it is used by a single triangle, i.e. if
+  // it appears an odd number of times. Gather edges with the smaller vertex
+  // first and count duplicates.
+  std::vector<std::pair<uint32_t, uint32_t>> edges;
+  edges.reserve(mTriangles.size());
+  for (size_t t = 0; t < mNumTriangles; ++t)
+  {
+    const uint32_t* tri = &mTriangles[3 * t];
+    for (int k = 0; k < 3; ++k)
+    {
+      uint32_t a = tri[k];
+      uint32_t b = tri[(k + 1) % 3];
+      edges.push_back(std::make_pair(std::min(a, b), std::max(a, b)));
+    }
+  }
+  std::sort(edges.begin(), edges.end());
+
+  for (size_t i = 0; i < edges.size();)
+  {
+    size_t j = i + 1;
+    while (j < edges.size() && edges[j] == edges[i])
+      ++j;
+    if (j - i == 1)
+    {
+      mLocked[edges[i].first]  = true;
+      mLocked[edges[i].second] = true;
+    }
+    i = j;
+  }
+
+  for (size_t i = 0; i < edges.size(); ++i)
+  {
+    if (i == 0 || edges[i] != edges[i - 1])
+      pushEdge(edges[i].first, edges[i].second);
+  }
+  std::make_heap(mHeap.begin(), mHeap.end());
+}
+
+//------------------------------------------------------------------------------
+void MeshSimplifier::pushEdge(uint32_t a, uint32_t b)
+{
+  if (a == b || (mLocked[a] && mLocked[b]))
+    return;
+
+  Quadric q = mQuadrics[a];
+  q.add(mQuadrics[b]);
+
+  // Only queue the cheaper direction. The other is requeued if this one is
+  // rejected and either endpoint changes.
+  double costAB = mLocked[a] ? -1.0 : std::max(0.0, q.evaluate(position(b)));
+  double costBA = mLocked[b] ? -1.0 : std::max(0.0, q.evaluate(position(a)));
+
+  Collapse c;
+  if (costBA < 0.0 || (costAB >= 0.0 && costAB <= costBA))
+  {
+    c.cost = costAB;
+    c.from = a;
+    c.to   = b;
+  }
+  else
+  {
+    c.cost = costBA;
+    c.from = b;
+    c.to   = a;
+  }
+  c.fromStamp = mStamps[c.from];
+  c.toStamp   = mStamps[c.to];
+  mHeap.push_back(c);
+}
+
+//------------------------------------------------------------------------------
+bool MeshSimplifier::isCollapseValid(uint32_t from, uint32_t to) const
+{
+  const std::vector<uint32_t>& tris = mVertexTriangles[from];
+  for (auto it = tris.begin(); it != tris.end(); ++it)
+  {
+    if (mTriangleRemoved[*it])
+      continue;
+
+    const uint32_t* tri = &mTriangles[3 * *it];
+    if (tri[0] == to || tri[1] == to || tri[2] == to)
+      continue;   // Degenerates and is removed.
+
+    const double* before[3];
+    const double* after[3];
+    for (int k = 0; k < 3; ++k)
+    {
+      before[k] = position(tri[k]);
+      after[k]  = (tri[k] == from) ? position(to) : before[k];
+    }
+
+    double n0[3], n1[3];
+    triangleNormal(before[0], before[1], before[2], n0);
+    triangleNormal(after[0], after[1], after[2], n1);
+    if (n0[0] * n1[0] + n0[1] * n1[1] + n0[2] * n1[2] <= 0.0)
+      return false;
+  }
+  return true;
+}
+
+//------------------------------------------------------------------------------
+void MeshSimplifier::collapse(uint32_t from, uint32_t to)
+{
+  std::vector<uint32_t>& fromTris = mVertexTriangles[from];
+  std::vector<uint32_t>& toTris   = mVertexTriangles[to];
+  for (auto it = fromTris.begin(); it != fromTris.end(); ++it)
+  {
+    if (mTriangleRemoved[*it])
+      continue;
+
+    uint32_t* tri = &mTriangles[3 * *it];
+    if (tri[0] == to || tri[1] == to || tri[2] == to)
+    {
+      mTriangleRemoved[*it] = true;
+      --mNumTriangles;
+      continue;
+    }
+
+    for (int k = 0; k < 3; ++k)
+    {
+      if (tri[k] == from)
+        tri[k] = to;
+    }
+    toTris.push_back(*it);
+  }
+  fromTris.clear();
+  fromTris.shrink_to_fit();
+
+  mQuadrics[to].add(mQuadrics[from]);
+  mRemoved[from] = true;
+  ++mStamps[to];
+
+  // Drop removed triangles from 'to' and requeue the edges around it, whose
+  // costs changed along with its quadric.
+  toTris.erase(std::remove_if(toTris.begin(), toTris.end(),
+                              [this](uint32_t t) {return mTriangleRemoved[t];}),
+               toTris.end());
+
+  ++mVisitMark;
+  mVisited[to] = mVisitMark;
+  for (auto it = toTris.begin(); it != toTris.end(); ++it)
+  {
+    const uint32_t* tri = &mTriangles[3 * *it];
+    for (int k = 0; k < 3; ++k)
+    {
+      if (mVisited[tri[k]] != mVisitMark)
+      {
+        mVisited[tri[k]] = mVisitMark;
+        size_t heapSize = mHeap.size();
+        pushEdge(to, tri[k]);
+        if (mHeap.size() != heapSize)
+          std::push_heap(mHeap.begin(), mHeap.end());
+      }
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+size_t MeshSimplifier::simplify(size_t targetTriangles)
+{
+  while (mNumTriangles > targetTriangles && mHeap.empty() == false)
+  {
+    std::pop_heap(mHeap.begin(), mHeap.end());
+    Collapse c = mHeap.back();
+    mHeap.pop_back();
+
+    // Skip collapses computed before either vertex changed.
+    if (   mRemoved[c.from] || mRemoved[c.to]
+        || mStamps[c.from] != c.fromStamp || mStamps[c.to] != c.toStamp)
+      continue;
+
+    if (isCollapseValid(c.from, c.to) == false)
+      continue;
+
+    collapse(c.from, c.to);
+    mMaxCost = std::max(mMaxCost, c.cost);
+  }
+
+  return mNumTriangles;
+}
+
+//------------------------------------------------------------------------------
+void MeshSimplifier::getIndices(std::vector<uint32_t>& indicesOut) const
+{
+  indicesOut.clear();
+  indicesOut.reserve(3 * mNumTriangles);
+  for (size_t t = 0; t < mTriangleRemoved.size(); ++t)
+  {
+    if (mTriangleRemoved[t] == false)
+      indicesOut.insert(indicesOut.end(), &mTriangles[3 * t], &mTriangles[3 * t] + 3);
+  }
+}
+
+//------------------------------------------------------------------------------
+float MeshSimplifier::getError() const
+{
+  return static_cast<float>(std::sqrt(mMaxCost));
+}
+
+//------------------------------------------------------------------------------
+std::vector<LODLevel> buildLODChain(const uint8_t* vertices, size_t numVertices,
+                                    size_t stride, size_t positionOffset,
+                                    const std::vector<uint32_t>& indices,
+                                    size_t maxLevels, size_t minTriangles)
+{
+  std::vector<LODLevel> levels;
+  MeshSimplifier simplifier(vertices, numVertices, stride, positionOffset, indices);
+
+  // A single simplification run; every level is a snapshot along the way so
+  // quadrics, and hence errors, accumulate across levels.
+  size_t numTriangles = simplifier.getNumTriangles();
+  while (levels.size() < maxLevels)
+  {
+    size_t target = numTriangles / 2;
+    if (target < minTriangles)
+      break;
+
+    size_t remaining = simplifier.simplify(target);
+
+    // Stop once the mesh is mostly locked and barely shrinks.
+    if (remaining > numTriangles - numTriangles / 8)
+      break;
+
+    LODLevel level;
+    simplifier.getIndices(level.indices);
+    level.error = simplifier.getError();
+    levels.push_back(std::move(level));
+    numTriangles = remaining;
+  }
+
+  return levels;
+}
+
+} // namespace CPM_SPIRE_NS
@@ -0,0 +1,149 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2013 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+/// \author agent
+/// \date   October 2026
+
+#ifndef SPIRE_HIGH_MESHSIMPLIFIER_H
+#define SPIRE_HIGH_MESHSIMPLIFIER_H
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace CPM_SPIRE_NS {
+
+/// Simplifies an indexed triangle list using quadric error metric edge
+/// collapses (Garland & Heckbert). Edges are collapsed onto one of their
+/// endpoints, so the simplified triangles index the original vertices and can
+/// be drawn with the original VBO.
+///
+/// Vertices on a boundary edge (an edge used by a single triangle) never
+/// move, which keeps holes and seams between split vertices intact.
+/// Collapses that would flip a triangle are rejected.
+///
+/// Does not depend on GL and may be used from any thread.
+class MeshSimplifier
+{
+public:
+  /// Positions are 3 floats, 'positionOffset' bytes into each vertex.
+  /// Vertices are 'stride' bytes apart. 'indices' is a triangle list.
+  /// Throws std::invalid_argument if the number of indices is not a multiple
+  /// of 3 or if an index is out of range.
+  MeshSimplifier(const uint8_t* vertices, size_t numVertices, size_t stride,
+                 size_t positionOffset, const std::vector<uint32_t>& indices);
+
+  /// Collapses edges until at most 'targetTriangles' triangles remain, or
+  /// until no more edges can be collapsed. Returns the number of triangles
+  /// remaining. May be called repeatedly with decreasing targets.
+  size_t simplify(size_t targetTriangles);
+
+  /// Number of triangles remaining.
+  size_t getNumTriangles() const      {return mNumTriangles;}
+
+  /// Retrieves the remaining triangles, in their original order.
+  void getIndices(std::vector<uint32_t>& indicesOut) const;
+
+  /// Approximate object space error of the simplified mesh: the square root of
+  /// the largest quadric error of any collapse performed so far.
+  float getError() const;
+
+private:
+
+  /// Symmetric 4x4 matrix, upper triangle stored row by row.
+  struct Quadric
+  {
+    Quadric();
+    void addPlane(double a, double b, double c, double d);
+    void add(const Quadric& other);
+    double evaluate(const double* p) const;
+
+    double q[10];
+  };
+
+  struct Collapse
+  {
+    double    cost;
+    uint32_t  from;       ///< Vertex removed by the collapse.
+    uint32_t  to;         ///< Vertex 'from' is merged into.
+    uint32_t  fromStamp;  ///< mStamps[from] when the collapse was computed.
+    uint32_t  toStamp;    ///< mStamps[to] when the collapse was computed.
+
+    bool operator<(const Collapse& other) const {return cost > other.cost;}
+  };
+
+  /// Appends the cheaper collapse along the edge (a, b) to mHeap. The caller
+  /// restores the heap property.
+  void pushEdge(uint32_t a, uint32_t b);
+
+  /// Returns false if collapsing 'from' into 'to' flips a triangle.
+  bool isCollapseValid(uint32_t from, uint32_t to) const;
+
+  /// Merges 'from' into 'to' and queues the collapses of edges around 'to'.
+  void collapse(uint32_t from, uint32_t to);
+
+  const double* position(uint32_t v) const  {return &mPositions[3 * v];}
+
+  std::vector<double>                 mPositions;   ///< xyz per vertex.
+  std::vector<Quadric>                mQuadrics;
+  std::vector<uint32_t>               mStamps;      ///< Bumped when a vertex changes.
+  std::vector<bool>                   mLocked;      ///< Boundary vertices.
+  std::vector<bool>                   mRemoved;
+  std::vector<std::vector<uint32_t>>  mVertexTriangles;
+
+  std::vector<uint32_t>               mTriangles;   ///< 3 vertices per triangle.
+  std::vector<bool>                   mTriangleRemoved;
+  size_t                              mNumTriangles;
+
+  std::vector<Collapse>               mHeap;        ///< Min-heap on cost.
+  std::vector<uint32_t>               mVisited;     ///< Scratch, per vertex.
+  uint32_t                            mVisitMark;
+  double                              mMaxCost;
+};
+
+/// One level of a LOD chain.
+struct LODLevel
+{
+  std::vector<uint32_t> indices;  ///< Triangle list.
+  float                 error;    ///< See MeshSimplifier::getError.
+};
+
+/// Builds a chain of progressively simplified versions of a triangle list.
+/// Each level has about half the triangles of the previous one. The chain
+/// stops after 'maxLevels' levels, when a level would have fewer than
+/// 'minTriangles' triangles, or when the mesh cannot be simplified further.
+/// The original mesh is not part of the chain. See MeshSimplifier for the
+/// remaining parameters.
+std::vector<LODLevel> buildLODChain(const uint8_t* vertices, size_t numVertices,
+                                    size_t stride, size_t positionOffset,
+                                    const std::vector<uint32_t>& indices,
+                                    size_t maxLevels, size_t minTriangles);
+
+} // namespace CPM_SPIRE_NS
+
+#endif
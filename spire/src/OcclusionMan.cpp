@@ -0,0 +1,347 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2013 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+/// \author agent
+/// \date   October 2026
+
+#include "Common.h"
+#include "Exceptions.h"
+#include "OcclusionMan.h"
+#include "Hub.h"
+#include "GLStateMan.h"
+#include "GLCaps.h"
+#include "SpireObject.h"
+
+namespace CPM_SPIRE_NS {
+
+//------------------------------------------------------------------------------
+OcclusionQuery::~OcclusionQuery()
+{
+#ifdef SPIRE_USE_OCCLUSION_QUERIES
+  if (query != 0)
+    GL(glDeleteQueries(1, &query));
+#endif
+}
+
+//------------------------------------------------------------------------------
+// OcclusionMan
+//------------------------------------------------------------------------------
+
+const size_t OcclusionMan::MinOccludedElements;
+
+#ifdef SPIRE_USE_OCCLUSION_QUERIES
+static const char* ProxyVertexShader =
+    "#version 150\n"
+    "uniform mat4 uProxyTransform;\n"
+    "in vec3 aPos;\n"
+    "void main()\n"
+    "{\n"
+    "  gl_Position = uProxyTransform * vec4(aPos, 1.0);\n"
+    "}\n";
+
+static const char* ProxyFragmentShader =
+    "#version 150\n"
+    "out vec4 fragColor;\n"
+    "void main()\n"
+    "{\n"
+    "  fragColor = vec4(1.0);\n"
+    "}\n";
+
+//------------------------------------------------------------------------------
+static GLuint compileProxyShader(GLenum type, const char* source)
+{
+  GLuint shader = glCreateShader(type);
+  GL_CHECK();
+  if (shader == 0)
+    throw GLError("Unable to construct occlusion proxy shader.");
+
+  GL(glShaderSource(shader, 1, &source, NULL));
+  GL(glCompileShader(shader));
+
+  GLint compiled;
+  GL(glGetShaderiv(shader, GL_COMPILE_STATUS, &compiled));
+  if (!compiled)
+  {
+    GL(glDeleteShader(shader));
+    throw GLError("Failed to compile occlusion proxy shader.");
+  }
+  return shader;
+}
+#endif
+
+//------------------------------------------------------------------------------
+OcclusionMan::OcclusionMan(Hub& hub) :
+    mHub(hub),
+    mEnabled(false),
+    mNumOccluded(0),
+    mProgram(0),
+    mTransformLocation(-1),
+    mVAO(0),
+    mVBO(0),
+    mIBO(0)
+{
+}
+
+//------------------------------------------------------------------------------
+OcclusionMan::~OcclusionMan()
+{
+  destroyProxyResources();
+}
+
+//------------------------------------------------------------------------------
+void OcclusionMan::setEnabled(bool enabled)
+{
+#ifdef SPIRE_USE_OCCLUSION_QUERIES
+  if (enabled && mHub.getGLCaps().hasOcclusionQuery2() == false)
+    throw UnsupportedException("Occlusion culling requires OpenGL 3.3 or GL_ARB_occlusion_query2.");
+  if (enabled && mProgram == 0)
+    createProxyResources();
+  if (enabled == false)
+    mProxies.clear();
+  mEnabled = enabled;
+#else
+  if (enabled)
+    throw UnsupportedException("Occlusion culling requires an OpenGL core profile.");
+#endif
+}
+
+//------------------------------------------------------------------------------
+void OcclusionMan::beginFrame()
+{
+  mNumOccluded = 0;
+  mProxies.clear();
+}
+
+//------------------------------------------------------------------------------
+bool OcclusionMan::testPass(ObjectPass* pass, const M44& projIVObject)
+{
+#ifdef SPIRE_USE_OCCLUSION_QUERIES
+  if (mEnabled == false || pass->hasBounds() == false
+      || pass->getIBO()->getNumElements(pass->getLOD()) < MinOccludedElements)
+    return true;
+
+  OcclusionQuery& query = pass->getOcclusionQuery();
+  if (query.pending)
+  {
+    GLuint available = 0;
+    GL(glGetQueryObjectuiv(query.query, GL_QUERY_RESULT_AVAILABLE, &available));
+    if (available)
+    {
+      GLuint anySamples = 0;
+      GL(glGetQueryObjectuiv(query.query, GL_QUERY_RESULT, &anySamples));
+      query.occluded = (anySamples == 0);
+      query.pending = false;
+    }
+  }
+
+  // Map the unit cube onto the pass' bounding box.
+  const AABB& box = pass->getAABB();
+  M44 boxTransform(1.0f);
+  V3 halfExtents = (box.max - box.min) * 0.5f;
+  boxTransform[0][0] = halfExtents.x;
+  boxTransform[1][1] = halfExtents.y;
+  boxTransform[2][2] = halfExtents.z;
+  boxTransform[3] = V4((box.min + box.max) * 0.5f, 1.0f);
+
+  Proxy proxy;
+  proxy.pass = pass;
+  proxy.transform = projIVObject * boxTransform;
+
+  // The proxy is clipped by the near plane when the camera is inside of, or
+  // very close to, the bounding box. The query would then report the pass as
+  // occluded, so such passes are always considered visible.
+  for (int i = 0; i < 8; ++i)
+  {
+    V4 corner = proxy.transform * V4((i & 1) ? 1.0f : -1.0f,
+                                     (i & 2) ? 1.0f : -1.0f,
+                                     (i & 4) ? 1.0f : -1.0f, 1.0f);
+    if (corner.z < -corner.w)
+    {
+      query.occluded = false;
+      return true;
+    }
+  }
+
+  if (query.pending == false)
+    mProxies.push_back(proxy);
+
+  if (query.occluded)
+    ++mNumOccluded;
+  return query.occluded == false;
+#else
+  (void)pass;
+  (void)projIVObject;
+  return true;
+#endif
+}
+
+//------------------------------------------------------------------------------
+void OcclusionMan::renderProxies()
+{
+#ifdef SPIRE_USE_OCCLUSION_QUERIES
+  if (mProxies.empty())
+    return;
+
+  GLStateMan& state = mHub.getGLStateManager();
+  state.useProgram(mProgram);
+  state.bindVertexArray(mVAO);
+
+  // Proxies must not modify the framebuffer. Face culling is disabled since
+  // the camera may be looking at the inside of a bounding box. The depth
+  // buffer already holds the pass' own geometry, and box faces coinciding
+  // with its surface must not fail against it (GL_LESS), or the pass would
+  // flicker between visible and occluded.
+  GLboolean depthMask;
+  GLboolean colorMask[4];
+  GLint depthFunc;
+  GL(glGetBooleanv(GL_DEPTH_WRITEMASK, &depthMask));
+  GL(glGetBooleanv(GL_COLOR_WRITEMASK, colorMask));
+  GL(glGetIntegerv(GL_DEPTH_FUNC, &depthFunc));
+  GLboolean cullFace = glIsEnabled(GL_CULL_FACE);
+  GL(glDepthMask(GL_FALSE));
+  GL(glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE));
+  GL(glDepthFunc(GL_LEQUAL));
+  if (cullFace)
+    GL(glDisable(GL_CULL_FACE));
+
+  for (auto it = mProxies.begin(); it != mProxies.end(); ++it)
+  {
+    OcclusionQuery& query = it->pass->getOcclusionQuery();
+    if (query.query == 0)
+      GL(glGenQueries(1, &query.query));
+
+    GL(glUniformMatrix4fv(mTransformLocation, 1, GL_FALSE,
+                          glm::value_ptr(it->transform)));
+    GL(glBeginQuery(GL_ANY_SAMPLES_PASSED, query.query));
+    GL(glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_SHORT, 0));
+    GL(glEndQuery(GL_ANY_SAMPLES_PASSED));
+    query.pending = true;
+  }
+  mProxies.clear();
+
+  GL(glDepthMask(depthMask));
+  GL(glColorMask(colorMask[0], colorMask[1], colorMask[2], colorMask[3]));
+  GL(glDepthFunc(static_cast<GLenum>(depthFunc)));
+  if (cullFace)
+    GL(glEnable(GL_CULL_FACE));
+#endif
+}
+
+//------------------------------------------------------------------------------
+void OcclusionMan::createProxyResources()
+{
+#ifdef SPIRE_USE_OCCLUSION_QUERIES
+  GLuint vertexShader   = compileProxyShader(GL_VERTEX_SHADER, ProxyVertexShader);
+  GLuint fragmentShader = compileProxyShader(GL_FRAGMENT_SHADER, ProxyFragmentShader);
+
+  mProgram = glCreateProgram();
+  GL_CHECK();
+  GL(glAttachShader(mProgram, vertexShader));
+  GL(glAttachShader(mProgram, fragmentShader));
+  GL(glBindAttribLocation(mProgram, 0, "aPos"));
+  GL(glLinkProgram(mProgram));
+  GL(glDeleteShader(vertexShader));
+  GL(glDeleteShader(fragmentShader));
+
+  GLint linked;
+  GL(glGetProgramiv(mProgram, GL_LINK_STATUS, &linked));
+  if (!linked)
+  {
+    destroyProxyResources();
+    throw GLError("Failed to link occlusion proxy program.");
+  }
+  mTransformLocation = glGetUniformLocation(mProgram, "uProxyTransform");
+  GL_CHECK();
+
+  // Unit cube spanning [-1, 1] on every axis.
+  static const GLfloat vertices[] =
+  {
+    -1.0f, -1.0f, -1.0f,   1.0f, -1.0f, -1.0f,
+    -1.0f,  1.0f, -1.0f,   1.0f,  1.0f, -1.0f,
+    -1.0f, -1.0f,  1.0f,   1.0f, -1.0f,  1.0f,
+    -1.0f,  1.0f,  1.0f,   1.0f,  1.0f,  1.0f
+  };
+  static const GLushort indices[] =
+  {
+    0, 2, 1,  1, 2, 3,    // -z
+    4, 5, 6,  5, 7, 6,    // +z
+    0, 1, 4,  1, 5, 4,    // -y
+    2, 6, 3,  3, 6, 7,    // +y
+    0, 4, 2,  2, 4, 6,    // -x
+    1, 3, 5,  3, 7, 5     // +x
+  };
+
+  GLStateMan& state = mHub.getGLStateManager();
+  GL(glGenVertexArrays(1, &mVAO));
+  state.bindVertexArray(mVAO);
+
+  GL(glGenBuffers(1, &mVBO));
+  state.bindArrayBuffer(mVBO);
+  GL(glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW));
+  GL(glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, 0));
+  state.setEnabledAttribArrays(GLStateMan::getAttribBit(0));
+
+  GL(glGenBuffers(1, &mIBO));
+  state.bindElementArrayBuffer(mIBO);
+  GL(glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW));
+#endif
+}
+
+//------------------------------------------------------------------------------
+void OcclusionMan::destroyProxyResources()
+{
+#ifdef SPIRE_USE_OCCLUSION_QUERIES
+  GLStateMan& state = mHub.getGLStateManager();
+  if (mVAO != 0)
+  {
+    state.onVertexArrayDeleted(mVAO);
+    GL(glDeleteVertexArrays(1, &mVAO));
+    mVAO = 0;
+  }
+  if (mVBO != 0)
+  {
+    state.onBufferDeleted(mVBO);
+    GL(glDeleteBuffers(1, &mVBO));
+    mVBO = 0;
+  }
+  if (mIBO != 0)
+  {
+    state.onBufferDeleted(mIBO);
+    GL(glDeleteBuffers(1, &mIBO));
+    mIBO = 0;
+  }
+  if (mProgram != 0)
+  {
+    state.onProgramDeleted(mProgram);
+    GL(glDeleteProgram(mProgram));
+    mProgram = 0;
+  }
+#endif
+}
+
+} // namespace CPM_SPIRE_NS
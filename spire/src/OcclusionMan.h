@@ -0,0 +1,133 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2013 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+/// \author agent
+/// \date   October 2026
+
+#ifndef SPIRE_HIGH_OCCLUSIONMAN_H
+#define SPIRE_HIGH_OCCLUSIONMAN_H
+
+#include <vector>
+#include <cstdint>
+
+#include "Common.h"
+
+namespace CPM_SPIRE_NS {
+
+class Hub;
+class ObjectPass;
+
+/// Occlusion query state of a single object pass. Owned by the pass so that
+/// the query is released along with it.
+class OcclusionQuery
+{
+public:
+  OcclusionQuery() :
+      query(0),
+      pending(false),
+      occluded(false)
+  {}
+  ~OcclusionQuery();
+
+  GLuint  query;    ///< GL query object, 0 until the first proxy is drawn.
+  bool    pending;  ///< True if the query was issued and its result not read.
+  bool    occluded; ///< Result of the last query that completed.
+
+private:
+  OcclusionQuery(const OcclusionQuery&);
+  OcclusionQuery& operator=(const OcclusionQuery&);
+};
+
+/// Skips expensive object passes hidden behind other geometry. Each candidate
+/// pass has its bounding box drawn as a proxy, without color or depth writes,
+/// inside a GL_ANY_SAMPLES_PASSED query after the visible passes have been
+/// rendered. Results are read back in a later frame, once they are available,
+/// so the CPU never waits on the GPU. Consequently a pass that becomes visible
+/// may be missing for a frame or two.
+///
+/// Occlusion culling is opt-in (see setEnabled) and is only available under
+/// the core profiles, with OpenGL 3.3 or GL_ARB_occlusion_query2.
+class OcclusionMan
+{
+public:
+  OcclusionMan(Hub& hub);
+  virtual ~OcclusionMan();
+
+  /// Enables or disables occlusion culling. Throws UnsupportedException when
+  /// enabling occlusion culling under OpenGL ES 2.0, or when the context
+  /// supports neither OpenGL 3.3 nor GL_ARB_occlusion_query2.
+  void setEnabled(bool enabled);
+  bool isEnabled() const          {return mEnabled;}
+
+  /// Starts a new frame.
+  void beginFrame();
+
+  /// Returns false if the pass was found to be occluded by a previous query.
+  /// Unless a query is still in flight for the pass, its proxy is queued to
+  /// be drawn by renderProxies. 'projIVObject' transforms the pass' vertices
+  /// into clip space.
+  bool testPass(ObjectPass* pass, const M44& projIVObject);
+
+  /// Draws the proxies queued by testPass since the last call. Must be called
+  /// after rendering the visible passes, which act as occluders.
+  void renderProxies();
+
+  /// Number of passes rejected by testPass in the current frame.
+  size_t getNumOccludedPasses() const {return mNumOccluded;}
+
+  /// Passes with fewer indices than this are never occlusion culled. Drawing
+  /// the proxy would cost about as much as drawing the pass.
+  static const size_t MinOccludedElements = 3 * 1024;
+
+private:
+
+  /// Creates the proxy program and the unit cube the proxies are drawn with.
+  void createProxyResources();
+  void destroyProxyResources();
+
+  struct Proxy
+  {
+    ObjectPass* pass;
+    M44         transform;  ///< Unit cube to clip space.
+  };
+
+  Hub&                mHub;
+  bool                mEnabled;
+  size_t              mNumOccluded;
+  std::vector<Proxy>  mProxies;       ///< Queued by testPass.
+
+  GLuint              mProgram;
+  GLint               mTransformLocation;
+  GLuint              mVAO;
+  GLuint              mVBO;
+  GLuint              mIBO;
+};
+
+} // namespace CPM_SPIRE_NS
+
+#endif
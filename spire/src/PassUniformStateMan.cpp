@@ -46,72 +46,62 @@ PassUniformStateMan::PassUniformStateMan(Hub& hub) :
 //------------------------------------------------------------------------------
 PassUniformStateMan::PassUniforms* PassUniformStateMan::getPass(const std::string& pass)
 {
-  // Not very efficient -- but still more efficient than other methods when the
-  // number of passes is low.
-  for (size_t i = 0; i < mPasses.size(); i++)
-  {
-    if (mPasses[i].passName == pass)
-    {
-      return &mPasses[i];
-    }
-  }
-
-  return nullptr;
+  size_t passIndex;
+  if (findPassIndex(pass, passIndex))
+    return &mPasses[passIndex];
+  else
+    return nullptr;
 }
 
 //------------------------------------------------------------------------------
 const PassUniformStateMan::PassUniforms* PassUniformStateMan::getPass(const std::string& pass) const
 {
-  // Not very efficient -- but still more efficient than other methods when the
-  // number of passes is low.
-  for (size_t i = 0; i < mPasses.size(); i++)
-  {
-    if (mPasses[i].passName == pass)
-    {
-      return &mPasses[i];
-    }
-  }
-
-  return nullptr;
+  size_t passIndex;
+  if (findPassIndex(pass, passIndex))
+    return &mPasses[passIndex];
+  else
+    return nullptr;
 }
 
 //------------------------------------------------------------------------------
 PassUniformStateMan::PassUniforms& PassUniformStateMan::getOrCreatePass(const std::string& pass)
 {
-  PassUniforms* passStruct = getPass(pass);
-  if (passStruct == nullptr)
+  return mPasses[addPass(pass)];
+}
+
+//------------------------------------------------------------------------------
+size_t PassUniformStateMan::addPass(const std::string& pass)
+{
+  auto inserted = mPassIndices.insert(std::make_pair(pass, mPasses.size()));
+  if (inserted.second)
   {
-    // Add a new pass, and return that.
     PassUniforms passUniforms;
     passUniforms.passName = pass;
     mPasses.push_back(passUniforms);
-    return mPasses.back();
-  }
-  else
-  {
-    return *passStruct;
   }
+  return inserted.first->second;
 }
 
 //------------------------------------------------------------------------------
-bool PassUniformStateMan::tryApplyUniform(const std::string& pass, 
-                                          const std::string& name, int location)
+bool PassUniformStateMan::findPassIndex(const std::string& pass, size_t& indexOut) const
 {
-  // We use mState.at instead of the [] operator because at throws an
-  // exception if the key is not found in the container.
-  /// \xxx  Possibly detect if the name exists, and if it does not then throw
-  ///       a different exception (instead of letting the map throw std::range_error).
-  PassUniforms* passStruct = getPass(pass);
-  if (passStruct != nullptr)
-  {
-    std::shared_ptr<AbstractUniformStateItem> ptr = passStruct->uniforms[name];
-    if (ptr != nullptr)
-    {
-      ShaderUniformMan::applyUniformGLState(ptr, location);
-      return true;
-    }
-  }
-  return false;
+  auto it = mPassIndices.find(pass);
+  if (it == mPassIndices.end())
+    return false;
+
+  indexOut = it->second;
+  return true;
+}
+
+//------------------------------------------------------------------------------
+std::shared_ptr<AbstractUniformStateItem> PassUniformStateMan::findUniform(
+    const PassUniforms& passStruct, const std::string& name) const
+{
+  std::shared_ptr<const UniformState> uniform = mHub.getShaderUniformManager().findUniformWithName(name);
+  if (uniform != nullptr && uniform->index < passStruct.uniforms.size())
+    return passStruct.uniforms[uniform->index];
+  else
+    return std::shared_ptr<AbstractUniformStateItem>();
 }
 
 //------------------------------------------------------------------------------
@@ -133,7 +123,9 @@ void PassUniformStateMan::updatePassUniform(const std::string& pass, const std::
 
   // Retrieve the appropriate pass and add/update our uniform.
   PassUniforms& passStruct = getOrCreatePass(pass);
-  passStruct.uniforms[name] = item;
+  if (uniform->index >= passStruct.uniforms.size())
+    passStruct.uniforms.resize(uniform->index + 1);
+  passStruct.uniforms[uniform->index] = item;
 }
 
 //------------------------------------------------------------------------------
@@ -143,15 +135,7 @@ PassUniformStateMan::getPassUninform(const std::string& pass, const std::string&
   const PassUniforms* passStruct = getPass(pass);
   if (passStruct != nullptr)
   {
-    auto it = passStruct->uniforms.find(name);
-    if (it != passStruct->uniforms.end())
-    {
-      return it->second;
-    }
-    else
-    {
-      return std::shared_ptr<AbstractUniformStateItem>(); 
-    }
+    return findUniform(*passStruct, name);
   }
   else
   {
@@ -165,9 +149,9 @@ std::string PassUniformStateMan::uniformAsString(const std::string& pass, const
   const PassUniforms* passStruct = getPass(pass);
   if (passStruct != nullptr)
   {
-    auto it = passStruct->uniforms.find(name);
-    if (it != passStruct->uniforms.end())
-      return it->second->asString();
+    std::shared_ptr<AbstractUniformStateItem> item = findUniform(*passStruct, name);
+    if (item != nullptr)
+      return item->asString();
     else
       return "";
   }
@@ -32,8 +32,8 @@
 #ifndef SPIRE_CORE_PASSUNIFORMSTATEMAN_H
 #define SPIRE_CORE_PASSUNIFORMSTATEMAN_H
 
-#include <map>
 #include <unordered_map>
+#include <vector>
 #include "ShaderUniformStateManTemplates.h"
 
 namespace CPM_SPIRE_NS {
@@ -71,9 +71,32 @@ public:
   void updatePassUniform(const std::string& pass, const std::string& name, 
                          std::shared_ptr<AbstractUniformStateItem> item);
 
-  /// Attempts to apply the specified uniform to the current shader state.
-  /// Returns false 
-  bool tryApplyUniform(const std::string& pass, const std::string& name, int location);
+  /// Adds 'pass' if it does not exist yet and returns its index. Pass
+  /// indices are stable for the lifetime of the manager.
+  size_t addPass(const std::string& pass);
+
+  /// Retrieves the index of 'pass' without creating it. Returns false if the
+  /// pass has never been added.
+  bool findPassIndex(const std::string& pass, size_t& indexOut) const;
+
+  /// Retrieves the name of the pass at 'passIndex'.
+  /// Throws std::out_of_range if there is no such pass.
+  const std::string& getPassName(size_t passIndex) const
+  {return mPasses.at(passIndex).passName;}
+
+  /// Retrieves the uniform at 'uniformIndex' (see UniformState::index) in
+  /// the pass at 'passIndex'. Returns nullptr if the pass does not have
+  /// the uniform.
+  const AbstractUniformStateItem* findPassUniform(size_t passIndex,
+                                                  size_t uniformIndex) const
+  {
+    const std::vector<std::shared_ptr<AbstractUniformStateItem>>& uniforms =
+        mPasses[passIndex].uniforms;
+    if (uniformIndex < uniforms.size())
+      return uniforms[uniformIndex].get();
+    else
+      return nullptr;
+  }
 
   /// Retrieves the texture representation of the uniform with 'name'.
   /// This *really* should return std::optional.
@@ -91,9 +114,17 @@ private:
   struct PassUniforms
   {
     std::string passName;
-    std::unordered_map<std::string, std::shared_ptr<AbstractUniformStateItem>> uniforms;
+
+    /// Indexed by uniform index (see ShaderUniformMan). Slots for uniforms
+    /// not present in the pass are empty.
+    std::vector<std::shared_ptr<AbstractUniformStateItem>> uniforms;
   };
 
+  /// Retrieves the uniform with 'name' in 'passStruct'. Returns an empty
+  /// pointer if not found.
+  std::shared_ptr<AbstractUniformStateItem> findUniform(
+      const PassUniforms& passStruct, const std::string& name) const;
+
   // Retrieves a pre-existing pass. If there exists no pass then create it.
   PassUniforms& getOrCreatePass(const std::string& pass);
 
@@ -103,10 +134,11 @@ private:
   PassUniforms* getPass(const std::string& pass);
   const PassUniforms* getPass(const std::string& pass) const;
 
-  // We're not likely to have very many pass uniforms. So this is just a vector
-  // for now.
-  std::vector<PassUniforms>   mPasses;
-  Hub&                        mHub;
+  // Passes are addressed by index while rendering, names are only looked up
+  // through mPassIndices.
+  std::vector<PassUniforms>                 mPasses;
+  std::unordered_map<std::string, size_t>   mPassIndices; ///< Pass name -> index.
+  Hub&                                      mHub;
 };
 
 
@@ -0,0 +1,70 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2013 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+/// \author agent
+/// \date   October 2026
+
+#include <algorithm>
+
+#include "Common.h"
+#include "RenderList.h"
+#include "SpireObject.h"
+
+namespace CPM_SPIRE_NS {
+
+//------------------------------------------------------------------------------
+void RenderList::clear()
+{
+  mRecords.clear();
+  mGeneration = 0;
+}
+
+//------------------------------------------------------------------------------
+void RenderList::addPass(ObjectPass* pass)
+{
+  mRecords.emplace_back(Record(pass->getSortKey(), pass));
+}
+
+//------------------------------------------------------------------------------
+void RenderList::finalize(uint64_t generation)
+{
+  // Stable sort so that subpasses keep their order relative to their parent
+  // pass (see RenderQueue::render).
+  std::stable_sort(mRecords.begin(), mRecords.end());
+  mGeneration = generation;
+}
+
+//------------------------------------------------------------------------------
+void RenderList::copyPasses(std::vector<ObjectPass*>& out) const
+{
+  out.resize(mRecords.size());
+  for (size_t i = 0; i < mRecords.size(); ++i)
+    out[i] = mRecords[i].pass;
+}
+
+} // namespace CPM_SPIRE_NS
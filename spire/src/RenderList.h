@@ -0,0 +1,95 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2013 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+/// \author agent
+/// \date   October 2026
+
+#ifndef SPIRE_HIGH_RENDERLIST_H
+#define SPIRE_HIGH_RENDERLIST_H
+
+#include <vector>
+#include <cstdint>
+
+#include "Common.h"
+
+namespace CPM_SPIRE_NS {
+
+class ObjectPass;
+
+/// Flat list of every object pass rendered by one pass, sorted by
+/// ObjectPass::getSortKey. The list is built once and replayed every frame
+/// until the scene changes. Object passes already hold direct references to
+/// their program, buffers, attribute binding plan, and uniform slots, so a
+/// replay involves no lookups by name and no allocation.
+class RenderList
+{
+public:
+  RenderList() : mGeneration(0) {}
+  virtual ~RenderList()         {}
+
+  /// Returns true if the list was built for the scene 'generation'.
+  bool isCurrent(uint64_t generation) const {return mGeneration == generation;}
+
+  /// Starts rebuilding the list.
+  void clear();
+
+  /// Adds a pass to the list. The pass must remain valid until the scene
+  /// generation changes.
+  void addPass(ObjectPass* pass);
+
+  /// Sorts the list and marks it current for 'generation'.
+  void finalize(uint64_t generation);
+
+  /// Replaces the contents of 'out' with the passes in the list, in order.
+  void copyPasses(std::vector<ObjectPass*>& out) const;
+
+  /// Number of passes in the list.
+  size_t getNumPasses() const   {return mRecords.size();}
+
+private:
+
+  struct Record
+  {
+    Record(uint64_t sortKey, ObjectPass* objectPass) :
+        key(sortKey),
+        pass(objectPass)
+    {}
+
+    uint64_t    key;
+    ObjectPass* pass;
+
+    bool operator<(const Record& other) const {return key < other.key;}
+  };
+
+  std::vector<Record> mRecords;
+  uint64_t            mGeneration;  ///< 0 if the list was never built.
+};
+
+} // namespace CPM_SPIRE_NS
+
+#endif
@@ -0,0 +1,99 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2013 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+/// \author agent
+/// \date   October 2026
+
+#include <algorithm>
+
+#include "Common.h"
+#include "RenderQueue.h"
+#include "SpireObject.h"
+
+namespace CPM_SPIRE_NS {
+
+//------------------------------------------------------------------------------
+void RenderQueue::clear()
+{
+  mEntries.clear();
+}
+
+//------------------------------------------------------------------------------
+void RenderQueue::addPass(ObjectPass* pass)
+{
+  mEntries.emplace_back(Entry(pass->getSortKey(), pass));
+}
+
+//------------------------------------------------------------------------------
+void RenderQueue::addPass(ObjectPass* pass, uint64_t sortKey)
+{
+  mEntries.emplace_back(Entry(sortKey, pass));
+}
+
+//------------------------------------------------------------------------------
+void RenderQueue::render()
+{
+  // Stable sort so that subpasses of an object keep their relative order
+  // whenever they share GL state with their parent pass. Passes replayed from
+  // a RenderList arrive sorted, skip the sort (and its allocation) then.
+  if (std::is_sorted(mEntries.begin(), mEntries.end()) == false)
+    std::stable_sort(mEntries.begin(), mEntries.end());
+
+  ObjectPass* prev = nullptr;
+  for (auto it = mEntries.begin(); it != mEntries.end(); ++it)
+  {
+    ObjectPass* pass = it->pass;
+    pass->flushBufferUpdates();
+
+    // Redundant program and buffer binds are filtered by GLStateMan.
+    pass->bindProgram();
+
+#ifdef SPIRE_USE_VAO
+    // Every pass owns a VAO, binding it is all that is required.
+    pass->bindVertexBuffer();
+#else
+    // Track changes here to avoid re-specifying attribute pointers, whose
+    // locations depend on both the program and the VBO. Attribute arrays
+    // common to both layouts are left enabled between passes.
+    bool programChanged = (prev == nullptr || prev->getProgramID() != pass->getProgramID());
+    bool vboChanged     = (   prev == nullptr || prev->getVBOGLIndex() != pass->getVBOGLIndex()
+                           || prev->getVBOOffset() != pass->getVBOOffset());
+    if (programChanged || vboChanged)
+      pass->bindVertexBuffer();
+    pass->bindIndexBuffer();
+#endif
+
+    pass->applyUniformsAndDraw();
+    prev = pass;
+  }
+
+  if (prev != nullptr)
+    prev->unbindAttributes();
+}
+
+} // namespace CPM_SPIRE_NS
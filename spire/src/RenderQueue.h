@@ -0,0 +1,92 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2013 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+/// \author agent
+/// \date   October 2026
+
+#ifndef SPIRE_HIGH_RENDERQUEUE_H
+#define SPIRE_HIGH_RENDERQUEUE_H
+
+#include <vector>
+#include <cstdint>
+
+#include "Common.h"
+
+namespace CPM_SPIRE_NS {
+
+class ObjectPass;
+
+/// Collects object passes and renders them sorted by GL state.
+/// Passes are sorted by ObjectPass::getSortKey so that passes sharing a
+/// program, VBO, or IBO are rendered consecutively. Bindings shared with the
+/// previously rendered pass are skipped (see GLStateMan).
+class RenderQueue
+{
+public:
+  RenderQueue()           {}
+  virtual ~RenderQueue()  {}
+
+  /// Removes all passes from the queue. Memory is retained so that the queue
+  /// can be refilled every frame without reallocating.
+  void clear();
+
+  /// Adds a pass to the queue. The pointer must remain valid until render
+  /// is called.
+  void addPass(ObjectPass* pass);
+
+  /// Same as above, with a precomputed ObjectPass::getSortKey.
+  void addPass(ObjectPass* pass, uint64_t sortKey);
+
+  /// Sorts and renders all passes in the queue. Ordering between passes is
+  /// only guaranteed for passes that have identical sort keys.
+  void render();
+
+  /// Number of passes currently in the queue.
+  size_t getNumPasses() const   {return mEntries.size();}
+
+private:
+
+  struct Entry
+  {
+    Entry(uint64_t sortKey, ObjectPass* objectPass) :
+        key(sortKey),
+        pass(objectPass)
+    {}
+
+    uint64_t    key;
+    ObjectPass* pass;
+
+    bool operator<(const Entry& other) const {return key < other.key;}
+  };
+
+  std::vector<Entry>  mEntries;
+};
+
+} // namespace CPM_SPIRE_NS
+
+#endif
@@ -0,0 +1,318 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2013 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+/// \author agent
+/// \date   October 2026
+
+#include <cstring>
+#include <stdexcept>
+
+#include "SR6Format.h"
+#include "MeshCodec.h"
+
+namespace CPM_SPIRE_NS {
+
+namespace {
+
+const char   SR6Magic[4]       = {'S', 'C', 'R', '6'};
+const size_t HeaderSize        = 32;
+const size_t AttributeSize     = 48;
+const size_t MeshSize          = 64;
+const size_t MeshSizeVersion1  = 48;
+const uint32_t FlagCompressed  = 1;
+const size_t AttributeNameSize = SR6MaxAttributeName + 1;
+
+size_t alignUp(size_t offset)
+{
+  return (offset + SR6Alignment - 1) / SR6Alignment * SR6Alignment;
+}
+
+// Fixed size records are assembled in a byte buffer.
+void putU32(std::vector<uint8_t>& out, size_t offset, uint32_t value)
+{
+  std::memcpy(&out[offset], &value, sizeof(value));
+}
+
+void putU64(std::vector<uint8_t>& out, size_t offset, uint64_t value)
+{
+  std::memcpy(&out[offset], &value, sizeof(value));
+}
+
+uint32_t getU32(const uint8_t* in)
+{
+  uint32_t value;
+  std::memcpy(&value, in, sizeof(value));
+  return value;
+}
+
+uint64_t getU64(const uint8_t* in)
+{
+  uint64_t value;
+  std::memcpy(&value, in, sizeof(value));
+  return value;
+}
+
+// Returns true if [offset, offset + length) lies within 'size' bytes.
+bool inRange(uint64_t offset, uint64_t length, size_t size)
+{
+  return offset <= size && length <= size - offset;
+}
+
+size_t getVertexSize(const std::vector<SR6Attribute>& attributes)
+{
+  size_t vertexSize = 0;
+  for (auto it = attributes.begin(); it != attributes.end(); ++it)
+    vertexSize += it->size;
+  return vertexSize;
+}
+
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
+void writeSR6(std::ostream& out, const std::vector<SR6Mesh>& meshes)
+{
+  size_t numAttributes = 0;
+  for (auto it = meshes.begin(); it != meshes.end(); ++it)
+  {
+    if (it->indexSize != 1 && it->indexSize != 2 && it->indexSize != 4)
+      throw std::invalid_argument("SR6 index size must be 1, 2, or 4 bytes.");
+    numAttributes += it->attributes.size();
+  }
+
+  size_t attributeTable = HeaderSize;
+  size_t meshTable      = attributeTable + numAttributes * AttributeSize;
+
+  // Header and tables, followed by the data of every mesh.
+  std::vector<uint8_t> tables(meshTable + meshes.size() * MeshSize, 0);
+  std::memcpy(&tables[0], SR6Magic, sizeof(SR6Magic));
+  putU32(tables, 4,  SR6Version);
+  putU32(tables, 8,  static_cast<uint32_t>(meshes.size()));
+  putU32(tables, 12, static_cast<uint32_t>(numAttributes));
+  putU64(tables, 16, attributeTable);
+  putU64(tables, 24, meshTable);
+
+  // Encoded data of compressed meshes, two entries (VBO, IBO) per mesh.
+  std::vector<std::vector<uint8_t>> encoded(2 * meshes.size());
+
+  size_t attribute = 0;
+  size_t dataOffset = alignUp(tables.size());
+  for (size_t m = 0; m < meshes.size(); ++m)
+  {
+    const SR6Mesh& mesh = meshes[m];
+    size_t record = meshTable + m * MeshSize;
+    putU32(tables, record + 0,  static_cast<uint32_t>(attribute));
+    putU32(tables, record + 4,  static_cast<uint32_t>(mesh.attributes.size()));
+    putU32(tables, record + 8,  mesh.indexSize);
+    putU32(tables, record + 12, mesh.compressed ? FlagCompressed : 0);
+
+    for (auto it = mesh.attributes.begin(); it != mesh.attributes.end(); ++it, ++attribute)
+    {
+      if (it->name.empty() || it->name.size() > SR6MaxAttributeName)
+        throw std::invalid_argument("Invalid SR6 attribute name: " + it->name);
+
+      size_t offset = attributeTable + attribute * AttributeSize;
+      std::memcpy(&tables[offset], it->name.c_str(), it->name.size());
+      putU32(tables, offset + AttributeNameSize + 0,  it->numComponents);
+      putU32(tables, offset + AttributeNameSize + 4,  it->type);
+      putU32(tables, offset + AttributeNameSize + 8,  it->size);
+      putU32(tables, offset + AttributeNameSize + 12, it->normalize ? 1 : 0);
+    }
+
+    size_t vboStored = mesh.vboSize;
+    size_t iboStored = mesh.iboSize;
+    if (mesh.compressed)
+    {
+      size_t vertexSize = getVertexSize(mesh.attributes);
+      if (vertexSize == 0 || mesh.vboSize % vertexSize != 0 || mesh.iboSize % mesh.indexSize != 0)
+        throw std::invalid_argument("SR6 VBO and IBO sizes must be whole vertices and indices.");
+
+      encodeVertices(mesh.vbo, mesh.vboSize / vertexSize, vertexSize, encoded[2 * m]);
+      encodeIndices(mesh.ibo, mesh.iboSize / mesh.indexSize, mesh.indexSize, encoded[2 * m + 1]);
+      vboStored = encoded[2 * m].size();
+      iboStored = encoded[2 * m + 1].size();
+    }
+
+    putU64(tables, record + 16, dataOffset);
+    putU64(tables, record + 24, mesh.vboSize);
+    putU64(tables, record + 48, vboStored);
+    dataOffset = alignUp(dataOffset + vboStored);
+    putU64(tables, record + 32, dataOffset);
+    putU64(tables, record + 40, mesh.iboSize);
+    putU64(tables, record + 56, iboStored);
+    dataOffset = alignUp(dataOffset + iboStored);
+  }
+
+  const char padding[SR6Alignment] = {0};
+  auto writePadded = [&out, &padding](const void* data, size_t size)
+  {
+    out.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+    out.write(padding, static_cast<std::streamsize>(alignUp(size) - size));
+  };
+
+  writePadded(tables.data(), tables.size());
+  for (size_t m = 0; m < meshes.size(); ++m)
+  {
+    if (meshes[m].compressed)
+    {
+      writePadded(encoded[2 * m].data(), encoded[2 * m].size());
+      writePadded(encoded[2 * m + 1].data(), encoded[2 * m + 1].size());
+    }
+    else
+    {
+      writePadded(meshes[m].vbo, meshes[m].vboSize);
+      writePadded(meshes[m].ibo, meshes[m].iboSize);
+    }
+  }
+
+  if (out.fail())
+    throw std::runtime_error("Failed to write SR6 file.");
+}
+
+//------------------------------------------------------------------------------
+std::vector<SR6Mesh> readSR6(const uint8_t* data, size_t size,
+                             std::vector<uint8_t>& decoded)
+{
+  if (size < HeaderSize || std::memcmp(data, SR6Magic, sizeof(SR6Magic)) != 0)
+    throw std::invalid_argument("Header does not match SR6 asset file.");
+  uint32_t version = getU32(data + 4);
+  if (version != 1 && version != SR6Version)
+    throw std::invalid_argument("Unsupported SR6 asset file version.");
+  size_t meshSize = (version == 1) ? MeshSizeVersion1 : MeshSize;
+
+  uint32_t numMeshes      = getU32(data + 8);
+  uint32_t numAttributes  = getU32(data + 12);
+  uint64_t attributeTable = getU64(data + 16);
+  uint64_t meshTable      = getU64(data + 24);
+  if (   inRange(attributeTable, static_cast<uint64_t>(numAttributes) * AttributeSize, size) == false
+      || inRange(meshTable, static_cast<uint64_t>(numMeshes) * meshSize, size) == false)
+    throw std::invalid_argument("Truncated SR6 asset file.");
+
+  std::vector<SR6Attribute> attributes(numAttributes);
+  for (size_t a = 0; a < numAttributes; ++a)
+  {
+    const uint8_t* record = data + attributeTable + a * AttributeSize;
+    if (std::memchr(record, '\0', AttributeNameSize) == nullptr)
+      throw std::invalid_argument("Invalid SR6 attribute name.");
+
+    SR6Attribute& attribute = attributes[a];
+    attribute.name          = reinterpret_cast<const char*>(record);
+    attribute.numComponents = getU32(record + AttributeNameSize + 0);
+    attribute.type          = getU32(record + AttributeNameSize + 4);
+    attribute.size          = getU32(record + AttributeNameSize + 8);
+    attribute.normalize     = getU32(record + AttributeNameSize + 12) != 0;
+  }
+
+  // Stored sizes of the VBO and IBO of each mesh.
+  std::vector<uint64_t> stored(2 * numMeshes);
+  uint64_t decodedSize = 0;
+
+  std::vector<SR6Mesh> meshes(numMeshes);
+  for (size_t m = 0; m < numMeshes; ++m)
+  {
+    const uint8_t* record = data + meshTable + m * meshSize;
+    uint32_t firstAttribute = getU32(record + 0);
+    uint32_t meshAttributes = getU32(record + 4);
+    uint32_t flags          = (version == 1) ? 0 : getU32(record + 12);
+    uint64_t vboOffset      = getU64(record + 16);
+    uint64_t vboSize        = getU64(record + 24);
+    uint64_t iboOffset      = getU64(record + 32);
+    uint64_t iboSize        = getU64(record + 40);
+    stored[2 * m]           = (version == 1) ? vboSize : getU64(record + 48);
+    stored[2 * m + 1]       = (version == 1) ? iboSize : getU64(record + 56);
+
+    if (   firstAttribute > numAttributes
+        || meshAttributes > numAttributes - firstAttribute
+        || inRange(vboOffset, stored[2 * m], size) == false
+        || inRange(iboOffset, stored[2 * m + 1], size) == false)
+      throw std::invalid_argument("Truncated SR6 asset file.");
+
+    SR6Mesh& mesh = meshes[m];
+    mesh.attributes.assign(attributes.begin() + firstAttribute,
+                           attributes.begin() + firstAttribute + meshAttributes);
+    mesh.indexSize  = getU32(record + 8);
+    mesh.compressed = (flags & FlagCompressed) != 0;
+    mesh.vbo        = data + vboOffset;
+    mesh.vboSize    = static_cast<size_t>(vboSize);
+    mesh.ibo        = data + iboOffset;
+    mesh.iboSize    = static_cast<size_t>(iboSize);
+
+    if (mesh.indexSize != 1 && mesh.indexSize != 2 && mesh.indexSize != 4)
+      throw std::invalid_argument("Invalid SR6 index size.");
+
+    if (mesh.compressed)
+    {
+      // Every triangle and every index past the last triangle is stored in
+      // at least one byte, and every block of 16 vertices in at least one
+      // byte per 4 bytes of the vertex. Checked before allocating room for
+      // the decoded data.
+      size_t vertexSize = getVertexSize(mesh.attributes);
+      uint64_t numIndices = iboSize / mesh.indexSize;
+      if (   vertexSize == 0 || vboSize % vertexSize != 0 || iboSize % mesh.indexSize != 0
+          || (vboSize / vertexSize + 15) / 16 > stored[2 * m] / ((vertexSize + 3) / 4)
+          || numIndices / 3 + numIndices % 3 > stored[2 * m + 1])
+        throw std::invalid_argument("Invalid SR6 mesh sizes.");
+      decodedSize += alignUp(static_cast<size_t>(vboSize)) + alignUp(static_cast<size_t>(iboSize));
+    }
+    else if (stored[2 * m] != vboSize || stored[2 * m + 1] != iboSize)
+    {
+      throw std::invalid_argument("Invalid SR6 mesh sizes.");
+    }
+  }
+
+  // Decoded meshes share one buffer, sized up front so pointers into it
+  // stay valid.
+  if (decodedSize > size_t(-1))
+    throw std::invalid_argument("Invalid SR6 mesh sizes.");
+  decoded.assign(static_cast<size_t>(decodedSize), 0);
+
+  size_t decodedOffset = 0;
+  for (size_t m = 0; m < numMeshes; ++m)
+  {
+    SR6Mesh& mesh = meshes[m];
+    if (mesh.compressed == false)
+      continue;
+
+    size_t vertexSize = getVertexSize(mesh.attributes);
+    uint8_t* vbo = decoded.data() + decodedOffset;
+    decodeVertices(mesh.vbo, static_cast<size_t>(stored[2 * m]),
+                   mesh.vboSize / vertexSize, vertexSize, vbo);
+    decodedOffset += alignUp(mesh.vboSize);
+
+    uint8_t* ibo = decoded.data() + decodedOffset;
+    decodeIndices(mesh.ibo, static_cast<size_t>(stored[2 * m + 1]),
+                  mesh.iboSize / mesh.indexSize, mesh.indexSize, ibo);
+    decodedOffset += alignUp(mesh.iboSize);
+
+    mesh.vbo = vbo;
+    mesh.ibo = ibo;
+  }
+
+  return meshes;
+}
+
+} // namespace CPM_SPIRE_NS
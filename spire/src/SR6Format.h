@@ -0,0 +1,106 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2013 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+/// \author agent
+/// \date   October 2026
+
+#ifndef SPIRE_HIGH_SR6FORMAT_H
+#define SPIRE_HIGH_SR6FORMAT_H
+
+#include <ostream>
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace CPM_SPIRE_NS {
+
+// SR6 asset files hold meshes whose vertex and index data is stored exactly
+// as it is handed to GL, so loading a file amounts to mapping it (see
+// MappedFile) and passing pointers along. Values are stored in host byte
+// order, which is little endian on every platform spire supports.
+//
+//   Header       "SCR6", version, number of meshes, number of attribute
+//                records, and the offsets of the attribute and mesh tables.
+//   Attributes   One record per vertex attribute: name, number of
+//                components, type (Interface::DATA_TYPES), size in bytes
+//                including padding, and whether it is normalized.
+//   Meshes       One record per mesh: its run of attribute records, index
+//                size, flags, and the offset and size of its VBO and IBO
+//                data.
+//   Data         VBO and IBO data, each starting on an SR6Alignment byte
+//                boundary. Compressed meshes store it encoded with
+//                encodeVertices / encodeIndices (see MeshCodec), and record
+//                both the decoded and the stored size. Version 1 files have
+//                no flags or stored sizes, and are never compressed.
+//
+// Does not depend on GL. assetConv compiles this file to write SR6 files.
+
+const uint32_t SR6Version           = 2;
+const size_t   SR6Alignment         = 64;
+const size_t   SR6MaxAttributeName  = 31;
+
+/// Vertex attribute, see Interface::addShaderAttribute.
+struct SR6Attribute
+{
+  std::string name;
+  uint32_t    numComponents;
+  uint32_t    type;           ///< Interface::DATA_TYPES.
+  uint32_t    size;           ///< Bytes, including padding.
+  bool        normalize;
+};
+
+/// One mesh: interleaved vertices and an indexed triangle list.
+struct SR6Mesh
+{
+  std::vector<SR6Attribute> attributes; ///< Vertex layout, in order.
+  const uint8_t*            vbo;
+  size_t                    vboSize;
+  const uint8_t*            ibo;
+  size_t                    iboSize;
+  uint32_t                  indexSize;  ///< 1, 2, or 4 bytes.
+  bool                      compressed; ///< Stored with MeshCodec.
+};
+
+/// Writes 'meshes' as an SR6 file, encoding those that are 'compressed'.
+/// Throws std::invalid_argument if an attribute name is longer than
+/// SR6MaxAttributeName characters, an index size is not 1, 2, or 4, or the
+/// VBO of a compressed mesh is not a whole number of vertices, and
+/// std::runtime_error if writing fails.
+void writeSR6(std::ostream& out, const std::vector<SR6Mesh>& meshes);
+
+/// Parses the SR6 file held in 'data'. The VBO and IBO pointers of the
+/// returned meshes point into 'data', except for compressed meshes, which
+/// are decoded into 'decoded' and point there. Throws std::invalid_argument
+/// if 'data' is not an SR6 file of a supported version, or is truncated.
+std::vector<SR6Mesh> readSR6(const uint8_t* data, size_t size,
+                             std::vector<uint8_t>& decoded);
+
+} // namespace CPM_SPIRE_NS
+
+#endif
@@ -31,6 +31,7 @@
 
 #include <algorithm>
 #include <iostream>
+#include <limits>
 
 #include "Common.h"
 #include "Exceptions.h"
@@ -38,6 +39,7 @@
 
 #include "ShaderAttributeMan.h"
 #include "ShaderProgramMan.h"
+#include "GLStateMan.h"
 
 namespace CPM_SPIRE_NS {
 
@@ -56,7 +58,8 @@ ShaderAttributeMan::~ShaderAttributeMan()
 //------------------------------------------------------------------------------
 void ShaderAttributeMan::addAttribute(const std::string& codeName,
                                       size_t numComponents, bool normalize,
-                                      size_t size, Interface::DATA_TYPES type)
+                                      size_t size, Interface::DATA_TYPES type,
+                                      size_t divisor)
 {
   AttribState attrib;
   attrib.index          = mAttributes.size();
@@ -65,6 +68,7 @@ void ShaderAttributeMan::addAttribute(const std::string& codeName,
   attrib.normalize      = normalize;
   attrib.size           = size;
   attrib.type           = type;
+  attrib.divisor        = divisor;
   attrib.nameHash       = hashString(codeName);
 
   mAttributes.push_back(attrib);
@@ -119,6 +123,102 @@ AttribState ShaderAttributeMan::getAttributeAtIndex(size_t index) const
   return mAttributes[index];
 }
 
+//------------------------------------------------------------------------------
+// ATTRIBUTE BINDING PLAN
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+AttribBindingPlan::AttribBindingPlan(const std::vector<AttribBinding>& bindings,
+                                     GLsizei stride) :
+    mBindings(bindings),
+    mStride(stride),
+    mEnabledMask(0)
+{
+  for (auto it = mBindings.begin(); it != mBindings.end(); ++it)
+    mEnabledMask |= GLStateMan::getAttribBit(static_cast<GLint>(it->location));
+}
+
+//------------------------------------------------------------------------------
+void AttribBindingPlan::bind(GLStateMan& state, size_t baseOffset) const
+{
+  for (auto it = mBindings.begin(); it != mBindings.end(); ++it)
+  {
+    GL(glVertexAttribPointer(it->location, it->numComponents, it->type,
+                             it->normalize, mStride,
+                             reinterpret_cast<const void*>(baseOffset + it->offset)));
+  }
+
+  state.setEnabledAttribArrays(mEnabledMask);
+}
+
+//------------------------------------------------------------------------------
+void AttribBindingPlan::unbind(GLStateMan& state) const
+{
+  state.disableAttribArrays(mEnabledMask);
+}
+
+#ifdef SPIRE_USE_INSTANCING
+//------------------------------------------------------------------------------
+void AttribBindingPlan::bindInstanced(GLStateMan& state) const
+{
+  for (auto it = mBindings.begin(); it != mBindings.end(); ++it)
+  {
+    GL(glVertexAttribPointer(it->location, it->numComponents, it->type,
+                             it->normalize, mStride,
+                             reinterpret_cast<const void*>(it->offset)));
+    GL(glVertexAttribDivisor(it->location, it->divisor));
+  }
+
+  state.enableAttribArrays(mEnabledMask);
+}
+#endif
+
+namespace {
+
+template <typename T>
+void convertComponents(const uint8_t* src, GLint numComponents, bool normalize,
+                       float* dst)
+{
+  const T* data = reinterpret_cast<const T*>(src);
+  for (GLint i = 0; i < numComponents; ++i)
+  {
+    if (normalize)
+      dst[i] = static_cast<float>(data[i]) / static_cast<float>(std::numeric_limits<T>::max());
+    else
+      dst[i] = static_cast<float>(data[i]);
+  }
+}
+
+} // namespace
+
+//------------------------------------------------------------------------------
+void AttribBindingPlan::applyInstance(const uint8_t* data, size_t instance) const
+{
+  for (auto it = mBindings.begin(); it != mBindings.end(); ++it)
+  {
+    // Missing components default to (0, 0, 0, 1), as they do for arrays.
+    float value[4] = {0.0f, 0.0f, 0.0f, 1.0f};
+    size_t element = instance / it->divisor;
+    const uint8_t* src = data + element * static_cast<size_t>(mStride) + it->offset;
+    bool normalize = (it->normalize == GL_TRUE);
+    GLint numComponents = std::min(it->numComponents, 4);
+    switch (it->type)
+    {
+      case GL_FLOAT:          convertComponents<float>(src, numComponents, false, value);         break;
+      case GL_BYTE:           convertComponents<int8_t>(src, numComponents, normalize, value);    break;
+      case GL_UNSIGNED_BYTE:  convertComponents<uint8_t>(src, numComponents, normalize, value);   break;
+      case GL_SHORT:          convertComponents<int16_t>(src, numComponents, normalize, value);   break;
+      case GL_UNSIGNED_SHORT: convertComponents<uint16_t>(src, numComponents, normalize, value);  break;
+      case GL_INT:            convertComponents<int32_t>(src, numComponents, normalize, value);   break;
+      case GL_UNSIGNED_INT:   convertComponents<uint32_t>(src, numComponents, normalize, value);  break;
+      default:
+        throw UnsupportedException("Unsupported instance attribute type.");
+    }
+
+    GL(glVertexAttrib4fv(it->location, value));
+  }
+}
+
 //------------------------------------------------------------------------------
 // SHADER ATTRIBUTES
 //------------------------------------------------------------------------------
@@ -138,6 +238,25 @@ size_t ShaderAttributeCollection::getNumAttributes() const
   return mAttributes.size();
 }
 
+//------------------------------------------------------------------------------
+bool ShaderAttributeCollection::findAttribute(const std::string& attribName,
+                                              AttribState& stateOut,
+                                              size_t& offsetOut) const
+{
+  size_t offset = 0;
+  for (auto it = mAttributes.begin(); it != mAttributes.end(); ++it)
+  {
+    if (it->codeName == attribName)
+    {
+      stateOut  = *it;
+      offsetOut = offset;
+      return true;
+    }
+    offset += getFullAttributeSize(*it);
+  }
+  return false;
+}
+
 //------------------------------------------------------------------------------
 bool ShaderAttributeCollection::hasAttribute(const std::string& attribName) const
 {
@@ -159,6 +278,30 @@ bool ShaderAttributeCollection::hasAttribute(const std::string& attribName) cons
   return false;
 }
 
+//------------------------------------------------------------------------------
+bool ShaderAttributeCollection::areAllAttributesInstanced() const
+{
+  for (auto it = mAttributes.begin(); it != mAttributes.end(); ++it)
+  {
+    if (it->divisor == 0)
+      return false;
+  }
+
+  return mAttributes.size() > 0;
+}
+
+//------------------------------------------------------------------------------
+bool ShaderAttributeCollection::hasInstancedAttributes() const
+{
+  for (auto it = mAttributes.begin(); it != mAttributes.end(); ++it)
+  {
+    if (it->divisor != 0)
+      return true;
+  }
+
+  return false;
+}
+
 //------------------------------------------------------------------------------
 bool ShaderAttributeCollection::doesSatisfyShader(const ShaderAttributeCollection& compare) const
 {
@@ -208,51 +351,49 @@ size_t ShaderAttributeCollection::getFullAttributeSize(const AttribState& att) c
 }
 
 //------------------------------------------------------------------------------
-void ShaderAttributeCollection::bindAttributes(std::shared_ptr<ShaderProgramAsset> program) const
+std::shared_ptr<const AttribBindingPlan>
+ShaderAttributeCollection::compileBindingPlan(const ShaderProgramAsset& program) const
 {
-  GLsizei stride = static_cast<GLsizei>(calculateStride());
+  std::vector<AttribBinding> bindings;
+  bindings.reserve(mAttributes.size());
+
   size_t offset = 0;
   for (auto it = mAttributes.begin(); it != mAttributes.end(); ++it)
   {
-    if (program->getAttributes().hasAttribute(it->codeName))
+    if (program.getAttributes().hasAttribute(it->codeName))
     {
       if (it->index != ShaderAttributeMan::getUnknownAttributeIndex())
       {
-        AttribState attrib = *it;
-        GLint attribPos = glGetAttribLocation(program->getProgramID(), attrib.codeName.c_str());
-        GL(glEnableVertexAttribArray(static_cast<GLuint>(attribPos)));
-        //Log::debug() << "Binding attribute " << attribPos << " with name '" << attrib.codeName << "' "
-        //             << "with num components " << attrib.numComponents << " type " << attrib.type
-        //             << " normalize " << attrib.normalize << " and stride: " << stride << std::endl;
-        GL(glVertexAttribPointer(static_cast<GLuint>(attribPos),
-                                 static_cast<GLint>(attrib.numComponents),
-                                 InterfaceImplementation::getGLType(attrib.type), 
-                                 static_cast<GLboolean>(attrib.normalize),
-                                 stride, reinterpret_cast<const void*>(offset)));
+        GLint attribPos = glGetAttribLocation(program.getProgramID(), it->codeName.c_str());
+        if (attribPos >= 0)
+        {
+          AttribBinding binding;
+          binding.location      = static_cast<GLuint>(attribPos);
+          binding.numComponents = static_cast<GLint>(it->numComponents);
+          binding.type          = InterfaceImplementation::getGLType(it->type);
+          binding.normalize     = static_cast<GLboolean>(it->normalize);
+          binding.offset        = offset;
+          binding.divisor       = static_cast<GLuint>(it->divisor);
+          bindings.push_back(binding);
+        }
       }
     }
 
     offset += it->size;
   }
+
+  return std::make_shared<AttribBindingPlan>(
+      bindings, static_cast<GLsizei>(calculateStride()));
 }
 
 //------------------------------------------------------------------------------
-void ShaderAttributeCollection::unbindAttributes(std::shared_ptr<ShaderProgramAsset> program) const
+std::vector<size_t> ShaderAttributeCollection::getAttributeIndices() const
 {
+  std::vector<size_t> indices;
+  indices.reserve(mAttributes.size());
   for (auto it = mAttributes.begin(); it != mAttributes.end(); ++it)
-  {
-    /// \todo Make this check more efficient.
-    if (program->getAttributes().hasAttribute(it->codeName))
-    {
-      if (it->index != ShaderAttributeMan::getUnknownAttributeIndex())
-      {
-        AttribState attrib = *it;
-        GLint attribPos = glGetAttribLocation(program->getProgramID(), attrib.codeName.c_str());
-        GL(glDisableVertexAttribArray(static_cast<GLuint>(attribPos)));
-      }
-    }
-  }
-
+    indices.push_back(it->index);
+  return indices;
 }
 
 //------------------------------------------------------------------------------
@@ -36,11 +36,13 @@
 #include <vector>
 #include <string>
 #include <tuple>
+#include <memory>
 
 namespace CPM_SPIRE_NS {
 
 class ShaderAttributeMan;
 class ShaderProgramAsset;
+class GLStateMan;
 
 /// Holds all information regarding one attribute.
 struct AttribState
@@ -52,6 +54,58 @@ struct AttribState
   bool                  normalize;      ///< True = normalize.
   size_t                size;           ///< Size, in bytes, of all components.
   Interface::DATA_TYPES type;           ///< GLtype of each component.
+  size_t                divisor;        ///< 0 = per-vertex. N = advances once
+                                        ///< every N instances.
+};
+
+/// Binding of a single VBO attribute to a program's attribute location.
+struct AttribBinding
+{
+  GLuint                location;       ///< Program attribute location.
+  GLint                 numComponents;  ///< Number of attribute components.
+  GLenum                type;           ///< GL type of each component.
+  GLboolean             normalize;      ///< GL_TRUE = normalize.
+  size_t                offset;         ///< Byte offset within a vertex.
+  GLuint                divisor;        ///< Instance divisor (0 = per-vertex).
+};
+
+/// Immutable set of attribute bindings for one (VBO attribute layout, program)
+/// pair. All string lookups and GL queries are performed when the plan is
+/// compiled (see ShaderAttributeCollection::compileBindingPlan), binding only
+/// issues glVertexAttribPointer and the attribute array enables.
+class AttribBindingPlan
+{
+public:
+  AttribBindingPlan(const std::vector<AttribBinding>& bindings, GLsizei stride);
+
+  /// Specifies attribute pointers into the currently bound GL_ARRAY_BUFFER and
+  /// enables the plan's attribute arrays. Vertices start 'baseOffset' bytes
+  /// into the buffer.
+  void bind(GLStateMan& state, size_t baseOffset = 0) const;
+
+  /// Disables the plan's attribute arrays.
+  void unbind(GLStateMan& state) const;
+
+#ifdef SPIRE_USE_INSTANCING
+  /// Same as bind, but also sets each attribute's instance divisor and does
+  /// not disable any other attribute arrays. Used for instance VBOs, which
+  /// are bound in addition to the pass' regular VBO.
+  void bindInstanced(GLStateMan& state) const;
+#endif
+
+  /// Instancing fallback. Sets the current (generic) value of every attribute
+  /// to its value for 'instance', taking divisors into account. 'data' is
+  /// the contents of the instance VBO.
+  void applyInstance(const uint8_t* data, size_t instance) const;
+
+  const std::vector<AttribBinding>& getBindings() const {return mBindings;}
+  GLsizei getStride() const                             {return mStride;}
+  uint32_t getEnabledMask() const                       {return mEnabledMask;}
+
+private:
+  std::vector<AttribBinding>  mBindings;    ///< Bindings, in VBO order.
+  GLsizei                     mStride;      ///< Stride between vertices.
+  uint32_t                    mEnabledMask; ///< Mask of attribute locations.
 };
 
 /// Shader attrtibutes class used to sort and compare shader input attributes.
@@ -81,11 +135,26 @@ public:
   /// If 'attrib' is contained herein, returns true.
   bool hasAttribute(const std::string& attribName) const;
 
-  /// Binds attributes to the shader indicated by parameter 'program'.
-  void bindAttributes(std::shared_ptr<ShaderProgramAsset> program) const;
+  /// Finds the attribute named 'attribName'. On success, returns true and
+  /// populates 'stateOut' and the attribute's byte offset within a vertex.
+  bool findAttribute(const std::string& attribName, AttribState& stateOut,
+                     size_t& offsetOut) const;
+
+  /// Returns true if every attribute has an instance divisor > 0.
+  bool areAllAttributesInstanced() const;
+
+  /// Returns true if any attribute has an instance divisor > 0.
+  bool hasInstancedAttributes() const;
+
+  /// Compiles the bindings required to feed this (VBO) attribute layout into
+  /// 'program'. Attributes not used by the program are skipped.
+  /// Prefer ShaderProgramAsset::getBindingPlan, which caches the result.
+  std::shared_ptr<const AttribBindingPlan>
+  compileBindingPlan(const ShaderProgramAsset& program) const;
 
-  /// Unbinds all attributes (glDisableVertexAttribArray).
-  void unbindAttributes(std::shared_ptr<ShaderProgramAsset> program) const;
+  /// Retrieves the ShaderAttributeMan indices of all attributes, in order.
+  /// Two collections with identical indices have identical vertex layouts.
+  std::vector<size_t> getAttributeIndices() const;
 
   /// Calculates the stride between vertices based on the attribute sizes
   /// calculated using calculateAttributeSizes.
@@ -141,8 +210,12 @@ public:
   /// \param normalize      If true, the attribute will be normalized.
   /// \param size           Size of the attribute in bytes, including padding.
   /// \param type           Type of the attribute.
+  /// \param divisor        Instance divisor. 0 for regular per-vertex
+  ///                       attributes. Attributes with a divisor > 0 may only
+  ///                       be placed in instance VBOs.
   void addAttribute(const std::string& codeName, size_t numComponents,
-                    bool normalize, size_t size, Interface::DATA_TYPES type);
+                    bool normalize, size_t size, Interface::DATA_TYPES type,
+                    size_t divisor = 0);
 
   /// Returns the index associated with the attribute whose name is 'codeName'.
   /// \return the first tuple parameter (bool) indicates whether or not an 
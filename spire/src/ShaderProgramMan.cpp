@@ -33,6 +33,8 @@
 #include "Exceptions.h"
 
 #include "Hub.h"
+#include "GLStateMan.h"
+#include "GlobalUniformBlock.h"
 #include "ShaderProgramMan.h"
 #include "ShaderMan.h"
 
@@ -76,8 +78,11 @@ ShaderProgramAsset::ShaderProgramAsset(
       const std::list<std::tuple<std::string, GLenum>>& shaders) :
     BaseAsset(name),
     mHasValidProgram(false),
+    mUsesGlobalBlock(false),
     mHub(hub),
-    mAttributes(mHub.getShaderAttributeManager())
+    mAttributes(mHub.getShaderAttributeManager()),
+    mNumUploads(0),
+    mNumSkippedUploads(0)
 {
   GLuint program = glCreateProgram();
   GL_CHECK();
@@ -165,6 +170,20 @@ ShaderProgramAsset::ShaderProgramAsset(
   // Now sync up program attributes
   //mAttributes.bindAttributes(program);
 
+#ifdef SPIRE_USE_UBO
+  // UNIFORM BLOCKS
+  try
+  {
+    mUsesGlobalBlock = 
+        mHub.getGlobalUniformStateMan().getGlobalUniformBlock().registerProgram(program);
+  }
+  catch (...)
+  {
+    GL(glDeleteProgram(program));
+    throw;
+  }
+#endif
+
   // UNIFORMS
   {
     // Check the active uniforms.
@@ -181,6 +200,19 @@ ShaderProgramAsset::ShaderProgramAsset(
       GL(glGetActiveUniform(program, static_cast<GLuint>(i), maxUniformNameSize, &charsWritten,
                             &uniformSize, &type, uniformName));
 
+#ifdef SPIRE_USE_UBO
+      // Block members are sourced from uniform buffers, not glUniform*.
+      // registerProgram has added them to the uniform manager.
+      if (GlobalUniformBlock::isBlockMember(program, static_cast<GLuint>(i)))
+      {
+        std::shared_ptr<const UniformState> state =
+            mHub.getShaderUniformManager().findUniformWithName(uniformName);
+        if (state != nullptr)
+          mGlobalBlockMembers.push_back(state->index);
+        continue;
+      }
+#endif
+
       try
       {
         mUniforms->addUniform(uniformName);
@@ -193,6 +225,8 @@ ShaderProgramAsset::ShaderProgramAsset(
     }
   }
 
+  mUploadedUniformVersions.resize(mUniforms->getNumUniforms(), 0);
+
   mLoadedShaders    = shaders;
   mHasValidProgram  = true;
 
@@ -204,11 +238,26 @@ ShaderProgramAsset::~ShaderProgramAsset()
 {
   if (mHasValidProgram)
   {
+    mHub.getGLStateManager().onProgramDeleted(glProgramID);
     GL(glDeleteProgram(glProgramID));
     mHasValidProgram = false;
   }
 }
 
+//------------------------------------------------------------------------------
+std::shared_ptr<const AttribBindingPlan>
+ShaderProgramAsset::getBindingPlan(const ShaderAttributeCollection& vboAttributes)
+{
+  std::vector<size_t> layout = vboAttributes.getAttributeIndices();
+  auto it = mBindingPlans.find(layout);
+  if (it != mBindingPlans.end())
+    return it->second;
+
+  std::shared_ptr<const AttribBindingPlan> plan = vboAttributes.compileBindingPlan(*this);
+  mBindingPlans.insert(std::make_pair(layout, plan));
+  return plan;
+}
+
 //------------------------------------------------------------------------------
 bool ShaderProgramAsset::areProgramSignaturesIdentical(
     const std::list<std::tuple<std::string, GLenum>>& shaders)
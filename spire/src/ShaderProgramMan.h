@@ -32,6 +32,8 @@
 #ifndef SPIRE_HIGH_SHADERPROGRAMMAN_H
 #define SPIRE_HIGH_SHADERPROGRAMMAN_H
 
+#include <map>
+
 #include "BaseAssetMan.h"
 #include "ShaderAttributeMan.h"
 #include "ShaderUniformMan.h"
@@ -52,9 +54,54 @@ public:
   /// Shader attribute collection.
   const ShaderAttributeCollection& getAttributes() const  {return mAttributes;}
 
-  /// Shader uniform collection.
+  /// Shader uniform collection. Does not include uniform block members.
   const ShaderUniformCollection& getUniforms() const      {return *mUniforms;}
 
+  /// True if the program reads global uniforms from GlobalUniformBlock.
+  bool usesGlobalUniformBlock() const                     {return mUsesGlobalBlock;}
+
+  /// True if the uniform with the given index (see UniformState::index) is a
+  /// member of the program's global uniform block. Block members are not
+  /// part of getUniforms and always hold the global value.
+  bool hasGlobalBlockMember(size_t uniformIndex) const
+  {
+    for (auto it = mGlobalBlockMembers.begin(); it != mGlobalBlockMembers.end(); ++it)
+    {
+      if (*it == uniformIndex)
+        return true;
+    }
+    return false;
+  }
+
+  /// Retrieves the attribute binding plan for VBOs with the attribute layout
+  /// 'vboAttributes'. Plans are compiled on first use and shared between all
+  /// VBOs with the same layout.
+  std::shared_ptr<const AttribBindingPlan>
+  getBindingPlan(const ShaderAttributeCollection& vboAttributes);
+
+  /// Returns true if the uniform at 'uniformIndex' (index into getUniforms)
+  /// must be uploaded to hold the value of the item with 'version'. The
+  /// version is recorded as uploaded, so the caller must upload the uniform
+  /// whenever true is returned. The program must be in use.
+  bool needsUniformUpload(size_t uniformIndex, uint64_t version)
+  {
+    if (mUploadedUniformVersions[uniformIndex] == version)
+    {
+      ++mNumSkippedUploads;
+      return false;
+    }
+
+    mUploadedUniformVersions[uniformIndex] = version;
+    ++mNumUploads;
+    return true;
+  }
+
+  /// Number of times needsUniformUpload returned true / false.
+  /// @{
+  size_t getNumUniformUploads() const                     {return mNumUploads;}
+  size_t getNumSkippedUniformUploads() const              {return mNumSkippedUploads;}
+  /// @}
+
   /// Returns false if 'shaders' does not match our program definition.
   /// O(n^2)
   bool areProgramSignaturesIdentical(const std::list<std::tuple<std::string, GLenum>>& shaders);
@@ -62,6 +109,7 @@ public:
 protected:
 
   bool                      mHasValidProgram; ///< True if glProgramID is valid.
+  bool                      mUsesGlobalBlock; ///< True if the SpireGlobals block is used.
   GLuint                    glProgramID;      ///< GL program ID.
 
   Hub&                      mHub;             ///< Reference to render hub.
@@ -69,6 +117,19 @@ protected:
   ShaderAttributeCollection mAttributes;      ///< All program attributes.
   std::unique_ptr<ShaderUniformCollection> mUniforms;
 
+  /// Uniform indices of the members of the global uniform block the program
+  /// reads (see UniformState::index).
+  std::vector<size_t>       mGlobalBlockMembers;
+
+  /// Version of the uniform state item last uploaded to each uniform in
+  /// mUniforms. 0 if nothing has been uploaded.
+  std::vector<uint64_t>     mUploadedUniformVersions;
+  size_t                    mNumUploads;        ///< See getNumUniformUploads.
+  size_t                    mNumSkippedUploads; ///< See getNumSkippedUniformUploads.
+
+  /// Attribute binding plans keyed by VBO attribute layout.
+  std::map<std::vector<size_t>, std::shared_ptr<const AttribBindingPlan>> mBindingPlans;
+
   ///< This list is used to verify that requested shader programs are not at
   ///< odds with each other.
   std::list<std::tuple<std::string, GLenum>>  mLoadedShaders;
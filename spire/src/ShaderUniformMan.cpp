@@ -50,9 +50,14 @@ ShaderUniformMan::~ShaderUniformMan()
 //------------------------------------------------------------------------------
 void ShaderUniformMan::addUniform(const std::string& codeName, GLenum type)
 {
+  // Keep the original uniform (and its index) if it has already been added.
+  if (mUniforms.find(codeName) != mUniforms.end())
+    return;
+
   std::shared_ptr<UniformState> uniform(new UniformState);
   uniform->codeName  = codeName;
   uniform->type      = type;
+  uniform->index     = mUniforms.size();
 
   mUniforms.insert(std::make_pair(codeName, uniform));
 }
@@ -162,13 +167,16 @@ bool ShaderUniformCollection::hasUniform(const std::string& uniformName) const
 const ShaderUniformCollection::UniformSpecificData&
 ShaderUniformCollection::getUniformData(const std::string& uniformName) const
 {
-  for (auto it = mUniforms.begin(); it != mUniforms.end(); ++it)
+  return mUniforms[getUniformIndex(uniformName)];
+}
+
+//------------------------------------------------------------------------------
+size_t ShaderUniformCollection::getUniformIndex(const std::string& uniformName) const
+{
+  for (size_t i = 0; i < mUniforms.size(); ++i)
   {
-    std::shared_ptr<const UniformState> state = it->uniform;
-    if (state->codeName == uniformName)
-    {
-      return *it;
-    }
+    if (mUniforms[i].uniform->codeName == uniformName)
+      return i;
   }
 
   throw std::out_of_range("Unable to find uniform with name specified.");
@@ -446,32 +454,32 @@ GLenum ShaderUniformMan::uniformTypeToGL(UNIFORM_TYPE type)
 }
 
 //------------------------------------------------------------------------------
-void ShaderUniformMan::applyUniformGLState(std::shared_ptr<AbstractUniformStateItem> item,
+void ShaderUniformMan::applyUniformGLState(const AbstractUniformStateItem& item,
                                            int location)
 {
-  switch (item->getGLType())
+  switch (item.getGLType())
   {
   case UNIFORM_FLOAT:
-    GL(glUniform1f(static_cast<GLint>(location), item->getData<float>()));
+    GL(glUniform1f(static_cast<GLint>(location), item.getData<float>()));
     break;
 
   case UNIFORM_FLOAT_VEC2:
     {
-      V2 data = item->getData<V2>();
+      V2 data = item.getData<V2>();
       GL(glUniform2f(static_cast<GLint>(location), data.x, data.y));
     }
     break;
 
   case UNIFORM_FLOAT_VEC3:
     {
-      V3 data = item->getData<V3>();
+      V3 data = item.getData<V3>();
       GL(glUniform3f(static_cast<GLint>(location), data.x, data.y, data.z));
     }
     break;
 
   case UNIFORM_FLOAT_VEC4:
     {
-      V4 data = item->getData<V4>();
+      V4 data = item.getData<V4>();
       GL(glUniform4f(static_cast<GLint>(location), data.x, data.y, data.z, data.w));
     }
     break;
@@ -484,7 +492,7 @@ void ShaderUniformMan::applyUniformGLState(std::shared_ptr<AbstractUniformStateI
 
   case UNIFORM_FLOAT_MAT4:
     GL(glUniformMatrix4fv(static_cast<GLint>(location), 1, false,
-                          static_cast<const GLfloat*>(item->getRawData())));
+                          static_cast<const GLfloat*>(item.getRawData())));
     break;
 
   case UNIFORM_SAMPLER_1D:
@@ -48,6 +48,8 @@ struct UniformState
 {
   std::string codeName;       ///< In-shader code name.
   GLenum      type;           ///< Type of the uniform. Used for type checking.
+  size_t      index;          ///< Unique integer id assigned by ShaderUniformMan.
+                              ///< Used to index uniform state slots.
 };
 
 class ShaderUniformCollection
@@ -89,6 +91,10 @@ public:
   /// not found in the list of uniforms.
   const UniformSpecificData& getUniformData(const std::string& uniformName) const;
 
+  /// Same as getUniformData, but retrieves the uniform's index in this
+  /// collection (see getUniformAtIndex).
+  size_t getUniformIndex(const std::string& uniformName) const;
+
   /// If 'uniformName' is contained herein, returns true.
   bool hasUniform(const std::string& uniformName) const;
 
@@ -119,7 +125,8 @@ public:
   /// @}
 
   /// Adds a new uniform to the system. Automatically assigns it an internal
-  /// index based on when it was added.
+  /// index based on when it was added. Indices are dense, starting at 0 for
+  /// the unknown uniform. Adding a uniform twice has no effect.
   /// A ShaderUniformNotFound exception will be thrown if the uniform is not
   /// found in the ShaderUniformMan.
   /// \param codeName       Name of the uniform in the shader code.
@@ -143,7 +150,7 @@ public:
   static GLenum uniformTypeToGL(UNIFORM_TYPE type);
 
   /// Given the uniform, applies the raw uniform state.
-  static void applyUniformGLState(std::shared_ptr<AbstractUniformStateItem> item,
+  static void applyUniformGLState(const AbstractUniformStateItem& item,
                                   int location);
 
 private:
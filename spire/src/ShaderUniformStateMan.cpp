@@ -34,39 +34,36 @@
 #include "ShaderUniformMan.h"
 #include "Hub.h"
 #include "Exceptions.h"
+#include "GlobalUniformBlock.h"
 
 namespace CPM_SPIRE_NS {
 
 //------------------------------------------------------------------------------
 ShaderUniformStateMan::ShaderUniformStateMan(Hub& hub) :
+#ifdef SPIRE_USE_UBO
+    mGlobalBlock(new GlobalUniformBlock(hub)),
+#endif
     mHub(hub)
 {
 }
 
 //------------------------------------------------------------------------------
-//ShaderUniformStateMan::~ShaderUniformStateMan()
-//{
-//}
+ShaderUniformStateMan::~ShaderUniformStateMan()
+{
+}
 
 //------------------------------------------------------------------------------
-bool ShaderUniformStateMan::applyUniform(const std::string& name, int location)
+size_t ShaderUniformStateMan::getGlobalUniformIndex(const std::string& name) const
 {
-  // We use mGlobalState.at instead of the [] operator because at throws an
-  // exception if the key is not found in the container.
-  /// \xxx  Possibly detect if the name exists, and if it does not then throw
-  ///       a different exception (instead of letting the map throw std::range_error).
-  auto it = mGlobalState.find(name);
-  if (it != mGlobalState.end())
-  {
-    std::shared_ptr<AbstractUniformStateItem>& ptr = it->second;
-    ShaderUniformMan::applyUniformGLState(ptr, location);
-    //std::cout << name << ": " << ptr->asString() << std::endl;
-    return true;
-  }
-  else
+  std::shared_ptr<const UniformState> uniform = mHub.getShaderUniformManager().findUniformWithName(name);
+  if (   uniform == nullptr
+      || uniform->index >= mGlobalState.size()
+      || mGlobalState[uniform->index] == nullptr)
   {
-    return false;
+    throw std::out_of_range("Unable to find global uniform.");
   }
+
+  return uniform->index;
 }
 
 //------------------------------------------------------------------------------
@@ -86,7 +83,13 @@ void ShaderUniformStateMan::updateGlobalUniform(const std::string& name,
   if (incomingType != uniform->type)
     throw ShaderUniformTypeError("Incoming type does not match type stored in uniform!");
 
-  mGlobalState[name] = item;
+  if (uniform->index >= mGlobalState.size())
+    mGlobalState.resize(uniform->index + 1);
+  mGlobalState[uniform->index] = item;
+
+#ifdef SPIRE_USE_UBO
+  mGlobalBlock->onGlobalUniformChanged(uniform->index);
+#endif
 }
 
 //------------------------------------------------------------------------------
@@ -94,7 +97,7 @@ std::shared_ptr<const AbstractUniformStateItem> ShaderUniformStateMan::getGlobal
 {
   try
   {
-    return mGlobalState.at(name);
+    return mGlobalState[getGlobalUniformIndex(name)];
   }
   catch (std::exception&)
   {
@@ -105,8 +108,7 @@ std::shared_ptr<const AbstractUniformStateItem> ShaderUniformStateMan::getGlobal
 //------------------------------------------------------------------------------
 std::string ShaderUniformStateMan::uniformAsString(const std::string& name) const
 {
-  const std::shared_ptr<const AbstractUniformStateItem>& ptr = mGlobalState.at(name);
-  return ptr->asString();
+  return mGlobalState[getGlobalUniformIndex(name)]->asString();
 }
 
 
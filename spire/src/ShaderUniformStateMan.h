@@ -32,13 +32,14 @@
 #ifndef SPIRE_CORE_SHADERUNIFORMSTATEMAN_H
 #define SPIRE_CORE_SHADERUNIFORMSTATEMAN_H
 
-#include <map>
-#include <unordered_map>
+#include <vector>
+#include <memory>
 #include "ShaderUniformStateManTemplates.h"
 
 namespace CPM_SPIRE_NS {
 
 class Hub;
+class GlobalUniformBlock;
 
 /// Unform state management. The currently available uniform state can be
 /// set and queried from this interface.
@@ -46,7 +47,7 @@ class ShaderUniformStateMan
 {
 public:
   ShaderUniformStateMan(Hub& hub);
-  virtual ~ShaderUniformStateMan() {}
+  virtual ~ShaderUniformStateMan();
   
   /// Adds a uniform to the global state.
   /// Throws std::out_of_range if a uniform of corresponding name is not found
@@ -81,9 +82,16 @@ public:
   void updateGlobalUniform(const std::string& name, 
                            std::shared_ptr<AbstractUniformStateItem> item);
 
-  /// Applies the specified uniform to the current shader state.
-  /// Throws std::out_of_range if the key was not found in the map.
-  bool applyUniform(const std::string& name, int location);
+  /// Retrieves the global uniform associated with the uniform index
+  /// 'uniformIndex' (see UniformState::index). Returns nullptr if no global
+  /// uniform has been set at that index.
+  const AbstractUniformStateItem* findGlobalUniform(size_t uniformIndex) const
+  {
+    if (uniformIndex < mGlobalState.size())
+      return mGlobalState[uniformIndex].get();
+    else
+      return nullptr;
+  }
 
   /// Retrieves the texture representation of the uniform with 'name'.
   std::string uniformAsString(const std::string& name) const;
@@ -93,12 +101,25 @@ public:
   /// exist.
   std::shared_ptr<const AbstractUniformStateItem> getGlobalUniform(const std::string& name);
 
+#ifdef SPIRE_USE_UBO
+  /// Retrieves the uniform block backing global uniforms.
+  GlobalUniformBlock& getGlobalUniformBlock()   {return *mGlobalBlock;}
+#endif
+
 private:
 
-  /// Contains all current global uniform state. I would use an ordered map,
-  /// but less than is used as the comparison operator. I would need to hash
-  /// the strings then insert the hashed value into the map.
-  std::unordered_map<std::string, std::shared_ptr<AbstractUniformStateItem>> mGlobalState;
+  /// Retrieves the index of the global uniform with 'name', or throws
+  /// std::out_of_range if no global uniform with that name has been set.
+  size_t getGlobalUniformIndex(const std::string& name) const;
+
+  /// Contains all current global uniform state, indexed by uniform index
+  /// (see ShaderUniformMan). Slots for uniforms without global state are
+  /// empty.
+  std::vector<std::shared_ptr<AbstractUniformStateItem>> mGlobalState;
+
+#ifdef SPIRE_USE_UBO
+  std::unique_ptr<GlobalUniformBlock> mGlobalBlock; ///< UBO backing for global uniforms.
+#endif
 
   Hub& mHub;
 };
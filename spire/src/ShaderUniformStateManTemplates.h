@@ -33,6 +33,8 @@
 #define SPIRE_CORE_SHADERUNIFORMSTATEMANTEMPLATES_H
 
 #include <cstddef>
+#include <cstdint>
+#include <atomic>
 #include <sstream>
 #include <vector>
 #include <stdexcept>
@@ -193,9 +195,14 @@ public:
 class AbstractUniformStateItem
 {
 public:
-  AbstractUniformStateItem()            {}
+  AbstractUniformStateItem() : mVersion(nextVersion())  {}
   virtual ~AbstractUniformStateItem()   {}
 
+  /// Items are immutable, so every item is assigned a unique, monotonically
+  /// increasing version on construction. Used to detect whether a program
+  /// already holds this item's value (see ShaderProgramAsset).
+  uint64_t getVersion() const           {return mVersion;}
+
   /// Returns appropriate OpenGL type
   virtual UNIFORM_TYPE getGLType() const = 0;
 
@@ -299,6 +306,16 @@ public:
   //static void uniform3fv(int location, size_t count, const float* value);
   /////@}
 
+private:
+
+  static uint64_t nextVersion()
+  {
+    // Version 0 is reserved to indicate 'no value'.
+    static std::atomic<uint64_t> version(0);
+    return ++version;
+  }
+
+  uint64_t mVersion;
 };
 
 //------------------------------------------------------------------------------
@@ -0,0 +1,186 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2013 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+/// \author agent
+/// \date   October 2026
+
+#ifndef SPIRE_HIGH_SLOTMAP_H
+#define SPIRE_HIGH_SLOTMAP_H
+
+#include <vector>
+#include <utility>
+#include <stdexcept>
+#include <cstdint>
+
+#include "Handle.h"
+
+namespace CPM_SPIRE_NS {
+
+/// Generational slot map. Values are stored contiguously and are addressed
+/// through handles (see Handle) in constant time without hashing. Removing a
+/// value increments the generation of its slot so that outstanding handles to
+/// it are detected as stale. Slots are recycled.
+///
+/// Iteration (begin / end) visits every value in an unspecified order.
+/// Inserting or erasing values invalidates iterators and pointers to values.
+template <typename T, typename Tag>
+class SlotMap
+{
+public:
+  typedef Handle<Tag>                               HandleType;
+  typedef typename std::vector<T>::iterator         iterator;
+  typedef typename std::vector<T>::const_iterator   const_iterator;
+
+  SlotMap()           {}
+  virtual ~SlotMap()  {}
+
+  /// Adds 'value' and returns its handle.
+  HandleType insert(const T& value)
+  {
+    uint32_t slotIndex;
+    if (mFreeSlots.empty())
+    {
+      slotIndex = static_cast<uint32_t>(mSlots.size());
+      mSlots.push_back(Slot());
+    }
+    else
+    {
+      slotIndex = mFreeSlots.back();
+      mFreeSlots.pop_back();
+    }
+
+    Slot& slot = mSlots[slotIndex];
+    slot.valueIndex = static_cast<uint32_t>(mValues.size());
+    mValues.push_back(value);
+    mValueSlots.push_back(slotIndex);
+    return HandleType(slotIndex, slot.generation);
+  }
+
+  /// Removes the value referenced by 'handle'.
+  /// Throws std::out_of_range if the handle is stale or invalid.
+  void erase(HandleType handle)
+  {
+    Slot& slot = getSlot(handle);
+
+    // Move the last value into the hole.
+    uint32_t valueIndex = slot.valueIndex;
+    uint32_t lastIndex  = static_cast<uint32_t>(mValues.size() - 1);
+    if (valueIndex != lastIndex)
+    {
+      mValues[valueIndex]     = std::move(mValues[lastIndex]);
+      mValueSlots[valueIndex] = mValueSlots[lastIndex];
+      mSlots[mValueSlots[valueIndex]].valueIndex = valueIndex;
+    }
+    mValues.pop_back();
+    mValueSlots.pop_back();
+
+    releaseSlot(handle.index);
+  }
+
+  /// Removes all values. All outstanding handles become stale.
+  void clear()
+  {
+    for (auto it = mValueSlots.begin(); it != mValueSlots.end(); ++it)
+      releaseSlot(*it);
+    mValues.clear();
+    mValueSlots.clear();
+  }
+
+  /// Retrieves the value referenced by 'handle'.
+  /// Throws std::out_of_range if the handle is stale or invalid.
+  T& at(HandleType handle)              {return mValues[getSlot(handle).valueIndex];}
+  const T& at(HandleType handle) const  {return mValues[getSlot(handle).valueIndex];}
+
+  /// Returns nullptr if 'handle' is stale or invalid.
+  T* find(HandleType handle)
+  {
+    if (contains(handle))
+      return &mValues[mSlots[handle.index].valueIndex];
+    else
+      return nullptr;
+  }
+
+  /// Returns true if 'handle' references a value in the map.
+  bool contains(HandleType handle) const
+  {
+    return handle.index < mSlots.size()
+        && handle.generation != 0
+        && mSlots[handle.index].generation == handle.generation;
+  }
+
+  size_t size() const                   {return mValues.size();}
+  bool empty() const                    {return mValues.empty();}
+
+  iterator begin()                      {return mValues.begin();}
+  iterator end()                        {return mValues.end();}
+  const_iterator begin() const          {return mValues.begin();}
+  const_iterator end() const            {return mValues.end();}
+
+private:
+
+  struct Slot
+  {
+    Slot() : valueIndex(0), generation(1) {}
+
+    uint32_t valueIndex;  ///< Index into mValues while the slot is in use.
+    uint32_t generation;  ///< Incremented whenever the slot is released.
+  };
+
+  const Slot& getSlot(HandleType handle) const
+  {
+    if (contains(handle) == false)
+      throw std::out_of_range("Stale or invalid handle.");
+    return mSlots[handle.index];
+  }
+
+  Slot& getSlot(HandleType handle)
+  {
+    if (contains(handle) == false)
+      throw std::out_of_range("Stale or invalid handle.");
+    return mSlots[handle.index];
+  }
+
+  void releaseSlot(uint32_t slotIndex)
+  {
+    // Generation 0 is reserved for invalid handles.
+    Slot& slot = mSlots[slotIndex];
+    ++slot.generation;
+    if (slot.generation == 0)
+      slot.generation = 1;
+    mFreeSlots.push_back(slotIndex);
+  }
+
+  std::vector<T>        mValues;      ///< Densely packed values.
+  std::vector<uint32_t> mValueSlots;  ///< Slot index of each value.
+  std::vector<Slot>     mSlots;
+  std::vector<uint32_t> mFreeSlots;
+};
+
+} // namespace CPM_SPIRE_NS
+
+#endif
@@ -35,7 +35,11 @@
 #include "SpireObject.h"
 #include "Exceptions.h"
 #include "Hub.h"
+#include "GLStateMan.h"
+#include "GLCaps.h"
 #include "ShaderUniformStateMan.h"
+#include "GlobalUniformBlock.h"
+#include "BatchMan.h"
 
 namespace CPM_SPIRE_NS {
 
@@ -52,6 +56,8 @@ ObjectPass::ObjectPass(
     mPrimitiveType(primitiveType),
     mVBO(vbo),
     mIBO(ibo),
+    mNumInstances(0),
+    mLOD(0),
     mHub(hub)
 {
   // findProgram will throw an exception of type std::out_of_range if shader is
@@ -59,10 +65,32 @@ ObjectPass::ObjectPass(
   ShaderProgramMan& man = mHub.getShaderProgramManager();
   mShader = man.findProgram(programName);
 
+  // Resolve attribute locations now so that binding the VBO does not require
+  // any string lookups or GL queries.
+  mAttribBinding = mShader->getBindingPlan(mVBO->getAttributeCollection());
+
+#ifdef SPIRE_USE_VAO
+  mVAO        = 0;
+  mVAOProgram = 0;
+  mVAOVBO     = 0;
+  mVAOIBO     = 0;
+  mVAOVBOOffset = 0;
+  // Streamed VBOs have no buffer until they are first written.
+  if (mVBO->getGLIndex() != 0)
+    buildVertexArray();
+#endif
+
+#ifdef SPIRE_USE_BATCHING
+  mBatch      = nullptr;
+  mBatchSlot  = 0;
+#endif
+
   // Ensure there is at least enough space in the mUniforms vector. 
   size_t numUniforms = mShader->getUniforms().getNumUniforms();
   mUniforms.reserve(numUniforms);
   mUnsatisfiedUniforms.reserve(numUniforms);
+  mUnsatisfiedUniformSlots.reserve(numUniforms);
+  mPassIndex = mHub.getPassUniformStateMan().addPass(mName);
 
   // Add uniforms present in the shader to the unsatisfied uniforms vector.
   // Not constructing an iterator interface as it's just easier to index.
@@ -75,67 +103,333 @@ ObjectPass::ObjectPass(
         Interface::UnsatisfiedUniform(uniformData.uniform->codeName, 
                                       uniformData.glUniformLoc,
                                       uniformData.glType));
+    mUnsatisfiedUniformSlots.push_back(
+        UniformSlot(uniformData.glUniformLoc, i, uniformData.uniform->index));
   }
 }
 
 //------------------------------------------------------------------------------
 ObjectPass::~ObjectPass()
 {
+#ifdef SPIRE_USE_BATCHING
+  if (mBatch != nullptr)
+    mBatch->removePass(this);
+#endif
+
+#ifdef SPIRE_USE_VAO
+  if (mVAO != 0)
+  {
+    mHub.getGLStateManager().onVertexArrayDeleted(mVAO);
+    GL(glDeleteVertexArrays(1, &mVAO));
+  }
+#endif
 }
 
+#ifdef SPIRE_USE_VAO
+//------------------------------------------------------------------------------
+void ObjectPass::buildVertexArray()
+{
+  GLStateMan& state = mHub.getGLStateManager();
+
+  // Start from a fresh VAO so that no attribute arrays from a previous
+  // binding plan are left enabled.
+  if (mVAO != 0)
+  {
+    state.onVertexArrayDeleted(mVAO);
+    GL(glDeleteVertexArrays(1, &mVAO));
+    mVAO = 0;
+  }
+
+  mAttribBinding = mShader->getBindingPlan(mVBO->getAttributeCollection());
+
+  GL(glGenVertexArrays(1, &mVAO));
+  state.bindVertexArray(mVAO);
+  state.bindArrayBuffer(mVBO->getGLIndex());
+  mAttribBinding->bind(state, mVBO->getOffset());
+  if (mInstanceVBO != nullptr && mHub.getGLCaps().hasInstancedArrays())
+  {
+    state.bindArrayBuffer(mInstanceVBO->getGLIndex());
+    mInstanceBinding->bindInstanced(state);
+  }
+  state.bindElementArrayBuffer(mIBO->getGLIndex(mLOD));
+
+  mVAOProgram = mShader->getProgramID();
+  mVAOVBO     = mVBO->getGLIndex();
+  mVAOIBO     = mIBO->getGLIndex(mLOD);
+  mVAOVBOOffset = mVBO->getOffset();
+}
+#endif
+
 //------------------------------------------------------------------------------
 void ObjectPass::renderPass()
 {
-  GL(glUseProgram(mShader->getProgramID()));
+  if (isResident() == false)
+    return;
 
-  GL(glBindBuffer(GL_ARRAY_BUFFER, mVBO->getGLIndex()));
-  GL(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mIBO->getGLIndex()));
+  flushBufferUpdates();
+  bindProgram();
+  bindVertexBuffer();
+  bindIndexBuffer();
+
+  //GPUState priorGPUState = mHub.getGPUStateManager().getState(); // Do NOT store a reference to the state...
+  //if (mGPUState != nullptr)
+  //  mHub.getGPUStateManager().apply(*mGPUState);
+
+  applyUniformsAndDraw();
+
+  // No-op when using VAOs.
+  unbindAttributes();
+
+  //if (mGPUState != nullptr)
+  //  mHub.getGPUStateManager().apply(priorGPUState);
+}
+
+//------------------------------------------------------------------------------
+void ObjectPass::bindProgram() const
+{
+  mHub.getGLStateManager().useProgram(mShader->getProgramID());
+}
+
+//------------------------------------------------------------------------------
+void ObjectPass::bindVertexBuffer()
+{
+  GLStateMan& state = mHub.getGLStateManager();
+
+#ifdef SPIRE_USE_VAO
+  if (   mVAOProgram != mShader->getProgramID()
+      || mVAOVBO != mVBO->getGLIndex())
+  {
+    buildVertexArray();
+  }
+
+  // The VAO holds the attribute pointers, attribute enables, and IBO binding.
+  state.bindVertexArray(mVAO);
+
+  // Streamed VBOs move within the stream buffer every frame, only the
+  // attribute pointers need to follow.
+  if (mVAOVBOOffset != mVBO->getOffset())
+  {
+    state.bindArrayBuffer(mVBO->getGLIndex());
+    mAttribBinding->bind(state, mVBO->getOffset());
+    mVAOVBOOffset = mVBO->getOffset();
+  }
+
+  // Switching LODs only changes the VAO's IBO binding.
+  GLuint ibo = mIBO->getGLIndex(mLOD);
+  if (mVAOIBO != ibo)
+  {
+    state.bindElementArrayBuffer(ibo);
+    mVAOIBO = ibo;
+  }
+#else
+  state.bindArrayBuffer(mVBO->getGLIndex());
 
   // We have already verified that the attributes contained in the shader
   // are consistent with the attributes we have in the VBO. Therefore, it's
   // okay to calculate the attribute stride based on the shader's stride, and
   // bind all of the shader's attributes.
-  const ShaderAttributeCollection& attribs = mVBO->getAttributeCollection();
-  attribs.bindAttributes(mShader);
+  mAttribBinding->bind(state, mVBO->getOffset());
+#endif
+}
 
-  //GPUState priorGPUState = mHub.getGPUStateManager().getState(); // Do NOT store a reference to the state...
-  //if (mGPUState != nullptr)
-  //  mHub.getGPUStateManager().apply(*mGPUState);
+//------------------------------------------------------------------------------
+void ObjectPass::bindIndexBuffer() const
+{
+#ifndef SPIRE_USE_VAO
+  mHub.getGLStateManager().bindElementArrayBuffer(mIBO->getGLIndex(mLOD));
+#endif
+}
+
+//------------------------------------------------------------------------------
+void ObjectPass::unbindAttributes() const
+{
+#ifndef SPIRE_USE_VAO
+  mAttribBinding->unbind(mHub.getGLStateManager());
+#endif
+}
+
+//------------------------------------------------------------------------------
+void ObjectPass::applyUniformsAndDraw()
+{
+  applyUniforms();
+
+  GLsizei numElements = static_cast<GLsizei>(mIBO->getNumElements(mLOD));
+  // Streamed and sub-allocated IBOs start at a non-zero offset, their LODs
+  // do not.
+  const void* indices = reinterpret_cast<const void*>(mIBO->getOffset(mLOD));
+  if (mInstanceVBO == nullptr)
+  {
+    GL(glDrawElements(mPrimitiveType, numElements, mIBO->getType(), indices));
+  }
+#ifdef SPIRE_USE_INSTANCING
+  else if (mHub.getGLCaps().hasInstancedArrays())
+  {
+    GL(glDrawElementsInstanced(mPrimitiveType, numElements, mIBO->getType(), indices,
+                               static_cast<GLsizei>(mNumInstances)));
+  }
+#endif
+  else
+  {
+    // No hardware instancing. Set the instanced attributes as generic
+    // attribute values and draw each instance individually.
+    const uint8_t* instanceData = mInstanceVBO->getInstanceData().data();
+    for (size_t i = 0; i < mNumInstances; ++i)
+    {
+      mInstanceBinding->applyInstance(instanceData, i);
+      GL(glDrawElements(mPrimitiveType, numElements, mIBO->getType(), indices));
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+void ObjectPass::applyUniforms()
+{
+#ifdef SPIRE_USE_UBO
+  // Upload global uniform block contents if any global uniform changed.
+  if (mShader->usesGlobalUniformBlock())
+    mHub.getGlobalUniformStateMan().getGlobalUniformBlock().flush();
+#endif
 
   // Assign pass local uniforms.
   for (auto it = mUniforms.begin(); it != mUniforms.end(); ++it)
   {
-    ShaderUniformMan::applyUniformGLState(it->item, it->shaderLocation);
+    applyUniform(*it->item, it->shaderLocation, it->programUniformIndex);
     //std::cout << it->uniformName << ": " << it->item->asString() << std::endl;
   }
 
   // Assign global uniforms, searches through 3 levels in an attempt to find the
   // uniform: object global -> pass global -> and global.
-  std::list<std::string> unsatisfiedGlobalUniforms;
-  for (auto it = mUnsatisfiedUniforms.begin(); it != mUnsatisfiedUniforms.end(); ++it)
+  const PassUniformStateMan& passMan = mHub.getPassUniformStateMan();
+  const ShaderUniformStateMan& globalMan = mHub.getGlobalUniformStateMan();
+  for (size_t i = 0; i < mUnsatisfiedUniformSlots.size(); ++i)
   {
-    bool applied = mHub.getPassUniformStateMan().tryApplyUniform(mName, it->uniformName, it->shaderLocation);
-    if (applied == false)
+    const UniformSlot& slot = mUnsatisfiedUniformSlots[i];
+    const AbstractUniformStateItem* item = passMan.findPassUniform(mPassIndex, slot.uniformIndex);
+    if (item == nullptr)
+      item = globalMan.findGlobalUniform(slot.uniformIndex);
+
+    if (item == nullptr)
     {
-      if (mHub.getGlobalUniformStateMan().applyUniform(it->uniformName, it->shaderLocation) == false)
-        unsatisfiedGlobalUniforms.push_back(it->uniformName);
+      throw ShaderUniformNotFound("Could not initialize uniform: " + 
+                                  mUnsatisfiedUniforms[i].uniformName);
     }
+
+    applyUniform(*item, slot.shaderLocation, slot.programUniformIndex);
+  }
+}
+
+//------------------------------------------------------------------------------
+const AbstractUniformStateItem* ObjectPass::findUniform(size_t uniformIndex) const
+{
+  const ShaderUniformCollection& uniforms = mShader->getUniforms();
+  for (auto it = mUniforms.begin(); it != mUniforms.end(); ++it)
+  {
+    if (uniforms.getUniformAtIndex(it->programUniformIndex).uniform->index == uniformIndex)
+      return it->item.get();
   }
 
-  // If we have an unsatisfied uniforms callback, ensure that it is called..
-  if (unsatisfiedGlobalUniforms.size() > 0)
+  for (auto it = mUnsatisfiedUniformSlots.begin(); it != mUnsatisfiedUniformSlots.end(); ++it)
   {
-    throw ShaderUniformNotFound("Could not initialize uniform: " + unsatisfiedGlobalUniforms.front());
+    if (it->uniformIndex == uniformIndex)
+    {
+      const AbstractUniformStateItem* item =
+          mHub.getPassUniformStateMan().findPassUniform(mPassIndex, uniformIndex);
+      if (item == nullptr)
+        item = mHub.getGlobalUniformStateMan().findGlobalUniform(uniformIndex);
+      return item;
+    }
   }
-  
 
-  GL(glDrawElements(mPrimitiveType, static_cast<GLsizei>(mIBO->getNumElements()), mIBO->getType(), 0));
+  // Members of the global uniform block are not among the program's uniforms
+  // and always hold the global value.
+  if (mShader->hasGlobalBlockMember(uniformIndex))
+    return mHub.getGlobalUniformStateMan().findGlobalUniform(uniformIndex);
 
-  // We can do away with this once we switch to VAOs.
-  attribs.unbindAttributes(mShader);
+  return nullptr;
+}
 
-  //if (mGPUState != nullptr)
-  //  mHub.getGPUStateManager().apply(priorGPUState);
+//------------------------------------------------------------------------------
+bool ObjectPass::hasSameLocalUniforms(const ObjectPass& other) const
+{
+  // Both passes are assumed to use the same program, in which case the
+  // unsatisfied uniforms resolve to the same pass and global items as well.
+  // Local uniforms are compared in insertion order. Passes that added the
+  // same uniforms in a different order are treated as different.
+  if (mUniforms.size() != other.mUniforms.size())
+    return false;
+
+  for (size_t i = 0; i < mUniforms.size(); ++i)
+  {
+    const UniformItem& a = mUniforms[i];
+    const UniformItem& b = other.mUniforms[i];
+    if (   a.programUniformIndex != b.programUniformIndex
+        || a.item->getVersion() != b.item->getVersion())
+      return false;
+  }
+  return true;
+}
+
+#ifdef SPIRE_USE_BATCHING
+//------------------------------------------------------------------------------
+void ObjectPass::setBatch(DrawBatch* batch, size_t slot)
+{
+  mBatch      = batch;
+  mBatchSlot  = slot;
+}
+#endif
+
+//------------------------------------------------------------------------------
+void ObjectPass::setInstanceVBO(std::shared_ptr<VBOObject> vbo)
+{
+#ifdef SPIRE_USE_BATCHING
+  // Instanced passes cannot be batched.
+  if (vbo != nullptr && mBatch != nullptr)
+    mBatch->removePass(this);
+#endif
+
+  if (vbo != nullptr)
+  {
+    if (vbo->getAttributeCollection().areAllAttributesInstanced() == false)
+      throw std::invalid_argument("Instance VBOs may only contain attributes with a divisor.");
+
+    mInstanceBinding = mShader->getBindingPlan(vbo->getAttributeCollection());
+    size_t stride = vbo->getAttributeCollection().calculateStride();
+    mNumInstances = vbo->getSize() / stride;
+  }
+  else
+  {
+    mInstanceBinding.reset();
+    mNumInstances = 0;
+  }
+  mInstanceVBO = vbo;
+
+#ifdef SPIRE_USE_VAO
+  buildVertexArray();
+#endif
+}
+
+//------------------------------------------------------------------------------
+void ObjectPass::applyUniform(const AbstractUniformStateItem& item, GLint location,
+                              size_t programUniformIndex)
+{
+  // Programs retain uniform values. Only upload if the program's current
+  // value came from a different item, e.g. when objects sharing this program
+  // use different colors. Global uniforms shared by every object in a frame
+  // are uploaded once per program.
+  if (mShader->needsUniformUpload(programUniformIndex, item.getVersion()))
+    ShaderUniformMan::applyUniformGLState(item, location);
+}
+
+//------------------------------------------------------------------------------
+uint64_t ObjectPass::getSortKey() const
+{
+  // Program is the most expensive state change, followed by the VBO (which
+  // also requires re-binding attributes) and then the IBO. GL names are
+  // truncated to fit the key; this only affects the quality of the grouping,
+  // the render queue compares full GL names before skipping any binds.
+  return    (static_cast<uint64_t>(mShader->getProgramID() & 0xFFFF)   << 48)
+          | (static_cast<uint64_t>(mVBO->getGLIndex()      & 0xFFFFFF) << 24)
+          | (static_cast<uint64_t>(mIBO->getGLIndex()      & 0xFFFFFF));
 }
 
 //------------------------------------------------------------------------------
@@ -145,12 +439,14 @@ bool ObjectPass::addPassUniform(const std::string& uniformName,
 {
   GLenum uniformGlType;
   GLint uniformLoc;
+  size_t programUniformIndex;
 
   try
   {
     // Attempt to find uniform in bound shader.
+    programUniformIndex = mShader->getUniforms().getUniformIndex(uniformName);
     const ShaderUniformCollection::UniformSpecificData& uniformData = 
-        mShader->getUniforms().getUniformData(uniformName);
+        mShader->getUniforms().getUniformAtIndex(programUniformIndex);
     uniformGlType = uniformData.glType;
     uniformLoc = uniformData.glUniformLoc;
   }
@@ -200,11 +496,12 @@ bool ObjectPass::addPassUniform(const std::string& uniformName,
     // pre-existing uniforms. It has also passed an existence check against
     // the shader and a type check.
     bool foundUnsatisfiedUniform = false;
-    for (auto it = mUnsatisfiedUniforms.begin(); it != mUnsatisfiedUniforms.end(); ++it)
+    for (size_t i = 0; i < mUnsatisfiedUniforms.size(); ++i)
     {
-      if (it->uniformName == uniformName)
+      if (mUnsatisfiedUniforms[i].uniformName == uniformName)
       {
-        mUnsatisfiedUniforms.erase(it);
+        mUnsatisfiedUniforms.erase(mUnsatisfiedUniforms.begin() + i);
+        mUnsatisfiedUniformSlots.erase(mUnsatisfiedUniformSlots.begin() + i);
         foundUnsatisfiedUniform = true;
         break;
       }
@@ -216,6 +513,7 @@ bool ObjectPass::addPassUniform(const std::string& uniformName,
     }
 
     mUniforms.emplace_back(UniformItem(uniformName, item, uniformLoc,
+                                       programUniformIndex,
                                        !isObjectGlobalUniform));
   }
 
@@ -321,7 +619,7 @@ void SpireObject::addPass(
     // Insert the pass into our array. Even sub-passes are added to the toplevel
     // of our array. This is so that we can use the normal pass functions to
     // manipulate subpasses without any extra logic.
-    mPasses.insert(std::make_pair(passName, internalPass));
+    insertPass(passName, internalPass);
   }
 
   // Check to see if we are adding a subpass. If we are, look up the parent
@@ -336,7 +634,7 @@ void SpireObject::addPass(
       ObjectPassInternal parentInternalPass(nullptr);
 
       // Construct a dummy pass for the parent.
-      mPasses.insert(std::make_pair(parentPass, parentInternalPass));
+      insertPass(parentPass, parentInternalPass);
       parentPassIt = mPasses.find(parentPass);
     }
     
@@ -364,6 +662,51 @@ void SpireObject::addPass(
   }
 }
 
+//------------------------------------------------------------------------------
+SpireObject::ObjectPassInternal& SpireObject::insertPass(
+    const std::string& passName, const ObjectPassInternal& internalPass)
+{
+  auto inserted = mPasses.insert(std::make_pair(passName, internalPass));
+
+  size_t passIndex = mHub.getPassUniformStateMan().addPass(passName);
+  if (passIndex >= mPassesByIndex.size())
+    mPassesByIndex.resize(passIndex + 1, nullptr);
+  mPassesByIndex[passIndex] = &inserted.first->second;
+
+  return inserted.first->second;
+}
+
+//------------------------------------------------------------------------------
+const SpireObject::ObjectPassInternal* SpireObject::findPassInternal(size_t passIndex) const
+{
+  if (passIndex < mPassesByIndex.size())
+    return mPassesByIndex[passIndex];
+  else
+    return nullptr;
+}
+
+//------------------------------------------------------------------------------
+std::shared_ptr<ObjectPass> SpireObject::getPassByIndex(size_t passIndex) const
+{
+  const ObjectPassInternal* internalPass = findPassInternal(passIndex);
+  if (internalPass == nullptr || internalPass->objectPass == nullptr)
+    throw NotFound("Unable to find pass with given index.");
+  return internalPass->objectPass;
+}
+
+//------------------------------------------------------------------------------
+void SpireObject::setPassInstanceVBO(const std::string& passName,
+                                     std::shared_ptr<VBOObject> vbo)
+{
+  getPassByName(passName)->setInstanceVBO(vbo);
+}
+
+//------------------------------------------------------------------------------
+void SpireObject::setPassInstanceVBO(size_t passIndex, std::shared_ptr<VBOObject> vbo)
+{
+  getPassByIndex(passIndex)->setInstanceVBO(vbo);
+}
+
 //------------------------------------------------------------------------------
 std::shared_ptr<const ObjectPass> SpireObject::getObjectPassParams(const std::string& passName) const
 {
@@ -377,9 +720,19 @@ void SpireObject::removePass(const std::string& passName)
   // the pass' unordered_map.
   std::shared_ptr<ObjectPass> pass = getPassByName(passName);
 
+  mPassesByIndex[pass->getPassIndex()] = nullptr;
   mPasses.erase(passName);
 }
 
+//------------------------------------------------------------------------------
+void SpireObject::removePass(size_t passIndex)
+{
+  std::shared_ptr<ObjectPass> pass = getPassByIndex(passIndex);
+
+  mPassesByIndex[passIndex] = nullptr;
+  mPasses.erase(pass->getName());
+}
+
 //------------------------------------------------------------------------------
 void SpireObject::addPassUniform(const std::string& passName,
                                  const std::string uniformName,
@@ -398,6 +751,19 @@ void SpireObject::addPassUniform(const std::string& passName,
   }
 }
 
+//------------------------------------------------------------------------------
+void SpireObject::addPassUniform(size_t passIndex, const std::string& uniformName,
+                                 std::shared_ptr<AbstractUniformStateItem> item)
+{
+  std::shared_ptr<ObjectPass> pass = getPassByIndex(passIndex);
+  if (pass->addPassUniform(uniformName, item, false) == false)
+  {
+    std::stringstream stream;
+    stream << "This uniform (" << uniformName << ") is not recognized by the shader.";
+    throw std::invalid_argument(stream.str());
+  }
+}
+
 //------------------------------------------------------------------------------
 std::vector<Interface::UnsatisfiedUniform>
 SpireObject::getUnsatisfiedUniforms(const std::string& passName)
@@ -406,6 +772,13 @@ SpireObject::getUnsatisfiedUniforms(const std::string& passName)
   return pass->getUnsatisfiedUniforms();
 }
 
+//------------------------------------------------------------------------------
+std::vector<Interface::UnsatisfiedUniform>
+SpireObject::getUnsatisfiedUniforms(size_t passIndex)
+{
+  return getPassByIndex(passIndex)->getUnsatisfiedUniforms();
+}
+
 //------------------------------------------------------------------------------
 std::shared_ptr<const AbstractUniformStateItem>
 SpireObject::getPassUniform(const std::string& passName,
@@ -501,23 +874,62 @@ bool SpireObject::hasGlobalUniform(const std::string& uniformName) const
 //------------------------------------------------------------------------------
 void SpireObject::renderPass(const std::string& passName)
 {
-  ObjectPassInternal& internalObjectPass = mPasses[passName];
-  std::shared_ptr<ObjectPass> pass = internalObjectPass.objectPass;
+  size_t passIndex;
+  if (mHub.getPassUniformStateMan().findPassIndex(passName, passIndex))
+    renderPass(passIndex);
+}
+
+//------------------------------------------------------------------------------
+void SpireObject::renderPass(size_t passIndex)
+{
+  const ObjectPassInternal* internalObjectPass = findPassInternal(passIndex);
+  if (internalObjectPass == nullptr)
+    return;
 
   // Render the pass
-  if (pass != nullptr)
-    pass->renderPass();
+  if (internalObjectPass->objectPass != nullptr)
+    internalObjectPass->objectPass->renderPass();
 
   // Now render any associated subpasses.
-  if (internalObjectPass.objectSubPasses != nullptr)
+  if (internalObjectPass->objectSubPasses != nullptr)
   {
-    for (auto it = internalObjectPass.objectSubPasses->begin(); 
-         it != internalObjectPass.objectSubPasses->end(); ++it)
+    for (auto it = internalObjectPass->objectSubPasses->begin(); 
+         it != internalObjectPass->objectSubPasses->end(); ++it)
     {
       (*it)->renderPass();
     }
   }
 }
 
+//------------------------------------------------------------------------------
+void SpireObject::gatherPasses(const std::string& passName,
+                               std::vector<ObjectPass*>& out) const
+{
+  size_t passIndex;
+  if (mHub.getPassUniformStateMan().findPassIndex(passName, passIndex))
+    gatherPasses(passIndex, out);
+}
+
+//------------------------------------------------------------------------------
+void SpireObject::gatherPasses(size_t passIndex, std::vector<ObjectPass*>& out) const
+{
+  const ObjectPassInternal* internalPass = findPassInternal(passIndex);
+  if (internalPass == nullptr)
+    return;
+
+  const ObjectPassInternal& internalObjectPass = *internalPass;
+  if (internalObjectPass.objectPass != nullptr)
+    out.push_back(internalObjectPass.objectPass.get());
+
+  if (internalObjectPass.objectSubPasses != nullptr)
+  {
+    for (auto sub = internalObjectPass.objectSubPasses->begin();
+         sub != internalObjectPass.objectSubPasses->end(); ++sub)
+    {
+      out.push_back(sub->get());
+    }
+  }
+}
+
 } // namespace CPM_SPIRE_NS
 
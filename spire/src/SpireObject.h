@@ -42,9 +42,13 @@
 
 #include "VBOObject.h"
 #include "IBOObject.h"
+#include "Bounds.h"
+#include "OcclusionMan.h"
 
 namespace CPM_SPIRE_NS {
 
+class DrawBatch;
+
 //------------------------------------------------------------------------------
 // ObjectPassobject
 //------------------------------------------------------------------------------
@@ -59,11 +63,118 @@ public:
       std::shared_ptr<VBOObject> vbo, std::shared_ptr<IBOObject> ibo, GLenum primitiveType);
   virtual ~ObjectPass();
   
+  /// Binds all state required by the pass, renders, and unbinds attributes.
   void renderPass();
 
+  /// The following functions are the individual stages of renderPass. They
+  /// are used by the RenderQueue to skip bindings that are shared between
+  /// consecutively rendered passes.
+  /// @{
+  void bindProgram() const;
+  void bindVertexBuffer();        ///< Binds the VBO and enables attributes.
+  void bindIndexBuffer() const;   ///< No-op when using VAOs.
+  void unbindAttributes() const;  ///< No-op when using VAOs.
+  void applyUniformsAndDraw();
+  /// @}
+
+  /// Applies the pass' uniforms without drawing. Used by DrawBatch, which
+  /// draws the geometry of several passes at once.
+  void applyUniforms();
+
+  /// True if both passes have the same set of local uniform items. Passes
+  /// sharing a program and local uniforms can be drawn with a single call.
+  bool hasSameLocalUniforms(const ObjectPass& other) const;
+
+  /// True if the pass' geometry may be merged with that of other passes
+  /// (see BatchMan). Instanced passes are never batched, neither are passes
+  /// whose buffers are not static (batches hold copies of the geometry).
+  bool isBatchable() const
+  {
+    return mInstanceVBO == nullptr && mIBO->getNumLODs() == 1
+        && mVBO->isStatic() && mIBO->isStatic();
+  }
+
+  /// Uploads pending changes to the pass' buffers (see VBOObject::update).
+  /// Called before the pass is drawn.
+  void flushBufferUpdates()
+  {
+    mVBO->flushUpdates();
+    mIBO->flushUpdates();
+    if (mInstanceVBO != nullptr)
+      mInstanceVBO->flushUpdates();
+
+    // Updating the IBO discards its LOD chain.
+    if (mLOD >= mIBO->getNumLODs())
+      mLOD = 0;
+  }
+
+  /// Packed (program, VBO, IBO) key used to sort passes such that passes
+  /// sharing GL state are rendered consecutively.
+  uint64_t getSortKey() const;
+
   const std::string& getName() const    {return mName;}
   GLenum getPrimitiveType() const       {return mPrimitiveType;}
 
+  /// Attaches a VBO containing per-instance attributes (attributes with a
+  /// divisor > 0, see ShaderAttributeMan::addAttribute). The pass is then
+  /// drawn once per instance in the VBO. Pass an empty pointer to remove the
+  /// instance VBO. Throws std::invalid_argument if any attribute in 'vbo' is
+  /// not an instanced attribute.
+  void setInstanceVBO(std::shared_ptr<VBOObject> vbo);
+
+  /// Number of instances rendered by the pass (0 if not instanced).
+  size_t getNumInstances() const        {return mNumInstances;}
+
+  /// Bounds of the pass' geometry, taken from its VBO (see
+  /// VBOObject::hasBounds). Instanced passes have no bounds.
+  /// @{
+  bool hasBounds() const                {return mVBO->hasBounds() && mInstanceVBO == nullptr;}
+  const AABB& getAABB() const           {return mVBO->getAABB();}
+  const BoundingSphere& getBoundingSphere() const {return mVBO->getBoundingSphere();}
+  /// @}
+
+  /// False if any of the pass' buffers are still in the upload queue (see
+  /// UploadQueue). Such passes are skipped.
+  bool isResident() const
+  {
+    return mVBO->isResident() && mIBO->isResident()
+        && (mInstanceVBO == nullptr || mInstanceVBO->isResident());
+  }
+
+  /// Level of detail of the IBO drawn by the pass (see
+  /// IBOObject::getNumLODs). Selected every frame while culling.
+  void setLOD(size_t lod)               {mLOD = lod;}
+  size_t getLOD() const                 {return mLOD;}
+
+  /// Occlusion query state of the pass (see OcclusionMan).
+  OcclusionQuery& getOcclusionQuery()   {return mOcclusionQuery;}
+
+  /// Retrieves the item the pass renders with for the uniform at
+  /// 'uniformIndex' (see UniformState::index), following the same precedence
+  /// as applyUniforms. Members of the program's global uniform block resolve
+  /// to the global item. Returns nullptr if the pass' program does not use
+  /// the uniform or if no item is available.
+  const AbstractUniformStateItem* findUniform(size_t uniformIndex) const;
+
+  GLuint getProgramID() const           {return mShader->getProgramID();}
+  GLuint getVBOGLIndex() const          {return mVBO->getGLIndex();}
+  size_t getVBOOffset() const           {return mVBO->getOffset();}
+  GLuint getIBOGLIndex() const          {return mIBO->getGLIndex();}
+
+  std::shared_ptr<ShaderProgramAsset> getShader() const {return mShader;}
+  std::shared_ptr<VBOObject> getVBO() const             {return mVBO;}
+  std::shared_ptr<IBOObject> getIBO() const             {return mIBO;}
+  std::shared_ptr<const AttribBindingPlan> getAttribBinding() const {return mAttribBinding;}
+  size_t getPassIndex() const           {return mPassIndex;}
+
+#ifdef SPIRE_USE_BATCHING
+  /// Called by DrawBatch when the pass is added to or removed from a batch.
+  /// 'slot' identifies the pass within the batch.
+  void setBatch(DrawBatch* batch, size_t slot);
+  DrawBatch* getBatch() const           {return mBatch;}
+  size_t getBatchSlot() const           {return mBatchSlot;}
+#endif
+
   /// Adds a local uniform to the pass.
   /// throws std::out_of_range if 'uniformName' is not found in the shader's
   /// uniform list.
@@ -84,6 +195,11 @@ public:
   /// global uniforms were used to populate the uniform.
   bool hasUniform(const std::string& uniformName) const;
 
+  /// Uploads 'item' to the uniform at 'programUniformIndex' unless mShader
+  /// already holds its value.
+  void applyUniform(const AbstractUniformStateItem& item, GLint location,
+                    size_t programUniformIndex);
+
   /// Get unsatisfied uniforms.
   std::vector<Interface::UnsatisfiedUniform> getUnsatisfiedUniforms();
 
@@ -93,16 +209,18 @@ protected:
   {
     UniformItem(const std::string& name,
                 std::shared_ptr<AbstractUniformStateItem> uniformItem,
-                GLint location, bool passSpecificIn) :
+                GLint location, size_t programIndex, bool passSpecificIn) :
         uniformName(name),
         item(uniformItem),
         shaderLocation(location),
+        programUniformIndex(programIndex),
         passSpecific(passSpecificIn)
     {}
 
     std::string                               uniformName;
     std::shared_ptr<AbstractUniformStateItem> item;
     GLint                                     shaderLocation;
+    size_t                                    programUniformIndex; ///< Index into mShader's uniforms.
     bool                                      passSpecific;   ///< If true, global uniforms do not overwrite.
   };
 
@@ -118,10 +236,51 @@ protected:
   std::vector<Interface::UnsatisfiedUniform>  mUnsatisfiedUniforms;
   std::vector<UniformItem>              mUniforms;  ///< Local uniforms
 
+  /// Pre-resolved lookup data for mUnsatisfiedUniforms (same order). Pass and
+  /// global uniform state is looked up by uniform index when rendering.
+  struct UniformSlot
+  {
+    UniformSlot(GLint location, size_t programIndex, size_t index) :
+        shaderLocation(location),
+        programUniformIndex(programIndex),
+        uniformIndex(index)
+    {}
+
+    GLint   shaderLocation;       ///< Uniform location in mShader.
+    size_t  programUniformIndex;  ///< Index into mShader's uniforms.
+    size_t  uniformIndex;         ///< See UniformState::index.
+  };
+  std::vector<UniformSlot>              mUnsatisfiedUniformSlots;
+  size_t                                mPassIndex; ///< Index into PassUniformStateMan.
+
   std::shared_ptr<VBOObject>            mVBO;     ///< ID of VBO to use during pass.
   std::shared_ptr<IBOObject>            mIBO;     ///< ID of IBO to use during pass.
 
   std::shared_ptr<ShaderProgramAsset>   mShader;  ///< Shader to be used when rendering this pass.
+  std::shared_ptr<const AttribBindingPlan> mAttribBinding; ///< VBO -> mShader attribute bindings.
+
+  std::shared_ptr<VBOObject>            mInstanceVBO;     ///< Optional per-instance attributes.
+  std::shared_ptr<const AttribBindingPlan> mInstanceBinding; ///< mInstanceVBO -> mShader bindings.
+  size_t                                mNumInstances;    ///< Number of instances in mInstanceVBO.
+
+  OcclusionQuery                        mOcclusionQuery;
+  size_t                                mLOD;
+
+#ifdef SPIRE_USE_VAO
+  /// (Re)builds mVAO from the current program, VBO, and IBO.
+  void buildVertexArray();
+
+  GLuint                                mVAO;         ///< Captures attribute and IBO bindings.
+  GLuint                                mVAOProgram;  ///< Program mVAO was built against.
+  GLuint                                mVAOVBO;      ///< VBO mVAO was built against.
+  GLuint                                mVAOIBO;      ///< IBO mVAO was built against.
+  size_t                                mVAOVBOOffset;///< Vertex offset of the attribute pointers in mVAO.
+#endif
+
+#ifdef SPIRE_USE_BATCHING
+  DrawBatch*                            mBatch;       ///< Batch containing the pass, if any.
+  size_t                                mBatchSlot;   ///< Slot within mBatch.
+#endif
 
   Hub&                                  mHub;     ///< Hub.
 
@@ -153,6 +312,19 @@ public:
   /// Removes a geometry pass from the object.
   void removePass(const std::string& pass);
 
+  /// The following functions are equivalent to their string counterparts,
+  /// but address passes by index (see PassUniformStateMan::addPass)
+  /// without hashing the pass name.
+  /// @{
+  void removePass(size_t passIndex);
+  void addPassUniform(size_t passIndex, const std::string& uniformName,
+                      std::shared_ptr<AbstractUniformStateItem> item);
+  void renderPass(size_t passIndex);
+  void gatherPasses(size_t passIndex, std::vector<ObjectPass*>& out) const;
+  void setPassInstanceVBO(size_t passIndex, std::shared_ptr<VBOObject> vbo);
+  std::vector<Interface::UnsatisfiedUniform> getUnsatisfiedUniforms(size_t passIndex);
+  /// @}
+
   // The precedence for uniforms goes: pass -> uniform -> global.
   // So pass is checked first, then the uniform level of uniforms, then the
   // global level of uniforms.
@@ -176,8 +348,16 @@ public:
   bool hasPassRenderingOrder(const std::vector<std::string>& passes) const;
 
   /// \todo Ability to render a single named pass. See github issue #15.
+  /// Nothing is rendered if the object does not have the pass.
   void renderPass(const std::string& pass);
 
+  /// Appends the pass named 'pass', followed by its subpasses, to 'out'.
+  /// Nothing is appended if the object does not have the pass.
+  void gatherPasses(const std::string& pass, std::vector<ObjectPass*>& out) const;
+
+  /// Attaches an instance VBO to 'pass'. See ObjectPass::setInstanceVBO.
+  void setPassInstanceVBO(const std::string& pass, std::shared_ptr<VBOObject> vbo);
+
   /// Returns the associated pass. Otherwise an empty shared_ptr is returned.
   std::shared_ptr<const ObjectPass> getObjectPassParams(const std::string& passName) const;
 
@@ -225,8 +405,24 @@ protected:
   /// Retrieves the pass by name.
   std::shared_ptr<ObjectPass> getPassByName(const std::string& name) const;
 
+  /// Retrieves the pass by index. Throws NotFound if the object does not
+  /// have the pass.
+  std::shared_ptr<ObjectPass> getPassByIndex(size_t passIndex) const;
+
+  /// Returns nullptr if the object does not have an entry for the pass.
+  const ObjectPassInternal* findPassInternal(size_t passIndex) const;
+
+  /// Inserts 'internalPass' into mPasses and mPassesByIndex.
+  ObjectPassInternal& insertPass(const std::string& passName,
+                                 const ObjectPassInternal& internalPass);
+
   /// All registered passes.
   std::unordered_map<std::string, ObjectPassInternal>   mPasses;
+
+  /// Entries of mPasses indexed by pass index. Elements of an unordered_map
+  /// are never relocated, so the pointers remain valid until the entry is
+  /// erased. Unused indices hold nullptr.
+  std::vector<ObjectPassInternal*>                      mPassesByIndex;
   std::vector<ObjectGlobalUniformItem>                  mObjectGlobalUniforms;
 
   // These maps may actually be more efficient implemented as an array. The map 
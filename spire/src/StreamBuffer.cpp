@@ -0,0 +1,283 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2013 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+/// \author agent
+/// \date   October 2026
+
+#include <stdexcept>
+
+#include "StreamBuffer.h"
+#include "Hub.h"
+#include "GLStateMan.h"
+#include "GLCaps.h"
+#include "Exceptions.h"
+
+namespace CPM_SPIRE_NS {
+
+//------------------------------------------------------------------------------
+StreamBuffer::StreamBuffer(Hub& hub) :
+    mHub(hub),
+    mGLIndex(0),
+    mCapacity(0),
+    mHead(0),
+    mUsed(0),
+    mFrameSize(0),
+    mFrame(0),
+    mNumStalls(0),
+#if defined(SPIRE_USE_SYNC_OBJECTS)
+    mPersistent(nullptr),
+    mMapped(false)
+#else
+    mFlushed(0)
+#endif
+{
+}
+
+//------------------------------------------------------------------------------
+StreamBuffer::~StreamBuffer()
+{
+  release();
+}
+
+//------------------------------------------------------------------------------
+void StreamBuffer::release()
+{
+#ifdef SPIRE_USE_SYNC_OBJECTS
+  for (auto it = mFrames.begin(); it != mFrames.end(); ++it)
+    GL(glDeleteSync(it->fence));
+#endif
+  mFrames.clear();
+
+  if (mGLIndex != 0)
+  {
+    GLStateMan& state = mHub.getGLStateManager();
+#if defined(SPIRE_USE_SYNC_OBJECTS)
+    if (mPersistent != nullptr || mMapped)
+    {
+      state.bindArrayBuffer(mGLIndex);
+      GL(glUnmapBuffer(GL_ARRAY_BUFFER));
+    }
+#endif
+    state.onBufferDeleted(mGLIndex);
+    GL(glDeleteBuffers(1, &mGLIndex));
+  }
+
+  mGLIndex    = 0;
+  mCapacity   = 0;
+  mHead       = 0;
+  mUsed       = 0;
+  mFrameSize  = 0;
+#if defined(SPIRE_USE_SYNC_OBJECTS)
+  mPersistent = nullptr;
+  mMapped     = false;
+#else
+  mStaging.clear();
+  mFlushed    = 0;
+#endif
+}
+
+//------------------------------------------------------------------------------
+void StreamBuffer::setCapacity(size_t bytes)
+{
+  // Streamed buffers written so far refer to the old buffer.
+  ++mFrame;
+  release();
+  if (bytes == 0)
+    return;
+
+  mCapacity = bytes;
+  GL(glGenBuffers(1, &mGLIndex));
+  mHub.getGLStateManager().bindArrayBuffer(mGLIndex);
+
+#if defined(SPIRE_USE_PERSISTENT_MAPPING)
+  // 4.1 - 4.3 contexts (OS X) lack glBufferStorage and map each allocation
+  // instead.
+  if (mHub.getGLCaps().hasBufferStorage())
+  {
+    const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    GL(glBufferStorage(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(bytes), NULL, flags));
+    mPersistent = static_cast<uint8_t*>(glMapBufferRange(GL_ARRAY_BUFFER, 0,
+                                                         static_cast<GLsizeiptr>(bytes), flags));
+    if (mPersistent == nullptr)
+    {
+      release();
+      throw GLError("Failed to map stream buffer.");
+    }
+    return;
+  }
+#endif
+
+  GL(glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(bytes), NULL, GL_STREAM_DRAW));
+#if !defined(SPIRE_USE_SYNC_OBJECTS)
+  mStaging.resize(bytes);
+#endif
+}
+
+//------------------------------------------------------------------------------
+bool StreamBuffer::isPersistentlyMapped() const
+{
+#if defined(SPIRE_USE_SYNC_OBJECTS)
+  return (mPersistent != nullptr);
+#else
+  return false;
+#endif
+}
+
+//------------------------------------------------------------------------------
+uint8_t* StreamBuffer::allocate(size_t size, size_t& offsetOut)
+{
+  if (size > mCapacity)
+    throw std::out_of_range("Stream buffer allocation exceeds its capacity.");
+
+  size_t start;
+  size_t padding;
+  for (;;)
+  {
+    start = (mHead + Alignment - 1) / Alignment * Alignment;
+    if (start + size > mCapacity)
+      start = 0;  // Wrap around, skipping the end of the buffer.
+    padding = (start >= mHead) ? start - mHead : mCapacity - mHead;
+
+    if (mUsed + padding + size <= mCapacity)
+      break;
+
+    // Only the current frame is left, it does not fit.
+    if (mFrames.empty())
+      throw std::out_of_range("Stream buffer allocations of one frame exceed its capacity.");
+    retireOldestFrame();
+    ++mNumStalls;
+  }
+
+  mHead       = start + size;
+  mUsed      += padding + size;
+  mFrameSize += padding + size;
+  offsetOut   = start;
+
+#if defined(SPIRE_USE_SYNC_OBJECTS)
+  if (mPersistent != nullptr)
+    return mPersistent + start;
+
+  // GL has not finished with regions in flight, but this one is not among
+  // them. Skip synchronization.
+  flush();
+  if (size == 0)
+    return nullptr;
+  mHub.getGLStateManager().bindArrayBuffer(mGLIndex);
+  void* mapped = glMapBufferRange(GL_ARRAY_BUFFER, static_cast<GLintptr>(start),
+                                  static_cast<GLsizeiptr>(size),
+                                  GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT
+                                  | GL_MAP_INVALIDATE_RANGE_BIT);
+  if (mapped == nullptr)
+    throw GLError("Failed to map stream buffer region.");
+  mMapped = true;
+  return static_cast<uint8_t*>(mapped);
+#else
+  return mStaging.data() + start;
+#endif
+}
+
+//------------------------------------------------------------------------------
+void StreamBuffer::flush()
+{
+#if defined(SPIRE_USE_SYNC_OBJECTS)
+  // The persistent mapping is coherent, only regions mapped by allocate need
+  // to be unmapped.
+  if (mMapped)
+  {
+    mHub.getGLStateManager().bindArrayBuffer(mGLIndex);
+    GL(glUnmapBuffer(GL_ARRAY_BUFFER));
+    mMapped = false;
+  }
+#else
+  if (mHead > mFlushed)
+  {
+    mHub.getGLStateManager().bindArrayBuffer(mGLIndex);
+    GL(glBufferSubData(GL_ARRAY_BUFFER, static_cast<GLintptr>(mFlushed),
+                       static_cast<GLsizeiptr>(mHead - mFlushed), mStaging.data() + mFlushed));
+    mFlushed = mHead;
+  }
+#endif
+}
+
+//------------------------------------------------------------------------------
+void StreamBuffer::endFrame()
+{
+  ++mFrame;
+  if (mGLIndex == 0)
+    return;
+
+  flush();
+
+#ifdef SPIRE_USE_SYNC_OBJECTS
+  Frame frame;
+  frame.size  = mFrameSize;
+  frame.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+  mFrames.push_back(frame);
+  mFrameSize = 0;
+
+  // Reclaim frames GL has already finished with, and bound the number of
+  // frames in flight.
+  while (mFrames.empty() == false)
+  {
+    GLenum status = glClientWaitSync(mFrames.front().fence, 0, 0);
+    if (   mFrames.size() <= MaxFramesInFlight
+        && status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED)
+      break;
+    retireOldestFrame();
+  }
+#else
+  // Orphan the buffer. GL keeps the old storage around for draws still
+  // reading from it.
+  mHub.getGLStateManager().bindArrayBuffer(mGLIndex);
+  GL(glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(mCapacity), NULL, GL_STREAM_DRAW));
+  mHead       = 0;
+  mUsed       = 0;
+  mFrameSize  = 0;
+  mFlushed    = 0;
+#endif
+}
+
+//------------------------------------------------------------------------------
+void StreamBuffer::retireOldestFrame()
+{
+#ifdef SPIRE_USE_SYNC_OBJECTS
+  Frame& frame = mFrames.front();
+  const GLuint64 timeout = 1000000000;  // 1 second, in nanoseconds.
+  GLenum status;
+  do
+  {
+    status = glClientWaitSync(frame.fence, GL_SYNC_FLUSH_COMMANDS_BIT, timeout);
+  } while (status == GL_TIMEOUT_EXPIRED);
+  GL(glDeleteSync(frame.fence));
+
+  mUsed -= frame.size;
+  mFrames.pop_front();
+#endif
+}
+
+} // namespace CPM_SPIRE_NS
@@ -0,0 +1,140 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2013 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+/// \author agent
+/// \date   October 2026
+
+#ifndef SPIRE_HIGH_STREAMBUFFER_H
+#define SPIRE_HIGH_STREAMBUFFER_H
+
+#include <deque>
+#include <vector>
+#include <cstdint>
+
+#include "Common.h"
+
+namespace CPM_SPIRE_NS {
+
+class Hub;
+
+/// Ring buffer holding geometry that only lives for one frame (widgets,
+/// selection boxes, ...), see Interface::writeStreamVBO. Vertices and indices
+/// share the buffer; each allocation is a region that is drawn from by
+/// offset.
+///
+/// With SPIRE_USE_PERSISTENT_MAPPING, and a context supporting
+/// glBufferStorage, the buffer is mapped once and written directly. Otherwise,
+/// with SPIRE_USE_SYNC_OBJECTS, each allocation is mapped with
+/// GL_MAP_UNSYNCHRONIZED_BIT. In both cases endFrame fences the regions of
+/// the frame and regions are only reused once their fence has signaled, at
+/// most MaxFramesInFlight frames later. Otherwise allocations are staged on
+/// the CPU, uploaded by flush, and the buffer is orphaned by endFrame.
+class StreamBuffer
+{
+public:
+  StreamBuffer(Hub& hub);
+  virtual ~StreamBuffer();
+
+  /// (Re)creates the buffer with room for 'bytes' bytes. 0 releases the
+  /// buffer (the default). Regions allocated so far are lost.
+  void setCapacity(size_t bytes);
+  size_t getCapacity() const      {return mCapacity;}
+
+  /// Allocates 'size' bytes for the current frame and returns a pointer to
+  /// write them to. The region's byte offset within the buffer is written to
+  /// 'offsetOut', it is a multiple of Alignment. Without persistent mapping
+  /// the pointer is only valid until the next call to allocate or flush.
+  /// Throws std::out_of_range if the allocations of a single frame exceed
+  /// the capacity.
+  uint8_t* allocate(size_t size, size_t& offsetOut);
+
+  /// Makes everything written since the last call visible to GL. Must be
+  /// called before drawing from the buffer.
+  void flush();
+
+  /// Ends the current frame. Regions allocated during the frame are
+  /// reclaimed once GL has finished drawing from them.
+  void endFrame();
+
+  /// Number of calls to endFrame so far. Streamed VBOs / IBOs are only drawn
+  /// in the frame they were written in.
+  uint64_t getFrame() const       {return mFrame;}
+
+  GLuint getGLIndex() const       {return mGLIndex;}
+
+  /// Number of times allocate had to wait for GL to release a region.
+  size_t getNumStalls() const     {return mNumStalls;}
+
+  /// Returns true if the buffer is persistently mapped (see setCapacity).
+  bool isPersistentlyMapped() const;
+
+  /// Alignment of all regions, suitable for any vertex attribute or index.
+  static const size_t Alignment = 16;
+
+  /// Frames whose regions may be in use by GL at any time.
+  static const size_t MaxFramesInFlight = 3;
+
+private:
+
+  /// Region allocated during one frame.
+  struct Frame
+  {
+    size_t  size;     ///< Bytes allocated, including padding.
+#ifdef SPIRE_USE_SYNC_OBJECTS
+    GLsync  fence;    ///< Signaled once GL is done with the frame.
+#endif
+  };
+
+  /// Waits until GL is done with the oldest frame and reclaims its region.
+  void retireOldestFrame();
+
+  /// Deletes the buffer and any fences.
+  void release();
+
+  Hub&                mHub;
+  GLuint              mGLIndex;
+  size_t              mCapacity;
+  size_t              mHead;        ///< Next byte to allocate.
+  size_t              mUsed;        ///< Bytes in use, including the current frame.
+  size_t              mFrameSize;   ///< Bytes allocated in the current frame.
+  uint64_t            mFrame;
+  size_t              mNumStalls;
+  std::deque<Frame>   mFrames;      ///< Frames in flight, oldest first.
+
+#if defined(SPIRE_USE_SYNC_OBJECTS)
+  uint8_t*            mPersistent;  ///< Persistent mapping of the whole buffer, if any.
+  bool                mMapped;      ///< True while a region is mapped.
+#else
+  std::vector<uint8_t> mStaging;    ///< CPU copy of the buffer.
+  size_t              mFlushed;     ///< Bytes uploaded so far this frame.
+#endif
+};
+
+} // namespace CPM_SPIRE_NS
+
+#endif
@@ -0,0 +1,120 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2013 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+/// \author agent
+/// \date   October 2026
+
+#include <algorithm>
+#include <chrono>
+
+#include "UploadQueue.h"
+#include "Hub.h"
+#include "GLStateMan.h"
+
+namespace CPM_SPIRE_NS {
+
+const size_t UploadQueue::ChunkSize;
+
+//------------------------------------------------------------------------------
+UploadQueue::UploadQueue(Hub& hub) :
+    mHub(hub),
+    mBudgetMs(0.0),
+    mPendingBytes(0),
+    mBytesUploaded(0)
+{
+}
+
+//------------------------------------------------------------------------------
+void UploadQueue::enqueue(GLuint buffer, GLenum target, size_t offset,
+                          std::shared_ptr<const std::vector<uint8_t>> data,
+                          bool* resident)
+{
+  Upload upload;
+  upload.buffer       = buffer;
+  upload.target       = target;
+  upload.bufferOffset = offset;
+  upload.data         = data;
+  upload.offset       = 0;
+  upload.resident     = resident;
+  mUploads.push_back(upload);
+  mPendingBytes += data->size();
+}
+
+//------------------------------------------------------------------------------
+void UploadQueue::cancel(const bool* resident)
+{
+  for (auto it = mUploads.begin(); it != mUploads.end(); ++it)
+  {
+    if (it->resident == resident)
+    {
+      mPendingBytes -= it->data->size() - it->offset;
+      mUploads.erase(it);
+      return;
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+size_t UploadQueue::process()
+{
+  typedef std::chrono::steady_clock Clock;
+  Clock::time_point start = Clock::now();
+
+  GLStateMan& state = mHub.getGLStateManager();
+  mBytesUploaded = 0;
+  while (mUploads.empty() == false)
+  {
+    if (   mBytesUploaded > 0
+        && std::chrono::duration<double, std::milli>(Clock::now() - start).count() >= mBudgetMs)
+      break;
+
+    Upload& upload = mUploads.front();
+    size_t size = std::min(ChunkSize, upload.data->size() - upload.offset);
+
+    if (upload.target == GL_ARRAY_BUFFER)
+      state.bindArrayBuffer(upload.buffer);
+    else
+      state.bindElementArrayBuffer(upload.buffer);
+    GL(glBufferSubData(upload.target, static_cast<GLintptr>(upload.bufferOffset + upload.offset),
+                       static_cast<GLsizeiptr>(size), upload.data->data() + upload.offset));
+
+    upload.offset  += size;
+    mBytesUploaded += size;
+    mPendingBytes  -= size;
+
+    if (upload.offset == upload.data->size())
+    {
+      *upload.resident = true;
+      mUploads.pop_front();
+    }
+  }
+
+  return mBytesUploaded;
+}
+
+} // namespace CPM_SPIRE_NS
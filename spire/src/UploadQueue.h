@@ -0,0 +1,113 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2013 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+/// \author agent
+/// \date   October 2026
+
+#ifndef SPIRE_HIGH_UPLOADQUEUE_H
+#define SPIRE_HIGH_UPLOADQUEUE_H
+
+#include <deque>
+#include <memory>
+#include <vector>
+#include <cstdint>
+
+#include "Common.h"
+
+namespace CPM_SPIRE_NS {
+
+class Hub;
+
+/// Streams VBO and IBO contents to GL over several frames. Buffers are
+/// allocated (orphaned) with glBufferData when they are added, and their
+/// contents are uploaded in chunks with glBufferSubData by process, which
+/// stops once the per frame time budget is exhausted. Passes referencing
+/// buffers that are not resident yet are skipped.
+///
+/// The queue is disabled (buffers are uploaded synchronously) until a budget
+/// is set.
+class UploadQueue
+{
+public:
+  UploadQueue(Hub& hub);
+  virtual ~UploadQueue()  {}
+
+  /// Time spent uploading per call to process. 0 disables the queue.
+  void setBudget(double milliseconds)   {mBudgetMs = milliseconds;}
+  bool isEnabled() const                {return mBudgetMs > 0.0;}
+
+  /// Queues 'data' for upload to 'buffer', starting 'offset' bytes into it.
+  /// The buffer must already be allocated. '*resident' is set to true once
+  /// the upload completes. 'target' is the binding point used to upload.
+  void enqueue(GLuint buffer, GLenum target, size_t offset,
+               std::shared_ptr<const std::vector<uint8_t>> data, bool* resident);
+
+  /// Drops the pending upload that sets '*resident', if any. Called when a
+  /// buffer is deleted before its upload completed.
+  void cancel(const bool* resident);
+
+  /// Uploads queued data until the budget is exhausted. At least one chunk is
+  /// uploaded per call, so uploads always progress. Returns the number of
+  /// bytes uploaded.
+  size_t process();
+
+  /// Number of buffers waiting for (part of) their data.
+  size_t getNumPendingBuffers() const   {return mUploads.size();}
+
+  /// Bytes waiting to be uploaded.
+  size_t getNumPendingBytes() const     {return mPendingBytes;}
+
+  /// Bytes uploaded by the last call to process.
+  size_t getNumBytesUploaded() const    {return mBytesUploaded;}
+
+  /// Uploads are split into chunks of this size so the budget can be checked
+  /// in between.
+  static const size_t ChunkSize = 1024 * 1024;
+
+private:
+
+  struct Upload
+  {
+    GLuint                                      buffer;
+    GLenum                                      target;
+    size_t                                      bufferOffset; ///< Where data starts in buffer.
+    std::shared_ptr<const std::vector<uint8_t>> data;
+    size_t                                      offset;   ///< Bytes uploaded so far.
+    bool*                                       resident;
+  };
+
+  Hub&                mHub;
+  double              mBudgetMs;
+  std::deque<Upload>  mUploads;         ///< Uploaded front to back.
+  size_t              mPendingBytes;
+  size_t              mBytesUploaded;
+};
+
+} // namespace CPM_SPIRE_NS
+
+#endif
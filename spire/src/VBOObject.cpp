@@ -29,48 +29,233 @@
 /// \author James Hughes
 /// \date   February 2013
 
+#include <algorithm>
+#include <stdexcept>
+
 #include "VBOObject.h"
+#include "Hub.h"
+#include "GLStateMan.h"
+#include "GLCaps.h"
+#include "UploadQueue.h"
 
 namespace CPM_SPIRE_NS {
 
 //------------------------------------------------------------------------------
 VBOObject::VBOObject(std::shared_ptr<std::vector<uint8_t>> vboData,
                      const std::vector<std::string>& attributes,
-                     const ShaderAttributeMan& man)
-    : mAttributeCollection(man)
+                     Hub& hub, GLenum usage)
+    : mHub(hub),
+      mOffset(0),
+      mStream(nullptr),
+      mStreamFrame(0),
+      mArenaAllocation(nullptr),
+      mUsage(usage),
+      mUpdated(false),
+      mAttributeCollection(hub.getShaderAttributeManager())
 {
-  buildVBO(&(*vboData)[0], vboData->size(), attributes);
+  buildVBO(&(*vboData)[0], vboData->size(), attributes, vboData);
 }
 
 //------------------------------------------------------------------------------
 VBOObject::VBOObject(
     const uint8_t* vboData, const size_t vboLength,
     const std::vector<std::string>& attributes,
-    const ShaderAttributeMan& man)
-    : mAttributeCollection(man)
+    Hub& hub, GLenum usage)
+    : mHub(hub),
+      mOffset(0),
+      mStream(nullptr),
+      mStreamFrame(0),
+      mArenaAllocation(nullptr),
+      mUsage(usage),
+      mUpdated(false),
+      mAttributeCollection(hub.getShaderAttributeManager())
+{
+  std::shared_ptr<const std::vector<uint8_t>> queuedData;
+  if (hub.getUploadQueue().isEnabled())
+    queuedData = std::make_shared<std::vector<uint8_t>>(vboData, vboData + vboLength);
+  buildVBO(vboData, vboLength, attributes, queuedData);
+}
+
+//------------------------------------------------------------------------------
+VBOObject::VBOObject(const std::vector<std::string>& attributes, Hub& hub)
+    : mHub(hub),
+      mGLIndex(0),
+      mSize(0),
+      mResident(true),
+      mOffset(0),
+      mStream(&hub.getStreamBuffer()),
+      mStreamFrame(0),
+      mArenaAllocation(nullptr),
+      mUsage(GL_STREAM_DRAW),
+      mUpdated(false),
+      mAttributes(attributes),
+      mAttributeCollection(hub.getShaderAttributeManager()),
+      mHasBounds(false),
+      mStride(0),
+      mPositionOffset(0)
 {
-  buildVBO(vboData, vboLength, attributes);
+  for (auto it = attributes.begin(); it != attributes.end(); ++it)
+    mAttributeCollection.addAttribute(*it);
+
+  if (mAttributeCollection.hasInstancedAttributes())
+    throw std::invalid_argument("Streamed VBOs may not contain instanced attributes.");
 }
 
 //------------------------------------------------------------------------------
 VBOObject::~VBOObject()
 {
+  // Streamed VBOs do not own their buffer.
+  if (mStream != nullptr)
+    return;
+
+  if (mResident == false)
+    mHub.getUploadQueue().cancel(&mResident);
+
+  if (mArenaAllocation != nullptr)
+  {
+    mHub.getVertexArena().deallocate(mArenaAllocation);
+    return;
+  }
+
+  mHub.getGLStateManager().onBufferDeleted(mGLIndex);
   GL(glDeleteBuffers(1, &mGLIndex));
 }
 
 //------------------------------------------------------------------------------
 void VBOObject::buildVBO(const uint8_t* vboData, const size_t vboLength,
-                         const std::vector<std::string>& attributes)
+                         const std::vector<std::string>& attributes,
+                         std::shared_ptr<const std::vector<uint8_t>> queuedData)
 {
-  GL(glGenBuffers(1, &mGLIndex));
-  GL(glBindBuffer(GL_ARRAY_BUFFER, mGLIndex));
-  GL(glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(vboLength), 
-                  vboData, GL_STATIC_DRAW));
+  UploadQueue& uploads = mHub.getUploadQueue();
+  mResident = (queuedData == nullptr || uploads.isEnabled() == false);
+
+  // Dynamic VBOs keep their own buffer so that updates may orphan it.
+  if (mUsage == GL_STATIC_DRAW)
+    mArenaAllocation = mHub.getVertexArena().allocate(vboLength, &mGLIndex, &mOffset);
+
+  if (mArenaAllocation != nullptr)
+  {
+    mHub.getGLStateManager().bindArrayBuffer(mGLIndex);
+    if (mResident)
+    {
+      GL(glBufferSubData(GL_ARRAY_BUFFER, static_cast<GLintptr>(mOffset),
+                         static_cast<GLsizeiptr>(vboLength), vboData));
+    }
+  }
+  else
+  {
+    GL(glGenBuffers(1, &mGLIndex));
+    mHub.getGLStateManager().bindArrayBuffer(mGLIndex);
+    GL(glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(vboLength), 
+                    mResident ? vboData : NULL, mUsage));
+  }
+  if (mResident == false)
+    uploads.enqueue(mGLIndex, GL_ARRAY_BUFFER, mOffset, queuedData, &mResident);
+  mSize = vboLength;
 
   for (auto it = attributes.begin(); it != attributes.end(); ++it)
   {
     mAttributeCollection.addAttribute(*it);
   }
+
+  // Bounds are used for culling (see InterfaceImplementation::recordCommands).
+  mHasBounds = false;
+  mStride = 0;
+  mPositionOffset = 0;
+  AttribState position;
+  size_t positionOffset;
+  if (   mAttributeCollection.findAttribute(getPositionAttributeName(), position, positionOffset)
+      && position.type == Interface::TYPE_FLOAT
+      && position.numComponents >= 3
+      && position.divisor == 0)
+  {
+    size_t stride = mAttributeCollection.calculateStride();
+    if (stride > 0)
+    {
+      mHasBounds = computeBounds(vboData, vboLength / stride, stride,
+                                 positionOffset, mAABB, mSphere);
+      mStride = stride;
+      mPositionOffset = positionOffset;
+    }
+  }
+
+  // Without hardware instancing, instanced attributes are applied one
+  // instance at a time from the CPU.
+  if (   mAttributeCollection.hasInstancedAttributes()
+      && mHub.getGLCaps().hasInstancedArrays() == false)
+    mInstanceData.assign(vboData, vboData + vboLength);
+}
+
+//------------------------------------------------------------------------------
+void VBOObject::update(size_t offset, const uint8_t* data, size_t size)
+{
+  if (mStream != nullptr)
+    throw std::invalid_argument("Streamed VBOs are written with writeStream.");
+  if (offset > mSize || size > mSize - offset)
+    throw std::out_of_range("VBO update exceeds the size of the VBO.");
+
+  mUpdates.add(offset, data, size);
+  mUpdated = true;
+
+  if (mInstanceData.empty() == false)
+    std::copy(data, data + size, mInstanceData.begin() + static_cast<std::ptrdiff_t>(offset));
+
+  if (mHasBounds == false || size == 0)
+    return;
+
+  // Vertices whose position lies entirely inside of the update.
+  const size_t positionSize = 3 * sizeof(float);
+  const size_t numVertices  = mSize / mStride;
+  const size_t end          = offset + size;
+  size_t first = 0;
+  if (offset > mPositionOffset)
+    first = (offset - mPositionOffset + mStride - 1) / mStride;
+  size_t last = 0;
+  if (end >= mPositionOffset + positionSize)
+    last = std::min((end - mPositionOffset - positionSize) / mStride + 1, numVertices);
+
+  // The positions of the vertices around that span may be partially updated,
+  // in which case the new positions are unknown.
+  if (   (first > 0 && first <= numVertices
+          && (first - 1) * mStride + mPositionOffset + positionSize > offset)
+      || (   last < numVertices && last * mStride + mPositionOffset < end
+          && last * mStride + mPositionOffset + positionSize > offset))
+  {
+    mHasBounds = false;
+    return;
+  }
+
+  if (last <= first)
+    return;
+
+  AABB aabb;
+  BoundingSphere sphere;
+  computeBounds(data + (first * mStride + mPositionOffset - offset), last - first,
+                mStride, 0, aabb, sphere);
+  mergeBounds(aabb, sphere, mAABB, mSphere);
+}
+
+//------------------------------------------------------------------------------
+void VBOObject::uploadUpdates()
+{
+  if (mResident == false)
+    return;
+
+  mHub.getGLStateManager().bindArrayBuffer(mGLIndex);
+  mUpdates.upload(GL_ARRAY_BUFFER, mOffset, mSize, mUsage, mArenaAllocation == nullptr);
+}
+
+//------------------------------------------------------------------------------
+uint8_t* VBOObject::writeStream(size_t size)
+{
+  if (mStream == nullptr)
+    throw std::invalid_argument("Only streamed VBOs can be written with writeStream.");
+
+  uint8_t* data = mStream->allocate(size, mOffset);
+  mGLIndex      = mStream->getGLIndex();
+  mSize         = size;
+  mStreamFrame  = mStream->getFrame();
+  return data;
 }
 
 } // namespace CPM_SPIRE_NS
@@ -37,9 +37,15 @@
 
 #include "Common.h"
 #include "ShaderAttributeMan.h"
+#include "Bounds.h"
+#include "BufferUpdates.h"
+#include "StreamBuffer.h"
+#include "BufferArena.h"
 
 namespace CPM_SPIRE_NS {
 
+class Hub;
+
 //------------------------------------------------------------------------------
 // VBO object
 //------------------------------------------------------------------------------
@@ -51,27 +57,107 @@ public:
   // This constructor delegates to the raw version below.
   VBOObject(std::shared_ptr<std::vector<uint8_t>> vboData,
             const std::vector<std::string>& attributes,
-            const ShaderAttributeMan& man);
+            Hub& hub, GLenum usage = GL_STATIC_DRAW);
 
+  /// If the upload queue is enabled (see UploadQueue), the data is copied and
+  /// uploaded over the following frames. 'usage' is the GL usage hint. Small
+  /// static VBOs are sub-allocated from the vertex arena if it is enabled
+  /// (see BufferArena).
   VBOObject(const uint8_t* vboData, const size_t vboLength,
             const std::vector<std::string>& attributes,
-            const ShaderAttributeMan& man);
+            Hub& hub, GLenum usage = GL_STATIC_DRAW);
+
+  /// Creates a streamed VBO, whose contents are written to the stream buffer
+  /// (see StreamBuffer) every frame with writeStream.
+  VBOObject(const std::vector<std::string>& attributes, Hub& hub);
 
   ~VBOObject();
 
   GLuint getGLIndex() const                             {return mGLIndex;}
+  size_t getSize() const                                {return mSize;}
+
+  /// False while the VBO's contents are waiting in the upload queue, or if
+  /// the VBO is streamed and was not written during the current frame.
+  bool isResident() const
+  {
+    return mResident && (mStream == nullptr || mStreamFrame == mStream->getFrame());
+  }
+
+  /// Byte offset of the vertices within the GL buffer. Only streamed and
+  /// sub-allocated VBOs have a non-zero offset.
+  size_t getOffset() const                              {return mOffset;}
+
+  /// Allocates 'size' bytes in the stream buffer for the current frame and
+  /// returns a pointer to write the vertices to (see StreamBuffer::allocate).
+  /// Throws std::invalid_argument if the VBO is not streamed.
+  uint8_t* writeStream(size_t size);
+  bool isStreamed() const                               {return mStream != nullptr;}
+
+  /// Replaces 'size' bytes starting at byte 'offset' with 'data'. The change
+  /// is uploaded by the next call to flushUpdates. Bounds grow to include
+  /// updated positions; they are dropped if an update covers only part of a
+  /// position. Passes read the bounds from the VBO, so they see the change
+  /// right away. Throws std::out_of_range if the range exceeds the VBO.
+  void update(size_t offset, const uint8_t* data, size_t size);
+
+  /// Uploads the changes made by update. Must be called on the GL thread.
+  void flushUpdates()                                   {if (mUpdates.empty() == false) uploadUpdates();}
+
+  /// True if the VBO was created with GL_STATIC_DRAW and never updated.
+  bool isStatic() const                                 {return mUsage == GL_STATIC_DRAW && mUpdated == false;}
   const std::vector<std::string>& getAttributes() const {return mAttributes;}
   const ShaderAttributeCollection& getAttributeCollection() const {return mAttributeCollection;}
 
+  /// Bounds of the VBO's positions. Only available if the VBO contains the
+  /// position attribute (see getPositionAttributeName) with at least 3 float
+  /// components.
+  /// @{
+  bool hasBounds() const                                {return mHasBounds;}
+  const AABB& getAABB() const                           {return mAABB;}
+  const BoundingSphere& getBoundingSphere() const       {return mSphere;}
+  /// @}
+
+  /// Name of the attribute from which bounds are computed.
+  static const char* getPositionAttributeName()         {return "aPos";}
+
+  /// CPU copy of the VBO contents. Only populated for VBOs containing
+  /// instanced attributes when the context lacks hardware instancing, see
+  /// AttribBindingPlan::applyInstance.
+  const std::vector<uint8_t>& getInstanceData() const   {return mInstanceData;}
+
 private:
 
+  /// Uploads 'vboData', or queues 'queuedData' (which holds the same
+  /// contents) for upload if it is given and the upload queue is enabled.
   void buildVBO(const uint8_t* vboData, const size_t vboLength,
-                const std::vector<std::string>& attributes);
-                
+                const std::vector<std::string>& attributes,
+                std::shared_ptr<const std::vector<uint8_t>> queuedData);
+
+  /// Uploads mUpdates. Updates wait until the VBO is resident, since the
+  /// upload queue would overwrite them.
+  void uploadUpdates();
 
+  Hub&                      mHub;        ///< Hub, used for binding the buffer.
   GLuint                    mGLIndex;    ///< Corresponds to the map index but obtained from OpenGL.
+  size_t                    mSize;       ///< Size of the VBO in bytes.
+  bool                      mResident;   ///< See isResident.
+  size_t                    mOffset;     ///< See getOffset.
+  StreamBuffer*             mStream;     ///< Non-null for streamed VBOs.
+  uint64_t                  mStreamFrame;///< Frame in which the VBO was last written.
+  BufferArena::Allocation*  mArenaAllocation; ///< Non-null if sub-allocated.
+  GLenum                    mUsage;      ///< GL usage hint.
+  bool                      mUpdated;    ///< True once update has been called.
+  BufferUpdates             mUpdates;    ///< Changes not uploaded yet.
   std::vector<std::string>  mAttributes; ///< Attributes for shader verification.
   ShaderAttributeCollection mAttributeCollection;
+
+  bool                      mHasBounds;  ///< True if mAABB / mSphere are valid.
+  AABB                      mAABB;
+  BoundingSphere            mSphere;
+  size_t                    mStride;          ///< Vertex stride, valid with bounds.
+  size_t                    mPositionOffset;  ///< Position offset, valid with bounds.
+
+  std::vector<uint8_t>      mInstanceData; ///< See getInstanceData.
 };
 
 } // namespace CPM_SPIRE_NS
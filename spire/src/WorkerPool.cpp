@@ -0,0 +1,137 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2013 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+/// \author agent
+/// \date   October 2026
+
+#include "WorkerPool.h"
+
+namespace CPM_SPIRE_NS {
+
+//------------------------------------------------------------------------------
+WorkerPool::WorkerPool(size_t numThreads) :
+    mJobs(nullptr),
+    mNextJob(0),
+    mNumCompleted(0),
+    mBatch(0),
+    mStop(false)
+{
+  for (size_t i = 0; i < numThreads; ++i)
+    mThreads.push_back(std::thread(&WorkerPool::workerLoop, this));
+}
+
+//------------------------------------------------------------------------------
+WorkerPool::~WorkerPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mStop = true;
+  }
+  mWorkAvailable.notify_all();
+
+  for (auto it = mThreads.begin(); it != mThreads.end(); ++it)
+    it->join();
+}
+
+//------------------------------------------------------------------------------
+void WorkerPool::run(std::vector<Job>& jobs)
+{
+  if (jobs.empty())
+    return;
+
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mJobs         = &jobs;
+    mNextJob      = 0;
+    mNumCompleted = 0;
+    mException    = nullptr;
+    ++mBatch;
+  }
+  mWorkAvailable.notify_all();
+
+  executeJobs();
+
+  std::exception_ptr exception;
+  {
+    std::unique_lock<std::mutex> lock(mMutex);
+    mWorkDone.wait(lock, [this, &jobs]() {return mNumCompleted == jobs.size();});
+    mJobs = nullptr;
+    exception = mException;
+  }
+
+  if (exception)
+    std::rethrow_exception(exception);
+}
+
+//------------------------------------------------------------------------------
+void WorkerPool::executeJobs()
+{
+  std::unique_lock<std::mutex> lock(mMutex);
+  while (mJobs != nullptr && mNextJob < mJobs->size())
+  {
+    Job& job = (*mJobs)[mNextJob++];
+    std::vector<Job>* jobs = mJobs;
+
+    lock.unlock();
+    std::exception_ptr exception;
+    try
+    {
+      job();
+    }
+    catch (...)
+    {
+      exception = std::current_exception();
+    }
+    lock.lock();
+
+    if (exception && !mException)
+      mException = exception;
+    if (++mNumCompleted == jobs->size())
+      mWorkDone.notify_all();
+  }
+}
+
+//------------------------------------------------------------------------------
+void WorkerPool::workerLoop()
+{
+  uint64_t lastBatch = 0;
+  for (;;)
+  {
+    {
+      std::unique_lock<std::mutex> lock(mMutex);
+      mWorkAvailable.wait(lock, [this, lastBatch]() {return mStop || mBatch != lastBatch;});
+      if (mStop)
+        return;
+      lastBatch = mBatch;
+    }
+
+    executeJobs();
+  }
+}
+
+} // namespace CPM_SPIRE_NS
@@ -0,0 +1,92 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2013 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+/// \author agent
+/// \date   October 2026
+
+#ifndef SPIRE_HIGH_WORKERPOOL_H
+#define SPIRE_HIGH_WORKERPOOL_H
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <cstdint>
+
+namespace CPM_SPIRE_NS {
+
+/// Fixed set of threads executing batches of jobs. Workers never make GL
+/// calls; they only perform CPU work, such as recording CommandBuffers, while
+/// the GL thread waits in run.
+class WorkerPool
+{
+public:
+  typedef std::function<void ()> Job;
+
+  /// Spawns 'numThreads' worker threads.
+  WorkerPool(size_t numThreads);
+
+  /// Joins the worker threads.
+  virtual ~WorkerPool();
+
+  /// Executes every job and returns once all of them have completed. The
+  /// calling thread executes jobs as well. The order in which jobs run is not
+  /// defined. The first exception thrown by a job is rethrown on the calling
+  /// thread, after every other job has completed.
+  void run(std::vector<Job>& jobs);
+
+  /// Number of worker threads, not counting the calling thread.
+  size_t getNumThreads() const  {return mThreads.size();}
+
+private:
+
+  /// Executes jobs from the current batch until none are left.
+  void executeJobs();
+
+  /// Entry point of the worker threads.
+  void workerLoop();
+
+  std::vector<std::thread>    mThreads;
+
+  std::mutex                  mMutex;
+  std::condition_variable     mWorkAvailable;
+  std::condition_variable     mWorkDone;
+
+  std::vector<Job>*           mJobs;          ///< Current batch, guarded by mMutex.
+  size_t                      mNextJob;       ///< Next job to execute.
+  size_t                      mNumCompleted;  ///< Jobs completed in the batch.
+  uint64_t                    mBatch;         ///< Incremented for every call to run.
+  bool                        mStop;
+  std::exception_ptr          mException;
+};
+
+} // namespace CPM_SPIRE_NS
+
+#endif
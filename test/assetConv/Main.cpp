@@ -36,6 +36,13 @@
 #include <string>
 #include <map>
 #include <fstream>
+#include <sstream>
+#include <cstring>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <mutex>
+#include <thread>
 #include <boost/filesystem.hpp>
 
 #include <glm/glm.hpp>
@@ -54,8 +61,23 @@
 #include "assimp/DefaultLogger.hpp"
 #include "assimp/LogStream.hpp"
 
+#include "spire/src/MeshCodec.h"
+#include "spire/src/SR6Format.h"
+
+/// How files are written.
+struct OutputOptions
+{
+  std::string format;       ///< "sr5" or "sr6".
+  bool        compress;     ///< Compress SR6 meshes.
+  int         mantissaBits; ///< Quantize SR6 floats to this many bits, if >= 0.
+};
+
 // Forward declarations
-int processFile(const std::string& inFile, const std::string& outputDirectory);
+int processFile(const std::string& inFile, const std::string& outputDirectory,
+                const OutputOptions& options, std::ostream& log);
+int writeSR5File(const aiScene* scene, const std::string& outFile);
+int writeSR6File(const aiScene* scene, const std::string& outFile,
+                 const OutputOptions& options, std::ostream& log);
 
 //------------------------------------------------------------------------------
 void createAssimpLogger()
@@ -76,6 +98,8 @@ int main(int argc, char* argv[])
 {
   std::vector<std::string> inputFiles;
   std::string outputDirectory;
+  OutputOptions options;
+  size_t numJobs = 0;
   try
   {
     TCLAP::CmdLine cmd("Asset Converter");
@@ -88,9 +112,27 @@ int main(int argc, char* argv[])
                                            true, "", "Path");
     TCLAP::ValueArg<std::string> outputDir("o", "output", "Output directory.",
                                            false, "", "String");
+    std::vector<std::string> formats;
+    formats.push_back("sr5");
+    formats.push_back("sr6");
+    TCLAP::ValuesConstraint<std::string> formatConstraint(formats);
+    TCLAP::ValueArg<std::string> outputFormat("f", "format", "Output format.",
+                                              false, "sr5", &formatConstraint);
+    TCLAP::ValueArg<size_t> jobs("j", "jobs",
+                                 "Number of files converted at once. Defaults to the number of cores.",
+                                 false, 0, "Number");
+
+    TCLAP::SwitchArg compress("c", "compress", "Compress SR6 vertex and index data.");
+    TCLAP::ValueArg<int> quantize("q", "quantize",
+                                  "Round SR6 floats to this many mantissa bits (0 - 23). Lossy.",
+                                  false, -1, "Bits");
 
     cmd.xorAdd(inputs, directory);
     cmd.add(outputDir);
+    cmd.add(outputFormat);
+    cmd.add(jobs);
+    cmd.add(compress);
+    cmd.add(quantize);
     cmd.parse(argc, argv);
 
     // If inputs have been set, go ahead and add them to the list of inut files.
@@ -154,6 +196,10 @@ int main(int argc, char* argv[])
     }
 
     outputDirectory = outputDir.getValue();
+    options.format       = outputFormat.getValue();
+    options.compress     = compress.getValue();
+    options.mantissaBits = quantize.getValue();
+    numJobs = jobs.getValue();
   }
   catch (const TCLAP::ArgException& e)
   {
@@ -167,8 +213,14 @@ int main(int argc, char* argv[])
     std::cout << i << std::endl;
   }
 
-  // Initialize assimp.
-  createAssimpLogger();
+  if (numJobs == 0)
+    numJobs = std::max(1u, std::thread::hardware_concurrency());
+  numJobs = std::min(numJobs, std::max(inputFiles.size(), size_t(1)));
+
+  // Initialize assimp. Its logger is shared by every importer, so only
+  // enable it when converting one file at a time.
+  if (numJobs == 1)
+    createAssimpLogger();
   std::cout << "Assimp initialized." << std::endl;
 
   // Determine IL Version
@@ -183,18 +235,66 @@ int main(int argc, char* argv[])
 
   ilInit();
   
-  int lastExitCode = EXIT_SUCCESS;
-  for (auto i : inputFiles)
+  // Workers take the next unconverted file until none are left. Each
+  // file's messages are collected and printed together once it is done.
+  std::atomic<size_t> nextFile(0);
+  std::atomic<size_t> numFailed(0);
+  std::mutex outputMutex;
+  auto convert = [&]()
   {
-    lastExitCode = processFile(i, outputDirectory);
-  }
+    for (size_t i = nextFile++; i < inputFiles.size(); i = nextFile++)
+    {
+      std::ostringstream log;
+      auto start = std::chrono::steady_clock::now();
+      int exitCode;
+      try
+      {
+        exitCode = processFile(inputFiles[i], outputDirectory, options, log);
+      }
+      catch (const std::exception& e)
+      {
+        log << "Error: " << e.what() << std::endl;
+        exitCode = EXIT_FAILURE;
+      }
+      auto end = std::chrono::steady_clock::now();
+      double ms = std::chrono::duration<double, std::milli>(end - start).count();
+
+      if (exitCode != EXIT_SUCCESS)
+        ++numFailed;
 
-  return lastExitCode;
+      std::lock_guard<std::mutex> lock(outputMutex);
+      std::cout << log.str() << inputFiles[i]
+                << (exitCode == EXIT_SUCCESS ? " converted in " : " failed after ")
+                << ms << " ms" << std::endl;
+    }
+  };
+
+  auto start = std::chrono::steady_clock::now();
+  std::vector<std::future<void>> workers;
+  for (size_t i = 1; i < numJobs; ++i)
+    workers.push_back(std::async(std::launch::async, convert));
+  convert();
+  for (auto& worker : workers)
+    worker.get();
+  auto end = std::chrono::steady_clock::now();
+
+  std::cout << "Converted " << inputFiles.size() - numFailed << " of "
+            << inputFiles.size() << " files in "
+            << std::chrono::duration<double>(end - start).count() << " s using "
+            << numJobs << " jobs." << std::endl;
+
+  if (numJobs == 1)
+    destroyAssimpLogger();
+
+  return (numFailed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
 }
 
-int processFile(const std::string& inFile, const std::string& outputDirectory)
+//------------------------------------------------------------------------------
+int processFile(const std::string& inFile, const std::string& outputDirectory,
+                const OutputOptions& options, std::ostream& log)
 {
   std::string outFile;
+  std::string outExtension = (options.format == "sr6") ? ".sp6" : ".sp";
 
   if (outputDirectory.length() > 0)
   {
@@ -202,17 +302,17 @@ int processFile(const std::string& inFile, const std::string& outputDirectory)
     boost::filesystem::path boostPath(inFile);
     boost::filesystem::path outputFilePath(outputDirectory + "/" + boostPath.filename().string());
 
-    outputFilePath.replace_extension(".sp");
+    outputFilePath.replace_extension(outExtension);
     outFile = outputFilePath.string();
   }
   else
   {
     boost::filesystem::path boostPath(inFile);
-    boostPath.replace_extension(".sp");
+    boostPath.replace_extension(outExtension);
     outFile = boostPath.string();
   }
 
-  std::cout << "Target output file: " << outFile << std::endl;
+  log << "Target output file: " << outFile << std::endl;
 
   const aiScene* scene = nullptr;
   Assimp::Importer importer;
@@ -235,104 +335,228 @@ int processFile(const std::string& inFile, const std::string& outputDirectory)
 
   if (!scene)
   {
-    std::cout << "Error: " << importer.GetErrorString() << std::endl;
+    log << "Error: " << importer.GetErrorString() << std::endl;
     return EXIT_FAILURE;
   }
 
-  std::string header = "SCR5";
+  if (options.format == "sr6")
+    return writeSR6File(scene, outFile, options, log);
+  return writeSR5File(scene, outFile);
+}
 
-  // Open file for output.
-  std::ofstream output(outFile, std::ofstream::binary);
+namespace {
 
-  // Write out the file header.
-  output.write(header.c_str(), header.length());
+// Appends the bytes of 'value' to 'out'.
+template <typename T>
+void append(std::vector<char>& out, const T& value)
+{
+  const char* bytes = reinterpret_cast<const char*>(&value);
+  out.insert(out.end(), bytes, bytes + sizeof(T));
+}
 
-  // Write out number of meshes contained in the file.
-  output.write(reinterpret_cast<const char*>(&scene->mNumMeshes), sizeof(uint32_t));
+void write(std::ofstream& output, const std::vector<char>& section)
+{
+  output.write(section.data(), static_cast<std::streamsize>(section.size()));
+}
+
+} // anonymous namespace
 
+//------------------------------------------------------------------------------
+int writeSR5File(const aiScene* scene, const std::string& outFile)
+{
   /// \todo There are a lot of potential errors in the following code.
   ///       Most of the errors come from relying on unsigned int values
   ///       being readily convertable to uint32_t values.
 
+  // Each section is assembled in memory and written at once.
+  std::ofstream output(outFile, std::ofstream::binary);
+  std::vector<char> section;
+
+  // File header and number of meshes contained in the file.
+  section.insert(section.end(), {'S', 'C', 'R', '5'});
+  append(section, static_cast<uint32_t>(scene->mNumMeshes));
+  write(output, section);
+
   // Loop through every mesh and write out vertices, normals, and IBO data.
   for (size_t i = 0; i < scene->mNumMeshes; i++)
   {
     const struct aiMesh* mesh = scene->mMeshes[i];
     assert(mesh->mNumVertices > 0);
 
-    // Write out VBO data.
-    output.write(reinterpret_cast<const char*>(&mesh->mNumVertices), sizeof(uint32_t));
+    // VBO data: interleaved positions and normals.
+    section.clear();
+    section.reserve(sizeof(uint32_t) + mesh->mNumVertices * 6 * sizeof(float));
+    append(section, static_cast<uint32_t>(mesh->mNumVertices));
     for (size_t j = 0; j < mesh->mNumVertices; j++)
     {
-      // Position data
-      output.write(reinterpret_cast<const char*>(&mesh->mVertices[j].x), sizeof(float));
-      output.write(reinterpret_cast<const char*>(&mesh->mVertices[j].y), sizeof(float));
-      output.write(reinterpret_cast<const char*>(&mesh->mVertices[j].z), sizeof(float));
-
-      // Normal data
-      output.write(reinterpret_cast<const char*>(&mesh->mNormals[j].x), sizeof(float));
-      output.write(reinterpret_cast<const char*>(&mesh->mNormals[j].y), sizeof(float));
-      output.write(reinterpret_cast<const char*>(&mesh->mNormals[j].z), sizeof(float));
+      append(section, mesh->mVertices[j].x);
+      append(section, mesh->mVertices[j].y);
+      append(section, mesh->mVertices[j].z);
+
+      append(section, mesh->mNormals[j].x);
+      append(section, mesh->mNormals[j].y);
+      append(section, mesh->mNormals[j].z);
     }
+    write(output, section);
 
-    // Write out IBO data.
-    output.write(reinterpret_cast<const char*>(&mesh->mNumFaces), sizeof(uint32_t));
+    // IBO data.
+    section.clear();
+    section.reserve(sizeof(uint32_t) + mesh->mNumFaces * (1 + 6 * sizeof(uint16_t)));
+    append(section, static_cast<uint32_t>(mesh->mNumFaces));
     for (size_t j = 0; j < mesh->mNumFaces; j++)
     {
+      const unsigned int* face = mesh->mFaces[j].mIndices;
       uint8_t numIndices = static_cast<uint8_t>(mesh->mFaces[j].mNumIndices);
-      output.write(reinterpret_cast<const char*>(&numIndices), sizeof(uint8_t));
+      append(section, numIndices);
       if (numIndices == 3)
       {
         // Handle triangles.
 
         // The following is a precaution until we can start using 32 bit data.
-        // But we still write the indices out using 32 bit data.
-        assert(mesh->mFaces[j].mIndices[0] < 65536);
-        assert(mesh->mFaces[j].mIndices[1] < 65536);
-        assert(mesh->mFaces[j].mIndices[2] < 65536);
-
-        uint16_t index0 = static_cast<uint16_t>(mesh->mFaces[j].mIndices[0]);
-        uint16_t index1 = static_cast<uint16_t>(mesh->mFaces[j].mIndices[1]);
-        uint16_t index2 = static_cast<uint16_t>(mesh->mFaces[j].mIndices[2]);
-        output.write(reinterpret_cast<const char*>(&index0), sizeof(uint16_t));
-        output.write(reinterpret_cast<const char*>(&index1), sizeof(uint16_t));
-        output.write(reinterpret_cast<const char*>(&index2), sizeof(uint16_t));
+        assert(face[0] < 65536);
+        assert(face[1] < 65536);
+        assert(face[2] < 65536);
+
+        append(section, static_cast<uint16_t>(face[0]));
+        append(section, static_cast<uint16_t>(face[1]));
+        append(section, static_cast<uint16_t>(face[2]));
       }
       else if (numIndices == 4)
       {
         // Handle quads. Need to convert to triangles. Ensure to swap winding
         // order of the quads.
-        
-        // The following is a precaution until we can start using 32 bit data.
-        // But we still write the indices out using 32 bit data.
-        assert(mesh->mFaces[j].mIndices[0] < 65536);
-        assert(mesh->mFaces[j].mIndices[1] < 65536);
-        assert(mesh->mFaces[j].mIndices[2] < 65536);
-        assert(mesh->mFaces[j].mIndices[3] < 65536);
 
-        uint16_t index0 = static_cast<uint16_t>(mesh->mFaces[j].mIndices[0]);
-        uint16_t index1 = static_cast<uint16_t>(mesh->mFaces[j].mIndices[1]);
-        uint16_t index2 = static_cast<uint16_t>(mesh->mFaces[j].mIndices[2]);
-        uint16_t index3 = static_cast<uint16_t>(mesh->mFaces[j].mIndices[3]);
+        // The following is a precaution until we can start using 32 bit data.
+        assert(face[0] < 65536);
+        assert(face[1] < 65536);
+        assert(face[2] < 65536);
+        assert(face[3] < 65536);
 
         // First triangle.
-        output.write(reinterpret_cast<const char*>(&index0), sizeof(uint16_t));
-        output.write(reinterpret_cast<const char*>(&index1), sizeof(uint16_t));
-        output.write(reinterpret_cast<const char*>(&index2), sizeof(uint16_t));
+        append(section, static_cast<uint16_t>(face[0]));
+        append(section, static_cast<uint16_t>(face[1]));
+        append(section, static_cast<uint16_t>(face[2]));
 
         // Second triangle (opposite winding order).
-        output.write(reinterpret_cast<const char*>(&index3), sizeof(uint16_t));
-        output.write(reinterpret_cast<const char*>(&index2), sizeof(uint16_t));
-        output.write(reinterpret_cast<const char*>(&index1), sizeof(uint16_t));
+        append(section, static_cast<uint16_t>(face[3]));
+        append(section, static_cast<uint16_t>(face[2]));
+        append(section, static_cast<uint16_t>(face[1]));
       }
     }
+    write(output, section);
   }
-  uint32_t voidIndex = 0;
-  output.write(reinterpret_cast<const char*>(&voidIndex), sizeof(uint32_t));
+
+  section.clear();
+  append(section, static_cast<uint32_t>(0));
+  write(output, section);
 
   output.close();
 
-  return EXIT_SUCCESS;
+  return output ? EXIT_SUCCESS : EXIT_FAILURE;
 }
 
+//------------------------------------------------------------------------------
+int writeSR6File(const aiScene* scene, const std::string& outFile,
+                 const OutputOptions& options, std::ostream& log)
+{
+  // Interleaved position and normal, the same layout the SR5 loader produces.
+  std::vector<spire::SR6Attribute> attributes(2);
+  attributes[0].name          = "aPos";
+  attributes[1].name          = "aNormal";
+  for (auto& attrib : attributes)
+  {
+    attrib.numComponents      = 3;
+    attrib.type               = 6;  // spire::Interface::TYPE_FLOAT
+    attrib.size               = 3 * sizeof(float);
+    attrib.normalize          = false;
+  }
+
+  // Buffers backing the meshes' pointers, kept alive until written.
+  std::vector<std::vector<uint8_t>> vbos(scene->mNumMeshes);
+  std::vector<std::vector<uint8_t>> ibos(scene->mNumMeshes);
+  std::vector<spire::SR6Mesh> meshes(scene->mNumMeshes);
+
+  for (size_t i = 0; i < scene->mNumMeshes; i++)
+  {
+    const struct aiMesh* mesh = scene->mMeshes[i];
+    assert(mesh->mNumVertices > 0);
+
+    std::vector<float> vertices;
+    vertices.reserve(mesh->mNumVertices * 6);
+    for (size_t j = 0; j < mesh->mNumVertices; j++)
+    {
+      vertices.push_back(mesh->mVertices[j].x);
+      vertices.push_back(mesh->mVertices[j].y);
+      vertices.push_back(mesh->mVertices[j].z);
+      vertices.push_back(mesh->mNormals[j].x);
+      vertices.push_back(mesh->mNormals[j].y);
+      vertices.push_back(mesh->mNormals[j].z);
+    }
+    if (options.mantissaBits >= 0)
+      spire::quantizeFloats(vertices.data(), vertices.size(),
+                            static_cast<unsigned>(options.mantissaBits));
+
+    // Triangulate with the same winding as the SR5 output.
+    std::vector<uint32_t> indices;
+    for (size_t j = 0; j < mesh->mNumFaces; j++)
+    {
+      const unsigned int* face = mesh->mFaces[j].mIndices;
+      if (mesh->mFaces[j].mNumIndices == 3)
+      {
+        indices.push_back(face[0]);
+        indices.push_back(face[1]);
+        indices.push_back(face[2]);
+      }
+      else if (mesh->mFaces[j].mNumIndices == 4)
+      {
+        indices.push_back(face[0]);
+        indices.push_back(face[1]);
+        indices.push_back(face[2]);
+
+        indices.push_back(face[3]);
+        indices.push_back(face[2]);
+        indices.push_back(face[1]);
+      }
+    }
 
+    vbos[i].resize(vertices.size() * sizeof(float));
+    std::memcpy(&vbos[i][0], &vertices[0], vbos[i].size());
+
+    // 16 bit indices whenever every vertex can be addressed by them.
+    if (mesh->mNumVertices <= 65536)
+    {
+      std::vector<uint16_t> narrow(indices.begin(), indices.end());
+      ibos[i].resize(narrow.size() * sizeof(uint16_t));
+      if (!narrow.empty())
+        std::memcpy(&ibos[i][0], &narrow[0], ibos[i].size());
+      meshes[i].indexSize = sizeof(uint16_t);
+    }
+    else
+    {
+      ibos[i].resize(indices.size() * sizeof(uint32_t));
+      if (!indices.empty())
+        std::memcpy(&ibos[i][0], &indices[0], ibos[i].size());
+      meshes[i].indexSize = sizeof(uint32_t);
+    }
+
+    meshes[i].attributes  = attributes;
+    meshes[i].vbo         = vbos[i].empty() ? nullptr : &vbos[i][0];
+    meshes[i].vboSize     = vbos[i].size();
+    meshes[i].ibo         = ibos[i].empty() ? nullptr : &ibos[i][0];
+    meshes[i].iboSize     = ibos[i].size();
+    meshes[i].compressed  = options.compress;
+  }
+
+  std::ofstream output(outFile, std::ofstream::binary);
+  try
+  {
+    spire::writeSR6(output, meshes);
+  }
+  catch (const std::exception& e)
+  {
+    log << "Error: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,309 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2013 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+/// \author agent
+/// \date   October 2026
+/// \brief  Throughput benchmarks for spire's asset loaders. Loads the assets
+///         given on the command line along with synthetic meshes and reports
+///         MB/s, then compares reading their VBOs and IBOs raw with reading
+///         and decoding them compressed (see MeshCodec). Run through
+///         'make bench'.
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <spire/Interface.h>
+#include <spire/src/MeshCodec.h>
+#include "namespaces.h"
+
+namespace {
+
+/// Best of this many loads is reported.
+const int NumRuns = 5;
+
+//------------------------------------------------------------------------------
+void writeUInt32(std::ostream& out, uint32_t value)
+{
+  out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+//------------------------------------------------------------------------------
+/// Writes a SR5 file holding a (n x n) vertex grid over a gently rolling
+/// height field. Every other cell is a quad, the rest are two triangles.
+void writeSyntheticSR5(const std::string& filename, uint32_t n)
+{
+  std::ofstream out(filename.c_str(), std::ios::binary);
+  if (out.fail())
+    throw std::runtime_error("Unable to write " + filename);
+
+  out.write("SCR5", 4);
+  writeUInt32(out, 1);
+
+  std::vector<float> vertices(6 * static_cast<size_t>(n) * n);
+  for (uint32_t y = 0; y < n; ++y)
+  {
+    for (uint32_t x = 0; x < n; ++x)
+    {
+      float* v = &vertices[6 * (static_cast<size_t>(y) * n + x)];
+      float s = 0.05f * static_cast<float>(x);
+      float t = 0.05f * static_cast<float>(y);
+      float dx = -0.5f * std::cos(s) * std::cos(t);
+      float dy =  0.5f * std::sin(s) * std::sin(t);
+      float length = std::sqrt(dx * dx + dy * dy + 1.0f);
+      v[0] = static_cast<float>(x);
+      v[1] = static_cast<float>(y);
+      v[2] = 10.0f * std::sin(s) * std::cos(t);
+      v[3] = dx / length;
+      v[4] = dy / length;
+      v[5] = 1.0f / length;
+    }
+  }
+  writeUInt32(out, n * n);
+  out.write(reinterpret_cast<const char*>(vertices.data()),
+            static_cast<std::streamsize>(vertices.size() * sizeof(float)));
+
+  // Indices are 16 bit; wrap around, only the layout matters here. Wrapped
+  // indices are never the next new vertex, so they code slightly worse
+  // (see MeshCodec) than in a real mesh.
+  std::vector<char> faces;
+  uint32_t numFaces = 0;
+  for (uint32_t y = 0; y + 1 < n; ++y)
+  {
+    for (uint32_t x = 0; x + 1 < n; ++x)
+    {
+      uint16_t i = static_cast<uint16_t>(y * n + x);
+      uint16_t w = static_cast<uint16_t>(n);
+      uint16_t first[]  = {i, static_cast<uint16_t>(i + 1), static_cast<uint16_t>(i + w)};
+      uint16_t second[] = {static_cast<uint16_t>(i + 1), static_cast<uint16_t>(i + w + 1),
+                           static_cast<uint16_t>(i + w)};
+
+      if ((x + y) % 2 == 0)
+      {
+        faces.push_back(4);
+        faces.insert(faces.end(), reinterpret_cast<char*>(first), reinterpret_cast<char*>(first + 3));
+        faces.insert(faces.end(), reinterpret_cast<char*>(second), reinterpret_cast<char*>(second + 3));
+        ++numFaces;
+      }
+      else
+      {
+        faces.push_back(3);
+        faces.insert(faces.end(), reinterpret_cast<char*>(first), reinterpret_cast<char*>(first + 3));
+        faces.push_back(3);
+        faces.insert(faces.end(), reinterpret_cast<char*>(second), reinterpret_cast<char*>(second + 3));
+        numFaces += 2;
+      }
+    }
+  }
+  writeUInt32(out, numFaces);
+  out.write(faces.data(), static_cast<std::streamsize>(faces.size()));
+}
+
+//------------------------------------------------------------------------------
+void benchmarkSR5(const std::string& filename)
+{
+  double best = 0.0;
+  size_t fileSize = 0;
+  size_t numTriangles = 0;
+  for (int run = 0; run < NumRuns; ++run)
+  {
+    std::ifstream in(filename.c_str(), std::ios::binary | std::ios::ate);
+    if (in.fail())
+      throw std::runtime_error("Unable to open " + filename);
+    fileSize = static_cast<size_t>(in.tellg());
+    in.seekg(0);
+
+    std::vector<uint8_t> vbo;
+    std::vector<uint8_t> ibo;
+    auto start = std::chrono::high_resolution_clock::now();
+    numTriangles = spire::Interface::loadProprietarySR5AssetFile(in, vbo, ibo);
+    std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - start;
+
+    if (run == 0 || elapsed.count() < best)
+      best = elapsed.count();
+  }
+
+  double megabytes = static_cast<double>(fileSize) / (1024.0 * 1024.0);
+  std::printf("%-40s %9.2f MB %10zu tris %9.3f ms %9.1f MB/s\n",
+              filename.c_str(), megabytes, numTriangles, best * 1000.0,
+              best > 0.0 ? megabytes / best : 0.0);
+}
+
+//------------------------------------------------------------------------------
+/// Reads all of 'filename' into 'data'.
+void readFile(const std::string& filename, std::vector<uint8_t>& data)
+{
+  std::ifstream in(filename.c_str(), std::ios::binary | std::ios::ate);
+  if (in.fail())
+    throw std::runtime_error("Unable to open " + filename);
+  data.resize(static_cast<size_t>(in.tellg()));
+  in.seekg(0);
+  in.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(data.size()));
+}
+
+//------------------------------------------------------------------------------
+void writeFile(const std::string& filename, const std::vector<uint8_t>& data)
+{
+  std::ofstream out(filename.c_str(), std::ios::binary);
+  out.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+  if (out.fail())
+    throw std::runtime_error("Unable to write " + filename);
+}
+
+//------------------------------------------------------------------------------
+/// Times reading the mesh in 'filename' raw against reading and decoding it
+/// compressed, losslessly and with floats quantized to 12 mantissa bits.
+/// Reads are served from the page cache, so this is a lower bound on what
+/// compression saves on disks and network shares.
+void benchmarkCodec(const std::string& filename)
+{
+  std::ifstream in(filename.c_str(), std::ios::binary);
+  if (in.fail())
+    throw std::runtime_error("Unable to open " + filename);
+  std::vector<uint8_t> vbo;
+  std::vector<uint8_t> ibo;
+  spire::Interface::loadProprietarySR5AssetFile(in, vbo, ibo);
+
+  // SR5 vertices are a position and a normal, indices are 16 bit.
+  const size_t stride = 6 * sizeof(float);
+  const size_t numVertices = vbo.size() / stride;
+  const size_t numIndices = ibo.size() / sizeof(uint16_t);
+  const size_t rawSize = vbo.size() + ibo.size();
+
+  std::vector<uint8_t> raw(vbo);
+  raw.insert(raw.end(), ibo.begin(), ibo.end());
+  writeFile("codec_raw.bin", raw);
+
+  double rawBest = 0.0;
+  std::vector<uint8_t> data;
+  for (int run = 0; run < NumRuns; ++run)
+  {
+    auto start = std::chrono::high_resolution_clock::now();
+    readFile("codec_raw.bin", data);
+    std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - start;
+    if (run == 0 || elapsed.count() < rawBest)
+      rawBest = elapsed.count();
+  }
+  std::remove("codec_raw.bin");
+
+  double megabytes = static_cast<double>(rawSize) / (1024.0 * 1024.0);
+  std::printf("%-40s %9.2f MB raw read %9.3f ms\n", filename.c_str(), megabytes, rawBest * 1000.0);
+
+  const int mantissaBits[] = {-1, 12};
+  for (int bits : mantissaBits)
+  {
+    std::vector<uint8_t> vertices(vbo);
+    if (bits >= 0)
+      spire::quantizeFloats(reinterpret_cast<float*>(vertices.data()),
+                            vertices.size() / sizeof(float), static_cast<unsigned>(bits));
+
+    std::vector<uint8_t> encoded;
+    spire::encodeVertices(vertices.data(), numVertices, stride, encoded);
+    size_t vboEncoded = encoded.size();
+    spire::encodeIndices(ibo.data(), numIndices, sizeof(uint16_t), encoded);
+    writeFile("codec_encoded.bin", encoded);
+
+    double decodeBest = 0.0;
+    double totalBest = 0.0;
+    std::vector<uint8_t> decodedVBO(vbo.size());
+    std::vector<uint8_t> decodedIBO(ibo.size());
+    for (int run = 0; run < NumRuns; ++run)
+    {
+      auto start = std::chrono::high_resolution_clock::now();
+      readFile("codec_encoded.bin", data);
+      auto read = std::chrono::high_resolution_clock::now();
+      spire::decodeVertices(data.data(), vboEncoded, numVertices, stride, decodedVBO.data());
+      spire::decodeIndices(data.data() + vboEncoded, data.size() - vboEncoded, numIndices,
+                           sizeof(uint16_t), decodedIBO.data());
+      auto end = std::chrono::high_resolution_clock::now();
+
+      std::chrono::duration<double> decode = end - read;
+      std::chrono::duration<double> total = end - start;
+      if (run == 0 || decode.count() < decodeBest)
+        decodeBest = decode.count();
+      if (run == 0 || total.count() < totalBest)
+        totalBest = total.count();
+    }
+    std::remove("codec_encoded.bin");
+
+    if (decodedVBO != vertices || decodedIBO != ibo)
+      throw std::runtime_error("Decoded mesh does not match " + filename);
+
+    std::printf("  %-16s %6.2fx smaller (VBO %5.2fx, IBO %5.2fx), read + decode %9.3f ms, "
+                "decode %7.1f MB/s\n",
+                bits < 0 ? "lossless" : "12 bit mantissa",
+                static_cast<double>(rawSize) / static_cast<double>(encoded.size()),
+                static_cast<double>(vbo.size()) / static_cast<double>(vboEncoded),
+                static_cast<double>(ibo.size()) / static_cast<double>(encoded.size() - vboEncoded),
+                totalBest * 1000.0, decodeBest > 0.0 ? megabytes / decodeBest : 0.0);
+  }
+}
+
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+  std::vector<std::string> files(argv + 1, argv + argc);
+
+  // Synthetic meshes of about 1 and 4 million vertices.
+  const uint32_t gridSizes[] = {1024, 2048};
+  for (uint32_t n : gridSizes)
+  {
+    std::string filename = "synthetic_" + std::to_string(n) + ".sp";
+    writeSyntheticSR5(filename, n);
+    files.push_back(filename);
+  }
+
+  try
+  {
+    for (auto it = files.begin(); it != files.end(); ++it)
+      benchmarkSR5(*it);
+
+    std::printf("\n");
+    for (auto it = files.begin(); it != files.end(); ++it)
+      benchmarkCodec(*it);
+  }
+  catch (const std::exception& e)
+  {
+    std::cerr << "Benchmark failed: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  for (uint32_t n : gridSizes)
+    std::remove(("synthetic_" + std::to_string(n) + ".sp").c_str());
+
+  return EXIT_SUCCESS;
+}
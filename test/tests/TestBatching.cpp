@@ -0,0 +1,231 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2013 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+/// \author agent
+/// \date   October 2026
+
+#include <chrono>
+#include <thread>
+
+#include <batch-testing/GlobalGTestEnv.hpp>
+#include <batch-testing/SpireTestFixture.hpp>
+#include "namespaces.h"
+
+#include "spire/src/Common.h"
+
+#include "TestCamera.h"
+
+using namespace spire;
+using namespace CPM_BATCH_TESTING_NS;
+
+namespace {
+
+#ifdef SPIRE_USE_BATCHING
+
+/// Vertices of the quadrant of TestTriangle's quad with the given corner.
+std::vector<float> quadrant(float x, float y)
+{
+  return std::vector<float>
+  {
+    x,        y + 1.0f, 0.0f,
+    x + 1.0f, y + 1.0f, 0.0f,
+    x,        y,        0.0f,
+    x + 1.0f, y,        0.0f
+  };
+}
+
+//------------------------------------------------------------------------------
+TEST_F(SpireTestFixture, TestDrawBatches)
+{
+  std::unique_ptr<TestCamera> myCamera = std::unique_ptr<TestCamera>(new TestCamera);
+
+  std::vector<std::string> attribNames = {"aPos"};
+  Interface::IBO_TYPE iboType = Interface::IBO_16BIT;
+
+  std::string shader1 = "UniformColor";
+  mSpire->addPersistentShader(
+      shader1, 
+      { std::make_tuple("UniformColor.vsh", Interface::VERTEX_SHADER), 
+        std::make_tuple("UniformColor.fsh", Interface::FRAGMENT_SHADER),
+      });
+
+  mSpire->setBatchingEnabled(true);
+  mSpire->setCullingUniform("uProjIVObject");
+
+  std::string pass1 = "pass1";
+  auto addQuadObject = [&](const std::string& obj, const std::string& vbo,
+                           const std::string& ibo, Interface::PRIMITIVE_TYPES type)
+  {
+    mSpire->addObject(obj);
+    mSpire->addPassToObject(obj, shader1, vbo, ibo, type, pass1);
+    mSpire->addObjectPassUniform(obj, "uColor", V4(1.0f, 0.0f, 0.0f, 1.0f), pass1);
+    mSpire->addObjectGlobalUniform(obj, "uProjIVObject", myCamera->getWorldToProjection());
+  };
+
+  // The quad of TestTriangle split into four quadrants, each with a VBO of
+  // its own, drawn as strips.
+  const float corners[4][2] = {{-1.0f, 0.0f}, {0.0f, 0.0f}, {-1.0f, -1.0f}, {0.0f, -1.0f}};
+  for (int i = 0; i < 4; ++i)
+  {
+    std::vector<float> vboData = quadrant(corners[i][0], corners[i][1]);
+    mSpire->addVBO("quadrant" + std::to_string(i), reinterpret_cast<uint8_t*>(&vboData[0]),
+                   vboData.size() * sizeof(float), attribNames);
+  }
+
+  std::vector<uint16_t> stripData = {0, 1, 2, 3};
+  std::vector<uint16_t> listData  = {0, 1, 2, 2, 1, 3};
+  mSpire->addIBO("strip", reinterpret_cast<uint8_t*>(&stripData[0]),
+                 stripData.size() * sizeof(uint16_t), iboType);
+  mSpire->addIBO("list", reinterpret_cast<uint8_t*>(&listData[0]),
+                 listData.size() * sizeof(uint16_t), iboType);
+
+  for (int i = 0; i < 4; ++i)
+  {
+    addQuadObject("strip" + std::to_string(i), "quadrant" + std::to_string(i),
+                  "strip", Interface::TRIANGLE_STRIP);
+  }
+
+  // Passes sharing a program, primitive type, and layout share a batch.
+  beginFrame();
+  mSpire->renderPass(pass1);
+  EXPECT_EQ(4u, mSpire->getNumRenderedPasses());
+  EXPECT_EQ(1u, mSpire->getNumDrawBatches());
+
+  // A different primitive type starts a second batch.
+  addQuadObject("list", "quadrant1", "list", Interface::TRIANGLES);
+  beginFrame();
+  mSpire->renderPass(pass1);
+  EXPECT_EQ(5u, mSpire->getNumRenderedPasses());
+  EXPECT_EQ(2u, mSpire->getNumDrawBatches());
+
+  // Passes with a dynamic VBO are rendered through the render queue.
+  std::vector<float> dynamicData = quadrant(-1.0f, -1.0f);
+  mSpire->addVBO("dynamic", reinterpret_cast<uint8_t*>(&dynamicData[0]),
+                 dynamicData.size() * sizeof(float), attribNames, Interface::USAGE_DYNAMIC);
+  addQuadObject("dynamic", "dynamic", "strip", Interface::TRIANGLE_STRIP);
+
+  // The bottom right quadrant as a flat grid, which is batched until its IBO
+  // gains levels of detail.
+  const size_t n = 17;
+  std::vector<float> gridData;
+  for (size_t y = 0; y < n; ++y)
+  {
+    for (size_t x = 0; x < n; ++x)
+    {
+      gridData.push_back(static_cast<float>(x) / static_cast<float>(n - 1));
+      gridData.push_back(static_cast<float>(y) / static_cast<float>(n - 1) - 1.0f);
+      gridData.push_back(0.0f);
+    }
+  }
+  std::vector<uint16_t> gridIndices;
+  for (size_t y = 0; y + 1 < n; ++y)
+  {
+    for (size_t x = 0; x + 1 < n; ++x)
+    {
+      uint16_t i = static_cast<uint16_t>(y * n + x);
+      uint16_t w = static_cast<uint16_t>(n);
+      gridIndices.push_back(i);     gridIndices.push_back(i + 1);     gridIndices.push_back(i + w);
+      gridIndices.push_back(i + 1); gridIndices.push_back(i + w + 1); gridIndices.push_back(i + w);
+    }
+  }
+  std::shared_ptr<std::vector<uint8_t>> rawVBO(new std::vector<uint8_t>(
+      reinterpret_cast<uint8_t*>(&gridData[0]),
+      reinterpret_cast<uint8_t*>(&gridData[0]) + gridData.size() * sizeof(float)));
+  std::shared_ptr<std::vector<uint8_t>> rawIBO(new std::vector<uint8_t>(
+      reinterpret_cast<uint8_t*>(&gridIndices[0]),
+      reinterpret_cast<uint8_t*>(&gridIndices[0]) + gridIndices.size() * sizeof(uint16_t)));
+  mSpire->addVBO("grid", rawVBO, attribNames);
+  mSpire->addIBO("grid", rawIBO, iboType);
+  addQuadObject("grid", "grid", "grid", Interface::TRIANGLES);
+
+  beginFrame();
+  mSpire->renderPass(pass1);
+  EXPECT_EQ(7u, mSpire->getNumRenderedPasses());
+  EXPECT_EQ(2u, mSpire->getNumDrawBatches());
+
+  mSpire->generateIBOLODs("grid", rawIBO, rawVBO, attribNames);
+  for (int i = 0; i < 1000 && mSpire->getNumIBOLODs("grid") == 1; ++i)
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    mSpire->renderPass(pass1);
+  }
+  ASSERT_LT(1u, mSpire->getNumIBOLODs("grid"));
+
+  // With the dynamic and LOD'd passes drawn through the render queue, the
+  // batches only hold the strips and the list.
+  beginFrame();
+  mSpire->renderPass(pass1);
+  EXPECT_EQ(7u, mSpire->getNumRenderedPasses());
+  EXPECT_EQ(2u, mSpire->getNumDrawBatches());
+
+  GLint viewport[4];
+  GL(glGetIntegerv(GL_VIEWPORT, viewport));
+  std::vector<uint8_t> expected(static_cast<size_t>(viewport[2]) * static_cast<size_t>(viewport[3]) * 4);
+  std::vector<uint8_t> image(expected.size());
+  GL(glReadPixels(viewport[0], viewport[1], viewport[2], viewport[3],
+                  GL_RGBA, GL_UNSIGNED_BYTE, &expected[0]));
+
+  // Removing most of the strips leaves the strip batch mostly empty, so it
+  // is compacted before the next frame is drawn. The remaining quadrants are
+  // still covered by the list, dynamic, and grid passes.
+  mSpire->removeObject("strip1");
+  mSpire->removeObject("strip2");
+  mSpire->removeObject("strip3");
+  beginFrame();
+  mSpire->renderPass(pass1);
+  EXPECT_EQ(4u, mSpire->getNumRenderedPasses());
+  EXPECT_EQ(2u, mSpire->getNumDrawBatches());
+  GL(glReadPixels(viewport[0], viewport[1], viewport[2], viewport[3],
+                  GL_RGBA, GL_UNSIGNED_BYTE, &image[0]));
+  EXPECT_TRUE(expected == image);
+
+  // Empty batches are released.
+  mSpire->removeObject("strip0");
+  beginFrame();
+  mSpire->renderPass(pass1);
+  EXPECT_EQ(3u, mSpire->getNumRenderedPasses());
+  EXPECT_EQ(1u, mSpire->getNumDrawBatches());
+
+  // A batch appended to after compaction.
+  addQuadObject("strip0", "quadrant0", "strip", Interface::TRIANGLE_STRIP);
+  beginFrame();
+  mSpire->renderPass(pass1);
+  EXPECT_EQ(4u, mSpire->getNumRenderedPasses());
+  EXPECT_EQ(2u, mSpire->getNumDrawBatches());
+
+  compareFBOWithExistingFile(
+      "stuTriangle.png",
+      TEST_IMAGE_OUTPUT_DIR,
+      TEST_IMAGE_COMPARE_DIR,
+      TEST_PERCEPTUAL_COMPARE_BINARY,
+      50);
+}
+
+#endif
+
+}
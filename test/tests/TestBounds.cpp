@@ -0,0 +1,200 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2013 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+/// \author agent
+/// \date   October 2026
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "namespaces.h"
+#include "spire/src/Bounds.h"
+
+using namespace spire;
+
+namespace {
+
+// Interleaved vertex: 4 byte color, position, normal. The position is not
+// 16 byte aligned.
+const size_t TestStride         = 4 + 3 * sizeof(float) + 3 * sizeof(float);
+const size_t TestPositionOffset = 4;
+
+std::vector<uint8_t> buildVertices(const std::vector<V3>& positions)
+{
+  // Fill everything but the positions with bytes that are NaNs when read as
+  // floats, so that reading the wrong bytes cannot go unnoticed.
+  std::vector<uint8_t> vertices(positions.size() * TestStride, 0xFF);
+  for (size_t i = 0; i < positions.size(); ++i)
+  {
+    float pos[3] = {positions[i].x, positions[i].y, positions[i].z};
+    std::memcpy(&vertices[i * TestStride + TestPositionOffset], pos, sizeof(pos));
+  }
+  return vertices;
+}
+
+// Perspective projection with a 90 degree field of view, an aspect ratio of
+// 1, and near / far planes at 1 and 100. Looks down -z, so at depth d the
+// frustum spans -d to d in x and y.
+M44 buildProjection()
+{
+  const float n = 1.0f;
+  const float f = 100.0f;
+  M44 proj(0.0f);
+  proj[0][0] = 1.0f;
+  proj[1][1] = 1.0f;
+  proj[2][2] = (f + n) / (n - f);
+  proj[2][3] = -1.0f;
+  proj[3][2] = 2.0f * f * n / (n - f);
+  return proj;
+}
+
+AABB makeBox(const V3& min, const V3& max)
+{
+  AABB box;
+  box.min = min;
+  box.max = max;
+  return box;
+}
+
+BoundingSphere makeSphere(const V3& center, float radius)
+{
+  BoundingSphere sphere;
+  sphere.center = center;
+  sphere.radius = radius;
+  return sphere;
+}
+
+//------------------------------------------------------------------------------
+TEST(BoundsBasic, TestStridedPositions)
+{
+  std::vector<V3> positions =
+  {
+    V3( 1.0f,  2.0f,  3.0f),
+    V3(-4.0f,  5.0f,  0.5f),
+    V3( 2.0f, -6.0f,  1.0f),
+    V3( 0.0f,  0.0f, -7.0f),
+    V3( 3.0f,  1.0f,  2.0f)
+  };
+  std::vector<uint8_t> vertices = buildVertices(positions);
+
+  AABB aabb;
+  BoundingSphere sphere;
+  ASSERT_TRUE(computeBounds(&vertices[0], positions.size(), TestStride,
+                            TestPositionOffset, aabb, sphere));
+
+  EXPECT_EQ(-4.0f, aabb.min.x);
+  EXPECT_EQ(-6.0f, aabb.min.y);
+  EXPECT_EQ(-7.0f, aabb.min.z);
+  EXPECT_EQ( 3.0f, aabb.max.x);
+  EXPECT_EQ( 5.0f, aabb.max.y);
+  EXPECT_EQ( 3.0f, aabb.max.z);
+
+  // The sphere is centered on the box and reaches the furthest vertex.
+  EXPECT_EQ(-0.5f, sphere.center.x);
+  EXPECT_EQ(-0.5f, sphere.center.y);
+  EXPECT_EQ(-2.0f, sphere.center.z);
+
+  float maxDist = 0.0f;
+  for (auto it = positions.begin(); it != positions.end(); ++it)
+  {
+    V3 d = *it - sphere.center;
+    maxDist = std::max(maxDist, std::sqrt(d.x * d.x + d.y * d.y + d.z * d.z));
+  }
+  EXPECT_FLOAT_EQ(maxDist, sphere.radius);
+}
+
+//------------------------------------------------------------------------------
+TEST(BoundsBasic, TestSingleAndNoVertices)
+{
+  std::vector<V3> positions = {V3(1.0f, -2.0f, 3.0f)};
+  std::vector<uint8_t> vertices = buildVertices(positions);
+
+  AABB aabb;
+  BoundingSphere sphere;
+  ASSERT_TRUE(computeBounds(&vertices[0], 1, TestStride, TestPositionOffset, aabb, sphere));
+  EXPECT_EQ( 1.0f, aabb.min.x);
+  EXPECT_EQ(-2.0f, aabb.min.y);
+  EXPECT_EQ( 3.0f, aabb.min.z);
+  EXPECT_EQ( 1.0f, aabb.max.x);
+  EXPECT_EQ(-2.0f, aabb.max.y);
+  EXPECT_EQ( 3.0f, aabb.max.z);
+  EXPECT_EQ( 0.0f, sphere.radius);
+
+  EXPECT_FALSE(computeBounds(&vertices[0], 0, TestStride, TestPositionOffset, aabb, sphere));
+}
+
+//------------------------------------------------------------------------------
+TEST(FrustumBasic, TestSpheres)
+{
+  Frustum frustum(buildProjection());
+
+  // Inside.
+  EXPECT_TRUE(frustum.intersects(makeSphere(V3(0.0f, 0.0f, -10.0f), 1.0f)));
+  EXPECT_TRUE(frustum.intersects(makeSphere(V3(5.0f, -5.0f, -50.0f), 1.0f)));
+
+  // Outside of each plane: behind the near plane, past the far plane, and
+  // beyond the left, right, bottom, and top planes.
+  EXPECT_FALSE(frustum.intersects(makeSphere(V3(  0.0f,   0.0f,    1.0f), 1.0f)));
+  EXPECT_FALSE(frustum.intersects(makeSphere(V3(  0.0f,   0.0f, -110.0f), 1.0f)));
+  EXPECT_FALSE(frustum.intersects(makeSphere(V3(-30.0f,   0.0f,  -10.0f), 1.0f)));
+  EXPECT_FALSE(frustum.intersects(makeSphere(V3( 30.0f,   0.0f,  -10.0f), 1.0f)));
+  EXPECT_FALSE(frustum.intersects(makeSphere(V3(  0.0f, -30.0f,  -10.0f), 1.0f)));
+  EXPECT_FALSE(frustum.intersects(makeSphere(V3(  0.0f,  30.0f,  -10.0f), 1.0f)));
+
+  // Straddling the left, near, and far planes.
+  EXPECT_TRUE(frustum.intersects(makeSphere(V3(-10.5f, 0.0f,  -10.0f), 2.0f)));
+  EXPECT_TRUE(frustum.intersects(makeSphere(V3(  0.0f, 0.0f,   -0.5f), 1.0f)));
+  EXPECT_TRUE(frustum.intersects(makeSphere(V3(  0.0f, 0.0f, -100.5f), 1.0f)));
+}
+
+//------------------------------------------------------------------------------
+TEST(FrustumBasic, TestBoxes)
+{
+  Frustum frustum(buildProjection());
+
+  // Inside.
+  EXPECT_TRUE(frustum.intersects(makeBox(V3(-1.0f, -1.0f, -11.0f), V3(1.0f, 1.0f, -9.0f))));
+
+  // Outside of each plane.
+  EXPECT_FALSE(frustum.intersects(makeBox(V3( -1.0f,  -1.0f,    0.0f), V3(  1.0f,   1.0f,    2.0f))));
+  EXPECT_FALSE(frustum.intersects(makeBox(V3( -1.0f,  -1.0f, -120.0f), V3(  1.0f,   1.0f, -110.0f))));
+  EXPECT_FALSE(frustum.intersects(makeBox(V3(-32.0f,  -1.0f,  -11.0f), V3(-28.0f,   1.0f,   -9.0f))));
+  EXPECT_FALSE(frustum.intersects(makeBox(V3( 28.0f,  -1.0f,  -11.0f), V3( 32.0f,   1.0f,   -9.0f))));
+  EXPECT_FALSE(frustum.intersects(makeBox(V3( -1.0f, -32.0f,  -11.0f), V3(  1.0f, -28.0f,   -9.0f))));
+  EXPECT_FALSE(frustum.intersects(makeBox(V3( -1.0f,  28.0f,  -11.0f), V3(  1.0f,  32.0f,   -9.0f))));
+
+  // Straddling the left and near planes, and enclosing the whole frustum.
+  EXPECT_TRUE(frustum.intersects(makeBox(V3(-12.0f, -1.0f, -11.0f), V3(-9.0f, 1.0f, -9.0f))));
+  EXPECT_TRUE(frustum.intersects(makeBox(V3( -1.0f, -1.0f,  -2.0f), V3( 1.0f, 1.0f,  0.5f))));
+  EXPECT_TRUE(frustum.intersects(makeBox(V3(-500.0f, -500.0f, -500.0f), V3(500.0f, 500.0f, 500.0f))));
+}
+
+}
@@ -0,0 +1,169 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2013 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+/// \author agent
+/// \date   October 2026
+
+#include <batch-testing/GlobalGTestEnv.hpp>
+#include <batch-testing/SpireTestFixture.hpp>
+#include "namespaces.h"
+
+#include "spire/src/Common.h"
+#include "spire/src/Hub.h"
+#include "spire/src/GLStateMan.h"
+#include "spire/src/BufferArena.h"
+
+using namespace spire;
+using namespace CPM_BATCH_TESTING_NS;
+
+namespace {
+
+/// Location of an allocation, as written by the arena.
+struct Location
+{
+  Location() : buffer(0), offset(0), allocation(nullptr) {}
+
+  GLuint                    buffer;
+  size_t                    offset;
+  BufferArena::Allocation*  allocation;
+};
+
+void allocate(BufferArena& arena, size_t size, Location& location)
+{
+  location.allocation = arena.allocate(size, &location.buffer, &location.offset);
+  ASSERT_NE(nullptr, location.allocation);
+}
+
+//------------------------------------------------------------------------------
+TEST_F(SpireTestFixture, TestBufferArena)
+{
+  // The fixture's context is current. The arena only needs the hub for its
+  // GL state and upload queue.
+  Hub hub(nullptr, std::vector<std::string>(), Interface::LogFunction());
+  BufferArena arena(hub, GL_ARRAY_BUFFER);
+
+  const size_t minSize = BufferArena::MinAllocationSize;
+  const size_t maxSize = BufferArena::MaxAllocationSize;
+  Location rejected;
+  EXPECT_EQ(nullptr, arena.allocate(16, &rejected.buffer, &rejected.offset));
+  arena.setEnabled(true);
+  EXPECT_EQ(nullptr, arena.allocate(0, &rejected.buffer, &rejected.offset));
+  EXPECT_EQ(nullptr, arena.allocate(maxSize + 1, &rejected.buffer, &rejected.offset));
+  EXPECT_EQ(0u, arena.getNumBlocks());
+
+  // Sizes are rounded up to power of two size classes.
+  Location a, b, c, d;
+  allocate(arena, 1, a);
+  allocate(arena, minSize + 1, b);
+  allocate(arena, minSize, c);
+  allocate(arena, maxSize, d);
+  EXPECT_EQ(1u, arena.getNumBlocks());
+  EXPECT_EQ(0u, a.offset);
+  EXPECT_EQ(minSize, b.offset);
+  EXPECT_EQ(3 * minSize, c.offset);
+  EXPECT_EQ(4 * minSize, d.offset);
+  EXPECT_EQ(a.buffer, d.buffer);
+  EXPECT_EQ(4 * minSize + maxSize, arena.getNumLiveBytes());
+
+  // Freed slots are handed out again to allocations of the same class.
+  arena.deallocate(a.allocation);
+  EXPECT_EQ(3 * minSize + maxSize, arena.getNumLiveBytes());
+  Location e, f;
+  allocate(arena, minSize / 2, e);
+  EXPECT_EQ(0u, e.offset);
+  allocate(arena, 2 * minSize, f);
+  EXPECT_EQ(4 * minSize + maxSize, f.offset);
+
+  // Deallocating 'b' moves the last allocation, 'f', into its place. 'f'
+  // must still be found when it is deallocated in turn.
+  arena.deallocate(b.allocation);
+  arena.deallocate(f.allocation);
+  EXPECT_EQ(2 * minSize + maxSize, arena.getNumLiveBytes());
+  Location g;
+  allocate(arena, 2 * minSize, g);
+  EXPECT_TRUE(g.offset == minSize || g.offset == 4 * minSize + maxSize);
+
+  // Fill a second block, then free most of it.
+  const size_t perBlock = BufferArena::BlockSize / maxSize;
+  std::vector<Location> large(perBlock);
+  for (auto it = large.begin(); it != large.end(); ++it)
+    allocate(arena, maxSize, *it);
+  EXPECT_EQ(2u, arena.getNumBlocks());
+  EXPECT_NE(d.buffer, large.back().buffer);
+  for (size_t i = 2; i < large.size(); ++i)
+    arena.deallocate(large[i].allocation);
+  large.resize(2);
+
+#ifdef SPIRE_USE_BUFFER_COPIES
+  // Tag each live allocation with a distinct byte so that moves can be
+  // followed.
+  std::vector<Location*> live = {&c, &d, &e, &g, &large[0], &large[1]};
+  GLStateMan& state = hub.getGLStateManager();
+  for (size_t i = 0; i < live.size(); ++i)
+  {
+    uint8_t tag = static_cast<uint8_t>(i + 1);
+    state.bindArrayBuffer(live[i]->buffer);
+    GL(glBufferSubData(GL_ARRAY_BUFFER, static_cast<GLintptr>(live[i]->offset), 1, &tag));
+  }
+
+  // Everything fits in one block. Live allocations move, largest first, and
+  // their owners see the new location.
+  size_t liveBytes = arena.getNumLiveBytes();
+  EXPECT_EQ(BufferArena::BlockSize, arena.compact());
+  EXPECT_EQ(1u, arena.getNumBlocks());
+  EXPECT_EQ(liveBytes, arena.getNumLiveBytes());
+  EXPECT_EQ(0u, arena.compact());
+
+  for (size_t i = 0; i < live.size(); ++i)
+  {
+    EXPECT_EQ(live[0]->buffer, live[i]->buffer);
+    for (size_t j = 0; j < i; ++j)
+      EXPECT_NE(live[j]->offset, live[i]->offset);
+
+    uint8_t tag = 0;
+    state.bindArrayBuffer(live[i]->buffer);
+    GL(glGetBufferSubData(GL_ARRAY_BUFFER, static_cast<GLintptr>(live[i]->offset), 1, &tag));
+    EXPECT_EQ(static_cast<uint8_t>(i + 1), tag);
+  }
+  EXPECT_GT(3 * maxSize, d.offset);
+  EXPECT_GT(3 * maxSize, large[0].offset);
+  EXPECT_GT(3 * maxSize, large[1].offset);
+  EXPECT_LE(3 * maxSize, c.offset);
+
+  // Slots freed before compacting are gone, new allocations follow the
+  // moved ones.
+  Location h;
+  allocate(arena, minSize, h);
+  EXPECT_EQ(3 * maxSize + 4 * minSize, h.offset);
+#else
+  EXPECT_EQ(0u, arena.compact());
+  EXPECT_EQ(2u, arena.getNumBlocks());
+#endif
+}
+
+} // namespace
@@ -0,0 +1,140 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2013 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+/// \author agent
+/// \date   October 2026
+
+#include <gtest/gtest.h>
+#include "namespaces.h"
+#include "spire/src/BufferUpdates.h"
+
+using namespace spire;
+
+namespace {
+
+/// 'size' bytes with value 'value'.
+std::vector<uint8_t> bytes(size_t size, uint8_t value)
+{
+  return std::vector<uint8_t>(size, value);
+}
+
+void add(BufferUpdates& updates, size_t offset, const std::vector<uint8_t>& data)
+{
+  updates.add(offset, data.data(), data.size());
+}
+
+/// Contents of the range starting at 'offset'.
+std::vector<uint8_t> range(const BufferUpdates& updates, size_t offset)
+{
+  auto it = updates.getRanges().find(offset);
+  if (it == updates.getRanges().end())
+    return std::vector<uint8_t>();
+  return it->second;
+}
+
+//------------------------------------------------------------------------------
+TEST(BufferUpdatesBasic, TestDisjoint)
+{
+  BufferUpdates updates;
+  EXPECT_TRUE(updates.empty());
+
+  add(updates, 10, bytes(4, 1));
+  add(updates, 0, bytes(4, 2));
+  add(updates, 20, bytes(0, 3));  // Empty updates are ignored.
+  EXPECT_EQ(2u, updates.getNumRanges());
+  EXPECT_EQ(8u, updates.getNumBytes());
+  EXPECT_EQ(bytes(4, 2), range(updates, 0));
+  EXPECT_EQ(bytes(4, 1), range(updates, 10));
+
+  updates.clear();
+  EXPECT_TRUE(updates.empty());
+  EXPECT_EQ(0u, updates.getNumBytes());
+}
+
+//------------------------------------------------------------------------------
+TEST(BufferUpdatesBasic, TestAdjacent)
+{
+  BufferUpdates updates;
+  add(updates, 4, bytes(4, 1));
+  add(updates, 8, bytes(4, 2));   // Touches the end.
+  add(updates, 0, bytes(4, 3));   // Touches the start.
+  EXPECT_EQ(1u, updates.getNumRanges());
+  EXPECT_EQ(12u, updates.getNumBytes());
+
+  std::vector<uint8_t> expected = {3, 3, 3, 3, 1, 1, 1, 1, 2, 2, 2, 2};
+  EXPECT_EQ(expected, range(updates, 0));
+}
+
+//------------------------------------------------------------------------------
+TEST(BufferUpdatesBasic, TestOverlapping)
+{
+  BufferUpdates updates;
+  add(updates, 0, bytes(6, 1));
+  add(updates, 4, bytes(6, 2));   // Overlaps the end, later update wins.
+  EXPECT_EQ(1u, updates.getNumRanges());
+  EXPECT_EQ(10u, updates.getNumBytes());
+
+  std::vector<uint8_t> expected = {1, 1, 1, 1, 2, 2, 2, 2, 2, 2};
+  EXPECT_EQ(expected, range(updates, 0));
+
+  // Bridging two ranges merges all three.
+  add(updates, 14, bytes(2, 3));
+  EXPECT_EQ(2u, updates.getNumRanges());
+  add(updates, 9, bytes(6, 4));
+  EXPECT_EQ(1u, updates.getNumRanges());
+  EXPECT_EQ(16u, updates.getNumBytes());
+
+  expected = {1, 1, 1, 1, 2, 2, 2, 2, 2, 4, 4, 4, 4, 4, 4, 3};
+  EXPECT_EQ(expected, range(updates, 0));
+}
+
+//------------------------------------------------------------------------------
+TEST(BufferUpdatesBasic, TestContained)
+{
+  BufferUpdates updates;
+  add(updates, 0, bytes(8, 1));
+  add(updates, 2, bytes(3, 2));   // Inside an existing range.
+  EXPECT_EQ(1u, updates.getNumRanges());
+  EXPECT_EQ(8u, updates.getNumBytes());
+
+  std::vector<uint8_t> expected = {1, 1, 2, 2, 2, 1, 1, 1};
+  EXPECT_EQ(expected, range(updates, 0));
+
+  // Covering several ranges replaces them.
+  add(updates, 20, bytes(2, 3));
+  add(updates, 30, bytes(2, 4));
+  EXPECT_EQ(3u, updates.getNumRanges());
+  EXPECT_EQ(12u, updates.getNumBytes());
+  add(updates, 16, bytes(20, 5));
+  EXPECT_EQ(2u, updates.getNumRanges());
+  EXPECT_EQ(28u, updates.getNumBytes());
+  EXPECT_EQ(expected, range(updates, 0));
+  EXPECT_EQ(bytes(20, 5), range(updates, 16));
+}
+
+} // namespace
@@ -0,0 +1,242 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2013 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+/// \author agent
+/// \date   October 2026
+
+#include <cstring>
+
+#include <batch-testing/GlobalGTestEnv.hpp>
+#include <batch-testing/SpireTestFixture.hpp>
+#include "namespaces.h"
+
+#include "spire/src/Common.h"
+#include "spire/src/Exceptions.h"
+
+#include "TestCamera.h"
+
+using namespace spire;
+using namespace CPM_BATCH_TESTING_NS;
+
+namespace {
+
+#ifdef SPIRE_USE_UBO
+//------------------------------------------------------------------------------
+TEST_F(SpireTestFixture, TestGlobalUniformBlockLayout)
+{
+  std::unique_ptr<TestCamera> myCamera = std::unique_ptr<TestCamera>(new TestCamera);
+
+  // Same geometry as TestRenderPass. Every uniform used by the shader lives in
+  // the global block, the result should be identical to TestTriangle.
+  std::vector<float> vboData = 
+  {
+    -1.0f,  1.0f,  0.0f,
+     1.0f,  1.0f,  0.0f,
+    -1.0f, -1.0f,  0.0f,
+     1.0f, -1.0f,  0.0f
+  };
+  std::vector<std::string> attribNames = {"aPos"};
+
+  std::vector<uint16_t> iboData =
+  {
+    0, 1, 2, 3
+  };
+  Interface::IBO_TYPE iboType = Interface::IBO_16BIT;
+
+  std::string vbo1 = "vbo1";
+  std::string ibo1 = "ibo1";
+  mSpire->addVBO(vbo1, reinterpret_cast<uint8_t*>(&vboData[0]), vboData.size() * sizeof(float), attribNames);
+  mSpire->addIBO(ibo1, reinterpret_cast<uint8_t*>(&iboData[0]), iboData.size() * sizeof(uint16_t), iboType);
+
+  std::string shader1 = "GlobalBlock";
+  mSpire->addPersistentShader(
+      shader1, 
+      { std::make_tuple("GlobalBlock.vsh", Interface::VERTEX_SHADER), 
+        std::make_tuple("GlobalBlock.fsh", Interface::FRAGMENT_SHADER),
+      });
+
+  std::string obj1 = "obj1";
+  mSpire->addObject(obj1);
+  mSpire->addPassToObject(obj1, shader1, vbo1, ibo1, Interface::TRIANGLE_STRIP);
+
+  M44 projIVObject = myCamera->getWorldToProjection();
+  V4  color(1.0f, 0.0f, 0.0f, 1.0f);
+  mSpire->addGlobalUniform("uOffset", V3(0.0f, 0.0f, 0.0f));
+  mSpire->addGlobalUniform("uScale", 1.0f);
+  mSpire->addGlobalUniform("uProjIVObject", projIVObject);
+  mSpire->addGlobalUniform("uGlobalColor", color);
+
+  beginFrame();
+  mSpire->renderObject(obj1);
+
+  // Spire leaves the last program it used current.
+  GLint currentProgram = 0;
+  GL(glGetIntegerv(GL_CURRENT_PROGRAM, &currentProgram));
+  GLuint program = static_cast<GLuint>(currentProgram);
+  ASSERT_NE(0u, program);
+
+  GLuint blockIndex = glGetUniformBlockIndex(program, "SpireGlobals");
+  ASSERT_NE(GL_INVALID_INDEX, blockIndex);
+
+  // std140: the vec3 is padded to 16 bytes unless a scalar fills its tail,
+  // matrix columns are 16 bytes apart and start on a 16 byte boundary.
+  GLint blockSize = 0;
+  GL(glGetActiveUniformBlockiv(program, blockIndex, GL_UNIFORM_BLOCK_DATA_SIZE, &blockSize));
+  EXPECT_EQ(96, blockSize);
+
+  const GLchar* names[] = {"uOffset", "uScale", "uProjIVObject", "uGlobalColor"};
+  GLuint indices[4];
+  GLint  offsets[4];
+  GLint  matrixStrides[4];
+  GL(glGetUniformIndices(program, 4, names, indices));
+  GL(glGetActiveUniformsiv(program, 4, indices, GL_UNIFORM_OFFSET, offsets));
+  GL(glGetActiveUniformsiv(program, 4, indices, GL_UNIFORM_MATRIX_STRIDE, matrixStrides));
+  EXPECT_EQ(0,  offsets[0]);
+  EXPECT_EQ(12, offsets[1]);
+  EXPECT_EQ(16, offsets[2]);
+  EXPECT_EQ(80, offsets[3]);
+  EXPECT_EQ(16, matrixStrides[2]);
+
+  // Read back the block contents uploaded by spire and check every member
+  // landed at the offset reported by GL.
+  GLint buffer = 0;
+  GL(glGetIntegeri_v(GL_UNIFORM_BUFFER_BINDING, 0, &buffer));
+  ASSERT_NE(0, buffer);
+
+  std::vector<uint8_t> contents(static_cast<size_t>(blockSize));
+  GL(glBindBuffer(GL_UNIFORM_BUFFER, static_cast<GLuint>(buffer)));
+  GL(glGetBufferSubData(GL_UNIFORM_BUFFER, 0, blockSize, &contents[0]));
+
+  float scale = 0.0f;
+  std::memcpy(&scale, &contents[static_cast<size_t>(offsets[1])], sizeof(float));
+  EXPECT_EQ(1.0f, scale);
+  for (int c = 0; c < 4; ++c)
+  {
+    size_t column = static_cast<size_t>(offsets[2] + c * matrixStrides[2]);
+    EXPECT_EQ(0, std::memcmp(&contents[column], &projIVObject[c][0], 4 * sizeof(float)));
+  }
+  EXPECT_EQ(0, std::memcmp(&contents[static_cast<size_t>(offsets[3])], &color[0], 4 * sizeof(float)));
+
+  compareFBOWithExistingFile(
+      "stuTriangle.png",
+      TEST_IMAGE_OUTPUT_DIR,
+      TEST_IMAGE_COMPARE_DIR,
+      TEST_PERCEPTUAL_COMPARE_BINARY,
+      50);
+}
+
+//------------------------------------------------------------------------------
+TEST_F(SpireTestFixture, TestGlobalUniformBlockCulling)
+{
+  std::unique_ptr<TestCamera> myCamera = std::unique_ptr<TestCamera>(new TestCamera);
+
+  // The quad of TestTriangle, and the same quad far outside of the frustum.
+  std::vector<float> vboData = 
+  {
+    -1.0f,  1.0f,  0.0f,
+     1.0f,  1.0f,  0.0f,
+    -1.0f, -1.0f,  0.0f,
+     1.0f, -1.0f,  0.0f
+  };
+  std::vector<float> offscreenData = 
+  {
+    99.0f,  1.0f,  0.0f,
+   101.0f,  1.0f,  0.0f,
+    99.0f, -1.0f,  0.0f,
+   101.0f, -1.0f,  0.0f
+  };
+  std::vector<std::string> attribNames = {"aPos"};
+
+  std::vector<uint16_t> iboData =
+  {
+    0, 1, 2, 3
+  };
+  Interface::IBO_TYPE iboType = Interface::IBO_16BIT;
+
+  std::string vbo1 = "vbo1";
+  std::string vbo2 = "vbo2";
+  std::string ibo1 = "ibo1";
+  mSpire->addVBO(vbo1, reinterpret_cast<uint8_t*>(&vboData[0]), vboData.size() * sizeof(float), attribNames);
+  mSpire->addVBO(vbo2, reinterpret_cast<uint8_t*>(&offscreenData[0]), offscreenData.size() * sizeof(float), attribNames);
+  mSpire->addIBO(ibo1, reinterpret_cast<uint8_t*>(&iboData[0]), iboData.size() * sizeof(uint16_t), iboType);
+
+  std::string shader1 = "GlobalBlock";
+  mSpire->addPersistentShader(
+      shader1, 
+      { std::make_tuple("GlobalBlock.vsh", Interface::VERTEX_SHADER), 
+        std::make_tuple("GlobalBlock.fsh", Interface::FRAGMENT_SHADER),
+      });
+
+  std::string obj1 = "obj1";
+  std::string obj2 = "obj2";
+  mSpire->addObject(obj1);
+  mSpire->addPassToObject(obj1, shader1, vbo1, ibo1, Interface::TRIANGLE_STRIP);
+  mSpire->addObject(obj2);
+  mSpire->addPassToObject(obj2, shader1, vbo2, ibo1, Interface::TRIANGLE_STRIP);
+
+  mSpire->addGlobalUniform("uOffset", V3(0.0f, 0.0f, 0.0f));
+  mSpire->addGlobalUniform("uScale", 1.0f);
+  mSpire->addGlobalUniform("uProjIVObject", myCamera->getWorldToProjection());
+  mSpire->addGlobalUniform("uGlobalColor", V4(1.0f, 0.0f, 0.0f, 1.0f));
+
+  // The culling uniform is only a member of the block, the programs do not
+  // list it among their uniforms.
+  mSpire->setCullingUniform("uProjIVObject");
+
+  beginFrame();
+  mSpire->renderPass();
+  EXPECT_EQ(1u, mSpire->getNumCulledPasses());
+  EXPECT_EQ(1u, mSpire->getNumRenderedPasses());
+
+  compareFBOWithExistingFile(
+      "stuTriangle.png",
+      TEST_IMAGE_OUTPUT_DIR,
+      TEST_IMAGE_COMPARE_DIR,
+      TEST_PERCEPTUAL_COMPARE_BINARY,
+      50);
+}
+
+//------------------------------------------------------------------------------
+TEST_F(SpireTestFixture, TestGlobalUniformBlockOverlap)
+{
+  mSpire->addPersistentShader(
+      "GlobalBlock", 
+      { std::make_tuple("GlobalBlock.vsh", Interface::VERTEX_SHADER), 
+        std::make_tuple("GlobalBlock.fsh", Interface::FRAGMENT_SHADER),
+      });
+
+  // uOpacity would share its bytes in the block with uScale.
+  EXPECT_THROW(mSpire->addPersistentShader(
+      "GlobalBlockOverlap", 
+      { std::make_tuple("GlobalBlockOverlap.vsh", Interface::VERTEX_SHADER), 
+        std::make_tuple("GlobalBlock.fsh", Interface::FRAGMENT_SHADER),
+      }), GLError);
+}
+#endif
+
+}
@@ -0,0 +1,145 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2013 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+/// \author agent
+/// \date   October 2026
+
+#include <batch-testing/GlobalGTestEnv.hpp>
+#include <batch-testing/SpireTestFixture.hpp>
+#include "namespaces.h"
+
+#include "spire/src/Common.h"
+#include "spire/src/Hub.h"
+#include "spire/src/GLCaps.h"
+#include "spire/src/InterfaceImplementation.h"
+#include "spire/src/ShaderUniformStateManTemplates.h"
+
+#include "TestCamera.h"
+
+using namespace spire;
+using namespace CPM_BATCH_TESTING_NS;
+
+namespace {
+
+//------------------------------------------------------------------------------
+TEST_F(SpireTestFixture, TestInstancedDraws)
+{
+  std::unique_ptr<TestCamera> myCamera = std::unique_ptr<TestCamera>(new TestCamera);
+
+  // The top left quadrant of the quad drawn in TestTriangle. The instances
+  // move it to every quadrant.
+  std::vector<float> vboData = 
+  {
+    -1.0f,  1.0f,  0.0f,
+     0.0f,  1.0f,  0.0f,
+    -1.0f,  0.0f,  0.0f,
+     0.0f,  0.0f,  0.0f
+  };
+  std::vector<float> instanceData =
+  {
+     0.0f,  0.0f,  0.0f,
+     1.0f,  0.0f,  0.0f,
+     0.0f, -1.0f,  0.0f,
+     1.0f, -1.0f,  0.0f
+  };
+  std::vector<uint16_t> iboData =
+  {
+    0, 1, 2, 3
+  };
+
+  GLint viewport[4];
+  GL(glGetIntegerv(GL_VIEWPORT, viewport));
+  std::vector<uint8_t> images[2];
+
+  // The draw path is picked when passes are set up, so each run uses a Hub of
+  // its own. The first run uses glDrawElementsInstanced if the context
+  // supports it, the second hides glVertexAttribDivisor and draws every
+  // instance separately.
+  for (size_t run = 0; run < 2; ++run)
+  {
+    Hub hub(nullptr, std::vector<std::string>(), Interface::LogFunction());
+    if (run == 1)
+      hub.getGLCaps().limitVersion(3, 2);
+    EXPECT_FALSE(run == 1 && hub.getGLCaps().hasInstancedArrays());
+
+    InterfaceImplementation& impl = *hub.getInterfaceImpl();
+    impl.addShaderAttribute("aPos", 3, false, sizeof(float) * 3, Interface::TYPE_FLOAT, 0);
+    impl.addShaderAttribute("aInstanceOffset", 3, false, sizeof(float) * 3, Interface::TYPE_FLOAT, 1);
+
+    std::shared_ptr<std::vector<uint8_t>> rawVBO(new std::vector<uint8_t>(
+        reinterpret_cast<uint8_t*>(&vboData[0]),
+        reinterpret_cast<uint8_t*>(&vboData[0]) + vboData.size() * sizeof(float)));
+    std::shared_ptr<std::vector<uint8_t>> rawInstances(new std::vector<uint8_t>(
+        reinterpret_cast<uint8_t*>(&instanceData[0]),
+        reinterpret_cast<uint8_t*>(&instanceData[0]) + instanceData.size() * sizeof(float)));
+    std::shared_ptr<std::vector<uint8_t>> rawIBO(new std::vector<uint8_t>(
+        reinterpret_cast<uint8_t*>(&iboData[0]),
+        reinterpret_cast<uint8_t*>(&iboData[0]) + iboData.size() * sizeof(uint16_t)));
+
+    impl.addVBO("vbo1", rawVBO, {"aPos"}, Interface::USAGE_STATIC);
+    impl.addVBO("instances", rawInstances, {"aInstanceOffset"}, Interface::USAGE_STATIC);
+    impl.addIBO("ibo1", rawIBO, Interface::IBO_16BIT, Interface::USAGE_STATIC);
+
+    std::string shader1 = "InstancedColor";
+    impl.addPersistentShader(
+        shader1, 
+        { std::make_tuple("InstancedColor.vsh", Interface::VERTEX_SHADER), 
+          std::make_tuple("UniformColor.fsh", Interface::FRAGMENT_SHADER),
+        });
+    impl.addGlobalUniformConcrete("uProjIVObject",
+        std::shared_ptr<AbstractUniformStateItem>(
+            new UniformStateItem<M44>(myCamera->getWorldToProjection())));
+
+    std::string pass1 = "pass1";
+    std::string obj1 = "obj1";
+    impl.addObject(obj1);
+    impl.addPassToObject(obj1, shader1, "vbo1", "ibo1", Interface::TRIANGLE_STRIP, pass1, "");
+    impl.addObjectPassUniformConcrete(obj1, "uColor",
+        std::shared_ptr<AbstractUniformStateItem>(
+            new UniformStateItem<V4>(V4(1.0f, 0.0f, 0.0f, 1.0f))), pass1);
+    impl.setObjectPassInstanceVBO(obj1, "instances", pass1);
+
+    beginFrame();
+    impl.renderPass(pass1);
+    EXPECT_EQ(1u, impl.getNumRenderedPasses());
+
+    images[run].resize(static_cast<size_t>(viewport[2]) * static_cast<size_t>(viewport[3]) * 4);
+    GL(glReadPixels(viewport[0], viewport[1], viewport[2], viewport[3],
+                    GL_RGBA, GL_UNSIGNED_BYTE, &images[run][0]));
+  }
+  EXPECT_TRUE(images[0] == images[1]);
+
+  compareFBOWithExistingFile(
+      "stuTriangle.png",
+      TEST_IMAGE_OUTPUT_DIR,
+      TEST_IMAGE_COMPARE_DIR,
+      TEST_PERCEPTUAL_COMPARE_BINARY,
+      50);
+}
+
+}
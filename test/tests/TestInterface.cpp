@@ -29,6 +29,10 @@
 /// \author James Hughes
 /// \date   February 2013
 
+#include <cstring>
+#include <chrono>
+#include <thread>
+
 #include <batch-testing/GlobalGTestEnv.hpp>
 #include <batch-testing/SpireTestFixture.hpp>
 #include "namespaces.h"
@@ -36,6 +40,8 @@
 #include "spire/src/Common.h"
 #include "spire/src/Exceptions.h"
 #include "spire/src/SpireObject.h"
+#include "spire/src/InterfaceImplementation.h"
+#include "spire/src/UploadQueue.h"
 #include "spire/src/FileUtil.h"
 
 #include "TestCommonUniforms.h"
@@ -155,6 +161,68 @@ TEST(SpireNoFixtureTests, TestSR5AssetLoader)
     verifySSUInt16(i, iboStream);
 }
 
+//------------------------------------------------------------------------------
+TEST(SpireNoFixtureTests, TestSR5MultiMeshLoader)
+{
+  auto writeUInt32 = [](std::ostream& ss, uint32_t i)
+  { ss.write(reinterpret_cast<const char*>(&i), sizeof(uint32_t)); };
+
+  // Mesh 'm' has m + 1 vertices and m faces, alternating triangles and quads.
+  const uint32_t numMeshes = 17;
+  std::ostringstream sRaw;
+  sRaw.write("SCR5", 4);
+  writeUInt32(sRaw, numMeshes);
+  for (uint32_t m = 0; m < numMeshes; ++m)
+  {
+    writeUInt32(sRaw, m + 1);
+    for (uint32_t v = 0; v < 6 * (m + 1); ++v)
+    {
+      float value = static_cast<float>(m * 100 + v);
+      sRaw.write(reinterpret_cast<const char*>(&value), sizeof(float));
+    }
+
+    writeUInt32(sRaw, m);
+    for (uint32_t f = 0; f < m; ++f)
+    {
+      uint8_t count = (f % 2 == 0) ? 3 : 4;
+      sRaw.write(reinterpret_cast<const char*>(&count), sizeof(uint8_t));
+      for (uint32_t i = 0; i < (count == 3 ? 3u : 6u); ++i)
+      {
+        uint16_t index = static_cast<uint16_t>(i % (m + 1));
+        sRaw.write(reinterpret_cast<const char*>(&index), sizeof(uint16_t));
+      }
+    }
+  }
+  writeUInt32(sRaw, 0);
+
+  for (size_t numThreads : {1, 4})
+  {
+    std::istringstream ss(sRaw.str());
+    std::vector<Interface::AssetMesh> meshes =
+        Interface::loadProprietarySR5AssetFileMeshes(ss, numThreads);
+    ASSERT_EQ(numMeshes, meshes.size());
+
+    for (uint32_t m = 0; m < numMeshes; ++m)
+    {
+      const Interface::AssetMesh& mesh = meshes[m];
+      ASSERT_EQ(6 * (m + 1) * sizeof(float), mesh.vbo.size());
+      float first;
+      std::memcpy(&first, mesh.vbo.data(), sizeof(float));
+      EXPECT_FLOAT_EQ(static_cast<float>(m * 100), first);
+
+      size_t numTriangles = m / 2 + 2 * (m / 2) + (m % 2);
+      EXPECT_EQ(numTriangles, mesh.numTriangles);
+      EXPECT_EQ(numTriangles * 3 * sizeof(uint16_t), mesh.ibo.size());
+    }
+  }
+
+  // Truncated files are rejected.
+  std::string truncated = sRaw.str();
+  truncated.resize(truncated.size() / 2);
+  std::istringstream ss(truncated);
+  EXPECT_THROW(Interface::loadProprietarySR5AssetFileMeshes(ss), std::invalid_argument);
+}
+
 //------------------------------------------------------------------------------
 TEST_F(SpireTestFixture, TestPublicInterface)
 {
@@ -378,6 +446,575 @@ TEST_F(SpireTestFixture, TestTriangle)
   /// \todo Test pass order using hasPassRenderingOrder on the object.
 }
 
+//------------------------------------------------------------------------------
+TEST_F(SpireTestFixture, TestRenderPass)
+{
+  std::unique_ptr<TestCamera> myCamera = std::unique_ptr<TestCamera>(new TestCamera);
+
+  // Renders two objects sharing the same shader, VBO, and IBO through the
+  // sorted render queue. The result should be identical to TestTriangle.
+  std::vector<float> vboData = 
+  {
+    -1.0f,  1.0f,  0.0f,
+     1.0f,  1.0f,  0.0f,
+    -1.0f, -1.0f,  0.0f,
+     1.0f, -1.0f,  0.0f
+  };
+  std::vector<std::string> attribNames = {"aPos"};
+
+  std::vector<uint16_t> iboData =
+  {
+    0, 1, 2, 3
+  };
+  Interface::IBO_TYPE iboType = Interface::IBO_16BIT;
+
+  std::string vbo1 = "vbo1";
+  std::string ibo1 = "ibo1";
+  mSpire->addVBO(vbo1, reinterpret_cast<uint8_t*>(&vboData[0]), vboData.size() * sizeof(float), attribNames);
+  mSpire->addIBO(ibo1, reinterpret_cast<uint8_t*>(&iboData[0]), iboData.size() * sizeof(uint16_t), iboType);
+
+  std::string shader1 = "UniformColor";
+  mSpire->addPersistentShader(
+      shader1, 
+      { std::make_tuple("UniformColor.vsh", Interface::VERTEX_SHADER), 
+        std::make_tuple("UniformColor.fsh", Interface::FRAGMENT_SHADER),
+      });
+
+  std::string pass1 = "pass1";
+  std::string obj1 = "obj1";
+  std::string obj2 = "obj2";
+  std::string obj3 = "obj3";
+  mSpire->addObject(obj1);
+  mSpire->addObject(obj2);
+  mSpire->addObject(obj3);
+  mSpire->addPassToObject(obj1, shader1, vbo1, ibo1, Interface::TRIANGLE_STRIP, pass1);
+  mSpire->addPassToObject(obj2, shader1, vbo1, ibo1, Interface::TRIANGLE_STRIP, pass1);
+
+  // obj3 does not have pass1 and should not be rendered.
+  mSpire->addPassToObject(obj3, shader1, vbo1, ibo1, Interface::TRIANGLE_STRIP);
+
+  mSpire->removeIBO(ibo1);
+  mSpire->removeVBO(vbo1);
+
+  mSpire->addGlobalUniform("uProjIVObject", myCamera->getWorldToProjection());
+  mSpire->addObjectPassUniform(obj1, "uColor", V4(1.0f, 0.0f, 0.0f, 1.0f), pass1);
+  mSpire->addObjectPassUniform(obj2, "uColor", V4(1.0f, 0.0f, 0.0f, 1.0f), pass1);
+  mSpire->addObjectPassUniform(obj3, "uColor", V4(0.0f, 0.0f, 1.0f, 1.0f));
+
+  // Start from unknown GL state so that every binding made by obj1 is issued.
+  beginFrame();
+  mSpire->invalidateGLState();
+  mSpire->resetGLStateCounters();
+  mSpire->renderPass(pass1);
+
+  // obj2 shares its program, VBO, and IBO with obj1.
+#ifdef SPIRE_USE_VAO
+  // Issued: program, obj1's VAO, obj2's VAO. Skipped: obj2's program.
+  EXPECT_EQ(3u, mSpire->getNumGLStateCallsIssued());
+  EXPECT_EQ(1u, mSpire->getNumGLStateCallsSkipped());
+#else
+  // Issued: program, VBO, enable aPos, IBO, and the final disable of aPos.
+  // Skipped: obj2's program and IBO. obj2's attribute pointers are not
+  // re-specified at all.
+  EXPECT_EQ(5u, mSpire->getNumGLStateCallsIssued());
+  EXPECT_EQ(2u, mSpire->getNumGLStateCallsSkipped());
+#endif
+
+  // Rendering a pass that was never added is a no-op, and does not add it.
+  mSpire->resetGLStateCounters();
+  mSpire->renderPass("nonexistant");
+  mSpire->renderObject(obj1, "nonexistant");
+  EXPECT_EQ(0u, mSpire->getNumGLStateCallsIssued());
+  EXPECT_EQ(0u, mSpire->getNumGLStateCallsSkipped());
+  EXPECT_THROW(mSpire->getPassHandle("nonexistant"), std::out_of_range);
+
+  // Passes added without objects exist, but render nothing.
+  PassHandle emptyPass = mSpire->addPass("empty");
+  EXPECT_EQ(emptyPass, mSpire->getPassHandle("empty"));
+  EXPECT_EQ(mSpire->getPassHandle(pass1), mSpire->addPass(pass1));
+  mSpire->renderPass(emptyPass);
+  EXPECT_EQ(0u, mSpire->getNumGLStateCallsIssued());
+  EXPECT_EQ(0u, mSpire->getNumGLStateCallsSkipped());
+
+  compareFBOWithExistingFile(
+      "stuTriangle.png",
+      TEST_IMAGE_OUTPUT_DIR,
+      TEST_IMAGE_COMPARE_DIR,
+      TEST_PERCEPTUAL_COMPARE_BINARY,
+      50);
+}
+
+//------------------------------------------------------------------------------
+TEST_F(SpireTestFixture, TestRenderListRebuild)
+{
+  std::unique_ptr<TestCamera> myCamera = std::unique_ptr<TestCamera>(new TestCamera);
+
+  std::vector<float> vboData = 
+  {
+    -1.0f,  1.0f,  0.0f,
+     1.0f,  1.0f,  0.0f,
+    -1.0f, -1.0f,  0.0f,
+     1.0f, -1.0f,  0.0f
+  };
+  std::vector<std::string> attribNames = {"aPos"};
+
+  std::vector<uint16_t> iboData =
+  {
+    0, 1, 2, 3
+  };
+  Interface::IBO_TYPE iboType = Interface::IBO_16BIT;
+
+  std::string vbo1 = "vbo1";
+  std::string ibo1 = "ibo1";
+  mSpire->addVBO(vbo1, reinterpret_cast<uint8_t*>(&vboData[0]), vboData.size() * sizeof(float), attribNames);
+  mSpire->addIBO(ibo1, reinterpret_cast<uint8_t*>(&iboData[0]), iboData.size() * sizeof(uint16_t), iboType);
+
+  std::string shader1 = "UniformColor";
+  mSpire->addPersistentShader(
+      shader1, 
+      { std::make_tuple("UniformColor.vsh", Interface::VERTEX_SHADER), 
+        std::make_tuple("UniformColor.fsh", Interface::FRAGMENT_SHADER),
+      });
+  mSpire->addGlobalUniform("uProjIVObject", myCamera->getWorldToProjection());
+
+  std::string pass1 = "pass1";
+  std::string pass2 = "pass2";
+  std::string obj1 = "obj1";
+  std::string obj2 = "obj2";
+  V4 red(1.0f, 0.0f, 0.0f, 1.0f);
+  mSpire->addObject(obj1);
+  mSpire->addPassToObject(obj1, shader1, vbo1, ibo1, Interface::TRIANGLE_STRIP, pass1);
+  mSpire->addObjectPassUniform(obj1, "uColor", red, pass1);
+
+  beginFrame();
+
+  // The first render builds the list, an unchanged scene replays it.
+  size_t builds = mSpire->getNumRenderListBuilds();
+  mSpire->renderPass(pass1);
+  EXPECT_EQ(builds + 1, mSpire->getNumRenderListBuilds());
+  EXPECT_EQ(1u, mSpire->getNumRenderedPasses());
+
+  mSpire->renderPass(pass1);
+  EXPECT_EQ(builds + 1, mSpire->getNumRenderListBuilds());
+  EXPECT_EQ(1u, mSpire->getNumRenderedPasses());
+
+  // Changing uniforms does not change the scene.
+  mSpire->addObjectPassUniform(obj1, "uColor", red, pass1);
+  mSpire->renderPass(pass1);
+  EXPECT_EQ(builds + 1, mSpire->getNumRenderListBuilds());
+
+  // Adding an object.
+  mSpire->addObject(obj2);
+  mSpire->addPassToObject(obj2, shader1, vbo1, ibo1, Interface::TRIANGLE_STRIP, pass1);
+  mSpire->addObjectPassUniform(obj2, "uColor", red, pass1);
+  mSpire->renderPass(pass1);
+  EXPECT_EQ(builds + 2, mSpire->getNumRenderListBuilds());
+  EXPECT_EQ(2u, mSpire->getNumRenderedPasses());
+
+  // Adding a pass invalidates the lists of every pass. Compiling the list
+  // ahead of time leaves nothing to rebuild in renderPass.
+  mSpire->addPassToObject(obj2, shader1, vbo1, ibo1, Interface::TRIANGLE_STRIP, pass2);
+  mSpire->addObjectPassUniform(obj2, "uColor", red, pass2);
+  mSpire->compileRenderList(mSpire->getPassHandle(pass1));
+  EXPECT_EQ(builds + 3, mSpire->getNumRenderListBuilds());
+  mSpire->renderPass(pass1);
+  EXPECT_EQ(builds + 3, mSpire->getNumRenderListBuilds());
+  EXPECT_EQ(2u, mSpire->getNumRenderedPasses());
+  mSpire->renderPass(pass2);
+  EXPECT_EQ(builds + 4, mSpire->getNumRenderListBuilds());
+  EXPECT_EQ(1u, mSpire->getNumRenderedPasses());
+
+  // Removing a pass.
+  mSpire->removePassFromObject(obj2, pass1);
+  mSpire->renderPass(pass1);
+  EXPECT_EQ(builds + 5, mSpire->getNumRenderListBuilds());
+  EXPECT_EQ(1u, mSpire->getNumRenderedPasses());
+
+  // Removing an object.
+  mSpire->removeObject(obj1);
+  mSpire->renderPass(pass1);
+  EXPECT_EQ(builds + 6, mSpire->getNumRenderListBuilds());
+  EXPECT_EQ(0u, mSpire->getNumRenderedPasses());
+
+  // obj2's remaining pass is unaffected.
+  beginFrame();
+  mSpire->renderPass(pass2);
+  EXPECT_EQ(builds + 7, mSpire->getNumRenderListBuilds());
+  EXPECT_EQ(1u, mSpire->getNumRenderedPasses());
+
+  compareFBOWithExistingFile(
+      "stuTriangle.png",
+      TEST_IMAGE_OUTPUT_DIR,
+      TEST_IMAGE_COMPARE_DIR,
+      TEST_PERCEPTUAL_COMPARE_BINARY,
+      50);
+}
+
+//------------------------------------------------------------------------------
+TEST_F(SpireTestFixture, TestUploadQueueResidency)
+{
+  std::unique_ptr<TestCamera> myCamera = std::unique_ptr<TestCamera>(new TestCamera);
+
+  // Only the first 4 vertices are drawn. The rest pads the VBO so that it
+  // takes two chunks to upload.
+  std::vector<float> vboData = 
+  {
+    -1.0f,  1.0f,  0.0f,
+     1.0f,  1.0f,  0.0f,
+    -1.0f, -1.0f,  0.0f,
+     1.0f, -1.0f,  0.0f
+  };
+  vboData.resize(UploadQueue::ChunkSize / sizeof(float) + 3, 0.0f);
+  std::vector<std::string> attribNames = {"aPos"};
+
+  std::vector<uint16_t> iboData =
+  {
+    0, 1, 2, 3
+  };
+  Interface::IBO_TYPE iboType = Interface::IBO_16BIT;
+
+  // With a negligible budget, every call to processUploads uploads a single
+  // chunk.
+  mSpire->setUploadBudget(1.0e-9);
+
+  std::string vbo1 = "vbo1";
+  std::string ibo1 = "ibo1";
+  mSpire->addVBO(vbo1, reinterpret_cast<uint8_t*>(&vboData[0]), vboData.size() * sizeof(float), attribNames);
+  mSpire->addIBO(ibo1, reinterpret_cast<uint8_t*>(&iboData[0]), iboData.size() * sizeof(uint16_t), iboType);
+  EXPECT_EQ(2u, mSpire->getNumPendingUploads());
+  EXPECT_EQ(vboData.size() * sizeof(float) + iboData.size() * sizeof(uint16_t),
+            mSpire->getNumPendingUploadBytes());
+
+  std::string shader1 = "UniformColor";
+  mSpire->addPersistentShader(
+      shader1, 
+      { std::make_tuple("UniformColor.vsh", Interface::VERTEX_SHADER), 
+        std::make_tuple("UniformColor.fsh", Interface::FRAGMENT_SHADER),
+      });
+  mSpire->addGlobalUniform("uProjIVObject", myCamera->getWorldToProjection());
+
+  std::string pass1 = "pass1";
+  std::string obj1 = "obj1";
+  mSpire->addObject(obj1);
+  mSpire->addPassToObject(obj1, shader1, vbo1, ibo1, Interface::TRIANGLE_STRIP, pass1);
+  mSpire->addObjectPassUniform(obj1, "uColor", V4(1.0f, 0.0f, 0.0f, 1.0f), pass1);
+
+  // Nothing is resident yet.
+  beginFrame();
+  mSpire->renderPass(pass1);
+  EXPECT_EQ(0u, mSpire->getNumRenderedPasses());
+
+  // First chunk of the VBO.
+  EXPECT_EQ(UploadQueue::ChunkSize, mSpire->processUploads());
+  EXPECT_EQ(2u, mSpire->getNumPendingUploads());
+  beginFrame();
+  mSpire->renderPass(pass1);
+  EXPECT_EQ(0u, mSpire->getNumRenderedPasses());
+
+  // Rest of the VBO. The IBO is still pending.
+  EXPECT_EQ(3 * sizeof(float), mSpire->processUploads());
+  EXPECT_EQ(1u, mSpire->getNumPendingUploads());
+  beginFrame();
+  mSpire->renderPass(pass1);
+  EXPECT_EQ(0u, mSpire->getNumRenderedPasses());
+
+  // The IBO completes the pass.
+  EXPECT_EQ(iboData.size() * sizeof(uint16_t), mSpire->processUploads());
+  EXPECT_EQ(0u, mSpire->getNumPendingUploads());
+  EXPECT_EQ(0u, mSpire->getNumPendingUploadBytes());
+  beginFrame();
+  mSpire->renderPass(pass1);
+  EXPECT_EQ(1u, mSpire->getNumRenderedPasses());
+
+  compareFBOWithExistingFile(
+      "stuTriangle.png",
+      TEST_IMAGE_OUTPUT_DIR,
+      TEST_IMAGE_COMPARE_DIR,
+      TEST_PERCEPTUAL_COMPARE_BINARY,
+      50);
+}
+
+//------------------------------------------------------------------------------
+TEST_F(SpireTestFixture, TestUpdateVBO)
+{
+  std::unique_ptr<TestCamera> myCamera = std::unique_ptr<TestCamera>(new TestCamera);
+
+  // Starts out as a smaller quad, updateVBO grows it to the quad drawn in
+  // TestTriangle.
+  std::vector<float> vboData = 
+  {
+    -0.5f,  0.5f,  0.0f,
+     0.5f,  0.5f,  0.0f,
+    -0.5f, -0.5f,  0.0f,
+     0.5f, -0.5f,  0.0f
+  };
+  std::vector<float> finalData = 
+  {
+    -1.0f,  1.0f,  0.0f,
+     1.0f,  1.0f,  0.0f,
+    -1.0f, -1.0f,  0.0f,
+     1.0f, -1.0f,  0.0f
+  };
+  std::vector<std::string> attribNames = {"aPos"};
+
+  std::vector<uint16_t> iboData =
+  {
+    0, 1, 2, 3
+  };
+  Interface::IBO_TYPE iboType = Interface::IBO_16BIT;
+
+  std::string vbo1 = "vbo1";
+  std::string ibo1 = "ibo1";
+  mSpire->addVBO(vbo1, reinterpret_cast<uint8_t*>(&vboData[0]), vboData.size() * sizeof(float),
+                 attribNames, Interface::USAGE_DYNAMIC);
+  mSpire->addIBO(ibo1, reinterpret_cast<uint8_t*>(&iboData[0]), iboData.size() * sizeof(uint16_t), iboType);
+
+  std::string shader1 = "UniformColor";
+  mSpire->addPersistentShader(
+      shader1, 
+      { std::make_tuple("UniformColor.vsh", Interface::VERTEX_SHADER), 
+        std::make_tuple("UniformColor.fsh", Interface::FRAGMENT_SHADER),
+      });
+  mSpire->addGlobalUniform("uProjIVObject", myCamera->getWorldToProjection());
+
+  std::string pass1 = "pass1";
+  std::string obj1 = "obj1";
+  mSpire->addObject(obj1);
+  mSpire->addPassToObject(obj1, shader1, vbo1, ibo1, Interface::TRIANGLE_STRIP, pass1);
+  mSpire->addObjectPassUniform(obj1, "uColor", V4(1.0f, 0.0f, 0.0f, 1.0f), pass1);
+
+  beginFrame();
+  mSpire->renderPass(pass1);
+  EXPECT_EQ(1u, mSpire->getNumRenderedPasses());
+
+  // Overlapping partial updates: vertices 0 - 2, then 2 - 3.
+  const uint8_t* finalBytes = reinterpret_cast<const uint8_t*>(&finalData[0]);
+  const size_t vertexSize = 3 * sizeof(float);
+  mSpire->updateVBO(vbo1, 0, finalBytes, 3 * vertexSize);
+  mSpire->updateVBO(vbo1, 2 * vertexSize, finalBytes + 2 * vertexSize, 2 * vertexSize);
+
+  EXPECT_THROW(mSpire->updateVBO(vbo1, vertexSize, finalBytes, 4 * vertexSize),
+               std::out_of_range);
+  EXPECT_THROW(mSpire->updateVBO("nonexistant", 0, finalBytes, vertexSize),
+               std::out_of_range);
+
+  beginFrame();
+  mSpire->renderPass(pass1);
+  EXPECT_EQ(1u, mSpire->getNumRenderedPasses());
+
+  compareFBOWithExistingFile(
+      "stuTriangle.png",
+      TEST_IMAGE_OUTPUT_DIR,
+      TEST_IMAGE_COMPARE_DIR,
+      TEST_PERCEPTUAL_COMPARE_BINARY,
+      50);
+}
+
+//------------------------------------------------------------------------------
+TEST_F(SpireTestFixture, TestArenaIBOLODs)
+{
+  std::unique_ptr<TestCamera> myCamera = std::unique_ptr<TestCamera>(new TestCamera);
+
+  // The quad of TestTriangle, as a flat n x n grid. Simplification locks the
+  // boundary and introduces no error, so every level covers the same pixels.
+  const size_t n = 33;
+  std::vector<float> vboData;
+  for (size_t y = 0; y < n; ++y)
+  {
+    for (size_t x = 0; x < n; ++x)
+    {
+      vboData.push_back(2.0f * static_cast<float>(x) / static_cast<float>(n - 1) - 1.0f);
+      vboData.push_back(2.0f * static_cast<float>(y) / static_cast<float>(n - 1) - 1.0f);
+      vboData.push_back(0.0f);
+    }
+  }
+  std::vector<std::string> attribNames = {"aPos"};
+
+  std::vector<uint16_t> iboData;
+  for (size_t y = 0; y + 1 < n; ++y)
+  {
+    for (size_t x = 0; x + 1 < n; ++x)
+    {
+      uint16_t i = static_cast<uint16_t>(y * n + x);
+      uint16_t w = static_cast<uint16_t>(n);
+      iboData.push_back(i);     iboData.push_back(i + 1);     iboData.push_back(i + w);
+      iboData.push_back(i + 1); iboData.push_back(i + w + 1); iboData.push_back(i + w);
+    }
+  }
+  Interface::IBO_TYPE iboType = Interface::IBO_16BIT;
+
+  std::shared_ptr<std::vector<uint8_t>> rawVBO(new std::vector<uint8_t>(
+      reinterpret_cast<uint8_t*>(&vboData[0]),
+      reinterpret_cast<uint8_t*>(&vboData[0]) + vboData.size() * sizeof(float)));
+  std::shared_ptr<std::vector<uint8_t>> rawIBO(new std::vector<uint8_t>(
+      reinterpret_cast<uint8_t*>(&iboData[0]),
+      reinterpret_cast<uint8_t*>(&iboData[0]) + iboData.size() * sizeof(uint16_t)));
+
+  // Another IBO comes first, so the grid's indices do not start at offset 0
+  // of the shared buffer. Its LODs have buffers of their own.
+  mSpire->setBufferArenaEnabled(true);
+  std::vector<uint16_t> paddingData(64, 0);
+  mSpire->addIBO("padding", reinterpret_cast<uint8_t*>(&paddingData[0]),
+                 paddingData.size() * sizeof(uint16_t), iboType);
+
+  std::string vbo1 = "vbo1";
+  std::string ibo1 = "ibo1";
+  mSpire->addVBO(vbo1, rawVBO, attribNames);
+  mSpire->addIBO(ibo1, rawIBO, iboType);
+  EXPECT_EQ(2u, mSpire->getNumArenaBuffers());
+
+  std::string shader1 = "UniformColor";
+  mSpire->addPersistentShader(
+      shader1, 
+      { std::make_tuple("UniformColor.vsh", Interface::VERTEX_SHADER), 
+        std::make_tuple("UniformColor.fsh", Interface::FRAGMENT_SHADER),
+      });
+
+  std::string pass1 = "pass1";
+  std::string obj1 = "obj1";
+  mSpire->addObject(obj1);
+  mSpire->addPassToObject(obj1, shader1, vbo1, ibo1, Interface::TRIANGLES, pass1);
+  mSpire->addObjectPassUniform(obj1, "uColor", V4(1.0f, 0.0f, 0.0f, 1.0f), pass1);
+  mSpire->addObjectGlobalUniform(obj1, "uProjIVObject", myCamera->getWorldToProjection());
+  mSpire->setCullingUniform("uProjIVObject");
+
+  GLint viewport[4];
+  GL(glGetIntegerv(GL_VIEWPORT, viewport));
+  std::vector<uint8_t> fullDetail(static_cast<size_t>(viewport[2]) * static_cast<size_t>(viewport[3]) * 4);
+  std::vector<uint8_t> coarsest(fullDetail.size());
+
+  beginFrame();
+  mSpire->renderPass(pass1);
+  GL(glReadPixels(viewport[0], viewport[1], viewport[2], viewport[3],
+                  GL_RGBA, GL_UNSIGNED_BYTE, &fullDetail[0]));
+
+  // renderPass picks up the chain once the worker is done.
+  mSpire->generateIBOLODs(ibo1, rawIBO, rawVBO, attribNames);
+  for (int i = 0; i < 1000 && mSpire->getNumIBOLODs(ibo1) == 1; ++i)
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    mSpire->renderPass(pass1);
+  }
+  ASSERT_LT(1u, mSpire->getNumIBOLODs(ibo1));
+  EXPECT_EQ(1u, mSpire->getNumIBOLODs("padding"));
+
+  // The coarsest level is within any pixel error.
+  beginFrame();
+  mSpire->renderPass(pass1);
+  EXPECT_EQ(1u, mSpire->getNumRenderedPasses());
+  GL(glReadPixels(viewport[0], viewport[1], viewport[2], viewport[3],
+                  GL_RGBA, GL_UNSIGNED_BYTE, &coarsest[0]));
+  EXPECT_TRUE(fullDetail == coarsest);
+
+  compareFBOWithExistingFile(
+      "stuTriangle.png",
+      TEST_IMAGE_OUTPUT_DIR,
+      TEST_IMAGE_COMPARE_DIR,
+      TEST_PERCEPTUAL_COMPARE_BINARY,
+      50);
+}
+
+//------------------------------------------------------------------------------
+TEST_F(SpireTestFixture, TestMultiThreadedRecording)
+{
+  std::unique_ptr<TestCamera> myCamera = std::unique_ptr<TestCamera>(new TestCamera);
+
+  std::vector<float> vboData = 
+  {
+    -1.0f,  1.0f,  0.0f,
+     1.0f,  1.0f,  0.0f,
+    -1.0f, -1.0f,  0.0f,
+     1.0f, -1.0f,  0.0f
+  };
+  std::vector<std::string> attribNames = {"aPos"};
+
+  std::vector<uint16_t> iboData =
+  {
+    0, 1, 2, 3
+  };
+  Interface::IBO_TYPE iboType = Interface::IBO_16BIT;
+
+  std::string vbo1 = "vbo1";
+  std::string ibo1 = "ibo1";
+  mSpire->addVBO(vbo1, reinterpret_cast<uint8_t*>(&vboData[0]), vboData.size() * sizeof(float), attribNames);
+  mSpire->addIBO(ibo1, reinterpret_cast<uint8_t*>(&iboData[0]), iboData.size() * sizeof(uint16_t), iboType);
+
+  std::string shader1 = "UniformColor";
+  mSpire->addPersistentShader(
+      shader1, 
+      { std::make_tuple("UniformColor.vsh", Interface::VERTEX_SHADER), 
+        std::make_tuple("UniformColor.fsh", Interface::FRAGMENT_SHADER),
+      });
+
+  // Enough overlapping quads with distinct colors for 4 recording jobs. The
+  // image depends on the order in which the quads are drawn. Every fourth
+  // quad lies outside of the frustum and is culled.
+  const size_t numObjects = 4 * InterfaceImplementation::MinPassesPerRecordingJob;
+  std::string pass1 = "pass1";
+  uint32_t seed = 1;
+  auto random = [&seed]()
+  {
+    seed = seed * 1664525u + 1013904223u;
+    return static_cast<float>(seed >> 8) / static_cast<float>(1 << 24) * 2.0f - 1.0f;
+  };
+  for (size_t i = 0; i < numObjects; ++i)
+  {
+    std::string obj = "obj" + std::to_string(i);
+    mSpire->addObject(obj);
+    mSpire->addPassToObject(obj, shader1, vbo1, ibo1, Interface::TRIANGLE_STRIP, pass1);
+    mSpire->addObjectPassUniform(obj, "uColor",
+                                 V4(static_cast<float>(i % 16) / 15.0f,
+                                    static_cast<float>((i / 16) % 16) / 15.0f,
+                                    static_cast<float>(i / 256) / 15.0f, 1.0f),
+                                 pass1);
+
+    M44 xform(1.0f);
+    xform[0][0] = 0.2f;
+    xform[1][1] = 0.2f;
+    xform[3] = (i % 4 == 3) ? V4(100.0f, 0.0f, 0.0f, 1.0f) : V4(random(), random(), 0.0f, 1.0f);
+    mSpire->addObjectGlobalUniform(obj, "uProjIVObject", myCamera->getWorldToProjection() * xform);
+  }
+  mSpire->setCullingUniform("uProjIVObject");
+
+  GLint viewport[4];
+  GL(glGetIntegerv(GL_VIEWPORT, viewport));
+  size_t imageSize = static_cast<size_t>(viewport[2]) * static_cast<size_t>(viewport[3]) * 4;
+
+  // Recording on 4 threads must draw exactly what recording on 1 thread
+  // draws, in the same order.
+  std::vector<uint8_t> expectedImage;
+  size_t expectedIssued = 0;
+  size_t expectedSkipped = 0;
+  for (size_t numThreads : {1, 4})
+  {
+    mSpire->setNumRecordingThreads(numThreads);
+
+    beginFrame();
+    mSpire->invalidateGLState();
+    mSpire->resetGLStateCounters();
+    mSpire->renderPass(pass1);
+    EXPECT_EQ(numObjects / 4, mSpire->getNumCulledPasses());
+    EXPECT_EQ(numObjects - numObjects / 4, mSpire->getNumRenderedPasses());
+
+    std::vector<uint8_t> image(imageSize);
+    GL(glReadPixels(viewport[0], viewport[1], viewport[2], viewport[3],
+                    GL_RGBA, GL_UNSIGNED_BYTE, &image[0]));
+
+    if (numThreads == 1)
+    {
+      expectedImage = image;
+      expectedIssued = mSpire->getNumGLStateCallsIssued();
+      expectedSkipped = mSpire->getNumGLStateCallsSkipped();
+    }
+    else
+    {
+      EXPECT_TRUE(expectedImage == image);
+      EXPECT_EQ(expectedIssued, mSpire->getNumGLStateCallsIssued());
+      EXPECT_EQ(expectedSkipped, mSpire->getNumGLStateCallsSkipped());
+    }
+  }
+}
+
 //------------------------------------------------------------------------------
 TEST_F(SpireTestFixture, TestObjectsStructure)
 {
@@ -0,0 +1,211 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2013 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+/// \author agent
+/// \date   October 2026
+
+#include <cstring>
+#include <limits>
+#include <gtest/gtest.h>
+#include "namespaces.h"
+#include "spire/src/MeshCodec.h"
+
+using namespace spire;
+
+namespace {
+
+//------------------------------------------------------------------------------
+TEST(MeshCodecBasic, TestVertices)
+{
+  // Strides that are not a multiple of 4, and counts that are not a
+  // multiple of the block size.
+  const size_t strides[] = {1, 7, 24, 33};
+  const size_t counts[]  = {0, 1, 16, 17, 1000};
+  for (size_t stride : strides)
+  {
+    for (size_t count : counts)
+    {
+      // Every third byte is noise, the rest change slowly.
+      std::vector<uint8_t> vertices(count * stride);
+      uint32_t noise = 12345;
+      for (size_t i = 0; i < vertices.size(); ++i)
+      {
+        noise = noise * 1103515245 + 12345;
+        vertices[i] = (i % 3 == 0) ? static_cast<uint8_t>(noise >> 16)
+                                   : static_cast<uint8_t>((i / stride) % 7);
+      }
+
+      std::vector<uint8_t> encoded;
+      encodeVertices(vertices.data(), count, stride, encoded);
+
+      // Nothing is written past the last vertex.
+      std::vector<uint8_t> decoded(vertices.size() + 1, 0xAB);
+      decodeVertices(encoded.data(), encoded.size(), count, stride, decoded.data());
+      EXPECT_EQ(0, std::memcmp(vertices.data(), decoded.data(), vertices.size()));
+      EXPECT_EQ(0xAB, decoded.back());
+
+      if (count > 0)
+      {
+        EXPECT_THROW(decodeVertices(encoded.data(), encoded.size() - 1, count,
+                                    stride, decoded.data()),
+                     std::invalid_argument);
+      }
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+TEST(MeshCodecBasic, TestIndices)
+{
+  const size_t indexSizes[] = {1, 2, 4};
+  for (size_t indexSize : indexSizes)
+  {
+    std::vector<uint8_t> indices(3000 * indexSize);
+    uint32_t noise = 54321;
+    for (size_t i = 0; i < indices.size(); ++i)
+    {
+      noise = noise * 1103515245 + 12345;
+      indices[i] = static_cast<uint8_t>(noise >> 16);
+    }
+
+    std::vector<uint8_t> encoded;
+    encodeIndices(indices.data(), 3000, indexSize, encoded);
+    std::vector<uint8_t> decoded(indices.size());
+    decodeIndices(encoded.data(), encoded.size(), 3000, indexSize, decoded.data());
+    EXPECT_EQ(indices, decoded);
+
+    EXPECT_THROW(decodeIndices(encoded.data(), encoded.size() - 1, 3000,
+                               indexSize, decoded.data()),
+                 std::invalid_argument);
+  }
+
+  // Triangles of new vertices take a byte each. The last index does not
+  // make up a triangle and is delta coded on its own.
+  std::vector<uint16_t> fresh;
+  for (uint16_t i = 0; i < 1000; ++i)
+    fresh.push_back(i);
+  std::vector<uint8_t> encoded;
+  encodeIndices(reinterpret_cast<const uint8_t*>(fresh.data()), fresh.size(),
+                sizeof(uint16_t), encoded);
+  EXPECT_EQ(fresh.size() / 3 + 1, encoded.size());
+
+  // Decoded indices must fit the index size.
+  uint16_t large = 300;
+  encoded.clear();
+  encodeIndices(reinterpret_cast<const uint8_t*>(&large), 1, sizeof(uint16_t), encoded);
+  uint8_t narrow;
+  EXPECT_THROW(decodeIndices(encoded.data(), encoded.size(), 1, 1, &narrow),
+               std::invalid_argument);
+}
+
+//------------------------------------------------------------------------------
+TEST(MeshCodecBasic, TestGridIndices)
+{
+  // Row-major n x n grid, two triangles per cell. Past the first row and
+  // column, every triangle shares an edge with the previous one. Its third
+  // vertex is either the next vertex or one step from an edge vertex.
+  const size_t n = 64;
+  std::vector<uint32_t> indices;
+  for (size_t y = 0; y + 1 < n; ++y)
+  {
+    for (size_t x = 0; x + 1 < n; ++x)
+    {
+      uint32_t i = static_cast<uint32_t>(y * n + x);
+      uint32_t w = static_cast<uint32_t>(n);
+      indices.push_back(i);     indices.push_back(i + 1);     indices.push_back(i + w);
+      indices.push_back(i + 1); indices.push_back(i + w + 1); indices.push_back(i + w);
+    }
+  }
+
+  const size_t indexSizes[] = {2, 4};
+  for (size_t indexSize : indexSizes)
+  {
+    std::vector<uint8_t> raw(indices.size() * indexSize);
+    for (size_t i = 0; i < indices.size(); ++i)
+    {
+      if (indexSize == 2)
+      {
+        uint16_t narrow = static_cast<uint16_t>(indices[i]);
+        std::memcpy(&raw[2 * i], &narrow, sizeof(narrow));
+      }
+      else
+      {
+        std::memcpy(&raw[4 * i], &indices[i], sizeof(uint32_t));
+      }
+    }
+
+    std::vector<uint8_t> encoded;
+    encodeIndices(raw.data(), indices.size(), indexSize, encoded);
+    std::vector<uint8_t> decoded(raw.size());
+    decodeIndices(encoded.data(), encoded.size(), indices.size(), indexSize,
+                  decoded.data());
+    EXPECT_EQ(raw, decoded);
+
+    // About 1.5 bytes per triangle, 4x for 16 bit indices.
+    EXPECT_GE(indices.size() / 2 + 64, encoded.size());
+  }
+}
+
+//------------------------------------------------------------------------------
+TEST(MeshCodecBasic, TestMalformedIndices)
+{
+  // Triangle of explicit vertices: a vertex FIFO index out of range, then a
+  // reserved vertex mode.
+  const uint8_t badFIFO[] = {0x5D, 0, 0, 16};
+  const uint8_t badMode[] = {0xFF};
+  uint16_t indices[3];
+  EXPECT_THROW(decodeIndices(badFIFO, sizeof(badFIFO), 3, sizeof(uint16_t),
+                             reinterpret_cast<uint8_t*>(indices)),
+               std::invalid_argument);
+  EXPECT_THROW(decodeIndices(badMode, sizeof(badMode), 3, sizeof(uint16_t),
+                             reinterpret_cast<uint8_t*>(indices)),
+               std::invalid_argument);
+}
+
+//------------------------------------------------------------------------------
+TEST(MeshCodecBasic, TestQuantizeFloats)
+{
+  const float largest = std::numeric_limits<float>::max();
+  float values[] = {1.0f, 1.0f + 1.0f / 4096.0f, -2.5f, largest, 0.0f};
+  quantizeFloats(values, 5, 10);
+  EXPECT_EQ(1.0f, values[0]);
+  EXPECT_EQ(1.0f, values[1]);
+  EXPECT_EQ(-2.5f, values[2]);
+  EXPECT_EQ(0.0f, values[4]);
+
+  // Rounding up would overflow to infinity.
+  EXPECT_GE(largest, values[3]);
+  EXPECT_LT(0.999f * largest, values[3]);
+
+  // Quantized values leave the low mantissa bits clear.
+  uint32_t bits;
+  std::memcpy(&bits, &values[3], sizeof(bits));
+  EXPECT_EQ(0u, bits & 0x1FFF);
+}
+
+}
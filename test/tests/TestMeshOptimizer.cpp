@@ -0,0 +1,166 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2013 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+/// \author agent
+/// \date   October 2026
+
+#include <algorithm>
+#include <gtest/gtest.h>
+#include "namespaces.h"
+#include "spire/src/MeshOptimizer.h"
+
+using namespace spire;
+
+namespace {
+
+// Flat n x n grid of vertices in the z = 0 plane, two triangles per cell.
+// The triangles are shuffled, which defeats the vertex cache.
+void buildShuffledGrid(size_t n, std::vector<float>& positions,
+                       std::vector<uint32_t>& indices)
+{
+  for (size_t y = 0; y < n; ++y)
+  {
+    for (size_t x = 0; x < n; ++x)
+    {
+      positions.push_back(static_cast<float>(x));
+      positions.push_back(static_cast<float>(y));
+      positions.push_back(0.0f);
+    }
+  }
+
+  std::vector<uint32_t> grid;
+  for (size_t y = 0; y + 1 < n; ++y)
+  {
+    for (size_t x = 0; x + 1 < n; ++x)
+    {
+      uint32_t i = static_cast<uint32_t>(y * n + x);
+      uint32_t w = static_cast<uint32_t>(n);
+      grid.push_back(i);     grid.push_back(i + 1); grid.push_back(i + w);
+      grid.push_back(i + 1); grid.push_back(i + w + 1); grid.push_back(i + w);
+    }
+  }
+
+  // Deterministic permutation of the triangles.
+  size_t numTriangles = grid.size() / 3;
+  for (size_t i = 0; i < numTriangles; ++i)
+  {
+    size_t t = (i * 7919) % numTriangles;
+    indices.insert(indices.end(), grid.begin() + 3 * t, grid.begin() + 3 * t + 3);
+  }
+}
+
+// Triangles as position triples, each rotated to start with its smallest
+// vertex, sorted. Equal for meshes that draw the same triangles.
+std::vector<std::vector<float>> getTriangleSet(const std::vector<float>& positions,
+                                               const std::vector<uint32_t>& indices)
+{
+  std::vector<std::vector<float>> triangles;
+  for (size_t t = 0; t < indices.size(); t += 3)
+  {
+    std::vector<std::vector<float>> corners;
+    for (size_t k = 0; k < 3; ++k)
+      corners.push_back(std::vector<float>(&positions[3 * indices[t + k]],
+                                           &positions[3 * indices[t + k]] + 3));
+    size_t first = std::min_element(corners.begin(), corners.end()) - corners.begin();
+
+    std::vector<float> triangle;
+    for (size_t k = 0; k < 3; ++k)
+    {
+      const std::vector<float>& corner = corners[(first + k) % 3];
+      triangle.insert(triangle.end(), corner.begin(), corner.end());
+    }
+    triangles.push_back(triangle);
+  }
+  std::sort(triangles.begin(), triangles.end());
+  return triangles;
+}
+
+//------------------------------------------------------------------------------
+TEST(MeshOptimizerBasic, TestOptimizeMesh)
+{
+  const size_t n = 64;
+  std::vector<float> positions;
+  std::vector<uint32_t> indices;
+  buildShuffledGrid(n, positions, indices);
+
+  std::vector<float> originalPositions = positions;
+  std::vector<uint32_t> originalIndices = indices;
+
+  MeshOptimizerStats stats =
+      optimizeMesh(reinterpret_cast<uint8_t*>(positions.data()), n * n,
+                   3 * sizeof(float), 0, indices);
+
+  // Shuffled triangles share almost no vertices through the cache. A
+  // reordered grid gets close to one vertex per two triangles.
+  EXPECT_LT(2.5f, stats.acmrBefore);
+  EXPECT_GT(0.8f, stats.acmrAfter);
+  EXPECT_FLOAT_EQ(stats.acmrAfter, computeACMR(indices, n * n));
+
+  // Same triangles, with the same winding.
+  ASSERT_EQ(originalIndices.size(), indices.size());
+  EXPECT_EQ(getTriangleSet(originalPositions, originalIndices),
+            getTriangleSet(positions, indices));
+
+  // Vertices are numbered in the order they are first used.
+  uint32_t next = 0;
+  for (auto it = indices.begin(); it != indices.end(); ++it)
+  {
+    EXPECT_GE(next, *it);
+    if (*it == next)
+      ++next;
+  }
+  EXPECT_EQ(n * n, next);
+}
+
+//------------------------------------------------------------------------------
+TEST(MeshOptimizerBasic, TestIndexWidth)
+{
+  std::vector<uint32_t> indices;
+  indices.push_back(0);
+  indices.push_back(255);
+  EXPECT_EQ(1u, getMinIndexSize(indices));
+
+  indices.push_back(256);
+  EXPECT_EQ(2u, getMinIndexSize(indices));
+
+  indices.push_back(65536);
+  EXPECT_EQ(4u, getMinIndexSize(indices));
+
+  std::vector<uint8_t> narrowed;
+  std::vector<uint32_t> widened;
+  indices.pop_back();
+  narrowIndices(indices, 2, narrowed);
+  EXPECT_EQ(indices.size() * 2, narrowed.size());
+  widenIndices(narrowed.data(), indices.size(), 2, widened);
+  EXPECT_EQ(indices, widened);
+
+  EXPECT_THROW(computeACMR(std::vector<uint32_t>(4, 0), 1), std::invalid_argument);
+  EXPECT_THROW(computeACMR(std::vector<uint32_t>(3, 1), 1), std::invalid_argument);
+}
+
+}
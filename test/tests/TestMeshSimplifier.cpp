@@ -0,0 +1,133 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2013 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+/// \author agent
+/// \date   October 2026
+
+#include <algorithm>
+#include <gtest/gtest.h>
+#include "namespaces.h"
+#include "spire/src/MeshSimplifier.h"
+
+using namespace spire;
+
+namespace {
+
+// Flat n x n grid of vertices in the z = 0 plane, two triangles per cell.
+void buildGrid(size_t n, std::vector<float>& positions, std::vector<uint32_t>& indices)
+{
+  for (size_t y = 0; y < n; ++y)
+  {
+    for (size_t x = 0; x < n; ++x)
+    {
+      positions.push_back(static_cast<float>(x));
+      positions.push_back(static_cast<float>(y));
+      positions.push_back(0.0f);
+    }
+  }
+
+  for (size_t y = 0; y + 1 < n; ++y)
+  {
+    for (size_t x = 0; x + 1 < n; ++x)
+    {
+      uint32_t i = static_cast<uint32_t>(y * n + x);
+      uint32_t w = static_cast<uint32_t>(n);
+      indices.push_back(i);     indices.push_back(i + 1); indices.push_back(i + w);
+      indices.push_back(i + 1); indices.push_back(i + w + 1); indices.push_back(i + w);
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+TEST(MeshSimplifierBasic, TestFlatGrid)
+{
+  const size_t n = 33;
+  std::vector<float> positions;
+  std::vector<uint32_t> indices;
+  buildGrid(n, positions, indices);
+
+  MeshSimplifier simplifier(reinterpret_cast<const uint8_t*>(positions.data()),
+                            n * n, 3 * sizeof(float), 0, indices);
+  EXPECT_EQ(indices.size() / 3, simplifier.getNumTriangles());
+
+  size_t remaining = simplifier.simplify(512);
+  EXPECT_GE(512u, remaining);
+
+  std::vector<uint32_t> simplified;
+  simplifier.getIndices(simplified);
+  EXPECT_EQ(3 * remaining, simplified.size());
+
+  // The grid is planar, so no error is introduced.
+  EXPECT_NEAR(0.0f, simplifier.getError(), 1e-4f);
+
+  // Boundary vertices are locked. The corners must still be referenced.
+  const uint32_t corners[] = {0, static_cast<uint32_t>(n - 1),
+                              static_cast<uint32_t>(n * (n - 1)),
+                              static_cast<uint32_t>(n * n - 1)};
+  for (uint32_t corner : corners)
+    EXPECT_NE(simplified.end(), std::find(simplified.begin(), simplified.end(), corner));
+
+  // No triangle may be flipped (all grid triangles face +z).
+  for (size_t t = 0; t < simplified.size(); t += 3)
+  {
+    const float* a = &positions[3 * simplified[t + 0]];
+    const float* b = &positions[3 * simplified[t + 1]];
+    const float* c = &positions[3 * simplified[t + 2]];
+    float nz = (b[0] - a[0]) * (c[1] - a[1]) - (b[1] - a[1]) * (c[0] - a[0]);
+    EXPECT_LT(0.0f, nz);
+  }
+}
+
+//------------------------------------------------------------------------------
+TEST(MeshSimplifierBasic, TestLODChain)
+{
+  const size_t n = 65;
+  std::vector<float> positions;
+  std::vector<uint32_t> indices;
+  buildGrid(n, positions, indices);
+
+  std::vector<LODLevel> levels =
+      buildLODChain(reinterpret_cast<const uint8_t*>(positions.data()), n * n,
+                    3 * sizeof(float), 0, indices, 8, 64);
+  ASSERT_FALSE(levels.empty());
+
+  size_t previous = indices.size();
+  for (auto it = levels.begin(); it != levels.end(); ++it)
+  {
+    EXPECT_GT(previous, it->indices.size());
+    EXPECT_EQ(0u, it->indices.size() % 3);
+    previous = it->indices.size();
+  }
+
+  EXPECT_THROW(MeshSimplifier(reinterpret_cast<const uint8_t*>(positions.data()),
+                              n * n, 3 * sizeof(float), 0,
+                              std::vector<uint32_t>(4, 0)),
+               std::invalid_argument);
+}
+
+}
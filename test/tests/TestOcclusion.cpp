@@ -0,0 +1,169 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2013 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+/// \author agent
+/// \date   October 2026
+
+#include <batch-testing/GlobalGTestEnv.hpp>
+#include <batch-testing/SpireTestFixture.hpp>
+#include "namespaces.h"
+
+#include "spire/src/Common.h"
+#include "spire/src/OcclusionMan.h"
+
+#include "TestCamera.h"
+
+using namespace spire;
+using namespace CPM_BATCH_TESTING_NS;
+
+namespace {
+
+#ifdef SPIRE_USE_OCCLUSION_QUERIES
+
+//------------------------------------------------------------------------------
+TEST_F(SpireTestFixture, TestOcclusionCulling)
+{
+  std::unique_ptr<TestCamera> myCamera = std::unique_ptr<TestCamera>(new TestCamera);
+
+  // The quad of TestTriangle as a flat n x n grid, with enough triangles to
+  // be considered for occlusion culling.
+  const size_t n = 33;
+  std::vector<float> vboData;
+  for (size_t y = 0; y < n; ++y)
+  {
+    for (size_t x = 0; x < n; ++x)
+    {
+      vboData.push_back(2.0f * static_cast<float>(x) / static_cast<float>(n - 1) - 1.0f);
+      vboData.push_back(2.0f * static_cast<float>(y) / static_cast<float>(n - 1) - 1.0f);
+      vboData.push_back(0.0f);
+    }
+  }
+  std::vector<std::string> attribNames = {"aPos"};
+
+  std::vector<uint16_t> iboData;
+  for (size_t y = 0; y + 1 < n; ++y)
+  {
+    for (size_t x = 0; x + 1 < n; ++x)
+    {
+      uint16_t i = static_cast<uint16_t>(y * n + x);
+      uint16_t w = static_cast<uint16_t>(n);
+      iboData.push_back(i);     iboData.push_back(i + 1);     iboData.push_back(i + w);
+      iboData.push_back(i + 1); iboData.push_back(i + w + 1); iboData.push_back(i + w);
+    }
+  }
+  ASSERT_LE(OcclusionMan::MinOccludedElements, iboData.size());
+  Interface::IBO_TYPE iboType = Interface::IBO_16BIT;
+
+  std::string vbo1 = "vbo1";
+  std::string ibo1 = "ibo1";
+  mSpire->addVBO(vbo1, reinterpret_cast<uint8_t*>(&vboData[0]), vboData.size() * sizeof(float), attribNames);
+  mSpire->addIBO(ibo1, reinterpret_cast<uint8_t*>(&iboData[0]), iboData.size() * sizeof(uint16_t), iboType);
+
+  std::string shader1 = "UniformColor";
+  mSpire->addPersistentShader(
+      shader1, 
+      { std::make_tuple("UniformColor.vsh", Interface::VERTEX_SHADER), 
+        std::make_tuple("UniformColor.fsh", Interface::FRAGMENT_SHADER),
+      });
+
+  // A red occluder where TestTriangle draws its quad, and a smaller green
+  // mesh right behind it.
+  std::string pass1 = "pass1";
+  std::string occluder = "occluder";
+  mSpire->addObject(occluder);
+  mSpire->addPassToObject(occluder, shader1, vbo1, ibo1, Interface::TRIANGLES, pass1);
+  mSpire->addObjectPassUniform(occluder, "uColor", V4(1.0f, 0.0f, 0.0f, 1.0f), pass1);
+  mSpire->addObjectGlobalUniform(occluder, "uProjIVObject", myCamera->getWorldToProjection());
+
+  M44 xform(1.0f);
+  xform[0][0] = 0.5f;
+  xform[1][1] = 0.5f;
+  xform[3] = V4(0.0f, 0.0f, -2.0f, 1.0f);
+  std::string occludee = "occludee";
+  mSpire->addObject(occludee);
+  mSpire->addPassToObject(occludee, shader1, vbo1, ibo1, Interface::TRIANGLES, pass1);
+  mSpire->addObjectPassUniform(occludee, "uColor", V4(0.0f, 1.0f, 0.0f, 1.0f), pass1);
+  mSpire->addObjectGlobalUniform(occludee, "uProjIVObject", myCamera->getWorldToProjection() * xform);
+
+  mSpire->setCullingUniform("uProjIVObject");
+  mSpire->setOcclusionCullingEnabled(true);
+
+  // The default depth function. The occluder's proxy lies exactly on its
+  // surface and must not be hidden by it.
+  GL(glEnable(GL_DEPTH_TEST));
+  GL(glDepthFunc(GL_LESS));
+
+  GLint viewport[4];
+  GL(glGetIntegerv(GL_VIEWPORT, viewport));
+  uint8_t center[4];
+
+  // Query results lag behind by at least a frame. Once the results are in,
+  // the occludee stays hidden and the occluder is never considered occluded.
+  size_t numFrames = 0;
+  size_t numOccludedFrames = 0;
+  for (; numFrames < 100 && numOccludedFrames < 10; ++numFrames)
+  {
+    beginFrame();
+    GL(glClear(GL_DEPTH_BUFFER_BIT));
+    mSpire->renderPass(pass1);
+    GL(glFinish());
+
+    GL(glReadPixels(viewport[0] + viewport[2] / 2, viewport[1] + viewport[3] / 2, 1, 1,
+                    GL_RGBA, GL_UNSIGNED_BYTE, center));
+    EXPECT_EQ(255, center[0]);
+    EXPECT_EQ(0, center[1]);
+
+    if (numOccludedFrames > 0 || mSpire->getNumOccludedPasses() > 0)
+    {
+      EXPECT_EQ(1u, mSpire->getNumOccludedPasses());
+      EXPECT_EQ(1u, mSpire->getNumRenderedPasses());
+      ++numOccludedFrames;
+    }
+    else
+    {
+      EXPECT_EQ(2u, mSpire->getNumRenderedPasses());
+    }
+  }
+  EXPECT_EQ(10u, numOccludedFrames);
+
+  // Proxies restore the application's depth function.
+  GLint depthFunc;
+  GL(glGetIntegerv(GL_DEPTH_FUNC, &depthFunc));
+  EXPECT_EQ(GL_LESS, depthFunc);
+
+  compareFBOWithExistingFile(
+      "stuTriangle.png",
+      TEST_IMAGE_OUTPUT_DIR,
+      TEST_IMAGE_COMPARE_DIR,
+      TEST_PERCEPTUAL_COMPARE_BINARY,
+      50);
+}
+
+#endif
+
+}
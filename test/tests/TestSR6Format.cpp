@@ -0,0 +1,193 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2013 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+/// \author agent
+/// \date   October 2026
+
+#include <cstring>
+#include <sstream>
+#include <gtest/gtest.h>
+#include "namespaces.h"
+#include "spire/src/SR6Format.h"
+
+using namespace spire;
+
+namespace {
+
+//------------------------------------------------------------------------------
+TEST(SR6FormatBasic, TestRoundTrip)
+{
+  SR6Attribute pos;
+  pos.name          = "aPos";
+  pos.numComponents = 3;
+  pos.type          = 6;
+  pos.size          = 3 * sizeof(float);
+  pos.normalize     = false;
+
+  SR6Attribute color = pos;
+  color.name          = "aColorFloat";
+  color.numComponents = 4;
+  color.type          = 4;
+  color.size          = 4;
+  color.normalize     = true;
+
+  std::vector<uint8_t> vbo0(3 * 16), vbo1(101);
+  std::vector<uint8_t> ibo0(6 * sizeof(uint16_t)), ibo1(3 * sizeof(uint32_t));
+  for (size_t i = 0; i < vbo1.size(); ++i)
+    vbo1[i] = static_cast<uint8_t>(i);
+  for (size_t i = 0; i < ibo0.size(); ++i)
+    ibo0[i] = static_cast<uint8_t>(0xF0 - i);
+
+  std::vector<SR6Mesh> meshes(2);
+  meshes[0].attributes.push_back(pos);
+  meshes[0].attributes.push_back(color);
+  meshes[0].vbo       = vbo0.data();
+  meshes[0].vboSize   = vbo0.size();
+  meshes[0].ibo       = ibo0.data();
+  meshes[0].iboSize   = ibo0.size();
+  meshes[0].indexSize = sizeof(uint16_t);
+  meshes[1].attributes.push_back(pos);
+  meshes[1].vbo       = vbo1.data();
+  meshes[1].vboSize   = vbo1.size();
+  meshes[1].ibo       = ibo1.data();
+  meshes[1].iboSize   = ibo1.size();
+  meshes[1].indexSize = sizeof(uint32_t);
+
+  std::ostringstream out;
+  writeSR6(out, meshes);
+  std::string file = out.str();
+  const uint8_t* data = reinterpret_cast<const uint8_t*>(file.data());
+
+  std::vector<uint8_t> decoded;
+  std::vector<SR6Mesh> read = readSR6(data, file.size(), decoded);
+  ASSERT_EQ(2u, read.size());
+  for (size_t m = 0; m < read.size(); ++m)
+  {
+    ASSERT_EQ(meshes[m].attributes.size(), read[m].attributes.size());
+    for (size_t a = 0; a < read[m].attributes.size(); ++a)
+    {
+      EXPECT_EQ(meshes[m].attributes[a].name, read[m].attributes[a].name);
+      EXPECT_EQ(meshes[m].attributes[a].numComponents, read[m].attributes[a].numComponents);
+      EXPECT_EQ(meshes[m].attributes[a].type, read[m].attributes[a].type);
+      EXPECT_EQ(meshes[m].attributes[a].size, read[m].attributes[a].size);
+      EXPECT_EQ(meshes[m].attributes[a].normalize, read[m].attributes[a].normalize);
+    }
+    EXPECT_EQ(meshes[m].indexSize, read[m].indexSize);
+
+    // Blobs are aligned relative to the start of the file.
+    EXPECT_EQ(0u, (read[m].vbo - data) % SR6Alignment);
+    EXPECT_EQ(0u, (read[m].ibo - data) % SR6Alignment);
+    EXPECT_EQ(std::vector<uint8_t>(meshes[m].vbo, meshes[m].vbo + meshes[m].vboSize),
+              std::vector<uint8_t>(read[m].vbo, read[m].vbo + read[m].vboSize));
+    EXPECT_EQ(std::vector<uint8_t>(meshes[m].ibo, meshes[m].ibo + meshes[m].iboSize),
+              std::vector<uint8_t>(read[m].ibo, read[m].ibo + read[m].iboSize));
+  }
+
+  // Truncated and malformed files are rejected.
+  size_t end = static_cast<size_t>(read[1].ibo + read[1].iboSize - data);
+  EXPECT_THROW(readSR6(data, end - 1, decoded), std::invalid_argument);
+  EXPECT_THROW(readSR6(data, 16, decoded), std::invalid_argument);
+  file[0] = 'X';
+  EXPECT_THROW(readSR6(data, file.size(), decoded), std::invalid_argument);
+
+  // Attribute names are limited to SR6MaxAttributeName characters.
+  meshes[1].attributes[0].name = std::string(SR6MaxAttributeName + 1, 'a');
+  std::ostringstream badOut;
+  EXPECT_THROW(writeSR6(badOut, meshes), std::invalid_argument);
+}
+
+//------------------------------------------------------------------------------
+TEST(SR6FormatBasic, TestCompressedRoundTrip)
+{
+  SR6Attribute pos;
+  pos.name          = "aPos";
+  pos.numComponents = 3;
+  pos.type          = 6;
+  pos.size          = 3 * sizeof(float);
+  pos.normalize     = false;
+
+  // A strip of 1000 quads.
+  const size_t numVertices = 2002;
+  std::vector<float> vertices;
+  for (size_t i = 0; i < numVertices; ++i)
+  {
+    vertices.push_back(static_cast<float>(i / 2));
+    vertices.push_back(static_cast<float>(i % 2));
+    vertices.push_back(0.5f);
+  }
+  std::vector<uint32_t> indices;
+  for (uint32_t i = 0; i + 2 < numVertices; i += 2)
+  {
+    uint32_t quad[] = {i, i + 1, i + 2, i + 2, i + 1, i + 3};
+    indices.insert(indices.end(), quad, quad + 6);
+  }
+
+  std::vector<SR6Mesh> meshes(2);
+  for (size_t m = 0; m < meshes.size(); ++m)
+  {
+    meshes[m].attributes.push_back(pos);
+    meshes[m].vbo        = reinterpret_cast<const uint8_t*>(vertices.data());
+    meshes[m].vboSize    = vertices.size() * sizeof(float);
+    meshes[m].ibo        = reinterpret_cast<const uint8_t*>(indices.data());
+    meshes[m].iboSize    = indices.size() * sizeof(uint32_t);
+    meshes[m].indexSize  = sizeof(uint32_t);
+    meshes[m].compressed = (m == 1);
+  }
+
+  std::ostringstream out;
+  writeSR6(out, meshes);
+  std::string file = out.str();
+  const uint8_t* data = reinterpret_cast<const uint8_t*>(file.data());
+
+  // The compressed copy takes up less than half the room of the raw one.
+  size_t rawSize = meshes[0].vboSize + meshes[0].iboSize;
+  EXPECT_GT(rawSize + rawSize / 2, file.size());
+
+  std::vector<uint8_t> decoded;
+  std::vector<SR6Mesh> read = readSR6(data, file.size(), decoded);
+  ASSERT_EQ(2u, read.size());
+  EXPECT_FALSE(read[0].compressed);
+  EXPECT_TRUE(read[1].compressed);
+  for (size_t m = 0; m < read.size(); ++m)
+  {
+    ASSERT_EQ(meshes[m].vboSize, read[m].vboSize);
+    ASSERT_EQ(meshes[m].iboSize, read[m].iboSize);
+    EXPECT_EQ(0, std::memcmp(meshes[m].vbo, read[m].vbo, read[m].vboSize));
+    EXPECT_EQ(0, std::memcmp(meshes[m].ibo, read[m].ibo, read[m].iboSize));
+  }
+  EXPECT_TRUE(read[1].vbo >= decoded.data() && read[1].vbo < decoded.data() + decoded.size());
+
+  EXPECT_THROW(readSR6(data, file.size() - SR6Alignment, decoded), std::invalid_argument);
+
+  // Compressed VBOs must hold whole vertices.
+  meshes[1].vboSize -= 1;
+  std::ostringstream badOut;
+  EXPECT_THROW(writeSR6(badOut, meshes), std::invalid_argument);
+}
+
+}
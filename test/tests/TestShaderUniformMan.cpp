@@ -87,6 +87,17 @@ TEST_F(ShaderUniformManInvolved, addingUniforms)
   ASSERT_NO_THROW(state = mUniformMan.getUniformWithName(uniformName));
   EXPECT_EQ(uniformName, state->codeName);
   EXPECT_EQ(GL_FLOAT_VEC4, state->type);
+
+  // Uniform indices are dense and assigned in the order uniforms are added.
+  // The unknown uniform is always at index 0.
+  EXPECT_EQ(0u, mUniformMan.getUniformWithName(ShaderUniformMan::getUnknownName())->index);
+  EXPECT_EQ(1u, mUniformMan.getUniformWithName("uniform1")->index);
+  EXPECT_EQ(2u, state->index);
+
+  // Re-adding a uniform does not change its index.
+  mUniformMan.addUniform("uniform1", GL_FLOAT_MAT4);
+  EXPECT_EQ(1u, mUniformMan.getUniformWithName("uniform1")->index);
+  EXPECT_EQ(3, mUniformMan.getNumUniforms());
 }
 
 }
@@ -0,0 +1,95 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2013 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+/// \author agent
+/// \date   October 2026
+
+#include <gtest/gtest.h>
+#include "namespaces.h"
+#include "spire/src/SlotMap.h"
+
+using namespace spire;
+
+namespace {
+
+struct TestTag {};
+typedef SlotMap<int, TestTag> TestSlotMap;
+
+//------------------------------------------------------------------------------
+TEST(SlotMapBasic, TestInsertAndErase)
+{
+  TestSlotMap slots;
+  TestSlotMap::HandleType a = slots.insert(1);
+  TestSlotMap::HandleType b = slots.insert(2);
+  TestSlotMap::HandleType c = slots.insert(3);
+
+  EXPECT_EQ(3u, slots.size());
+  EXPECT_EQ(1, slots.at(a));
+  EXPECT_EQ(2, slots.at(b));
+  EXPECT_EQ(3, slots.at(c));
+
+  // Erasing moves the last value into the hole, handles must still resolve.
+  slots.erase(a);
+  EXPECT_EQ(2u, slots.size());
+  EXPECT_FALSE(slots.contains(a));
+  EXPECT_EQ(nullptr, slots.find(a));
+  EXPECT_EQ(2, slots.at(b));
+  EXPECT_EQ(3, slots.at(c));
+
+  int sum = 0;
+  for (auto it = slots.begin(); it != slots.end(); ++it)
+    sum += *it;
+  EXPECT_EQ(5, sum);
+}
+
+//------------------------------------------------------------------------------
+TEST(SlotMapBasic, TestStaleHandles)
+{
+  TestSlotMap slots;
+  TestSlotMap::HandleType a = slots.insert(1);
+  slots.erase(a);
+
+  // The slot is recycled with a new generation.
+  TestSlotMap::HandleType b = slots.insert(2);
+  EXPECT_EQ(a.index, b.index);
+  EXPECT_NE(a, b);
+  EXPECT_THROW(slots.at(a), std::out_of_range);
+  EXPECT_THROW(slots.erase(a), std::out_of_range);
+  EXPECT_EQ(2, slots.at(b));
+
+  // Default constructed handles are never valid.
+  TestSlotMap::HandleType invalid;
+  EXPECT_FALSE(invalid.isValid());
+  EXPECT_FALSE(slots.contains(invalid));
+
+  slots.clear();
+  EXPECT_TRUE(slots.empty());
+  EXPECT_FALSE(slots.contains(b));
+}
+
+}
@@ -0,0 +1,191 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2013 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+/// \author agent
+/// \date   October 2026
+
+#include <cstring>
+
+#include <batch-testing/GlobalGTestEnv.hpp>
+#include <batch-testing/SpireTestFixture.hpp>
+#include "namespaces.h"
+
+#include "spire/src/Common.h"
+#include "spire/src/StreamBuffer.h"
+
+#include "TestCamera.h"
+
+using namespace spire;
+using namespace CPM_BATCH_TESTING_NS;
+
+namespace {
+
+/// Quad drawn by TestTriangle, streamed every frame.
+class StreamedQuad
+{
+public:
+  StreamedQuad(Interface& spire, const M44& projIVObject) :
+      mSpire(spire),
+      mVBOData({
+        -1.0f,  1.0f,  0.0f,
+         1.0f,  1.0f,  0.0f,
+        -1.0f, -1.0f,  0.0f,
+         1.0f, -1.0f,  0.0f
+      }),
+      mIBOData({0, 1, 2, 3}),
+      mPass("pass1")
+  {
+    mVBO = mSpire.addStreamVBO("vbo1", {"aPos"});
+    mIBO = mSpire.addStreamIBO("ibo1", Interface::IBO_16BIT);
+
+    std::string shader1 = "UniformColor";
+    mSpire.addPersistentShader(
+        shader1, 
+        { std::make_tuple("UniformColor.vsh", Interface::VERTEX_SHADER), 
+          std::make_tuple("UniformColor.fsh", Interface::FRAGMENT_SHADER),
+        });
+    mSpire.addGlobalUniform("uProjIVObject", projIVObject);
+
+    std::string obj1 = "obj1";
+    mSpire.addObject(obj1);
+    mSpire.addPassToObject(obj1, shader1, "vbo1", "ibo1", Interface::TRIANGLE_STRIP, mPass);
+    mSpire.addObjectPassUniform(obj1, "uColor", V4(1.0f, 0.0f, 0.0f, 1.0f), mPass);
+  }
+
+  /// Bytes of the ring buffer used by one frame, including alignment.
+  size_t getFrameSize() const
+  {
+    return getAlignedSize(mVBOData.size() * sizeof(float))
+         + getAlignedSize(mIBOData.size() * sizeof(uint16_t));
+  }
+
+  /// Writes the quad and renders it.
+  void render()
+  {
+    size_t vboSize = mVBOData.size() * sizeof(float);
+    std::memcpy(mSpire.writeStreamVBO(mVBO, vboSize), &mVBOData[0], vboSize);
+    size_t iboSize = mIBOData.size() * sizeof(uint16_t);
+    std::memcpy(mSpire.writeStreamIBO(mIBO, iboSize), &mIBOData[0], iboSize);
+    mSpire.renderPass(mPass);
+  }
+
+private:
+
+  static size_t getAlignedSize(size_t size)
+  {
+    return (size + StreamBuffer::Alignment - 1) / StreamBuffer::Alignment * StreamBuffer::Alignment;
+  }
+
+  Interface&            mSpire;
+  std::vector<float>    mVBOData;
+  std::vector<uint16_t> mIBOData;
+  std::string           mPass;
+  VBOHandle             mVBO;
+  IBOHandle             mIBO;
+};
+
+//------------------------------------------------------------------------------
+TEST_F(SpireTestFixture, TestStreamBufferWrapAround)
+{
+  std::unique_ptr<TestCamera> myCamera = std::unique_ptr<TestCamera>(new TestCamera);
+  StreamedQuad quad(*mSpire, myCamera->getWorldToProjection());
+
+  // Room for 2.5 frames, so the VBO of every other frame does not fit at the
+  // end of the buffer and wraps around to its start.
+  mSpire->setStreamBufferSize(quad.getFrameSize() * 5 / 2);
+
+  // Waiting for GL after each frame lets the next endStreamFrame retire it,
+  // so at most one frame is in flight and writing never stalls.
+  for (int i = 0; i < 16; ++i)
+  {
+    beginFrame();
+    quad.render();
+    EXPECT_EQ(1u, mSpire->getNumRenderedPasses());
+    mSpire->endStreamFrame();
+    GL(glFinish());
+  }
+  EXPECT_EQ(0u, mSpire->getNumStreamStalls());
+
+  // A quad not written this frame is not drawn.
+  beginFrame();
+  mSpire->renderPass("pass1");
+  EXPECT_EQ(0u, mSpire->getNumRenderedPasses());
+
+  quad.render();
+  compareFBOWithExistingFile(
+      "stuTriangle.png",
+      TEST_IMAGE_OUTPUT_DIR,
+      TEST_IMAGE_COMPARE_DIR,
+      TEST_PERCEPTUAL_COMPARE_BINARY,
+      50);
+}
+
+//------------------------------------------------------------------------------
+TEST_F(SpireTestFixture, TestStreamBufferFrameRetirement)
+{
+  std::unique_ptr<TestCamera> myCamera = std::unique_ptr<TestCamera>(new TestCamera);
+  StreamedQuad quad(*mSpire, myCamera->getWorldToProjection());
+
+  // endStreamFrame waits for frames beyond MaxFramesInFlight, so a buffer
+  // holding those and the current frame never stalls, whatever GL's pace.
+  mSpire->setStreamBufferSize(quad.getFrameSize() * (StreamBuffer::MaxFramesInFlight + 1));
+  for (int i = 0; i < 32; ++i)
+  {
+    beginFrame();
+    quad.render();
+    EXPECT_EQ(1u, mSpire->getNumRenderedPasses());
+    mSpire->endStreamFrame();
+  }
+  EXPECT_EQ(0u, mSpire->getNumStreamStalls());
+
+  // With room for a single frame, each frame reuses the region of the
+  // previous one, waiting for GL to release it when it is still in flight.
+  mSpire->setStreamBufferSize(quad.getFrameSize());
+  const int numFrames = 8;
+  for (int i = 0; i < numFrames; ++i)
+  {
+    beginFrame();
+    quad.render();
+    EXPECT_EQ(1u, mSpire->getNumRenderedPasses());
+    mSpire->endStreamFrame();
+  }
+  EXPECT_GE(static_cast<size_t>(numFrames - 1), mSpire->getNumStreamStalls());
+
+  // A frame's geometry must fit on its own.
+  beginFrame();
+  quad.render();
+  EXPECT_THROW(mSpire->writeStreamVBO("vbo1", StreamBuffer::Alignment), std::out_of_range);
+  compareFBOWithExistingFile(
+      "stuTriangle.png",
+      TEST_IMAGE_OUTPUT_DIR,
+      TEST_IMAGE_COMPARE_DIR,
+      TEST_PERCEPTUAL_COMPARE_BINARY,
+      50);
+}
+
+} // namespace
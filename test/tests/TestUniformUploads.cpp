@@ -0,0 +1,145 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2013 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+/// \author agent
+/// \date   October 2026
+
+#include <batch-testing/GlobalGTestEnv.hpp>
+#include <batch-testing/SpireTestFixture.hpp>
+#include "namespaces.h"
+
+#include "spire/src/Common.h"
+#include "spire/src/Hub.h"
+#include "spire/src/InterfaceImplementation.h"
+#include "spire/src/ShaderProgramMan.h"
+#include "spire/src/ShaderUniformStateManTemplates.h"
+
+#include "TestCamera.h"
+
+using namespace spire;
+using namespace CPM_BATCH_TESTING_NS;
+
+namespace {
+
+//------------------------------------------------------------------------------
+TEST_F(SpireTestFixture, TestRedundantUniformUploads)
+{
+  std::unique_ptr<TestCamera> myCamera = std::unique_ptr<TestCamera>(new TestCamera);
+
+  std::vector<float> vboData = 
+  {
+    -1.0f,  1.0f,  0.0f,
+     1.0f,  1.0f,  0.0f,
+    -1.0f, -1.0f,  0.0f,
+     1.0f, -1.0f,  0.0f
+  };
+  std::vector<uint16_t> iboData =
+  {
+    0, 1, 2, 3
+  };
+
+  // The upload counters live on the program, which the public interface does
+  // not expose.
+  Hub hub(nullptr, std::vector<std::string>(), Interface::LogFunction());
+  InterfaceImplementation& impl = *hub.getInterfaceImpl();
+  impl.addShaderAttribute("aPos", 3, false, sizeof(float) * 3, Interface::TYPE_FLOAT, 0);
+
+  std::shared_ptr<std::vector<uint8_t>> rawVBO(new std::vector<uint8_t>(
+      reinterpret_cast<uint8_t*>(&vboData[0]),
+      reinterpret_cast<uint8_t*>(&vboData[0]) + vboData.size() * sizeof(float)));
+  std::shared_ptr<std::vector<uint8_t>> rawIBO(new std::vector<uint8_t>(
+      reinterpret_cast<uint8_t*>(&iboData[0]),
+      reinterpret_cast<uint8_t*>(&iboData[0]) + iboData.size() * sizeof(uint16_t)));
+  impl.addVBO("vbo1", rawVBO, {"aPos"}, Interface::USAGE_STATIC);
+  impl.addIBO("ibo1", rawIBO, Interface::IBO_16BIT, Interface::USAGE_STATIC);
+
+  // Two programs built from the same shaders.
+  for (const char* name : {"UniformColor", "UniformColor2"})
+  {
+    impl.addPersistentShader(
+        name, 
+        { std::make_tuple("UniformColor.vsh", Interface::VERTEX_SHADER), 
+          std::make_tuple("UniformColor.fsh", Interface::FRAGMENT_SHADER),
+        });
+  }
+  std::shared_ptr<ShaderProgramAsset> program1 =
+      hub.getShaderProgramManager().findProgram("UniformColor");
+  std::shared_ptr<ShaderProgramAsset> program2 =
+      hub.getShaderProgramManager().findProgram("UniformColor2");
+
+  // Both uniforms are global, so every pass renders with the same items.
+  impl.addGlobalUniformConcrete("uProjIVObject",
+      std::shared_ptr<AbstractUniformStateItem>(
+          new UniformStateItem<M44>(myCamera->getWorldToProjection())));
+  impl.addGlobalUniformConcrete("uColor",
+      std::shared_ptr<AbstractUniformStateItem>(
+          new UniformStateItem<V4>(V4(0.0f, 0.0f, 1.0f, 1.0f))));
+
+  std::string pass1 = "pass1";
+  impl.addObject("obj1");
+  impl.addPassToObject("obj1", "UniformColor", "vbo1", "ibo1", Interface::TRIANGLE_STRIP, pass1, "");
+  impl.addObject("obj2");
+  impl.addPassToObject("obj2", "UniformColor", "vbo1", "ibo1", Interface::TRIANGLE_STRIP, pass1, "");
+
+  // The first pass uploads both uniforms, the second one finds them in the
+  // program already.
+  beginFrame();
+  impl.renderPass(pass1);
+  EXPECT_EQ(2u, program1->getNumUniformUploads());
+  EXPECT_EQ(2u, program1->getNumSkippedUniformUploads());
+
+  // Only the uniform whose item changed is uploaded again, once.
+  impl.addGlobalUniformConcrete("uColor",
+      std::shared_ptr<AbstractUniformStateItem>(
+          new UniformStateItem<V4>(V4(1.0f, 0.0f, 0.0f, 1.0f))));
+  beginFrame();
+  impl.renderPass(pass1);
+  EXPECT_EQ(3u, program1->getNumUniformUploads());
+  EXPECT_EQ(5u, program1->getNumSkippedUniformUploads());
+
+  // Another program holds values of its own, so switching to it uploads the
+  // same items again.
+  impl.addObject("obj3");
+  impl.addPassToObject("obj3", "UniformColor2", "vbo1", "ibo1", Interface::TRIANGLE_STRIP, pass1, "");
+  beginFrame();
+  impl.renderPass(pass1);
+  EXPECT_EQ(3u, program1->getNumUniformUploads());
+  EXPECT_EQ(9u, program1->getNumSkippedUniformUploads());
+  EXPECT_EQ(2u, program2->getNumUniformUploads());
+  EXPECT_EQ(0u, program2->getNumSkippedUniformUploads());
+  EXPECT_EQ(3u, impl.getNumRenderedPasses());
+
+  compareFBOWithExistingFile(
+      "stuTriangle.png",
+      TEST_IMAGE_OUTPUT_DIR,
+      TEST_IMAGE_COMPARE_DIR,
+      TEST_PERCEPTUAL_COMPARE_BINARY,
+      50);
+}
+
+}
@@ -0,0 +1,143 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2013 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+/// \author agent
+/// \date   October 2026
+
+#include <atomic>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "namespaces.h"
+#include "spire/src/WorkerPool.h"
+#include "spire/src/CommandBuffer.h"
+
+using namespace spire;
+
+namespace {
+
+//------------------------------------------------------------------------------
+TEST(WorkerPoolBasic, TestAllJobsRun)
+{
+  for (size_t numThreads : {0, 3})
+  {
+    WorkerPool pool(numThreads);
+    EXPECT_EQ(numThreads, pool.getNumThreads());
+
+    // The pool is reused across batches.
+    for (size_t batch = 0; batch < 3; ++batch)
+    {
+      std::vector<size_t> results(64, 0);
+      std::vector<WorkerPool::Job> jobs;
+      for (size_t i = 0; i < results.size(); ++i)
+        jobs.push_back([&results, i, batch]() {results[i] = i * i + batch;});
+
+      pool.run(jobs);
+      for (size_t i = 0; i < results.size(); ++i)
+        EXPECT_EQ(i * i + batch, results[i]);
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+TEST(WorkerPoolBasic, TestSlicesMatchSingleThread)
+{
+  // Records a sorted list of passes in slices, one command buffer per job, the
+  // same way renderPass does. Executing the buffers in order must reproduce
+  // the list.
+  const size_t numPasses = 1000;
+  std::vector<ObjectPass*> passes;
+  for (size_t i = 0; i < numPasses; ++i)
+    passes.push_back(reinterpret_cast<ObjectPass*>(static_cast<uintptr_t>((i + 1) * 16)));
+
+  for (size_t numJobs : {1, 4})
+  {
+    WorkerPool pool(numJobs - 1);
+    std::vector<CommandBuffer> buffers(numJobs);
+    std::vector<WorkerPool::Job> jobs;
+    for (size_t i = 0; i < numJobs; ++i)
+    {
+      jobs.push_back([&passes, &buffers, i, numJobs]()
+      {
+        CommandBuffer& buffer = buffers[i];
+        buffer.clear();
+        size_t end = passes.size() * (i + 1) / numJobs;
+        for (size_t p = passes.size() * i / numJobs; p < end; ++p)
+          buffer.addDraw(passes[p], p, nullptr);
+      });
+    }
+    pool.run(jobs);
+
+    std::vector<ObjectPass*> executed;
+    for (auto buffer = buffers.begin(); buffer != buffers.end(); ++buffer)
+    {
+      const std::vector<DrawCommand>& draws = buffer->getDraws();
+      for (auto it = draws.begin(); it != draws.end(); ++it)
+      {
+        EXPECT_EQ(executed.size(), it->sortKey);
+        executed.push_back(it->pass);
+      }
+    }
+    EXPECT_EQ(passes, executed);
+  }
+}
+
+//------------------------------------------------------------------------------
+TEST(WorkerPoolBasic, TestExceptionReachesCaller)
+{
+  for (size_t numThreads : {0, 3})
+  {
+    WorkerPool pool(numThreads);
+
+    std::atomic<size_t> numCompleted(0);
+    std::vector<WorkerPool::Job> jobs;
+    for (size_t i = 0; i < 32; ++i)
+    {
+      jobs.push_back([&numCompleted, i]()
+      {
+        if (i == 5)
+          throw std::runtime_error("Job failed.");
+        ++numCompleted;
+      });
+    }
+
+    // Every other job still runs before the exception is rethrown.
+    EXPECT_THROW(pool.run(jobs), std::runtime_error);
+    EXPECT_EQ(31u, numCompleted.load());
+
+    // The pool remains usable.
+    jobs.erase(jobs.begin() + 5);
+    numCompleted = 0;
+    EXPECT_NO_THROW(pool.run(jobs));
+    EXPECT_EQ(31u, numCompleted.load());
+  }
+}
+
+}